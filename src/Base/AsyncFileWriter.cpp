@@ -0,0 +1,118 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <cstdio>
+#include <mutex>
+#include <unistd.h>
+#include "TROOT.h"
+#include "TFile.h"
+#include "AsyncFileWriter.hpp"
+using CAP::AsyncFileWriter;
+
+ClassImp(AsyncFileWriter);
+
+AsyncFileWriter::AsyncFileWriter()
+:
+worker(),
+data(),
+snapshot(),
+option(),
+target(),
+busy(false),
+status(true)
+{ }
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+  wait();
+}
+
+void AsyncFileWriter::write(const String & fileName, vector<char> & buffer)
+{
+  wait();
+  data.swap(buffer);
+  buffer.clear();
+  target = fileName;
+  busy   = true;
+  worker = thread([this]()
+                  {
+                  status = writeFile(target,data);
+                  data.clear();
+                  busy = false;
+                  });
+}
+
+void AsyncFileWriter::write(const String & fileName, const String & _option, vector<TObject*> & objects)
+{
+  // ROOT I/O from a second thread requires its global state to be protected.
+  static once_flag threadSafetyEnabled;
+  call_once(threadSafetyEnabled, [](){ ROOT::EnableThreadSafety(); });
+  wait();
+  snapshot.swap(objects);
+  objects.clear();
+  target = fileName;
+  option = _option;
+  busy   = true;
+  worker = thread([this]()
+                  {
+                  status = writeObjects(target,option,snapshot);
+                  busy = false;
+                  });
+}
+
+bool AsyncFileWriter::wait()
+{
+  if (worker.joinable()) worker.join();
+  return status;
+}
+
+bool AsyncFileWriter::writeFile(const String & fileName, const vector<char> & buffer)
+{
+  String temporaryName = fileName;
+  temporaryName += ".tmp";
+  FILE * file = fopen(temporaryName.Data(),"wb");
+  if (!file) return false;
+  bool ok = fwrite(buffer.data(),1,buffer.size(),file)==buffer.size();
+  ok = ok && fflush(file)==0;
+  ok = ok && fsync(fileno(file))==0;
+  ok = (fclose(file)==0) && ok;
+  if (!ok)
+    {
+    remove(temporaryName.Data());
+    return false;
+    }
+  return rename(temporaryName.Data(),fileName.Data())==0;
+}
+
+bool AsyncFileWriter::writeObjects(const String & fileName, const String & option, vector<TObject*> & objects)
+{
+  TFile * file = TFile::Open(fileName,option);
+  bool ok = file && file->IsOpen();
+  for (unsigned int iObject=0; iObject<objects.size(); iObject++)
+    {
+    if (ok) objects[iObject]->Write();
+    delete objects[iObject];
+    }
+  objects.clear();
+  if (file)
+    {
+    file->Close();
+    delete file;
+    }
+  return ok;
+}
+
+void AsyncFileWriter::serialize(TMemFile & file, vector<char> & buffer)
+{
+  Long64_t size = file.GetSize();
+  buffer.resize(size);
+  file.CopyTo(buffer.data(),size);
+}
@@ -0,0 +1,104 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__AsyncFileWriter
+#define CAP__AsyncFileWriter
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "TObject.h"
+#include "TMemFile.h"
+#include "Aliases.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Background writer of file images. The caller serializes the data to be written (e.g., a ROOT file built in memory with
+//! serialize()) and hands the bytes to write(), which returns immediately. A worker thread writes the bytes to fileName.tmp,
+//! flushes them to disk, and renames the temporary file to fileName so a reader (or a restarted job) never sees a partially written
+//! file. At most one write is in flight: write() first waits for the completion of the previous one.
+//!
+//! The writer also accepts a snapshot of ROOT objects, e.g., clones of histograms, which are written (and compressed) by the worker
+//! thread into a ROOT file opened by that thread. The objects are owned by the writer and deleted once written.
+//!
+class AsyncFileWriter
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  AsyncFileWriter();
+
+  //!
+  //! DTOR: waits for the write in progress, if any.
+  //!
+  virtual ~AsyncFileWriter();
+
+  //!
+  //! Start writing the given bytes to the file with the given name in the background. The content of buffer is moved to this
+  //! writer (buffer is left empty).
+  //!
+  void write(const String & fileName, vector<char> & buffer);
+
+  //!
+  //! Start writing the given objects, in order, to the ROOT file with the given name and open option in the background. The
+  //! objects must not be attached to any directory; they are owned by this writer (objects is left empty).
+  //!
+  void write(const String & fileName, const String & option, vector<TObject*> & objects);
+
+  //!
+  //! Wait for the write in progress, if any, to complete. Returns the status of the last write.
+  //!
+  bool wait();
+
+  //!
+  //! Return true if a write is in progress.
+  //!
+  inline bool isBusy() const
+  {
+  return busy;
+  }
+
+  //!
+  //! Write the given bytes to the file with the given name, atomically (temporary file and rename), in the calling thread.
+  //!
+  static bool writeFile(const String & fileName, const vector<char> & buffer);
+
+  //!
+  //! Write the given objects to the ROOT file with the given name and open option, in the calling thread, and delete them.
+  //!
+  static bool writeObjects(const String & fileName, const String & option, vector<TObject*> & objects);
+
+  //!
+  //! Copy the image of the given in-memory ROOT file into the given buffer. The file must have been written (Write()) beforehand.
+  //!
+  static void serialize(TMemFile & file, vector<char> & buffer);
+
+protected:
+
+  thread        worker;   //!
+  vector<char>  data;     //!
+  vector<TObject*> snapshot; //!
+  String        option;   //!
+  String        target;   //!
+  atomic<bool>  busy;     //!
+  atomic<bool>  status;   //!
+
+  ClassDef(AsyncFileWriter,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__AsyncFileWriter */
@@ -16,6 +16,8 @@
 #pragma link C++ class CAP::HistogramCollection+;
 #pragma link C++ class CAP::HistogramGroup+;
 #pragma link C++ class CAP::HistogramManager+;
+#pragma link C++ class CAP::HistogramCounter+;
+#pragma link C++ class CAP::SparseHistogram3D+;
 #pragma link C++ class CAP::Factory<CAP::VectorField>+;
 
 //#pragma link C++ class CAP::MomentumGenerator+;
@@ -33,8 +35,13 @@
 #pragma link C++ class CAP::Task+;
 #pragma link C++ class CAP::DerivedHistogramCalculator+;
 #pragma link C++ class CAP::RootTreeReader+;
+#pragma link C++ class CAP::TaskProfiler+;
+#pragma link C++ class CAP::AsyncFileWriter+;
 #pragma link C++ class CAP::TaskIterator+;
 #pragma link C++ class CAP::DerivedHistoIterator+;
+#pragma link C++ class CAP::BidimFitGrid+;
+#pragma link C++ class CAP::BidimFitJob+;
+#pragma link C++ class CAP::BidimGaussFitService+;
 #pragma link C++ class CAP::MessageLogger+;
 #pragma link C++ class CAP::StateManager+;
 #pragma link C++ class CAP::VectorField+;
@@ -0,0 +1,396 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "TROOT.h"
+#include "TMath.h"
+#include "TRandom3.h"
+#include "Math/Minimizer.h"
+#include "Math/Factory.h"
+#include "Math/Functor.h"
+#include "BidimGaussFitService.hpp"
+using CAP::BidimFitGrid;
+using CAP::BidimFitJob;
+using CAP::BidimGaussFitService;
+
+ClassImp(BidimFitGrid);
+ClassImp(BidimFitJob);
+ClassImp(BidimGaussFitService);
+
+BidimFitGrid::BidimFitGrid()
+:
+x(),
+y(),
+cosY(),
+iX(),
+iY(),
+content(),
+weight()
+{ }
+
+void BidimFitGrid::fill(const TH2 * h,
+                        double xLow, double xHigh,
+                        double yLow, double yHigh,
+                        double xExcludedLow, double xExcludedHigh,
+                        double yExcludedLow, double yExcludedHigh)
+{
+  x.clear();
+  y.clear();
+  iX.clear();
+  iY.clear();
+  content.clear();
+  weight.clear();
+  bool exclude = xExcludedLow<xExcludedHigh;
+  int nBinsX = h->GetNbinsX();
+  int nBinsY = h->GetNbinsY();
+  vector<int> xIndex(nBinsX+1,-1);
+  vector<int> yIndex(nBinsY+1,-1);
+  for (int iBinX=1; iBinX<=nBinsX; iBinX++)
+    {
+    double xc = h->GetXaxis()->GetBinCenter(iBinX);
+    if (xc<xLow || xc>xHigh) continue;
+    xIndex[iBinX] = x.size();
+    x.push_back(xc);
+    }
+  for (int iBinY=1; iBinY<=nBinsY; iBinY++)
+    {
+    double yc = h->GetYaxis()->GetBinCenter(iBinY);
+    if (yc<yLow || yc>yHigh) continue;
+    yIndex[iBinY] = y.size();
+    y.push_back(yc);
+    }
+  for (int iBinX=1; iBinX<=nBinsX; iBinX++)
+    {
+    if (xIndex[iBinX]<0) continue;
+    bool xExcluded = exclude && x[xIndex[iBinX]]>=xExcludedLow && x[xIndex[iBinX]]<=xExcludedHigh;
+    for (int iBinY=1; iBinY<=nBinsY; iBinY++)
+      {
+      if (yIndex[iBinY]<0) continue;
+      if (xExcluded && y[yIndex[iBinY]]>=yExcludedLow && y[yIndex[iBinY]]<=yExcludedHigh) continue;
+      double error = h->GetBinError(iBinX,iBinY);
+      if (error<=0.0) continue;
+      iX.push_back(xIndex[iBinX]);
+      iY.push_back(yIndex[iBinY]);
+      content.push_back(h->GetBinContent(iBinX,iBinY));
+      weight.push_back(1.0/(error*error));
+      }
+    }
+  int nY = y.size();
+  cosY.assign(nCos*nY,0.0);
+  for (int k=1; k<=nCos; k++)
+    for (int jY=0; jY<nY; jY++) cosY[(k-1)*nY+jY] = cos(double(k)*y[jY]);
+}
+
+BidimFitJob::BidimFitJob()
+:
+histogram(nullptr),
+model(BidimGaussFitService::Flow),
+function(nullptr),
+nParameters(0),
+xLow(-1.0E30),
+xHigh(1.0E30),
+yLow(-1.0E30),
+yHigh(1.0E30),
+xExcludedLow(0.0),
+xExcludedHigh(0.0),
+yExcludedLow(0.0),
+yExcludedHigh(0.0),
+start(),
+lower(),
+upper(),
+fixed(),
+parameters(),
+errors(),
+chi2(0.0),
+ndf(0),
+status(-1),
+bestStart(-1),
+nConverged(0)
+{ }
+
+void BidimFitJob::setParameters(TF1 * f) const
+{
+  for (unsigned int iPar=0; iPar<parameters.size(); iPar++)
+    {
+    f->SetParameter(iPar,parameters[iPar]);
+    f->SetParError(iPar,errors[iPar]);
+    }
+  f->SetChisquare(chi2);
+  f->SetNDF(ndf);
+}
+
+BidimGaussFitService::BidimGaussFitService(int _nThreads, int _nStarts, long _seed, Severity _reportLevel)
+:
+MessageLogger(_reportLevel),
+nThreads(_nThreads),
+nStarts(_nStarts),
+seed(_seed),
+startSpread(0.5),
+minimizerType("Minuit2"),
+minimizerAlgorithm("Migrad"),
+strategy(1),
+tolerance(0.01),
+maxFunctionCalls(100000),
+jobs(),
+grids()
+{
+  appendClassName("BidimGaussFitService");
+}
+
+int BidimGaussFitService::addFit(const BidimFitJob & job)
+{
+  jobs.push_back(job);
+  return jobs.size()-1;
+}
+
+void BidimGaussFitService::clear()
+{
+  jobs.clear();
+  grids.clear();
+}
+
+int BidimGaussFitService::getNParameters(int model, int nUserParameters)
+{
+  switch (model)
+    {
+      case Flow:         return 11;
+      case FlowPlusPeak: return 16;
+      default:           return nUserParameters;
+    }
+}
+
+void BidimGaussFitService::evaluate(const BidimFitGrid & grid, const BidimFitJob & job, const double * par, vector<double> & values, vector<double> & scratch)
+{
+  int n  = grid.size();
+  int nX = grid.x.size();
+  int nY = grid.y.size();
+  values.resize(n);
+  if (job.model==UserFunction)
+    {
+    // generic model: one callback per bin
+    scratch.assign(par,par+job.nParameters);
+    double xy[2];
+    for (int i=0; i<n; i++)
+      {
+      xy[0] = grid.x[grid.iX[i]];
+      xy[1] = grid.y[grid.iY[i]];
+      values[i] = job.function(xy,scratch.data());
+      }
+    return;
+    }
+  // Flow: par[0..10], with |x| in the eta dependence; FlowPlusPeak: peak par[0..4], flow par[5..15], with x in the eta dependence.
+  const double * a = job.model==Flow ? par : par+5;
+  bool absX = job.model==Flow;
+  scratch.resize(3*nX+3*nY);
+  double * c2X   = &scratch[0];
+  double * c3X   = &scratch[nX];
+  double * peakX = &scratch[2*nX];
+  double * base  = &scratch[3*nX];
+  double * peakY = &scratch[3*nX+nY];
+  const double * cos2 = &grid.cosY[nY];
+  const double * cos3 = &grid.cosY[2*nY];
+  for (int jX=0; jX<nX; jX++)
+    {
+    double eta = absX ? fabs(grid.x[jX]) : grid.x[jX];
+    c2X[jX] = a[7]*eta + a[9]*eta*eta;
+    c3X[jX] = a[8]*eta + a[10]*eta*eta;
+    }
+  for (int jY=0; jY<nY; jY++) base[jY] = a[0];
+  for (int k=1; k<=BidimFitGrid::nCos; k++)
+    {
+    const double * cosK = &grid.cosY[(k-1)*nY];
+    for (int jY=0; jY<nY; jY++) base[jY] += a[k]*cosK[jY];
+    }
+  if (job.model==FlowPlusPeak)
+    {
+    // generalized gaussian peak: the x and y factors are computed once per distinct bin center
+    double norm1 = par[3]/2.0/par[1]/TMath::Gamma(1.0/par[3]);
+    double norm2 = par[4]/2.0/par[2]/TMath::Gamma(1.0/par[4]);
+    for (int jX=0; jX<nX; jX++)
+      peakX[jX] = par[0]*norm1*exp(-pow(fabs(grid.x[jX]/par[1]),par[3]));
+    for (int jY=0; jY<nY; jY++)
+      {
+      double yy = grid.y[jY];
+      peakY[jY] = norm2*(exp(-pow(fabs(yy/par[2]),par[4])) + exp(-pow(fabs((yy-TMath::TwoPi())/par[2]),par[4])));
+      }
+    for (int i=0; i<n; i++)
+      {
+      int jX = grid.iX[i];
+      int jY = grid.iY[i];
+      values[i] = peakX[jX]*peakY[jY] + base[jY] + c2X[jX]*cos2[jY] + c3X[jX]*cos3[jY];
+      }
+    }
+  else
+    {
+    for (int i=0; i<n; i++)
+      {
+      int jX = grid.iX[i];
+      int jY = grid.iY[i];
+      values[i] = base[jY] + c2X[jX]*cos2[jY] + c3X[jX]*cos3[jY];
+      }
+    }
+}
+
+int BidimGaussFitService::fit(int iFit, int iStart, vector<double> & parameters, vector<double> & errors, double & chi2) const
+{
+  const BidimFitJob  & job  = jobs[iFit];
+  const BidimFitGrid & grid = grids[iFit];
+  int nPar = getNParameters(job.model,job.nParameters);
+
+  // starting values: as given for the first start, randomized for the others
+  vector<double> startValues(job.start);
+  startValues.resize(nPar,0.0);
+  if (iStart>0)
+    {
+    TRandom3 random(seed + long(iFit)*long(nStarts) + iStart);
+    for (int iPar=0; iPar<nPar; iPar++)
+      {
+      if (iPar<int(job.fixed.size()) && job.fixed[iPar]) continue;
+      bool bounded = iPar<int(job.lower.size()) && iPar<int(job.upper.size()) && job.lower[iPar]<job.upper[iPar];
+      if (bounded)
+        startValues[iPar] = random.Uniform(job.lower[iPar],job.upper[iPar]);
+      else
+        startValues[iPar] += startSpread*(startValues[iPar]!=0.0 ? fabs(startValues[iPar]) : 1.0)*random.Gaus(0.0,1.0);
+      }
+    }
+
+  vector<double> values;
+  vector<double> scratch;
+  ROOT::Math::Functor chi2Function([&](const double * par)
+                                   {
+                                   evaluate(grid,job,par,values,scratch);
+                                   double sum = 0.0;
+                                   int n = grid.size();
+                                   for (int i=0; i<n; i++)
+                                     {
+                                     double d = grid.content[i]-values[i];
+                                     sum += grid.weight[i]*d*d;
+                                     }
+                                   return sum;
+                                   },nPar);
+  ROOT::Math::Minimizer * minimizer = ROOT::Math::Factory::CreateMinimizer(minimizerType.Data(),minimizerAlgorithm.Data());
+  if (!minimizer) return -1;
+  minimizer->SetFunction(chi2Function);
+  minimizer->SetStrategy(strategy);
+  minimizer->SetTolerance(tolerance);
+  minimizer->SetMaxFunctionCalls(maxFunctionCalls);
+  minimizer->SetPrintLevel(0);
+  for (int iPar=0; iPar<nPar; iPar++)
+    {
+    String name = "p"; name += iPar;
+    double value = startValues[iPar];
+    bool bounded = iPar<int(job.lower.size()) && iPar<int(job.upper.size()) && job.lower[iPar]<job.upper[iPar];
+    double step  = bounded ? 0.01*(job.upper[iPar]-job.lower[iPar]) : (value!=0.0 ? 0.1*fabs(value) : 0.01);
+    if (iPar<int(job.fixed.size()) && job.fixed[iPar])
+      minimizer->SetFixedVariable(iPar,name.Data(),value);
+    else if (bounded)
+      minimizer->SetLimitedVariable(iPar,name.Data(),value,step,job.lower[iPar],job.upper[iPar]);
+    else
+      minimizer->SetVariable(iPar,name.Data(),value,step);
+    }
+  minimizer->Minimize();
+  int status = minimizer->Status();
+  chi2 = minimizer->MinValue();
+  parameters.assign(minimizer->X(),minimizer->X()+nPar);
+  errors.assign(minimizer->Errors(),minimizer->Errors()+nPar);
+  delete minimizer;
+  return status;
+}
+
+void BidimGaussFitService::run()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  int nFits = jobs.size();
+  if (nFits<1) return;
+  if (nStarts<1) nStarts = 1;
+
+  // grids are built serially: histogram access is not thread safe
+  grids.resize(nFits);
+  for (int iFit=0; iFit<nFits; iFit++)
+    {
+    const BidimFitJob & job = jobs[iFit];
+    grids[iFit].fill(job.histogram,
+                     job.xLow,job.xHigh,job.yLow,job.yHigh,
+                     job.xExcludedLow,job.xExcludedHigh,job.yExcludedLow,job.yExcludedHigh);
+    }
+
+  int nTasks = nFits*nStarts;
+  vector<int>            taskStatus(nTasks,-1);
+  vector<double>         taskChi2(nTasks,0.0);
+  vector<vector<double>> taskParameters(nTasks);
+  vector<vector<double>> taskErrors(nTasks);
+  atomic<int> nextTask(0);
+  auto worker = [&]()
+    {
+    int iTask;
+    while ((iTask = nextTask++) < nTasks)
+      {
+      taskStatus[iTask] = fit(iTask/nStarts,iTask%nStarts,taskParameters[iTask],taskErrors[iTask],taskChi2[iTask]);
+      }
+    };
+
+  int nWorkers = nThreads>0 ? nThreads : int(thread::hardware_concurrency());
+  if (nWorkers<1) nWorkers = 1;
+  if (nWorkers>nTasks) nWorkers = nTasks;
+  if (nWorkers>1)
+    {
+    static once_flag threadSafetyEnabled;
+    call_once(threadSafetyEnabled, [](){ ROOT::EnableThreadSafety(); });
+    // load the minimizer plugin once, before the workers start
+    delete ROOT::Math::Factory::CreateMinimizer(minimizerType.Data(),minimizerAlgorithm.Data());
+    vector<thread> workers;
+    for (int iWorker=0; iWorker<nWorkers; iWorker++) workers.push_back(thread(worker));
+    for (int iWorker=0; iWorker<nWorkers; iWorker++) workers[iWorker].join();
+    }
+  else
+    {
+    worker();
+    }
+
+  // keep the converged start with the lowest chi2 (the lowest chi2 if none converged)
+  for (int iFit=0; iFit<nFits; iFit++)
+    {
+    BidimFitJob & job = jobs[iFit];
+    int best = -1;
+    job.nConverged = 0;
+    for (int iStart=0; iStart<nStarts; iStart++)
+      {
+      int iTask = iFit*nStarts+iStart;
+      if (taskParameters[iTask].empty()) continue;
+      bool converged = taskStatus[iTask]==0;
+      if (converged) job.nConverged++;
+      if (best<0) { best = iTask; continue; }
+      bool bestConverged = taskStatus[best]==0;
+      if ((converged && !bestConverged) || (converged==bestConverged && taskChi2[iTask]<taskChi2[best])) best = iTask;
+      }
+    if (best<0)
+      {
+      if (reportError(__FUNCTION__)) cout << "Fit " << iFit << ": minimizer " << minimizerType << " not available." << endl;
+      continue;
+      }
+    int nFree = 0;
+    int nPar  = taskParameters[best].size();
+    for (int iPar=0; iPar<nPar; iPar++) if (!(iPar<int(job.fixed.size()) && job.fixed[iPar])) nFree++;
+    job.parameters = taskParameters[best];
+    job.errors     = taskErrors[best];
+    job.chi2       = taskChi2[best];
+    job.ndf        = grids[iFit].size() - nFree;
+    job.status     = taskStatus[best];
+    job.bestStart  = best - iFit*nStarts;
+    if (job.status!=0 && reportWarning(__FUNCTION__))
+      cout << "Fit " << iFit << ": none of the " << nStarts << " starts converged. Keeping the lowest chi2: " << job.chi2 << endl;
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
@@ -0,0 +1,181 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__BidimGaussFitService
+#define CAP__BidimGaussFitService
+#include <vector>
+#include "TH2.h"
+#include "TF2.h"
+#include "MessageLogger.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Fitted bins of a 2D (Deta,Dphi) histogram stored as arrays: the distinct bin centers along x and y, and, for each fitted
+//! bin, its x and y indices, content, and chi2 weight 1/error^2. The cos(k y), k=1..6, of the y bin centers are tabulated
+//! once so the flow models are evaluated without trigonometric calls.
+//!
+class BidimFitGrid
+{
+public:
+
+  BidimFitGrid();
+  virtual ~BidimFitGrid() {}
+
+  //!
+  //! Load the bins of h with centers within [xLow,xHigh]x[yLow,yHigh], excluding those within
+  //! [xExcludedLow,xExcludedHigh]x[yExcludedLow,yExcludedHigh] (no exclusion if xExcludedLow>=xExcludedHigh), and bins with a null error.
+  //!
+  void fill(const TH2 * h,
+            double xLow, double xHigh,
+            double yLow, double yHigh,
+            double xExcludedLow, double xExcludedHigh,
+            double yExcludedLow, double yExcludedHigh);
+
+  inline int size() const { return content.size(); }
+
+  static const int nCos = 6;
+
+  vector<double> x;         //!< distinct bin centers along x
+  vector<double> y;         //!< distinct bin centers along y
+  vector<double> cosY;      //!< cos(k y) of the y bin centers: [(k-1)*nY+iY]
+  vector<int>    iX;        //!< x index of each fitted bin
+  vector<int>    iY;        //!< y index of each fitted bin
+  vector<double> content;   //!< content of each fitted bin
+  vector<double> weight;    //!< 1/error^2 of each fitted bin
+
+  ClassDef(BidimFitGrid,0)
+};
+
+//!
+//! Specification and result of one histogram fit.
+//!
+class BidimFitJob
+{
+public:
+
+  BidimFitJob();
+  virtual ~BidimFitJob() {}
+
+  //!
+  //! Set the parameters of the given function to the best fit values.
+  //!
+  void setParameters(TF1 * f) const;
+
+  // specification
+  const TH2 *    histogram;
+  int            model;          //!< one of BidimGaussFitService::Model
+  double (*function)(double *, double *); //!< evaluated bin by bin for the UserFunction model
+  int            nParameters;    //!< number of parameters of the UserFunction model
+  double         xLow, xHigh, yLow, yHigh;
+  double         xExcludedLow, xExcludedHigh, yExcludedLow, yExcludedHigh;
+  vector<double> start;          //!< starting values
+  vector<double> lower;          //!< lower limits; the parameter is unbounded if lower>=upper
+  vector<double> upper;          //!< upper limits
+  vector<bool>   fixed;          //!< fixed parameters
+
+  // result
+  vector<double> parameters;
+  vector<double> errors;
+  double         chi2;
+  int            ndf;
+  int            status;         //!< minimizer status of the best start (0: converged), -1 if not fitted
+  int            bestStart;      //!< index of the start that gave the best fit
+  int            nConverged;     //!< number of starts that converged
+
+  ClassDef(BidimFitJob,0)
+};
+
+//!
+//! Service fitting many 2D histograms concurrently. Each fit is started from the given starting values and from nStarts-1
+//! randomized ones (uniform within the limits of bounded parameters, or Gaussian around the starting value of unbounded
+//! ones); the best converged fit, i.e., the one with the lowest chi2, is kept. The fits and their starts are independent
+//! tasks run by nThreads worker threads, each with its own minimizer (Minuit2 by default). The random starting values
+//! depend only on the seed, the fit index and the start index, so the results do not depend on the number of threads.
+//!
+//! The chi2 is computed from a BidimFitGrid: the Flow and FlowPlusPeak models (same parameterization as Flow2DFunction and
+//! FlowPlusGen2DGaussianFunction of BidimGaussFitter) are evaluated over the distinct x and y bin centers and combined bin by
+//! bin, rather than through the per-point callback of TF2; other models may be given as a UserFunction evaluated bin by bin.
+//!
+class BidimGaussFitService : public MessageLogger
+{
+public:
+
+  enum Model { Flow=0, FlowPlusPeak, UserFunction };
+
+  //!
+  //! CTOR
+  //!
+  //! @param _nThreads number of worker threads (the hardware concurrency if <= 0)
+  //! @param _nStarts number of starting points per fit
+  //! @param _seed seed of the randomized starting points
+  //!
+  BidimGaussFitService(int _nThreads=0, int _nStarts=1, long _seed=12345, Severity _reportLevel=Info);
+  virtual ~BidimGaussFitService() {}
+
+  //!
+  //! Add a fit and return its index.
+  //!
+  int addFit(const BidimFitJob & job);
+
+  //!
+  //! Run all the fits added since the last call to clear().
+  //!
+  void run();
+
+  //!
+  //! Remove all the fits.
+  //!
+  void clear();
+
+  inline int getNFits() const { return jobs.size(); }
+  inline const BidimFitJob & getFit(int iFit) const { return jobs[iFit]; }
+  inline BidimFitJob & getFit(int iFit) { return jobs[iFit]; }
+
+  //!
+  //! Number of parameters of the given model.
+  //!
+  static int getNParameters(int model, int nUserParameters=0);
+
+  //!
+  //! Evaluate the given model, with the given parameters, at all the bins of the grid.
+  //!
+  static void evaluate(const BidimFitGrid & grid, const BidimFitJob & job, const double * par, vector<double> & values, vector<double> & scratch);
+
+  int    nThreads;
+  int    nStarts;
+  long   seed;
+  double startSpread;          //!< relative spread of the randomized starting values of unbounded parameters
+  String minimizerType;
+  String minimizerAlgorithm;
+  int    strategy;
+  double tolerance;
+  int    maxFunctionCalls;
+
+protected:
+
+  //!
+  //! Fit the given job from the given start; returns the minimizer status and sets the parameters, errors, and chi2.
+  //!
+  int fit(int iFit, int iStart, vector<double> & parameters, vector<double> & errors, double & chi2) const;
+
+  vector<BidimFitJob>  jobs;
+  vector<BidimFitGrid> grids;
+
+  ClassDef(BidimGaussFitService,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__BidimGaussFitService */
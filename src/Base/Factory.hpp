@@ -40,6 +40,8 @@ protected:
   /////////////////////////////////////////////////////////////
   long capacity;
   long index;
+  long peakSize;
+  long nExpansions;
   T ** objects;
 
   public:
@@ -51,6 +53,8 @@ protected:
   TObject(),
   capacity(0),
   index(0),
+  peakSize(0),
+  nExpansions(0),
   objects(0)
   {
    // no ops
@@ -74,6 +78,7 @@ protected:
 
   void reset()
   {
+  if (index>peakSize) peakSize = index;
   index = 0;
   }
 
@@ -90,6 +95,20 @@ protected:
     return index;
   }
 
+  // Returns the largest number of objects
+  // used between two resets.
+  long getPeakSize() const
+  {
+    return index>peakSize ? index : peakSize;
+  }
+
+  // Returns the number of times the capacity
+  // was increased.
+  long getNExpansions() const
+  {
+    return nExpansions;
+  }
+
   long getLastIndex() const
   {
   return index-1;
@@ -116,6 +135,7 @@ protected:
     for (long k=capacity; k<newCapacity; k++) objects[k] = new T();
     delete[] keep;
     capacity = newCapacity;
+    nExpansions++;
     cout << "<W> Factory::getObject() Object capacity increased to : " << capacity << endl;
     return objects[index++];
     }
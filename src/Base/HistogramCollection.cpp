@@ -9,21 +9,36 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <atomic>
+#include <thread>
 #include "HistogramCollection.hpp"
+#include "TArrayD.h"
+#include "TArrayF.h"
 #include "TKey.h"
 
 using CAP::HistogramCollection;
+using CAP::HistogramCounter;
+using CAP::SparseHistogram3D;
 using CAP::String;
 
 ClassImp(CAP::Collection<TH1>);
 
 ClassImp(HistogramCollection);
 
+int HistogramCollection::kernelThreads = 0;
+
 HistogramCollection::HistogramCollection(const String & _name,
                                          Severity  _debugLevel)
 :
 Collection(_name, true, _debugLevel),
-randomGenerator(new TRandom())
+randomGenerator(new TRandom()),
+counters(),
+sparseHistograms(),
+kernelContents1(),
+kernelContents2(),
+kernelErrors2(),
+kernelSum(),
+kernelSumErr2()
 {
 
   setClassName("HistogramCollection");
@@ -33,8 +48,18 @@ randomGenerator(new TRandom())
 HistogramCollection::HistogramCollection(const HistogramCollection & source)
 :
 Collection<TH1>(source),
-randomGenerator(source.randomGenerator)
-{
+randomGenerator(source.randomGenerator),
+counters(),
+sparseHistograms(),
+kernelContents1(),
+kernelContents2(),
+kernelErrors2(),
+kernelSum(),
+kernelSumErr2()
+{
+  source.flushCounters();
+  for (unsigned int iSparse=0; iSparse<source.sparseHistograms.size(); iSparse++)
+    sparseHistograms.push_back(new SparseHistogram3D(*source.sparseHistograms[iSparse]));
   for (unsigned int iObject=0; iObject<source.size(); iObject++)
     {
     TH1* h0 = (TH1*) source.objects[iObject];
@@ -57,7 +82,12 @@ HistogramCollection & HistogramCollection::operator=(const HistogramCollection &
     ;
   if (this!=&source)
     {
+    source.flushCounters();
     Collection<TH1>::operator=(source);
+    for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++) delete sparseHistograms[iSparse];
+    sparseHistograms.clear();
+    for (unsigned int iSparse=0; iSparse<source.sparseHistograms.size(); iSparse++)
+      sparseHistograms.push_back(new SparseHistogram3D(*source.sparseHistograms[iSparse]));
     for (unsigned int iObject=0; iObject<source.size(); iObject++)
       {
       TH1* h0 = source.objects[iObject];
@@ -69,7 +99,42 @@ HistogramCollection & HistogramCollection::operator=(const HistogramCollection &
 }
 
 HistogramCollection::~HistogramCollection()
-{   }
+{
+  for (unsigned int iCounter=0; iCounter<counters.size(); iCounter++) delete counters[iCounter];
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++) delete sparseHistograms[iSparse];
+}
+
+HistogramCounter * HistogramCollection::createCounter(TH1 * h)
+{
+  HistogramCounter * counter = new HistogramCounter(h);
+  counters.push_back(counter);
+  return counter;
+}
+
+void HistogramCollection::flushCounters() const
+{
+  for (unsigned int iCounter=0; iCounter<counters.size(); iCounter++) counters[iCounter]->flush();
+}
+
+SparseHistogram3D * HistogramCollection::createSparseHistogram(const String & name,
+                                                               int n_x, double min_x, double max_x,
+                                                               int n_y, double min_y, double max_y,
+                                                               int n_z, double min_z, double max_z,
+                                                               const String & title_x,
+                                                               const String & title_y,
+                                                               const String & title_z,
+                                                               const String & title_w)
+{
+  if (reportDebug(__FUNCTION__))
+    cout << "Creating  sparse 3D histo " << name
+    << " n_x:" << n_x << " min_x:" << min_x << " max_x:" << max_x << " X:" << title_x
+    << " n_y:" << n_y << " min_y:" << min_y << " max_y:" << max_y << " Y:" << title_y
+    << " n_z:" << n_z << " min_z:" << min_z << " max_z:" << max_z << " Z:" << title_z
+    << " W:" << title_w  << endl;
+  SparseHistogram3D * h = new SparseHistogram3D(name,n_x,min_x,max_x,n_y,min_y,max_y,n_z,min_z,max_z,title_x,title_y,title_z,title_w);
+  sparseHistograms.push_back(h);
+  return h;
+}
 
 
 
@@ -82,6 +147,8 @@ void HistogramCollection::reset()
   if (reportStart(__FUNCTION__))
     ;
   for (unsigned int iObject=0; iObject<size(); iObject++) objects[iObject]->Reset();
+  for (unsigned int iCounter=0; iCounter<counters.size(); iCounter++) counters[iCounter]->reset();
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++) sparseHistograms[iSparse]->reset();
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -282,12 +349,41 @@ void HistogramCollection::exportHistograms(TFile & outputFile)
     ;
   if (reportDebug(__FUNCTION__)) cout << "    Saving histograms to file: " << outputFile.GetName()  << endl;
   if (reportDebug(__FUNCTION__)) cout << " Number of histograms to save: " <<  size() << endl;
+  flushCounters();
   outputFile.cd();
   for (unsigned int iObject=0; iObject<size(); iObject++)
     {
     if (reportDebug(__FUNCTION__)) cout << " Saving iObject: " << iObject << " named: " <<  objects[iObject]->GetName() << endl;
     objects[iObject]->Write();
     }
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++)
+    {
+    if (reportDebug(__FUNCTION__)) cout << " Saving sparse: " << iSparse << " named: " <<  sparseHistograms[iSparse]->getName() << endl;
+    TH3 * h = sparseHistograms[iSparse]->createHistogram();
+    h->Write();
+    delete h;
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void HistogramCollection::snapshotHistograms(vector<TObject*> & snapshot)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  flushCounters();
+  for (unsigned int iObject=0; iObject<size(); iObject++)
+    {
+    TH1 * h = (TH1*) objects[iObject]->Clone();
+    h->SetDirectory(nullptr);
+    snapshot.push_back(h);
+    }
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++)
+    {
+    TH3 * h = sparseHistograms[iSparse]->createHistogram();
+    h->SetDirectory(nullptr);
+    snapshot.push_back(h);
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -313,6 +409,46 @@ void HistogramCollection::exportHistograms(ofstream & outputFile __attribute__((
     ;
 }
 
+//!
+// Restore the contents of the histograms of this collection from file
+//!
+int HistogramCollection::restoreHistograms(TFile & inputFile)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  int nMissing = 0;
+  reset();
+  for (unsigned int iObject=0; iObject<size(); iObject++)
+    {
+    TH1 * h = (TH1 *) inputFile.Get(objects[iObject]->GetName());
+    if (!h)
+      {
+      if (reportWarning(__FUNCTION__)) cout << "Histogram not found in file: " << objects[iObject]->GetName() << endl;
+      nMissing++;
+      continue;
+      }
+    objects[iObject]->Add(h);
+    objects[iObject]->SetEntries(h->GetEntries());
+    delete h;
+    }
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++)
+    {
+    SparseHistogram3D & sparse = *sparseHistograms[iSparse];
+    TH3 * h = (TH3 *) inputFile.Get(sparse.getName());
+    if (!h)
+      {
+      if (reportWarning(__FUNCTION__)) cout << "Histogram not found in file: " << sparse.getName() << endl;
+      nMissing++;
+      continue;
+      }
+    copyToSparse(h,sparse);
+    delete h;
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+  return nMissing;
+}
+
 
 //!
 //! Scale selected histograms by the given factor
@@ -324,12 +460,14 @@ void HistogramCollection::scale(double factor)
 {
   if (reportStart(__FUNCTION__))
     { }
+  flushCounters();
   for (unsigned int iObject=0; iObject<size(); iObject++)
     {
     TH1 * h = objects[iObject];
     if ( (h->IsA()==TProfile::Class()) ||  (h->IsA()==TProfile2D::Class()) ) continue;
     h->Scale(factor);
     }
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++) sparseHistograms[iSparse]->scale(factor);
   if (reportEnd(__FUNCTION__))
     { }
 }
@@ -361,6 +499,7 @@ HistogramCollection * HistogramCollection::clone() const
 {
   if (reportStart(__FUNCTION__))
     ;
+  flushCounters();
   HistogramCollection * newCollection = new HistogramCollection(getInstanceName(), getSeverityLevel());
   for (unsigned int iObject=0; iObject<size(); iObject++)
     {
@@ -369,6 +508,8 @@ HistogramCollection * HistogramCollection::clone() const
     TH1* h1 = (TH1*) h0->Clone();
     newCollection->append(h1);
     }
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++)
+    newCollection->sparseHistograms.push_back(new SparseHistogram3D(*sparseHistograms[iSparse]));
   return newCollection;
 }
 
@@ -381,14 +522,16 @@ void HistogramCollection::add(const HistogramCollection & c1, double a1)
 
   if (reportStart(__FUNCTION__))
     ;
-  if (!sameSizeAs(c1))
+  flushCounters();
+  c1.flushCounters();
+  if (!sameSizeAs(c1) || !sameSparseSizeAs(c1))
     {
     if (reportError(__FUNCTION__) )
       {
       cout << endl;
       cout << "Invalid operation on collections -- incompatible sizes:"  << endl;
-      cout << "       this: " << getName()    << " contains " << size() << " histograms" << endl;
-      cout << "         c1: " << c1.getName() << " contains " << c1.size() << " histograms" << endl;
+      cout << "       this: " << getName()    << " contains " << size() << " histograms and " << sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "         c1: " << c1.getName() << " contains " << c1.size() << " histograms and " << c1.sparseHistograms.size() << " sparse histograms" << endl;
       }
     return;
     }
@@ -423,6 +566,8 @@ void HistogramCollection::add(const HistogramCollection & c1, double a1)
       }
     h0->Add(h1,a1);
     }
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++)
+    sparseHistograms[iSparse]->add(*c1.sparseHistograms[iSparse],a1);
 }
 
 //! ==========================
@@ -433,15 +578,19 @@ void HistogramCollection::add(const HistogramCollection & c1, const HistogramCol
 
   if (reportStart(__FUNCTION__))
     ;
-  if (!sameSizeAs(c1) || !sameSizeAs(c2))
+  flushCounters();
+  c1.flushCounters();
+  c2.flushCounters();
+  if (!sameSizeAs(c1) || !sameSizeAs(c2) ||
+      !sameSparseSizeAs(c1) || !sameSparseSizeAs(c2))
     {
     if (reportError(__FUNCTION__) )
       {
       cout << endl;
       cout << "Invalid operation on collections -- incompatible sizes:"  << endl;
-      cout << "this: " << getName()    << " contains " << size() << " histograms" << endl;
-      cout << "  c1: " << c1.getName() << " contains " << c1.size() << " histograms" << endl;
-      cout << "  c2: " << c2.getName() << " contains " << c2.size() << " histograms" << endl;
+      cout << "this: " << getName()    << " contains " << size() << " histograms and " << sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c1: " << c1.getName() << " contains " << c1.size() << " histograms and " << c1.sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c2: " << c2.getName() << " contains " << c2.size() << " histograms and " << c2.sparseHistograms.size() << " sparse histograms" << endl;
       }
     return;
     }
@@ -476,6 +625,7 @@ void HistogramCollection::add(const HistogramCollection & c1, const HistogramCol
       }
     h0->Add(h1,h2,a1,a2);
     }
+  setSparseSum({ &c1, &c2 }, { a1, a2 });
 }
 
 //! ==========================
@@ -489,16 +639,21 @@ void HistogramCollection::add(const HistogramCollection & c1,
 
   if (reportStart(__FUNCTION__))
     ;
-  if (!sameSizeAs(c1) || !sameSizeAs(c2) || !sameSizeAs(c3))
+  flushCounters();
+  c1.flushCounters();
+  c2.flushCounters();
+  c3.flushCounters();
+  if (!sameSizeAs(c1) || !sameSizeAs(c2) || !sameSizeAs(c3) ||
+      !sameSparseSizeAs(c1) || !sameSparseSizeAs(c2) || !sameSparseSizeAs(c3))
     {
     if (reportError(__FUNCTION__) )
       {
       cout << endl;
       cout << "Invalid operation on collections -- incompatible sizes:"  << endl;
-      cout << "this: " << getName()    << " contains " << size() << " histograms" << endl;
-      cout << "  c1: " << c1.getName() << " contains " << c1.size() << " histograms" << endl;
-      cout << "  c2: " << c2.getName() << " contains " << c2.size() << " histograms" << endl;
-      cout << "  c3: " << c3.getName() << " contains " << c3.size() << " histograms" << endl;
+      cout << "this: " << getName()    << " contains " << size() << " histograms and " << sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c1: " << c1.getName() << " contains " << c1.size() << " histograms and " << c1.sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c2: " << c2.getName() << " contains " << c2.size() << " histograms and " << c2.sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c3: " << c3.getName() << " contains " << c3.size() << " histograms and " << c3.sparseHistograms.size() << " sparse histograms" << endl;
       }
     return;
     }
@@ -542,6 +697,7 @@ void HistogramCollection::add(const HistogramCollection & c1,
     h0->Add(h1,h2,a1,a2);
     h0->Add(h3,a3);
     }
+  setSparseSum({ &c1, &c2, &c3 }, { a1, a2, a3 });
 }
 
 //! ==========================
@@ -556,17 +712,23 @@ void HistogramCollection::add(const HistogramCollection & c1,
 
   if (reportStart(__FUNCTION__))
     ;
-  if (!sameSizeAs(c1) || !sameSizeAs(c2) || !sameSizeAs(c3) || !sameSizeAs(c4))
+  flushCounters();
+  c1.flushCounters();
+  c2.flushCounters();
+  c3.flushCounters();
+  c4.flushCounters();
+  if (!sameSizeAs(c1) || !sameSizeAs(c2) || !sameSizeAs(c3) || !sameSizeAs(c4) ||
+      !sameSparseSizeAs(c1) || !sameSparseSizeAs(c2) || !sameSparseSizeAs(c3) || !sameSparseSizeAs(c4))
     {
     if (reportError(__FUNCTION__) )
       {
       cout << endl;
       cout << "Invalid operation on collections -- incompatible sizes:"  << endl;
-      cout << "this: " << getName()    << " contains " << size() << " histograms" << endl;
-      cout << "  c1: " << c1.getName() << " contains " << c1.size() << " histograms" << endl;
-      cout << "  c2: " << c2.getName() << " contains " << c2.size() << " histograms" << endl;
-      cout << "  c3: " << c3.getName() << " contains " << c3.size() << " histograms" << endl;
-      cout << "  c4: " << c4.getName() << " contains " << c4.size() << " histograms" << endl;
+      cout << "this: " << getName()    << " contains " << size() << " histograms and " << sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c1: " << c1.getName() << " contains " << c1.size() << " histograms and " << c1.sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c2: " << c2.getName() << " contains " << c2.size() << " histograms and " << c2.sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c3: " << c3.getName() << " contains " << c3.size() << " histograms and " << c3.sparseHistograms.size() << " sparse histograms" << endl;
+      cout << "  c4: " << c4.getName() << " contains " << c4.size() << " histograms and " << c4.sparseHistograms.size() << " sparse histograms" << endl;
       }
     return;
     }
@@ -613,6 +775,20 @@ void HistogramCollection::add(const HistogramCollection & c1,
     h0->Add(h3,a3);
     h0->Add(h4,a4);
     }
+  setSparseSum({ &c1, &c2, &c3, &c4 }, { a1, a2, a3, a4 });
+}
+
+void HistogramCollection::setSparseSum(const vector<const HistogramCollection*> & terms, const vector<double> & factors)
+{
+  // the sum is accumulated in a copy so any of the terms may be this collection
+  for (unsigned int iSparse=0; iSparse<sparseHistograms.size(); iSparse++)
+    {
+    SparseHistogram3D sum(*sparseHistograms[iSparse]);
+    sum.reset();
+    for (unsigned int iTerm=0; iTerm<terms.size(); iTerm++)
+      sum.add(*terms[iTerm]->sparseHistograms[iSparse],factors[iTerm]);
+    *sparseHistograms[iSparse] = sum;
+    }
 }
 
 //! ==========================
@@ -623,6 +799,8 @@ void HistogramCollection::divide(const HistogramCollection & c1)
 
   if (reportStart(__FUNCTION__))
     ;
+  flushCounters();
+  c1.flushCounters();
   if (!sameSizeAs(c1))
     {
     if (reportError(__FUNCTION__) )
@@ -678,6 +856,9 @@ void HistogramCollection::divide(const HistogramCollection & c1,
 
   if (reportStart(__FUNCTION__))
     ;
+  flushCounters();
+  c1.flushCounters();
+  c2.flushCounters();
   if (!sameSizeAs(c1) || !sameSizeAs(c2))
     {
     if (reportError(__FUNCTION__))
@@ -2470,6 +2651,17 @@ void HistogramCollection::calculateN1N1H2H2_Q3D(const TH2 * n1_1, const TH2 * n1
 
 }
 
+// Fill helpers used to share the Q3D loops between dense and sparse targets
+static inline void fillQ3D(TH3 & h, double Qlong, double Qside, double Qout, double w)
+{
+  h.Fill(Qlong, Qside, Qout, w);
+}
+
+static inline void fillQ3D(SparseHistogram3D & h, double Qlong, double Qside, double Qout, double w)
+{
+  h.fill(Qlong, Qside, Qout, w);
+}
+
 void HistogramCollection::calculateN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1_2, TH3 * n1n1_Q3D, double a1, double a2)
 {
 
@@ -2477,9 +2669,25 @@ void HistogramCollection::calculateN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1
     ;
   if (!ptrExist(__FUNCTION__,n1_1,n1_2,n1n1_Q3D)) return;
   if (!sameDimensions(__FUNCTION__,n1_1,n1_2)) return;
+  fillN1N1H3H3_Q3D(n1_1, n1_2, *n1n1_Q3D, a1, a2);
+}
+
+void HistogramCollection::calculateN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1_2, SparseHistogram3D * n1n1_Q3D, double a1, double a2)
+{
+
+  if (reportStart(__FUNCTION__))
+    ;
+  if (!ptrExist(__FUNCTION__,n1_1,n1_2) || !n1n1_Q3D) return;
+  if (!sameDimensions(__FUNCTION__,n1_1,n1_2)) return;
+  fillN1N1H3H3_Q3D(n1_1, n1_2, *n1n1_Q3D, a1, a2);
+}
+
+template <class H>
+void HistogramCollection::fillN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1_2, H & n1n1_Q3D, double a1, double a2)
+{
   int nx = n1_1->GetNbinsX();
   int ny = n1_1->GetNbinsY();
-  int nz = n1_1->GetNbinsX();
+  int nz = n1_1->GetNbinsZ();
 
   double v1;
   double v2;
@@ -2522,7 +2730,7 @@ void HistogramCollection::calculateN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1
                   {
                   //cout << " i1x:" << i1x << " i1y: " << i1y << " i1z: " << i1z << " i2x:" << i1x << " i2y: " << i2y << " i2z: " << i2z << " v1: " << v1 << " v2: " << v2 << endl;
                   //cout << " pt1:" << pt1 << " phi1: " << phi1 << " eta1: " << eta1 << " pt2:" << pt2 << " phi2: " << phi2 << " eta2: " << eta2 << " Qlong:" << Qlong << " Qout:" << Qout << " Qside:" << Qside << " v3:" << v3 << endl;
-                  n1n1_Q3D->Fill(Qlong, Qside, Qout, v3);
+                  fillQ3D(n1n1_Q3D, Qlong, Qside, Qout, v3);
                   }
                 // }
                 }
@@ -2542,7 +2750,7 @@ void HistogramCollection::calculateR2_Q3D(const TH3 * n2_Q3D, const TH3 * n1n1_Q
   if (!sameDimensions(__FUNCTION__,n2_Q3D,n1n1_Q3D)) return;
   int nx = n2_Q3D->GetNbinsX();
   int ny = n2_Q3D->GetNbinsY();
-  int nz = n2_Q3D->GetNbinsX();
+  int nz = n2_Q3D->GetNbinsZ();
   double v1,ev1,er1;
   double v2,ev2,er2;
   double v3,ev3;
@@ -2587,6 +2795,62 @@ void HistogramCollection::calculateR2_Q3D(const TH3 * n2_Q3D, const TH3 * n1n1_Q
     }
 }
 
+// Sparse version: only the cells occupied in n1n1 may yield a non-zero R2
+void HistogramCollection::calculateR2_Q3D(const SparseHistogram3D * n2_Q3D, const SparseHistogram3D * n1n1_Q3D, SparseHistogram3D * R2_Q3D, double a1, double a2)
+{
+
+  if (reportStart(__FUNCTION__))
+    ;
+  if (!n2_Q3D || !n1n1_Q3D || !R2_Q3D)
+    {
+    if (reportError(__FUNCTION__)) cout << "Null pointer argument(s)." << endl;
+    return;
+    }
+  if (!n2_Q3D->sameBinning(*n1n1_Q3D) || !n2_Q3D->sameBinning(*R2_Q3D))
+    {
+    if (reportError(__FUNCTION__)) cout << "Histograms have incompatible binnings." << endl;
+    return;
+    }
+  R2_Q3D->reset();
+  const int tileSize  = SparseHistogram3D::tileSize;
+  const int tileCells = SparseHistogram3D::tileCells;
+  int nx = n1n1_Q3D->getNBinsX();
+  int ny = n1n1_Q3D->getNBinsY();
+  int nz = n1n1_Q3D->getNBinsZ();
+  double v1,ev1,er1;
+  double v2,ev2,er2;
+  double v3,ev3;
+  for (unsigned int iTile=0; iTile<n1n1_Q3D->getNTiles(); iTile++)
+    {
+    int i10, i20, i30;
+    n1n1_Q3D->getTileOrigin(iTile,i10,i20,i30);
+    const double * tile = n1n1_Q3D->getTileData(iTile);
+    for (int i1=(i10>1?i10:1); i1<i10+tileSize && i1<=nx; ++i1)
+      {
+      for (int i2=(i20>1?i20:1); i2<i20+tileSize && i2<=ny; ++i2)
+        {
+        for (int i3=(i30>1?i30:1); i3<i30+tileSize && i3<=nz; ++i3)
+          {
+          int iCell = ((i1-i10)*tileSize + (i2-i20))*tileSize + (i3-i30);
+          v2  = a2*tile[iCell];
+          if (v2<=0) continue;
+          ev2 = a2*sqrt(tile[tileCells+iCell]);
+          v1  = a1*n2_Q3D->getBinContent(i1,i2,i3);
+          if (v1<=0) continue;
+          ev1 = a1*n2_Q3D->getBinError(i1,i2,i3);
+          er1 = ev1/v1;
+          er2 = ev2/v2;
+          if (er1>=0.5 || er2>=0.5) continue;
+          v3  = v1/v2 - 1;
+          ev3 = v3*sqrt(er1*er1 + er2*er2);
+          R2_Q3D->setBinContent(i1,i2,i3,v3);
+          R2_Q3D->setBinError(i1,i2,i3,ev3);
+          }
+        }
+      }
+    }
+}
+
 // Return the average bin content of the given 1D histogram
 double HistogramCollection::avgValue(TH1 * h)
 {
@@ -2707,6 +2971,41 @@ TH3 * HistogramCollection::loadH3(TFile & inputFile, const String & histoName) t
   return h;
 }
 
+SparseHistogram3D * HistogramCollection::loadSparseH3(TFile & inputFile, const String & histoName) throw (HistogramException)
+{
+  TH3* h = (TH3*) inputFile.Get(histoName);
+  if (!h) throw HistogramException(histoName,"Histogram not found/loaded","HistogramCollection::loadSparseH3");
+  const TAxis * xAxis = h->GetXaxis();
+  const TAxis * yAxis = h->GetYaxis();
+  const TAxis * zAxis = h->GetZaxis();
+  SparseHistogram3D * sparse = createSparseHistogram(histoName,
+                                                     xAxis->GetNbins(), xAxis->GetXmin(), xAxis->GetXmax(),
+                                                     yAxis->GetNbins(), yAxis->GetXmin(), yAxis->GetXmax(),
+                                                     zAxis->GetNbins(), zAxis->GetXmin(), zAxis->GetXmax(),
+                                                     xAxis->GetTitle(), yAxis->GetTitle(), zAxis->GetTitle(), h->GetTitle());
+  copyToSparse(h,*sparse);
+  delete h;
+  return sparse;
+}
+
+void HistogramCollection::copyToSparse(const TH3 * h, SparseHistogram3D & sparse)
+{
+  for (int ix=0; ix<=sparse.getNBinsX()+1; ix++)
+    {
+    for (int iy=0; iy<=sparse.getNBinsY()+1; iy++)
+      {
+      for (int iz=0; iz<=sparse.getNBinsZ()+1; iz++)
+        {
+        double v = h->GetBinContent(ix,iy,iz);
+        double e = h->GetBinError(ix,iy,iz);
+        if (v!=0.0) sparse.setBinContent(ix,iy,iz,v);
+        if (e!=0.0) sparse.setBinError(ix,iy,iz,e);
+        }
+      }
+    }
+  sparse.setEntries(h->GetEntries());
+}
+
 ///Load the given 3D histogram (name) from the given TFile
 ///No test is //done to verify that the file is properly opened.
 TProfile * HistogramCollection::loadProfile(TFile & inputFile, const String & histoName) throw (HistogramException)
@@ -3982,6 +4281,83 @@ void HistogramCollection::symmetrizeXX(TH2 * h, bool ijNormalization)
 //  delete [] denominator;
 //  }
 
+void HistogramCollection::setKernelThreads(int nThreads)
+{
+  kernelThreads = nThreads>0 ? nThreads : 0;
+}
+
+const double * HistogramCollection::getBinContents(const TH1 * h, vector<double> & buffer) const
+{
+  // profiles store sums rather than bin contents in their arrays
+  bool profile = dynamic_cast<const TProfile*>(h)!=nullptr || dynamic_cast<const TProfile2D*>(h)!=nullptr;
+  const TArrayD * arrayD = profile ? nullptr : dynamic_cast<const TArrayD*>(h);
+  if (arrayD) return arrayD->GetArray();
+  int nCells = h->GetNcells();
+  buffer.resize(nCells);
+  const TArrayF * arrayF = profile ? nullptr : dynamic_cast<const TArrayF*>(h);
+  if (arrayF)
+    {
+    const float * array = arrayF->GetArray();
+    for (int bin=0; bin<nCells; bin++) buffer[bin] = array[bin];
+    }
+  else
+    {
+    for (int bin=0; bin<nCells; bin++) buffer[bin] = h->GetBinContent(bin);
+    }
+  return buffer.data();
+}
+
+const double * HistogramCollection::getBinErrors2(const TH1 * h, const double * contents, vector<double> & buffer) const
+{
+  bool profile = dynamic_cast<const TProfile*>(h)!=nullptr || dynamic_cast<const TProfile2D*>(h)!=nullptr;
+  if (!profile && h->GetSumw2N()>0) return h->GetSumw2()->GetArray();
+  int nCells = h->GetNcells();
+  buffer.resize(nCells);
+  if (profile)
+    {
+    for (int bin=0; bin<nCells; bin++)
+      {
+      double e = h->GetBinError(bin);
+      buffer[bin] = e*e;
+      }
+    }
+  else
+    {
+    // no sum of weights squared: ROOT errors are sqrt(|content|)
+    for (int bin=0; bin<nCells; bin++) buffer[bin] = fabs(contents[bin]);
+    }
+  return buffer.data();
+}
+
+void HistogramCollection::runKernel(int nRows, long nCells, const function<void(int)> & kernel)
+{
+  int nThreads = kernelThreads>0 ? kernelThreads : int(thread::hardware_concurrency());
+  if (nThreads>nRows) nThreads = nRows;
+  if (nThreads<2 || nCells<kernelMinCells)
+    {
+    for (int row=0; row<nRows; row++) kernel(row);
+    return;
+    }
+  // rows are handed out one at a time since their costs differ (e.g., Deta rows near the edges are short)
+  atomic<int> nextRow(0);
+  vector<thread> threads;
+  for (int iThread=0; iThread<nThreads; iThread++)
+    {
+    threads.push_back(thread([&]()
+      {
+      int row;
+      while ((row=nextRow++)<nRows) kernel(row);
+      }));
+    }
+  for (unsigned int iThread=0; iThread<threads.size(); iThread++) threads[iThread].join();
+}
+
+//!
+//! Average the n2(eta_1,phi_1,eta_2,phi_2) matrix (x: eta_1*nPhiBins+phi_1, y: eta_2*nPhiBins+phi_2) onto n2(Deta,Dphi).
+//! Output row iDeta collects the (eta_1,eta_2) tiles with eta_1-eta_2 = iDeta-nEtaBins+1. Each tile is a nPhiBins x nPhiBins
+//! block of the source whose rows are contiguous in memory; a row with fixed phi_2 is added to the Dphi row in two contiguous
+//! segments (phi_1>=phi_2 and phi_1<phi_2).
+//!
 void HistogramCollection::reduce_n2xEtaPhi_n2DetaDphi(const TH2 * source, TH2 * target,int nEtaBins,int nPhiBins)
 {
 
@@ -3989,83 +4365,70 @@ void HistogramCollection::reduce_n2xEtaPhi_n2DetaDphi(const TH2 * source, TH2 *
     ;
   if (!ptrExist(__FUNCTION__,source,target)) return;
 
-  //if (reportDebug(__FUNCTION__)) cout << "reduce_n2xEtaPhi_n2DetaDphi() ==============  New Version From TH2" << endl;
-  double v1,v2,ev1;
-  int dPhi,dEta, iPhi,iEta,jPhi,jEta, i, j;
-  //int nBins = nEtaBins*nPhiBins;
-  int nWrk  = nPhiBins*(2*nEtaBins-1);
-  int index;
-  double * numerator    = new double[nWrk];
-  double * numeratorErr = new double[nWrk];
-  double * denominator  = new double[nWrk];
-  for (int k=0;k<nWrk;++k)
+  int nBins = nEtaBins*nPhiBins;
+  if (source->GetNbinsX()!=nBins || source->GetNbinsY()!=nBins)
     {
-    numerator[k]    = 0;
-    numeratorErr[k] = 0;
-    denominator[k]  = 0;
+    if (reportError(__FUNCTION__)) cout << endl << "Inconsistent indexes for histogram " << source->GetName() << endl;
+    return;
     }
 
-  String name = target->GetName();
+  int  nDeta  = 2*nEtaBins-1;
+  long stride = nBins+2;
+  const double * contents = getBinContents(source,kernelContents1);
+  const double * errors2  = getBinErrors2(source,contents,kernelErrors2);
+  kernelSum.assign(nDeta*nPhiBins,0.0);
+  kernelSumErr2.assign(nDeta*nPhiBins,0.0);
+  double * numerator    = kernelSum.data();
+  double * numeratorErr = kernelSumErr2.data();
 
-  i=1;
-  for (iEta=0;iEta<nEtaBins; ++iEta)
+  runKernel(nDeta, long(nBins)*long(nBins), [&](int iDeta)
     {
-    for (iPhi=0;iPhi<nPhiBins; ++iPhi)
+    double * num    = numerator    + iDeta*nPhiBins;
+    double * numErr = numeratorErr + iDeta*nPhiBins;
+    int iEtaMin = iDeta<nEtaBins ? 0 : iDeta-nEtaBins+1;
+    int iEtaMax = iDeta<nEtaBins ? iDeta : nEtaBins-1;
+    for (int iEta=iEtaMin; iEta<=iEtaMax; iEta++)
       {
-      j=1;
-      for (jEta=0;jEta<nEtaBins; ++jEta)
+      int jEta = iEta-iDeta+nEtaBins-1;
+      for (int jPhi=0; jPhi<nPhiBins; jPhi++)
         {
-        for (jPhi=0;jPhi<nPhiBins; ++jPhi)
+        long offset = stride*(jEta*nPhiBins+jPhi+1) + iEta*nPhiBins + 1;
+        const double * v  = contents + offset;
+        const double * ev = errors2  + offset;
+        int nUpper = nPhiBins-jPhi;
+        for (int k=0; k<nUpper; k++)
+          {
+          num[k]    += v[jPhi+k];
+          numErr[k] += ev[jPhi+k];
+          }
+        for (int k=0; k<jPhi; k++)
           {
-          dPhi = iPhi-jPhi; if (dPhi<0) dPhi += nPhiBins; dPhi+=1;
-          dEta = iEta-jEta + nEtaBins;
-          v1   = source->GetBinContent(i, j);
-          ev1  = source->GetBinError(  i, j);
-          index = (dEta-1)*nPhiBins + dPhi-1;
-          numerator[index]    += v1;
-          numeratorErr[index] += ev1*ev1;
-          denominator[index]  += 1.;
-          //cout << " " << name << "  iEta:" << iEta << " iPhi:" << iPhi << " jEta:" << jEta << " jPhi:" << jPhi << " v1:" << v1 << " ev1:" << ev1 << endl;
-          ++j;
+          num[nUpper+k]    += v[k];
+          numErr[nUpper+k] += ev[k];
           }
         }
-      ++i;
       }
-    }
-  for (dEta=0;dEta<2*nEtaBins-1;++dEta)
+    });
+
+  for (int iDeta=0; iDeta<nDeta; iDeta++)
     {
-    for (dPhi=0;dPhi<nPhiBins;++dPhi)
+    int    nTiles = iDeta<nEtaBins ? iDeta+1 : 2*nEtaBins-1-iDeta;
+    double den    = double(nTiles*nPhiBins);
+    for (int iDphi=0; iDphi<nPhiBins; iDphi++)
       {
-      //v1   = target->GetBinContent(dEta+1,dPhi+1);
-      //ev1  = target->GetBinError(dEta+1,dPhi+1);
-      index = dEta*nPhiBins + dPhi;
-      v1    = numerator[index];
-      ev1   = numeratorErr[index];
-      v2    = denominator[index];
-      if (v2<=0) if (reportDebug(__FUNCTION__)) cout << endl << "HistogramCollection::reduce_n2xEtaPhi_n2DetaDphi() Elements of denominator are negative." << endl;
-      target->SetBinContent(dEta+1,dPhi+1,v1/v2);
-      target->SetBinError(  dEta+1,dPhi+1,sqrt(ev1)/v2);
+      int index = iDeta*nPhiBins + iDphi;
+      target->SetBinContent(iDeta+1,iDphi+1,numerator[index]/den);
+      target->SetBinError(  iDeta+1,iDphi+1,sqrt(numeratorErr[index])/den);
       }
     }
-
-  // double a1m = target->GetBinContent(nEtaBins-1,1);
-  // double a1  = target->GetBinContent(nEtaBins,1);
-  // double a1p = target->GetBinContent(nEtaBins+1,1);
-  // if (reportDebug(__FUNCTION__)) cout << " a1m:" << a1m << endl;
-  // if (reportDebug(__FUNCTION__)) cout << " a1 :" << a1 << endl;
-  // if (reportDebug(__FUNCTION__)) cout << " a1p:" << a1p << endl;
-  // target->SetBinContent(nEtaBins,1,0.5*(a1m+a1p));
-
-
-  delete [] numerator;
-  delete [] numeratorErr;
-  delete [] denominator;
+  if (reportEnd(__FUNCTION__))
+    ;
 }
 
 //!
 //! Calculate the external product of n_1(eta,phi) by n_2(eta,phi) and project onto n1n1_12(Deta,Dphi)
-//! First create a 4D external product of h_1 and h_2 using a 1D vector
-//! than project it onto DeltaEta(x-axis) DeltaPhi (y-axis)
+//! Output row iDphi accumulates the products of the eta rows of h_1 and h_2 with phi_1-phi_2 = iDphi (modulo nPhi);
+//! each product of two eta rows is a 1D correlation onto the Deta axis. The 4D product is never stored.
 //! Errors are neglected and must be accounted for using a sub-sample analysis.
 //!
 void HistogramCollection::reduce_n1EtaPhiN1EtaPhiOntoN1N1DetaDphi(const TH2 * h_1, TH2 * h_2, TH2 * h_12, int nDeta,int nDphi)
@@ -4076,15 +4439,11 @@ void HistogramCollection::reduce_n1EtaPhiN1EtaPhiOntoN1N1DetaDphi(const TH2 * h_
   if (!ptrExist(__FUNCTION__,h_1,h_2,h_12)) return;
   if (!sameDimensions(__FUNCTION__,h_1,h_2)) return;
 
-  vector<double> numerator(nDeta*nDphi,0.0);
-  vector<double> denominator(nDeta*nDphi,0.0);
   int nEta = h_1->GetNbinsX();
   int nPhi = h_1->GetNbinsY();
   nDeta = h_12->GetNbinsX();
   nDphi = h_12->GetNbinsY();
 
-  int index;
-
   if (reportDebug(__FUNCTION__))
     {
     cout << endl;
@@ -4094,54 +4453,43 @@ void HistogramCollection::reduce_n1EtaPhiN1EtaPhiOntoN1N1DetaDphi(const TH2 * h_
     cout << "        nDphi:" << nDphi << endl;
     cout << "  nDeta*nDphi:" << nDeta*nDphi << endl;
     }
+  if (nDeta<2*nEta-1 || nDphi!=nPhi)
+    {
+    if (reportError(__FUNCTION__)) cout << endl << "Inconsistent indexes for histogram " << h_12->GetName() << endl;
+    return;
+    }
+
+  long stride = nEta+2;
+  const double * contents1 = getBinContents(h_1,kernelContents1);
+  const double * contents2 = getBinContents(h_2,kernelContents2);
+  kernelSum.assign(nDeta*nDphi,0.0);
+  double * numerator = kernelSum.data();
 
-  int iDeta, iDphi;
-  double v1, v2, v, r;
-  for (int iPhi1=1; iPhi1<=nPhi; iPhi1++)
+  runKernel(nDphi, long(nEta*nPhi)*long(nEta*nPhi), [&](int iDphi)
     {
-    for (int iEta1=1; iEta1<=nEta; iEta1++)
+    double * num = numerator + iDphi*nDeta + nEta - 1;
+    for (int iPhi1=0; iPhi1<nPhi; iPhi1++)
       {
-      v1 = h_1->GetBinContent(iEta1,iPhi1);
-      for (int iPhi2=1; iPhi2<=nPhi; iPhi2++)
+      int iPhi2 = iPhi1-iDphi; if (iPhi2<0) iPhi2 += nPhi;
+      const double * row1 = contents1 + stride*(iPhi1+1) + 1;
+      const double * row2 = contents2 + stride*(iPhi2+1) + 1;
+      for (int iEta1=0; iEta1<nEta; iEta1++)
         {
-        for (int iEta2=1; iEta2<=nEta; iEta2++)
-          {
-          v2 = h_2->GetBinContent(iEta2,iPhi2);
-          v  = v1 * v2;
-          iDphi = iPhi1-iPhi2; if (iDphi<0) iDphi += nDphi; //dPhi+=1;
-          iDeta = iEta1-iEta2 + nEta - 1;
-          // if (iDphi<0 || )
-          index = iDphi*nDeta + iDeta;
-          if (index<0)
-            {
-            cout << "index<0" << endl;
-            exit(1);
-            }
-          if (index>=nDeta*nDphi)
-            {
-            cout << "index>nDeta*nDphi" << endl;
-            exit(1);
-            }
-          numerator[index]    += v;
-          denominator[index]  += 1.0;
-          }
+        double   v1  = row1[iEta1];
+        double * out = num + iEta1;
+        for (int iEta2=0; iEta2<nEta; iEta2++) out[-iEta2] += v1*row2[iEta2];
         }
       }
-    }
+    });
+
   if (reportDebug(__FUNCTION__)) cout << "Compute ratio and fill target histogram." << endl;
   double zero = 0.0;
-  for (iDphi=0; iDphi<nDphi; iDphi++)
-    {
-    for (iDeta=0; iDeta<nDeta; iDeta++)
-      {
-      index = iDphi*nDeta + iDeta;
-      double num = numerator[index];
-      double den = denominator[index];
-      //cout << " iDphi: " << iDphi << " iDeta:" << iDeta << " index:" << index << " num:" << num << " denom:" << den << endl;
-      //if (den>0) r = num/den;
-      if (den>0) r = num;
-      else  r = zero;
-      h_12->SetBinContent(iDeta+1,iDphi+1,r);
+  for (int iDphi=0; iDphi<nDphi; iDphi++)
+    {
+    for (int iDeta=0; iDeta<nDeta; iDeta++)
+      {
+      // bins beyond 2*nEta-1 receive no entries and remain zero
+      h_12->SetBinContent(iDeta+1,iDphi+1,numerator[iDphi*nDeta + iDeta]);
       h_12->SetBinError(iDeta+1,iDphi+1,zero);
       }
     }
@@ -4157,60 +4505,70 @@ void HistogramCollection::reduce_n2xEtaPhi_n2EtaEta(const TH1 * source, TH2 * ta
     ;
   if (!ptrExist(__FUNCTION__,source,target)) return;
 
-  double v1,v2,ev1,ev2,v,ev;
-  int iPhi,iEta,jPhi,jEta, i, j;
-  int nBins = nEtaBins*nPhiBins;
+  int nBins   = nEtaBins*nPhiBins;
   int nEtaEta = nEtaBins*nEtaBins;
-  double * work = new double[nEtaEta];
-  for (int k=0;k<nEtaEta;++k) work[k]=0;
-  i=0;
-  for (iEta=0;iEta<nEtaBins; ++iEta)
+  if (source->GetNbinsX()!=nBins*nBins)
     {
-    for (iPhi=0;iPhi<nPhiBins; ++iPhi)
+    if (reportError(__FUNCTION__)) cout << endl << "Inconsistent indexes for histogram " << source->GetName() << endl;
+    return;
+    }
+
+  const double * contents = getBinContents(source,kernelContents1);
+  const double * errors2  = getBinErrors2(source,contents,kernelErrors2);
+  kernelSum.assign(nEtaEta,0.0);
+  kernelSumErr2.assign(nEtaEta,0.0);
+  kernelContents2.assign(nEtaEta,0.0);
+  double * sum     = kernelSum.data();
+  double * sumErr2 = kernelSumErr2.data();
+  double * work    = kernelContents2.data();
+
+  runKernel(nEtaBins, long(nBins)*long(nBins), [&](int iEta)
+    {
+    for (int iPhi=0; iPhi<nPhiBins; iPhi++)
       {
-      j=0;
-      for (jEta=0;jEta<nEtaBins; ++jEta)
+      long offset = long(iEta*nPhiBins+iPhi)*nBins + 1;
+      for (int jEta=0; jEta<nEtaBins; jEta++)
         {
-        for (jPhi=0;jPhi<nPhiBins; ++jPhi)
+        const double * v  = contents + offset + jEta*nPhiBins;
+        const double * ev = errors2  + offset + jEta*nPhiBins;
+        int index = iEta*nEtaBins+jEta;
+        for (int jPhi=0; jPhi<nPhiBins; jPhi++)
           {
-          v1   = source->GetBinContent(i*nBins+j+1);
-          ev1  = source->GetBinError(i*nBins+j+1);
-          if (v1> -0.9999999)
+          if (v[jPhi]> -0.9999999)
             {
-            v2   = target->GetBinContent(iEta+1,jEta+1);
-            ev2  = target->GetBinError(iEta+1,jEta+1);
-            v = v1+v2;
-            ev = sqrt(ev1*ev1+ev2*ev2);
-            target->SetBinContent(iEta+1,jEta+1,v);
-            target->SetBinError(iEta+1,jEta+1,ev);
-            work[ iEta*nEtaBins+jEta] += 1;
+            sum[index]     += v[jPhi];
+            sumErr2[index] += ev[jPhi];
+            work[index]    += 1;
             }
-          ++j;
           }
         }
-      ++i;
       }
-    }
-  for (iEta=0;iEta<nEtaBins; ++iEta)
+    });
+
+  for (int iEta=0;iEta<nEtaBins; ++iEta)
     {
-    for (jEta=0;jEta<nEtaBins; ++jEta)
+    for (int jEta=0;jEta<nEtaBins; ++jEta)
       {
-      v1   = target->GetBinContent(iEta+1,jEta+1);
-      ev1  = target->GetBinError(iEta+1,jEta+1);
-      v2   = work[ iEta*nEtaBins+jEta ];
+      int    index = iEta*nEtaBins+jEta;
+      double v1    = target->GetBinContent(iEta+1,jEta+1);
+      double ev1   = target->GetBinError(iEta+1,jEta+1);
+      double v2    = work[index];
       if (v2<=0)
         if (reportFatal(__FUNCTION__))
           {
           cout << endl;
           exit(1);
           }
-      target->SetBinContent(iEta+1,jEta+1,v1/v2);
-      target->SetBinError(iEta+1,jEta+1,ev1/v2);
+      target->SetBinContent(iEta+1,jEta+1,(v1+sum[index])/v2);
+      target->SetBinError(iEta+1,jEta+1,sqrt(ev1*ev1+sumErr2[index])/v2);
       }
     }
-  delete [] work;
 }
 
+//!
+//! Project the n2(x_1,y_1,x_2,y_2) matrix (x: x_1*nYBins+y_1, y: x_2*nYBins+y_2) onto n2(x_1,x_2).
+//! Output row jX reads the source rows of the x_2=jX block, each one contiguously.
+//!
 void HistogramCollection::project_n2XYXY_n2XX(const TH2 * source, TH2 * target,int nXBins,int nYBins)
 {
 
@@ -4218,8 +4576,6 @@ void HistogramCollection::project_n2XYXY_n2XX(const TH2 * source, TH2 * target,i
     ;
   if (!ptrExist(__FUNCTION__,source,target)) return;
 
-  double v1,v2,ev1,ev2,v,ev;
-
   /* sanity checks */
   if ((source->GetNbinsX() != nXBins*nYBins)
       or (source->GetNbinsY() != nXBins*nYBins)
@@ -4230,35 +4586,52 @@ void HistogramCollection::project_n2XYXY_n2XX(const TH2 * source, TH2 * target,i
     return;
     }
 
-  target->Reset();
+  int  nBins  = nXBins*nYBins;
+  long stride = nBins+2;
+  const double * contents = getBinContents(source,kernelContents1);
+  const double * errors2  = getBinErrors2(source,contents,kernelErrors2);
+  kernelSum.assign(nXBins*nXBins,0.0);
+  kernelSumErr2.assign(nXBins*nXBins,0.0);
+  double * sum     = kernelSum.data();
+  double * sumErr2 = kernelSumErr2.data();
 
-  int i=0;
-  for (int iX=0;iX<nXBins; ++iX)
+  runKernel(nXBins, long(nBins)*long(nBins), [&](int jX)
     {
-    for (int iY=0;iY<nYBins; ++iY)
+    double * s  = sum     + jX*nXBins;
+    double * s2 = sumErr2 + jX*nXBins;
+    for (int jY=0; jY<nYBins; jY++)
       {
-      int j=0;
-      for (int jX=0;jX<nXBins; ++jX)
+      long offset = stride*(jX*nYBins+jY+1) + 1;
+      const double * v  = contents + offset;
+      const double * ev = errors2  + offset;
+      for (int iX=0; iX<nXBins; iX++)
         {
-        for (int jY=0;jY<nYBins; ++jY)
+        for (int iY=0; iY<nYBins; iY++)
           {
-          v1   = source->GetBinContent(i+1,j+1);
-          ev1  = source->GetBinError(i+1,j+1);
-          v2   = target->GetBinContent(iX+1,jX+1);
-          ev2  = target->GetBinError(iX+1,jX+1);
-          v = v1+v2;
-          ev = sqrt(ev1*ev1+ev2*ev2);
-          target->SetBinContent(iX+1,jX+1,v);
-          target->SetBinError(iX+1,jX+1,ev);
-          ++j;
+          s[iX]  += v[iX*nYBins+iY];
+          s2[iX] += ev[iX*nYBins+iY];
           }
         }
-      ++i;
+      }
+    });
+
+  target->Reset();
+  for (int jX=0; jX<nXBins; jX++)
+    {
+    for (int iX=0; iX<nXBins; iX++)
+      {
+      int index = jX*nXBins+iX;
+      target->SetBinContent(iX+1,jX+1,sum[index]);
+      target->SetBinError(iX+1,jX+1,sqrt(sumErr2[index]));
       }
     }
   target->SetEntries(source->GetEntries());
 }
 
+//!
+//! Project the n2(x_1,y_1,x_2,y_2) matrix (x: x_1*nYBins+y_1, y: x_2*nYBins+y_2) onto n2(y_1,y_2).
+//! Output row jY reads the source rows with y_2=jY, each one contiguously.
+//!
 void HistogramCollection::project_n2XYXY_n2YY(const TH2 * source, TH2 * target,int nXBins,int nYBins)
 {
 
@@ -4266,8 +4639,6 @@ void HistogramCollection::project_n2XYXY_n2YY(const TH2 * source, TH2 * target,i
     ;
   if (!ptrExist(__FUNCTION__,source,target)) return;
 
-  double v1,v2,ev1,ev2,v,ev;
-
   /* sanity checks */
   if ((source->GetNbinsX() != nXBins*nYBins)
       or (source->GetNbinsY() != nXBins*nYBins)
@@ -4277,30 +4648,43 @@ void HistogramCollection::project_n2XYXY_n2YY(const TH2 * source, TH2 * target,i
     return;
   }
 
-  target->Reset();
-
-  int i=0;
-  for (int iX=0;iX<nXBins; ++iX)
-    {
-    for (int iY=0;iY<nYBins; ++iY)
-      {
-      int j=0;
-      for (int jX=0;jX<nXBins; ++jX)
+  int  nBins  = nXBins*nYBins;
+  long stride = nBins+2;
+  const double * contents = getBinContents(source,kernelContents1);
+  const double * errors2  = getBinErrors2(source,contents,kernelErrors2);
+  kernelSum.assign(nYBins*nYBins,0.0);
+  kernelSumErr2.assign(nYBins*nYBins,0.0);
+  double * sum     = kernelSum.data();
+  double * sumErr2 = kernelSumErr2.data();
+
+  runKernel(nYBins, long(nBins)*long(nBins), [&](int jY)
+    {
+    double * s  = sum     + jY*nYBins;
+    double * s2 = sumErr2 + jY*nYBins;
+    for (int jX=0; jX<nXBins; jX++)
+      {
+      long offset = stride*(jX*nYBins+jY+1) + 1;
+      const double * v  = contents + offset;
+      const double * ev = errors2  + offset;
+      for (int iX=0; iX<nXBins; iX++)
         {
-        for (int jY=0;jY<nYBins; ++jY)
+        for (int iY=0; iY<nYBins; iY++)
           {
-          v1   = source->GetBinContent(i+1,j+1);
-          ev1  = source->GetBinError(i+1,j+1);
-          v2   = target->GetBinContent(iY+1,jY+1);
-          ev2  = target->GetBinError(iY+1,jY+1);
-          v = v1+v2;
-          ev = sqrt(ev1*ev1+ev2*ev2);
-          target->SetBinContent(iY+1,jY+1,v);
-          target->SetBinError(iY+1,jY+1,ev);
-          ++j;
+          s[iY]  += v[iX*nYBins+iY];
+          s2[iY] += ev[iX*nYBins+iY];
           }
         }
-      ++i;
+      }
+    });
+
+  target->Reset();
+  for (int jY=0; jY<nYBins; jY++)
+    {
+    for (int iY=0; iY<nYBins; iY++)
+      {
+      int index = jY*nYBins+iY;
+      target->SetBinContent(iY+1,jY+1,sum[index]);
+      target->SetBinError(iY+1,jY+1,sqrt(sumErr2[index]));
       }
     }
   target->SetEntries(source->GetEntries());
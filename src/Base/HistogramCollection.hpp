@@ -12,6 +12,7 @@
 #ifndef CAP__HistogramCollection
 #define CAP__HistogramCollection
 #include <stdio.h>
+#include <functional>
 #include "TROOT.h"
 #include "TClass.h"
 #include "TH1D.h"
@@ -37,6 +38,8 @@
 //#include "TLine.h"
 //#include "TArrow.h"
 #include "Collection.hpp"
+#include "HistogramCounter.hpp"
+#include "SparseHistogram3D.hpp"
 #include "MessageLogger.hpp"
 #include "MathConstants.hpp"
 #include "MathBasicFunctions.hpp"
@@ -69,6 +72,30 @@ public:
 
   virtual void reset();
 
+  //!
+  //! Create an integer-exact counter attached to the given histogram of this collection. Counters are owned by this collection
+  //! and flushed into their histograms whenever the histograms are scaled, exported, or cloned.
+  //!
+  HistogramCounter * createCounter(TH1 * h);
+
+  //!
+  //! Add the content accumulated by the counters of this collection to their histograms.
+  //!
+  void flushCounters() const;
+
+  //!
+  //! Create a sparse 3D accumulator owned by this collection. Sparse accumulators are scaled and reset along with the histograms
+  //! of this collection and are converted to dense histograms only when the collection is exported.
+  //!
+  SparseHistogram3D * createSparseHistogram(const String & name,
+                                            int n_x, double min_x, double max_x,
+                                            int n_y, double min_y, double max_y,
+                                            int n_z, double min_z, double max_z,
+                                            const String & title_x,
+                                            const String & title_y,
+                                            const String & title_z,
+                                            const String & title_w);
+
   TH1 * createHistogram(const String & name,
                         int n, double min_x, double max_x,
                         const String & title_x,
@@ -116,6 +143,19 @@ public:
   void addHistogramsToExtList(TList *list);
   void exportHistograms(TFile & outputFile);
   void exportHistograms(ofstream & outputFile);
+
+  //!
+  //! Append to the given list detached copies of the histograms of this collection (and histograms built from its sparse
+  //! accumulators) in the order they are written by exportHistograms(TFile&). The copies are owned by the caller.
+  //!
+  void snapshotHistograms(vector<TObject*> & snapshot);
+
+  //!
+  //! Replace the contents of the histograms (and sparse accumulators) of this collection by those of the histograms with the same
+  //! names found in the given file, e.g., a checkpoint written with exportHistograms(TFile&). Returns the number of histograms
+  //! not found in the file.
+  //!
+  int restoreHistograms(TFile & inputFile);
   void scale(double factor);
 
   void add(const HistogramCollection & c1, double a1);
@@ -156,7 +196,9 @@ public:
   void calculateN1N1H2H2_Q3D_MCEta(TH2 * n1_1, TH2 * n1_2, TH3 * n1n1_Q3D, double a1, double a2);
   void calculateN1N1H2H2_Q3D(const TH2 * n1_1, const TH2 * n1_2, TH3 * n1n1_Q3D, double a1, double a2);
   void calculateN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1_2, TH3 * n1n1_Q3D, double a1, double a2);
+  void calculateN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1_2, SparseHistogram3D * n1n1_Q3D, double a1, double a2);
   void calculateR2_Q3D(const TH3 * n2_Q3D, const TH3 * n1n1_Q3D, TH3 * R2_Q3D, double a1, double a2);
+  void calculateR2_Q3D(const SparseHistogram3D * n2_Q3D, const SparseHistogram3D * n1n1_Q3D, SparseHistogram3D * R2_Q3D, double a1, double a2);
   double avgValue(TH1 * h);
 
   void setHistogram(TH1 * h, double v, double ev);
@@ -168,8 +210,17 @@ public:
   TH1 * loadH1(TFile & inputFile,const String & histoName) throw (HistogramException);
   TH2 * loadH2(TFile & inputFile,const String & histoName) throw (HistogramException);
   TH3 * loadH3(TFile & inputFile,const String & histoName) throw (HistogramException);
+  //!
+  //! Load the given 3D histogram into a new sparse accumulator of this collection with the same binning, e.g., to resume the
+  //! accumulation or the derivation of a sparse histogram exported as a dense one.
+  //!
+  SparseHistogram3D * loadSparseH3(TFile & inputFile,const String & histoName) throw (HistogramException);
   TProfile * loadProfile(TFile & inputFile,const String & histoName) throw (HistogramException);
   TProfile2D * loadProfile2D(TFile & inputFile,const String & histoName) throw (HistogramException);
+  //!
+  //! Set the bins (including under and overflows) and the entries of the given sparse accumulator from the given histogram.
+  //!
+  void copyToSparse(const TH3 * h, SparseHistogram3D & sparse);
   void histosImportInList(TFile & inputFile, HistogramCollection * collection) throw (HistogramException);
   TH1 * clone(const TH1 * h1, const String & histoName)  throw (HistogramException);
 
@@ -199,6 +250,12 @@ public:
   void symmetrize3D(TH3* h);
   void symmetrizeDeltaEtaDeltaPhi(TH2 * h, bool ijNormalization);
   void symmetrizeXX(TH2 * h, bool ijNormalization);
+  //!
+  //! The reduce_* and project_* functions below walk the full (eta,phi)x(eta,phi) matrices. They read the bin contents and errors
+  //! of their sources as raw arrays, accumulate in scratch buffers kept by this collection, and split the output rows among
+  //! kernel threads (see setKernelThreads). Each output row is summed by a single thread in a fixed order, so the results do
+  //! not depend on the number of threads.
+  //!
   void reduce_n2xEtaPhi_n2DetaDphi(const TH2 * source, TH2 * target,int nEtaBins,int nPhiBins);
   void reduce_n2xEtaPhi_n2EtaEta(const TH1 * source, TH2 * target,int nEtaBins,int nPhiBins);
 
@@ -349,6 +406,57 @@ public:
   // Data Members - Inputs
   ////////////////////////////////////////////////////////////////////////////
   TRandom   * randomGenerator;
+  vector<HistogramCounter*> counters; //! integer-exact counters attached to histograms of this collection
+  vector<SparseHistogram3D*> sparseHistograms; //! sparse 3D accumulators owned by this collection
+
+  //!
+  //! Set the number of threads used by the reduce_* and project_* kernels. Zero (the default) uses the hardware concurrency.
+  //! Reductions of fewer than kernelMinCells source cells always run in the calling thread.
+  //!
+  static void setKernelThreads(int nThreads);
+
+protected:
+
+  //!
+  //! Bin contents of h, all cells included, in ROOT global bin order. The internal array of h is returned directly for
+  //! double precision histograms; other histograms are copied into the given buffer.
+  //!
+  const double * getBinContents(const TH1 * h, vector<double> & buffer) const;
+
+  //!
+  //! Squared bin errors of h, all cells included, in ROOT global bin order. The sum of weights squared array of h is returned
+  //! directly when it exists; otherwise the squared errors are computed into the given buffer.
+  //!
+  const double * getBinErrors2(const TH1 * h, const double * contents, vector<double> & buffer) const;
+
+  //!
+  //! Call kernel(row) for all rows in [0,nRows), on the kernel threads if the reduction reads at least kernelMinCells cells.
+  //! The kernel must write only to the part of the output owned by its row and must not call ROOT.
+  //!
+  static void runKernel(int nRows, long nCells, const function<void(int)> & kernel);
+
+  vector<double> kernelContents1; //! scratch buffer: source contents
+  vector<double> kernelContents2; //! scratch buffer: second source contents
+  vector<double> kernelErrors2;   //! scratch buffer: source squared errors
+  vector<double> kernelSum;       //! scratch buffer: output sums
+  vector<double> kernelSumErr2;   //! scratch buffer: output sums of squared errors
+
+  static int        kernelThreads;
+  static const long kernelMinCells = 1L<<18;
+
+  inline bool sameSparseSizeAs(const HistogramCollection & c) const
+  {
+  return sparseHistograms.size()==c.sparseHistograms.size();
+  }
+
+  //!
+  //! Set the sparse accumulators of this collection to the sum of those of the given collections multiplied by the given factors.
+  //! The collections must hold the same number of sparse accumulators as this collection.
+  //!
+  void setSparseSum(const vector<const HistogramCollection*> & terms, const vector<double> & factors);
+
+  template <class H>
+  void fillN1N1H3H3_Q3D(const TH3 * n1_1, const TH3 * n1_2, H & n1n1_Q3D, double a1, double a2);
 
   ClassDef(HistogramCollection,1);
 
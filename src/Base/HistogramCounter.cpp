@@ -0,0 +1,92 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "HistogramCounter.hpp"
+using CAP::HistogramCounter;
+
+ClassImp(HistogramCounter);
+
+HistogramCounter::HistogramCounter(TH1 * _histogram)
+:
+histogram(_histogram),
+hasCounts(false),
+hasWeights(false),
+counts(_histogram->GetNcells(),0),
+carries(),
+weights(),
+weights2()
+{ }
+
+void HistogramCounter::fillWeighted(int bin, double weight)
+{
+  if (!hasWeights)
+    {
+    weights.assign(counts.size(),0.0);
+    weights2.assign(counts.size(),0.0);
+    hasWeights = true;
+    }
+  weights[bin]  += weight;
+  weights2[bin] += weight*weight;
+}
+
+void HistogramCounter::fillWeighted(int bin, double weight, unsigned long n)
+{
+  if (!hasWeights)
+    {
+    weights.assign(counts.size(),0.0);
+    weights2.assign(counts.size(),0.0);
+    hasWeights = true;
+    }
+  weights[bin]  += double(n)*weight;
+  weights2[bin] += double(n)*weight*weight;
+}
+
+void HistogramCounter::flush()
+{
+  if (!hasCounts && !hasWeights) return;
+  bool sumw2 = histogram->GetSumw2N()>0;
+  double * w2 = sumw2 ? histogram->GetSumw2()->GetArray() : nullptr;
+  map<int,unsigned long>::const_iterator carry = carries.begin();
+  int nCells = counts.size();
+  for (int bin=0; bin<nCells; bin++)
+    {
+    double n = double(counts[bin]);
+    if (carry!=carries.end() && carry->first==bin)
+      {
+      n += double(carry->second);
+      ++carry;
+      }
+    double sum  = n;
+    double sum2 = n;
+    if (hasWeights)
+      {
+      sum  += weights[bin];
+      sum2 += weights2[bin];
+      }
+    if (sum==0.0 && sum2==0.0) continue;
+    histogram->AddBinContent(bin,sum);
+    if (sumw2) w2[bin] += sum2;
+    }
+  reset();
+}
+
+void HistogramCounter::reset()
+{
+  if (hasCounts) counts.assign(counts.size(),0);
+  carries.clear();
+  if (hasWeights)
+    {
+    weights.clear();
+    weights2.clear();
+    }
+  hasCounts  = false;
+  hasWeights = false;
+}
@@ -0,0 +1,109 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__HistogramCounter
+#define CAP__HistogramCounter
+#include <map>
+#include <vector>
+#include "TH1.h"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Integer-exact bin accumulator attached to a ROOT histogram. Unit-weight fills are counted in 32-bit integers (with 64-bit carries kept
+//! on the side for the rare bins that overflow) so counts are never lost, unlike unit increments of a float bin content beyond 2^24.
+//! Fills with a weight other than one are accumulated in a double precision array allocated on the first such fill.
+//! The accumulated values are added to the histogram, and the accumulator cleared, by flush(). Bins are global bin indices as returned
+//! by TH1::GetBin().
+//!
+class HistogramCounter
+{
+public:
+
+  //!
+  //! CTOR: allocate one counter per cell (including under/overflows) of the given histogram.
+  //!
+  HistogramCounter(TH1 * _histogram);
+
+  //!
+  //! DTOR
+  //!
+  virtual ~HistogramCounter() {}
+
+  //!
+  //! Fill the given bin with the given weight.
+  //!
+  inline void fill(int bin, double weight)
+  {
+  if (weight==1.0)
+    {
+    if (++counts[bin]==0) carries[bin] += 0x100000000UL;
+    hasCounts = true;
+    }
+  else
+    fillWeighted(bin,weight);
+  }
+
+  //!
+  //! Fill the given bin n times with the given weight.
+  //!
+  inline void fill(int bin, double weight, unsigned long n)
+  {
+  if (weight==1.0)
+    {
+    unsigned long sum = counts[bin] + n;
+    counts[bin] = (unsigned int) sum;
+    if (sum>>32) carries[bin] += (sum>>32)<<32;
+    hasCounts = true;
+    }
+  else
+    fillWeighted(bin,weight,n);
+  }
+
+  //!
+  //! Add the accumulated values to the histogram and clear the accumulator.
+  //!
+  void flush();
+
+  //!
+  //! Clear the accumulator without modifying the histogram.
+  //!
+  void reset();
+
+  TH1 * getHistogram() const { return histogram; }
+
+protected:
+
+  void fillWeighted(int bin, double weight);
+
+  //!
+  //! Fill the given bin n times with the given weight: the sum of weights is incremented by n*weight and the sum of squared weights
+  //! by n*weight^2.
+  //!
+  void fillWeighted(int bin, double weight, unsigned long n);
+
+  TH1 * histogram;
+  bool  hasCounts;
+  bool  hasWeights;
+  vector<unsigned int>          counts;
+  map<int,unsigned long>        carries;
+  vector<double>                weights;
+  vector<double>                weights2;
+
+  ClassDef(HistogramCounter,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__HistogramCounter */
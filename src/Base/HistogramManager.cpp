@@ -95,6 +95,17 @@ void CAP::HistogramManager::save(TFile & outputFile)
     }
 }
 
+void CAP::HistogramManager::snapshot(vector<TObject*> & objects)
+{
+  for (unsigned int iSet=0; iSet<sets.size(); iSet++)
+    {
+    for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
+      {
+      sets[iSet][iGroup]->snapshotHistograms(objects);
+      }
+    }
+}
+
 void CAP::HistogramManager::save(ofstream & outputFile)
 {
   for (unsigned int iSet=0; iSet<sets.size(); iSet++)
@@ -124,6 +135,22 @@ void CAP::HistogramManager::load(TFile & outputFile)
     }
 }
 
+//!
+//!Restore the contents of the histograms of all sets and all groups they contain
+//!
+int CAP::HistogramManager::restore(TFile & inputFile)
+{
+  int nMissing = 0;
+  for (unsigned int iSet=0; iSet<sets.size(); iSet++)
+    {
+    for (unsigned int iGroup=0; iGroup<sets[iSet].size(); iGroup++)
+      {
+      nMissing += sets[iSet][iGroup]->restoreHistograms(inputFile);
+      }
+    }
+  return nMissing;
+}
+
 //!
 //!Scale histograms of all sets and all groups they contain by the given factor
 //!
@@ -75,12 +75,23 @@ public:
   //!
   void save(ofstream & outputFile);
 
+  //!
+  //!Append detached copies of the histograms of all sets and all groups to the given list, in the order they are saved by save(TFile&)
+  //!
+  void snapshot(vector<TObject*> & objects);
+
   
   //!
   //!Load histograms of all sets and all groups they contain
   //!
   void load(TFile & outputFile);
 
+  //!
+  //!Restore the contents of the existing histograms of all sets and all groups from the given file (see HistogramCollection::restoreHistograms).
+  //!Returns the number of histograms not found in the file.
+  //!
+  int restore(TFile & inputFile);
+
   //!
   //!Scale histograms of all sets and all groups they contain by the given factor
   //!
@@ -0,0 +1,166 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <cmath>
+#include "SparseHistogram3D.hpp"
+using CAP::SparseHistogram3D;
+
+ClassImp(SparseHistogram3D);
+
+SparseHistogram3D::SparseHistogram3D(const String & _name,
+                                     int _nBins_x, double _min_x, double _max_x,
+                                     int _nBins_y, double _min_y, double _max_y,
+                                     int _nBins_z, double _min_z, double _max_z,
+                                     const String & _title_x,
+                                     const String & _title_y,
+                                     const String & _title_z,
+                                     const String & _title_w)
+:
+name(_name),
+title_x(_title_x),
+title_y(_title_y),
+title_z(_title_z),
+title_w(_title_w),
+nBins_x(_nBins_x), min_x(_min_x), max_x(_max_x), scale_x(double(_nBins_x)/(_max_x-_min_x)),
+nBins_y(_nBins_y), min_y(_min_y), max_y(_max_y), scale_y(double(_nBins_y)/(_max_y-_min_y)),
+nBins_z(_nBins_z), min_z(_min_z), max_z(_max_z), scale_z(double(_nBins_z)/(_max_z-_min_z)),
+nTiles_y(((_nBins_y+2)>>tileBits)+1),
+nTiles_z(((_nBins_z+2)>>tileBits)+1),
+entries(0.0),
+tileIndex(),
+tileKeys(),
+storage()
+{ }
+
+double * SparseHistogram3D::getTile(int ix, int iy, int iz, bool create)
+{
+  unsigned long key = getTileKey(ix,iy,iz);
+  auto found = tileIndex.find(key);
+  if (found!=tileIndex.end()) return &storage[found->second*2*tileCells];
+  if (!create) return nullptr;
+  unsigned int iTile = tileKeys.size();
+  tileIndex[key] = iTile;
+  tileKeys.push_back(key);
+  storage.resize((iTile+1)*2*tileCells, 0.0);
+  return &storage[iTile*2*tileCells];
+}
+
+const double * SparseHistogram3D::getTile(int ix, int iy, int iz) const
+{
+  auto found = tileIndex.find(getTileKey(ix,iy,iz));
+  if (found==tileIndex.end()) return nullptr;
+  return &storage[found->second*2*tileCells];
+}
+
+double SparseHistogram3D::getBinContent(int ix, int iy, int iz) const
+{
+  const double * tile = getTile(ix,iy,iz);
+  return tile ? tile[getCellIndex(ix,iy,iz)] : 0.0;
+}
+
+double SparseHistogram3D::getBinError(int ix, int iy, int iz) const
+{
+  const double * tile = getTile(ix,iy,iz);
+  return tile ? sqrt(tile[tileCells+getCellIndex(ix,iy,iz)]) : 0.0;
+}
+
+void SparseHistogram3D::setBinContent(int ix, int iy, int iz, double value)
+{
+  double * tile = getTile(ix,iy,iz,value!=0.0);
+  if (tile) tile[getCellIndex(ix,iy,iz)] = value;
+}
+
+void SparseHistogram3D::setBinError(int ix, int iy, int iz, double error)
+{
+  double * tile = getTile(ix,iy,iz,error!=0.0);
+  if (tile) tile[tileCells+getCellIndex(ix,iy,iz)] = error*error;
+}
+
+void SparseHistogram3D::scale(double factor)
+{
+  double factor2 = factor*factor;
+  for (unsigned int iTile=0; iTile<tileKeys.size(); iTile++)
+    {
+    double * tile = &storage[iTile*2*tileCells];
+    for (int iCell=0; iCell<tileCells; iCell++)
+      {
+      tile[iCell]           *= factor;
+      tile[tileCells+iCell] *= factor2;
+      }
+    }
+}
+
+void SparseHistogram3D::add(const SparseHistogram3D & other, double factor)
+{
+  if (!sameBinning(other)) return;
+  double factor2 = factor*factor;
+  for (unsigned int jTile=0; jTile<other.tileKeys.size(); jTile++)
+    {
+    int ix, iy, iz;
+    other.getTileOrigin(jTile,ix,iy,iz);
+    double * tile = getTile(ix,iy,iz,true);
+    const double * source = other.getTileData(jTile);
+    for (int iCell=0; iCell<tileCells; iCell++)
+      {
+      tile[iCell]           += factor*source[iCell];
+      tile[tileCells+iCell] += factor2*source[tileCells+iCell];
+      }
+    }
+  entries += other.entries;
+}
+
+void SparseHistogram3D::reset()
+{
+  tileIndex.clear();
+  tileKeys.clear();
+  storage.clear();
+  storage.shrink_to_fit();
+  entries = 0.0;
+}
+
+void SparseHistogram3D::getTileOrigin(unsigned int iTile, int & ix, int & iy, int & iz) const
+{
+  unsigned long key = tileKeys[iTile];
+  iz = int(key % nTiles_z) << tileBits;
+  key /= nTiles_z;
+  iy = int(key % nTiles_y) << tileBits;
+  ix = int(key / nTiles_y) << tileBits;
+}
+
+TH3 * SparseHistogram3D::createHistogram() const
+{
+  TH3 * h = new TH3F(name,name,nBins_x,min_x,max_x,nBins_y,min_y,max_y,nBins_z,min_z,max_z);
+  h->Sumw2();
+  if (title_x.Sizeof()>0)  h->GetXaxis()->SetTitle(title_x);
+  if (title_y.Sizeof()>0)  h->GetYaxis()->SetTitle(title_y);
+  if (title_z.Sizeof()>0)  h->GetZaxis()->SetTitle(title_z);
+  for (unsigned int iTile=0; iTile<tileKeys.size(); iTile++)
+    {
+    int ix0, iy0, iz0;
+    getTileOrigin(iTile,ix0,iy0,iz0);
+    const double * tile = getTileData(iTile);
+    for (int ix=ix0; ix<ix0+tileSize && ix<=nBins_x+1; ix++)
+      {
+      for (int iy=iy0; iy<iy0+tileSize && iy<=nBins_y+1; iy++)
+        {
+        for (int iz=iz0; iz<iz0+tileSize && iz<=nBins_z+1; iz++)
+          {
+          int iCell = getCellIndex(ix,iy,iz);
+          if (tile[iCell]==0.0 && tile[tileCells+iCell]==0.0) continue;
+          h->SetBinContent(ix,iy,iz,tile[iCell]);
+          h->SetBinError(ix,iy,iz,sqrt(tile[tileCells+iCell]));
+          }
+        }
+      }
+    }
+  h->SetEntries(entries);
+  return h;
+}
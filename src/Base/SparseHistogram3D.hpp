@@ -0,0 +1,201 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__SparseHistogram3D
+#define CAP__SparseHistogram3D
+#include <unordered_map>
+#include <vector>
+#include "TH3F.h"
+#include "Aliases.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Sparse accumulator for three dimensional histograms. The bins (including under/overflows) are grouped in tiles of 8x8x8 cells and
+//! a tile is allocated (contents and sums of squared weights) only when one of its cells is first filled. The memory used thus scales
+//! with the occupied phase space rather than with the number of bins. A dense ROOT histogram with the same binning, contents, and
+//! errors is produced by createHistogram(), e.g., at export time. Bin indices follow the ROOT convention: 0 is the underflow and
+//! nBins+1 the overflow along each axis.
+//!
+class SparseHistogram3D
+{
+public:
+
+  static const int tileBits  = 3;
+  static const int tileSize  = 1<<tileBits;
+  static const int tileCells = tileSize*tileSize*tileSize;
+
+  //!
+  //! CTOR
+  //!
+  SparseHistogram3D(const String & _name,
+                    int _nBins_x, double _min_x, double _max_x,
+                    int _nBins_y, double _min_y, double _max_y,
+                    int _nBins_z, double _min_z, double _max_z,
+                    const String & _title_x,
+                    const String & _title_y,
+                    const String & _title_z,
+                    const String & _title_w);
+
+  //!
+  //! DTOR
+  //!
+  virtual ~SparseHistogram3D() {}
+
+  inline int getBinX(double x) const
+  {
+  if (x<min_x) return 0;
+  if (x>=max_x) return nBins_x+1;
+  return 1+int(scale_x*(x-min_x));
+  }
+
+  inline int getBinY(double y) const
+  {
+  if (y<min_y) return 0;
+  if (y>=max_y) return nBins_y+1;
+  return 1+int(scale_y*(y-min_y));
+  }
+
+  inline int getBinZ(double z) const
+  {
+  if (z<min_z) return 0;
+  if (z>=max_z) return nBins_z+1;
+  return 1+int(scale_z*(z-min_z));
+  }
+
+  //!
+  //! Add the given weight to the bin containing (x,y,z).
+  //!
+  inline void fill(double x, double y, double z, double weight=1.0)
+  {
+  addBinContent(getBinX(x),getBinY(y),getBinZ(z),weight);
+  entries++;
+  }
+
+  //!
+  //! Add the given weight to the bin (ix,iy,iz), allocating its tile if needed.
+  //!
+  inline void addBinContent(int ix, int iy, int iz, double weight)
+  {
+  double * tile = getTile(ix,iy,iz,true);
+  int iCell = getCellIndex(ix,iy,iz);
+  tile[iCell] += weight;
+  tile[tileCells+iCell] += weight*weight;
+  }
+
+  double getBinContent(int ix, int iy, int iz) const;
+  double getBinError(int ix, int iy, int iz) const;
+  void   setBinContent(int ix, int iy, int iz, double value);
+  void   setBinError(int ix, int iy, int iz, double error);
+
+  //!
+  //! Scale the contents by the given factor (and the sums of squared weights by its square).
+  //!
+  void scale(double factor);
+
+  //!
+  //! Add the contents of the given accumulator, which must have the same binning, multiplied by the given factor.
+  //!
+  void add(const SparseHistogram3D & other, double factor=1.0);
+
+  //!
+  //! Release all the tiles.
+  //!
+  void reset();
+
+  //!
+  //! Create a dense ROOT histogram (owned by the caller) with the binning, contents, and errors of this accumulator.
+  //!
+  TH3 * createHistogram() const;
+
+  inline const String & getName() const { return name; }
+  inline int getNBinsX() const { return nBins_x; }
+  inline int getNBinsY() const { return nBins_y; }
+  inline int getNBinsZ() const { return nBins_z; }
+  inline double getEntries() const { return entries; }
+  inline void   setEntries(double _entries) { entries = _entries; }
+
+  //!
+  //! Number of allocated tiles and the memory they use (in bytes).
+  //!
+  inline unsigned int getNTiles() const { return tileKeys.size(); }
+  inline size_t getMemorySize() const { return storage.size()*sizeof(double); }
+
+  //!
+  //! Bin indices of the first cell of the given tile.
+  //!
+  void getTileOrigin(unsigned int iTile, int & ix, int & iy, int & iz) const;
+
+  //!
+  //! Contents (first tileCells values) and sums of squared weights (next tileCells values) of the given tile. Cells are indexed
+  //! by ((ix%tileSize)*tileSize + iy%tileSize)*tileSize + iz%tileSize.
+  //!
+  inline const double * getTileData(unsigned int iTile) const { return &storage[iTile*2*tileCells]; }
+
+  inline bool sameBinning(const SparseHistogram3D & other) const
+  {
+  return nBins_x==other.nBins_x && min_x==other.min_x && max_x==other.max_x &&
+         nBins_y==other.nBins_y && min_y==other.min_y && max_y==other.max_y &&
+         nBins_z==other.nBins_z && min_z==other.min_z && max_z==other.max_z;
+  }
+
+protected:
+
+  inline unsigned long getTileKey(int ix, int iy, int iz) const
+  {
+  return ((unsigned long)(ix>>tileBits)*nTiles_y + (iy>>tileBits))*nTiles_z + (iz>>tileBits);
+  }
+
+  inline int getCellIndex(int ix, int iy, int iz) const
+  {
+  return (((ix&(tileSize-1))<<tileBits) + (iy&(tileSize-1)))*tileSize + (iz&(tileSize-1));
+  }
+
+  //!
+  //! Return the tile containing the bin (ix,iy,iz), or nullptr if it is not allocated and create is false.
+  //!
+  double * getTile(int ix, int iy, int iz, bool create);
+  const double * getTile(int ix, int iy, int iz) const;
+
+  String name;
+  String title_x;
+  String title_y;
+  String title_z;
+  String title_w;
+  int    nBins_x;
+  double min_x;
+  double max_x;
+  double scale_x;
+  int    nBins_y;
+  double min_y;
+  double max_y;
+  double scale_y;
+  int    nBins_z;
+  double min_z;
+  double max_z;
+  double scale_z;
+  unsigned long nTiles_y;
+  unsigned long nTiles_z;
+  double entries;
+
+  unordered_map<unsigned long,unsigned int> tileIndex; //!< tile key -> tile index
+  vector<unsigned long> tileKeys;                      //!< tile index -> tile key
+  vector<double> storage;                              //!< 2*tileCells values per tile
+
+  ClassDef(SparseHistogram3D,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__SparseHistogram3D */
@@ -9,6 +9,7 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <algorithm>
 #include "TSystem.h"
 #include "TSystemDirectory.h"
 #include "TSystemFile.h"
@@ -25,7 +26,9 @@ ConfigurationManager     (),
 IdentifiedObject         (),
 //MessageLogger            (Info),
 timer                    (),
+profiler                 (),
 histogramManager         (),
+exportWriter             (),
 parent                   (nullptr),
 histosCreate             (false),
 histosReset              (false),
@@ -43,6 +46,7 @@ histosExportAsText       (false),
 histosExportPartial      (false),
 histosExportPartialCount (false),
 histosExportMaxPerPartial(false),
+histosExportAsync        (false),
 histosExportPath         (""),
 histosExportFile         (""),
 taskExecutedTotal        (0),
@@ -59,7 +63,9 @@ Task::Task(const String & _name,
 ConfigurationManager     (_configuration),
 IdentifiedObject         (_name,_name,"1.0",_name,_name,0),
 timer                    (),
+profiler                 (),
 histogramManager         (),
+exportWriter             (),
 parent                   (nullptr),
 histosCreate             (false),
 histosReset              (false),
@@ -77,6 +83,7 @@ histosExportAsText       (false),
 histosExportPartial      (false),
 histosExportPartialCount (false),
 histosExportMaxPerPartial(false),
+histosExportAsync        (false),
 histosExportPath         (""),
 histosExportFile         (""),
 taskExecutedTotal        (0),
@@ -130,6 +137,7 @@ void Task::setDefaultConfiguration()
   addParameter("HistogramsExportPartial",       histosExportPartial);
   addParameter("HistogramsExportPartialCount",  histosExportPartialCount);
   addParameter("HistogramsExportMaxPerPartial", histosExportMaxPerPartial);
+  addParameter("HistogramsExportAsync",         histosExportAsync);
   addParameter("HistogramsExportPath",          histosExportPath);
   addParameter("HistogramsExportFile",          histosExportFile);
 }
@@ -156,6 +164,7 @@ void Task::configure()
   histosExportPartial       = getValueBool("HistogramsExportPartial");
   histosExportPartialCount  = getValueInt("HistogramsExportPartialCount");
   histosExportMaxPerPartial = getValueInt("HistogramsExportMaxPerPartial");
+  histosExportAsync         = getValueBool("HistogramsExportAsync");
   histosExportPath          = getValueString("HistogramsExportPath");
   histosExportFile          = getValueString("HistogramsExportFile");
   if (hasSubTasks())
@@ -347,6 +356,17 @@ void Task::exportHistograms(TFile & outputFile)
     ;
 }
 
+void Task::snapshotHistograms(vector<TObject*> & snapshot)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  snapshotNEventsAccepted(snapshot);
+  snapshot.push_back(new TParameter<Long64_t>("taskExecuted",taskExecuted,'+'));
+  histogramManager.snapshot(snapshot);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
 void Task::exportHistograms(ofstream & outputFile)
 {
   if (reportStart(__FUNCTION__))
@@ -377,6 +397,20 @@ void Task::exportHistograms()
 //  {
   String option = "NEW";
   if (histosForceRewrite) option = "RECREATE";
+  if (histosExportAsync)
+    {
+    String outputFileName = histosExportPath;
+    if (outputFileName.Length()>0 && !outputFileName.EndsWith("/")) outputFileName += "/";
+    outputFileName += histosExportFile;
+    if (!outputFileName.EndsWith(".root")) outputFileName += ".root";
+    if (!exportWriter.wait() && reportError(__FUNCTION__)) cout << "Previous background export of this task failed." << endl;
+    vector<TObject*> snapshot;
+    snapshotHistograms(snapshot);
+    exportWriter.write(outputFileName,option,snapshot);
+    if (reportEnd(__FUNCTION__))
+      ;
+    return;
+    }
   TFile & outputFile = openRootFile(histosExportPath,histosExportFile,option);
   exportHistograms(outputFile);
   outputFile.Close();
@@ -400,6 +434,16 @@ void Task::exportHistograms()
     ;
 }
 
+void Task::waitHistogramsExport()
+{
+  if (!exportWriter.wait())
+    {
+    if (reportError(__FUNCTION__)) cout << "Background export of the histograms failed." << endl;
+    postTaskError();
+    }
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++)  subTasks[iTask]->waitHistogramsExport();
+}
+
 void Task::writeNEexecutedTask(TFile & outputFile)
 {
   if (reportStart(__FUNCTION__))
@@ -583,7 +627,7 @@ void Task::initializeSubTasks()
 void Task::executeSubTasks()
 {
   unsigned int nSubTasks = subTasks.size();
-  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->execute();
+  for (unsigned int  iTask=0; iTask<nSubTasks; iTask++) subTasks[iTask]->executeProfiled();
 }
 
 void Task::finalizeSubTasks()
@@ -947,5 +991,114 @@ void Task::printVersion(const TString & option __attribute__ (( unused )) ) cons
     }
 }
 
+bool Task::enableProfiling(bool usePerfCounters)
+{
+  bool status = profiler.enable(usePerfCounters);
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++)
+    status = subTasks[iTask]->enableProfiling(usePerfCounters) && status;
+  return status;
+}
+
+void Task::aggregateProfile(TaskProfiler & total) const
+{
+  vector<const void*> particleSources;
+  if (total.getParticleSource()) particleSources.push_back(total.getParticleSource());
+  aggregateProfile(total,particleSources);
+}
+
+void Task::aggregateProfile(TaskProfiler & total, vector<const void*> & particleSources) const
+{
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++)
+    {
+    // particles of a source shared by several tasks are counted once
+    const TaskProfiler & subProfiler = subTasks[iTask]->profiler;
+    const void * source = subProfiler.getParticleSource();
+    bool newSource = source && find(particleSources.begin(),particleSources.end(),source)==particleSources.end();
+    if (newSource) particleSources.push_back(source);
+    total.add(subProfiler,false,newSource);
+    subTasks[iTask]->aggregateProfile(total,particleSources);
+    }
+}
+
+void Task::printProfile(ostream & output)
+{
+  fillProfile();
+  profiler.print(output,getName());
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) subTasks[iTask]->printProfile(output);
+}
+
+void Task::writeProfile(ostream & output, const String & indent)
+{
+  fillProfile();
+  TaskProfiler total(profiler);
+  aggregateProfile(total);
+  String indent2 = indent + "  ";
+  String indent4 = indent + "    ";
+  output << indent << "{" << endl;
+  output << indent2 << "\"name\": \"" << getName() << "\"," << endl;
+  profiler.writeJson(output,indent2);
+  output << "," << endl;
+  output << indent2 << "\"total\": {" << endl;
+  total.writeJson(output,indent4);
+  output << endl << indent2 << "}," << endl;
+  output << indent2 << "\"subTasks\": [";
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++)
+    {
+    output << (iTask==0 ? "" : ",") << endl;
+    subTasks[iTask]->writeProfile(output,indent4);
+    }
+  output << endl << indent2 << "]" << endl;
+  output << indent << "}";
+}
+
+void Task::saveCheckpoint(TFile & outputFile)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  writeCheckpointValue(outputFile,"taskExecuted",taskExecuted);
+  writeCheckpointValue(outputFile,"taskExecutedTotal",taskExecutedTotal);
+  histogramManager.save(outputFile);
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) subTasks[iTask]->saveCheckpoint(outputFile);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void Task::loadCheckpoint(TFile & inputFile)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  taskExecuted      = readCheckpointValue(inputFile,"taskExecuted",taskExecuted);
+  taskExecutedTotal = readCheckpointValue(inputFile,"taskExecutedTotal",taskExecutedTotal);
+  int nMissing = histogramManager.restore(inputFile);
+  if (nMissing>0 && reportWarning(__FUNCTION__)) cout << nMissing << " histogram(s) of task " << getName() << " not found in checkpoint." << endl;
+  for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) subTasks[iTask]->loadCheckpoint(inputFile);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
 
+void Task::writeCheckpointValue(TFile & outputFile, const String & name, long value)
+{
+  String key = getFullTaskPath();
+  key.ReplaceAll(":","_");
+  key += "_";
+  key += name;
+  outputFile.cd();
+  TParameter<Long64_t>(key,value).Write(key,TObject::kOverwrite);
+}
 
+long Task::readCheckpointValue(TFile & inputFile, const String & name, long defaultValue)
+{
+  String key = getFullTaskPath();
+  key.ReplaceAll(":","_");
+  key += "_";
+  key += name;
+  TParameter<Long64_t> * parameter = (TParameter<Long64_t> *) inputFile.Get(key);
+  if (!parameter)
+    {
+    if (reportWarning(__FUNCTION__)) cout << "Checkpoint value not found: " << key << endl;
+    return defaultValue;
+    }
+  long value = parameter->GetVal();
+  delete parameter;
+  return value;
+}
@@ -25,6 +25,8 @@
 #include "StateManager.hpp"
 #include "NameManager.hpp"
 #include "Timer.hpp"
+#include "TaskProfiler.hpp"
+#include "AsyncFileWriter.hpp"
 
 using std::vector;
 using std::iostream;
@@ -67,11 +69,21 @@ protected:
 
   Timer timer;
 
+  //!
+  //! Performance profile of this task (disabled unless enabled with enableProfiling())
+  //!
+  TaskProfiler profiler;
+
   //!
   //! Histogram manager
   //!
   HistogramManager histogramManager;
 
+  //!
+  //! Background writer of the histogram exports (used if HistogramsExportAsync is true)
+  //!
+  AsyncFileWriter exportWriter;
+
   //!
   //! Pointer to parent task if any
   //!
@@ -93,6 +105,7 @@ protected:
   bool   histosExportPartial;
   long   histosExportPartialCount;
   long   histosExportMaxPerPartial;
+  bool   histosExportAsync;
   String histosExportPath;
   String histosExportFile;
 
@@ -187,6 +200,55 @@ public:
   //!
   Task *  addSubTask(Task * task);
 
+  //!
+  //! Call execute() and, if profiling is enabled, accumulate its wall and CPU times (including those of the subtasks of this task).
+  //! Parent tasks and iterators should call this method rather than execute() on their subtasks.
+  //!
+  inline void executeProfiled()
+  {
+  if (!profiler.isEnabled())
+    {
+    execute();
+    return;
+    }
+  profiler.start(TaskProfiler::Execute);
+  execute();
+  profiler.stop(TaskProfiler::Execute);
+  }
+
+  //!
+  //! Enable the profiling of this task and its subtasks, optionally with hardware counters. Returns false if hardware counters were
+  //! requested but are not available.
+  //!
+  bool enableProfiling(bool usePerfCounters);
+
+  //!
+  //! Report task specific values (e.g., factory occupancy) in the profile of this task. Called before profiles are printed or exported.
+  //!
+  virtual void fillProfile() {}
+
+  //!
+  //! Add the exclusive phases of this task and its subtasks to the given profile. The particles of a source (event stream) shared
+  //! by several tasks are counted once.
+  //!
+  void aggregateProfile(TaskProfiler & total) const;
+  void aggregateProfile(TaskProfiler & total, vector<const void*> & particleSources) const;
+
+  //!
+  //! Print the profiles of this task and its subtasks.
+  //!
+  void printProfile(ostream & output);
+
+  //!
+  //! Write the profiles of this task and its subtasks, and their aggregate, as a JSON object.
+  //!
+  void writeProfile(ostream & output, const String & indent);
+
+  inline const TaskProfiler & getProfiler() const
+  {
+  return profiler;
+  }
+
   //!
   //! Initialize this task instance. Implement this method in a derived class if the functionality provided in this base class is insufficient.
   //!
@@ -284,14 +346,45 @@ public:
   virtual void exportHistograms(TFile & outputFile);
   virtual void exportHistograms(ofstream & out);
 
+  //!
+  //! Append to the given list detached copies of the objects written by exportHistograms(TFile&), in the same order: the event
+  //! counters, the task execution counter, and the histograms of this task. The copies are owned by the caller.
+  //!
+  virtual void snapshotHistograms(vector<TObject*> & snapshot);
+
   //!
   //! Save this histogram groups owned by this task instance. This method calls opens the root file specified in the configuration object and calls the saveHistogram
-  //! methods of the histogram groups owned by this instance.
+  //! methods of the histogram groups owned by this instance. If HistogramsExportAsync is true, the histograms are copied and the file
+  //! is written by a background thread while this task carries on; the file content is the same as that of a synchronous export.
   //!
   virtual void exportHistograms();
 
+  //!
+  //! Wait for the completion of the background histogram exports of this task and its subtasks.
+  //!
+  void waitHistogramsExport();
+
   virtual void partial(const String & outputPathBase __attribute__((unused))) {}
 
+  //!
+  //! Write the resumable state of this task and of its subtasks (histograms, counters, and any state saved by derived classes) to the
+  //! given (checkpoint) file. Derived classes with additional state (e.g., reader positions) should override this method and call the
+  //! base class implementation.
+  //!
+  virtual void saveCheckpoint(TFile & outputFile);
+
+  //!
+  //! Restore the state of this task and of its subtasks from the given checkpoint file. The histograms must already exist, i.e., this
+  //! method must be called after initialize().
+  //!
+  virtual void loadCheckpoint(TFile & inputFile);
+
+  //!
+  //! Save (read) the given named value of this task in (from) a checkpoint file. Values are stored under keys unique within a task tree.
+  //!
+  void writeCheckpointValue(TFile & outputFile, const String & name, long value);
+  long readCheckpointValue(TFile & inputFile, const String & name, long defaultValue);
+
 
 
 
@@ -380,6 +473,7 @@ public:
   virtual long loadNEexecutedTask(TFile & inputFile);
 
   virtual void writeNEventsAccepted(TFile & inputFile __attribute__(( unused))) {}
+  virtual void snapshotNEventsAccepted(vector<TObject*> & snapshot __attribute__(( unused))) {}
   virtual void loadNEventsAccepted(TFile & inputFile  __attribute__(( unused))) {}
 
   //!
@@ -448,6 +542,14 @@ public:
   parent = _parent;
   }
 
+  //!
+  //! Returns the histogram manager of this task, e.g., for external drivers (benchmarks) that fill the histogram groups of this task directly.
+  //!
+  HistogramManager & getHistogramManager()
+  {
+  return histogramManager;
+  }
+
 
   //!
   //! Returns the name of the parent task (if there is a parent task). If this task has no parent
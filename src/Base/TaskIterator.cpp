@@ -9,6 +9,10 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <fstream>
+#include "TSystem.h"
+#include "TMemFile.h"
+#include "TRandom3.h"
 #include "TaskIterator.hpp"
 //using CAP::Task;
 //using CAP::TaskIterator;
@@ -29,6 +33,12 @@ nBunches(1),
 nEventsRequested(1),
 bunchLabel("BUNCH"),
 subbunchLabel(""),
+profileTasks(false),
+profilePerfCounters(false),
+checkpointInterval(0),
+checkpointFile("Checkpoint.root"),
+checkpointRestore(false),
+checkpointWriter(),
 iEvent(0),
 iSubBunch(0),
 iBunch(0)
@@ -47,6 +57,11 @@ void TaskIterator::setDefaultConfiguration()
   addParameter("nEventsRequested",        nEventsRequested);
   addParameter("BunchLabel",              bunchLabel);
   addParameter("SubbunchLabel",           subbunchLabel);
+  addParameter("ProfileTasks",            profileTasks);
+  addParameter("ProfilePerfCounters",     profilePerfCounters);
+  addParameter("CheckpointInterval",      checkpointInterval);
+  addParameter("CheckpointFile",          checkpointFile);
+  addParameter("CheckpointRestore",       checkpointRestore);
 }
 
 void TaskIterator::configure()
@@ -59,6 +74,11 @@ void TaskIterator::configure()
   nEventsRequested       = getValueLong(  "nEventsRequested");
   bunchLabel             = getValueString("BunchLabel");
   subbunchLabel          = getValueString("SubbunchLabel");
+  profileTasks           = getValueBool(  "ProfileTasks");
+  profilePerfCounters    = getValueBool(  "ProfilePerfCounters");
+  checkpointInterval     = getValueLong(  "CheckpointInterval");
+  checkpointFile         = getValueString("CheckpointFile");
+  checkpointRestore      = getValueBool(  "CheckpointRestore");
 
   if (reportInfo(__FUNCTION__))
     {
@@ -70,6 +90,11 @@ void TaskIterator::configure()
     printItem("nEventsRequested" ,nEventsRequested);
     printItem("bunchLabel" ,bunchLabel);
     printItem("subbunchLabel" ,subbunchLabel);
+    printItem("profileTasks" ,profileTasks);
+    printItem("profilePerfCounters" ,profilePerfCounters);
+    printItem("checkpointInterval" ,checkpointInterval);
+    printItem("checkpointFile" ,checkpointFile);
+    printItem("checkpointRestore" ,checkpointRestore);
     }
 }
 
@@ -98,13 +123,22 @@ void TaskIterator::execute()
 {
   timer.start();
   initialize();
+  if (profileTasks)
+    {
+    for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)
+      {
+      if (!subTasks[iTask]->enableProfiling(profilePerfCounters) && reportWarning(__FUNCTION__))
+        cout << "Hardware performance counters are not available. Only wall and CPU times will be profiled." << endl;
+      }
+    }
   iEvent           = 0;
   iSubBunch        = 0;
   iBunch           = 0;
+  if (checkpointRestore) readCheckpoint();
   bool working     = true;
   while (working)
     {
-    for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->execute();
+    for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->executeProfiled();
     iEvent++;
     if (isTaskEod())
       {
@@ -135,12 +169,15 @@ void TaskIterator::execute()
         if (iBunch==nBunches) working = false;
         }
       }
+    if (checkpointInterval>0 && iEvent%checkpointInterval==0) writeCheckpoint();
     }
+  checkpointWriter.wait();
   if (histosExportPartial && (iEvent%(nBunches*nSubbunchesPerBunch*nEventsPerSubbunch)!=0))
     partial(getValueString("HistogramsExportPath"));
 
   timer.stop();
   finalize();
+  for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->waitHistogramsExport();
   clear(); // should delete everything..
 }
 
@@ -171,6 +208,102 @@ void TaskIterator::finalize()
     cout << "---------------------------------------------------------------------------------------- " <<   endl;
     cout << endl << endl<< endl << endl;
     }
+  if (profileTasks)
+    {
+    if (reportInfo(__FUNCTION__))
+      {
+      for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->printProfile(cout);
+      }
+    String fileName = getValueString("HistogramsExportPath");
+    fileName += "/";
+    fileName += getName();
+    fileName += "_Profile.json";
+    exportProfile(fileName);
+    }
+}
+
+void TaskIterator::exportProfile(const String & fileName)
+{
+  ofstream output(fileName.Data());
+  if (!output.is_open())
+    {
+    if (reportError(__FUNCTION__)) cout << "Unable to open profile file: " << fileName << endl;
+    return;
+    }
+  output << "{" << endl;
+  output << "  \"name\": \"" << getName() << "\"," << endl;
+  output << "  \"events\": " << iEvent << "," << endl;
+  output << "  \"wall\": " << timer.totalDuration.count() << "," << endl;
+  output << "  \"subTasks\": [";
+  for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)
+    {
+    output << (iTask==0 ? "" : ",") << endl;
+    subTasks[iTask]->writeProfile(output,"    ");
+    }
+  output << endl << "  ]" << endl;
+  output << "}" << endl;
+  if (reportInfo(__FUNCTION__)) cout << "Task profiles written to: " << fileName << endl;
+}
 
+String TaskIterator::getCheckpointFileName()
+{
+  String fileName = getValueString("HistogramsExportPath");
+  if (fileName.Length()>0 && !fileName.EndsWith("/")) fileName += "/";
+  fileName += checkpointFile;
+  return fileName;
+}
+
+void TaskIterator::writeCheckpoint()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  String fileName = getCheckpointFileName();
+  TMemFile file(fileName,"RECREATE");
+  writeCheckpointValue(file,"iEvent",iEvent);
+  writeCheckpointValue(file,"iSubBunch",iSubBunch);
+  writeCheckpointValue(file,"iBunch",iBunch);
+  TRandom3 * random = dynamic_cast<TRandom3*>(gRandom);
+  if (random)
+    {
+    file.cd();
+    random->Write("gRandomState",TObject::kOverwrite);
+    }
+  for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->saveCheckpoint(file);
+  file.Write();
+  vector<char> buffer;
+  AsyncFileWriter::serialize(file,buffer);
+  file.Close();
+  if (!checkpointWriter.wait() && reportError(__FUNCTION__)) cout << "Previous checkpoint could not be written to: " << fileName << endl;
+  checkpointWriter.write(fileName,buffer);
+  if (reportInfo(__FUNCTION__)) cout << "Checkpoint at event " << iEvent << " queued for: " << fileName << endl;
 }
 
+bool TaskIterator::readCheckpoint()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  String fileName = getCheckpointFileName();
+  if (gSystem->AccessPathName(fileName))
+    {
+    if (reportInfo(__FUNCTION__)) cout << "No checkpoint found: " << fileName << ". Starting from the first event." << endl;
+    return false;
+    }
+  TFile file(fileName,"READ");
+  if (!file.IsOpen() || file.IsZombie())
+    {
+    if (reportError(__FUNCTION__)) cout << "Unable to open checkpoint: " << fileName << endl;
+    postTaskError();
+    return false;
+    }
+  iEvent    = readCheckpointValue(file,"iEvent",0);
+  iSubBunch = readCheckpointValue(file,"iSubBunch",0);
+  iBunch    = readCheckpointValue(file,"iBunch",0);
+  TRandom3 * random = dynamic_cast<TRandom3*>(gRandom);
+  TRandom3 * saved  = (TRandom3 *) file.Get("gRandomState");
+  if (random && saved) *random = *saved;
+  delete saved;
+  for (unsigned int  iTask=0; iTask<getNSubTasks(); iTask++)  subTasks[iTask]->loadCheckpoint(file);
+  file.Close();
+  if (reportInfo(__FUNCTION__)) cout << "Restored checkpoint: " << fileName << " resuming after event " << iEvent << endl;
+  return true;
+}
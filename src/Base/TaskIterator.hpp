@@ -12,6 +12,7 @@
 #ifndef CAP__TaskIterator
 #define CAP__TaskIterator
 #include "Task.hpp"
+#include "AsyncFileWriter.hpp"
 
 namespace CAP {
 
@@ -61,6 +62,28 @@ public:
   //!
   virtual void finalize();
 
+  //!
+  //! Write the profiles of the subtasks of this iterator, in JSON format, to the file with the given name.
+  //!
+  virtual void exportProfile(const String & fileName);
+
+  //!
+  //! Write a checkpoint of the resumable state of this iterator and its subtasks (event, subbunch, and bunch indices, state of gRandom,
+  //! histograms, counters, reader positions). The state is serialized in memory and written to disk in the background, atomically,
+  //! so the event loop does not wait for the disk.
+  //!
+  virtual void writeCheckpoint();
+
+  //!
+  //! Restore the state of this iterator and its subtasks from the checkpoint file, if it exists. Returns true if a checkpoint was restored.
+  //!
+  virtual bool readCheckpoint();
+
+  //!
+  //! Name of the checkpoint file: CheckpointFile in the HistogramsExportPath folder.
+  //!
+  String getCheckpointFileName();
+
 protected:
 
   bool    isGrid;
@@ -70,6 +93,12 @@ protected:
   long    nEventsRequested;
   String  bunchLabel;
   String  subbunchLabel;
+  bool    profileTasks;
+  bool    profilePerfCounters;
+  long    checkpointInterval;
+  String  checkpointFile;
+  bool    checkpointRestore;
+  AsyncFileWriter checkpointWriter; //!
   long    iEvent;
   int     iSubBunch;
   int     iBunch;
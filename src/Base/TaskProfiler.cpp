@@ -0,0 +1,270 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <ctime>
+#include <cstring>
+#include <iomanip>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "TaskProfiler.hpp"
+using CAP::TaskProfiler;
+
+ClassImp(TaskProfiler);
+
+int TaskProfiler::perfCyclesFd       = -1;
+int TaskProfiler::perfInstructionsFd = -1;
+int TaskProfiler::perfUsers          = 0;
+
+TaskProfiler::TaskProfiler()
+:
+enabled(false),
+perfEnabled(false),
+perfHeld(false),
+nParticles(0),
+particleSource(nullptr),
+valueNames(),
+values()
+{
+  reset();
+}
+
+TaskProfiler::TaskProfiler(const TaskProfiler & source)
+:
+enabled(false),
+perfEnabled(false),
+perfHeld(false),
+nParticles(0),
+particleSource(nullptr),
+valueNames(),
+values()
+{
+  copyCounts(source);
+}
+
+TaskProfiler::~TaskProfiler()
+{
+  releasePerfCounters();
+}
+
+TaskProfiler & TaskProfiler::operator=(const TaskProfiler & source)
+{
+  if (this!=&source) copyCounts(source);
+  return *this;
+}
+
+void TaskProfiler::copyCounts(const TaskProfiler & source)
+{
+  enabled        = source.enabled;
+  perfEnabled    = source.perfEnabled;
+  nParticles     = source.nParticles;
+  particleSource = source.particleSource;
+  for (int phase=0; phase<NPhases; phase++)
+    {
+    startWall[phase]         = source.startWall[phase];
+    startCpu[phase]          = source.startCpu[phase];
+    startCycles[phase]       = source.startCycles[phase];
+    startInstructions[phase] = source.startInstructions[phase];
+    calls[phase]             = source.calls[phase];
+    wallTime[phase]          = source.wallTime[phase];
+    cpuTime[phase]           = source.cpuTime[phase];
+    cycles[phase]            = source.cycles[phase];
+    instructions[phase]      = source.instructions[phase];
+    }
+  valueNames = source.valueNames;
+  values     = source.values;
+}
+
+#if defined(__linux__)
+static int openPerfCounter(unsigned long long config)
+{
+  struct perf_event_attr attributes;
+  memset(&attributes, 0, sizeof(attributes));
+  attributes.type           = PERF_TYPE_HARDWARE;
+  attributes.size           = sizeof(attributes);
+  attributes.config         = config;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv     = 1;
+  return syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+#endif
+
+bool TaskProfiler::enable(bool usePerfCounters)
+{
+  enabled = true;
+  releasePerfCounters();
+  if (!usePerfCounters) return true;
+#if defined(__linux__)
+  if (perfCyclesFd<0)       perfCyclesFd       = openPerfCounter(PERF_COUNT_HW_CPU_CYCLES);
+  if (perfInstructionsFd<0) perfInstructionsFd = openPerfCounter(PERF_COUNT_HW_INSTRUCTIONS);
+  perfEnabled = perfCyclesFd>=0 && perfInstructionsFd>=0;
+  perfHeld    = true;
+  perfUsers++;
+  // do not keep a single counter open if the other could not be opened
+  if (!perfEnabled) releasePerfCounters();
+#endif
+  return perfEnabled;
+}
+
+void TaskProfiler::releasePerfCounters()
+{
+  perfEnabled = false;
+  if (!perfHeld) return;
+  perfHeld = false;
+  perfUsers--;
+  if (perfUsers>0) return;
+#if defined(__linux__)
+  if (perfCyclesFd>=0)       close(perfCyclesFd);
+  if (perfInstructionsFd>=0) close(perfInstructionsFd);
+#endif
+  perfCyclesFd       = -1;
+  perfInstructionsFd = -1;
+}
+
+double TaskProfiler::getCpuTime()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return double(ts.tv_sec) + 1.0E-9*double(ts.tv_nsec);
+#else
+  return double(clock())/double(CLOCKS_PER_SEC);
+#endif
+}
+
+void TaskProfiler::readPerfCounters(long long & nCycles, long long & nInstructions)
+{
+  nCycles       = 0;
+  nInstructions = 0;
+#if defined(__linux__)
+  if (read(perfCyclesFd, &nCycles, sizeof(nCycles))!=sizeof(nCycles)) nCycles = 0;
+  if (read(perfInstructionsFd, &nInstructions, sizeof(nInstructions))!=sizeof(nInstructions)) nInstructions = 0;
+#endif
+}
+
+void TaskProfiler::setValue(const String & name, double value)
+{
+  for (unsigned int k=0; k<valueNames.size(); k++)
+    {
+    if (valueNames[k]==name)
+      {
+      values[k] = value;
+      return;
+      }
+    }
+  valueNames.push_back(name);
+  values.push_back(value);
+}
+
+void TaskProfiler::add(const TaskProfiler & other, bool includeExecute, bool includeParticles)
+{
+  for (int phase=includeExecute ? 0 : 1; phase<NPhases; phase++)
+    {
+    calls[phase]        += other.calls[phase];
+    wallTime[phase]     += other.wallTime[phase];
+    cpuTime[phase]      += other.cpuTime[phase];
+    cycles[phase]       += other.cycles[phase];
+    instructions[phase] += other.instructions[phase];
+    }
+  if (includeParticles) nParticles += other.nParticles;
+  perfEnabled = perfEnabled || other.perfEnabled;
+}
+
+void TaskProfiler::reset()
+{
+  nParticles = 0;
+  for (int phase=0; phase<NPhases; phase++)
+    {
+    startCpu[phase]          = 0.0;
+    startCycles[phase]       = 0;
+    startInstructions[phase] = 0;
+    calls[phase]             = 0;
+    wallTime[phase]          = 0.0;
+    cpuTime[phase]           = 0.0;
+    cycles[phase]            = 0;
+    instructions[phase]      = 0;
+    }
+  valueNames.clear();
+  values.clear();
+}
+
+double TaskProfiler::getEventRate() const
+{
+  return wallTime[Execute]>0.0 ? double(calls[Execute])/wallTime[Execute] : 0.0;
+}
+
+double TaskProfiler::getParticleRate() const
+{
+  return wallTime[Execute]>0.0 ? double(nParticles)/wallTime[Execute] : 0.0;
+}
+
+const char * TaskProfiler::getPhaseName(int phase)
+{
+  switch (phase)
+    {
+      case Execute: return "Execute";
+      case Import:  return "Import";
+      case Create:  return "Create";
+      case Analyze: return "Analyze";
+      case Export:  return "Export";
+      default:      return "Unknown";
+    }
+}
+
+void TaskProfiler::print(ostream & output, const String & taskName) const
+{
+  output << "Task: " << taskName << "  events/s: " << getEventRate() << "  particles/s: " << getParticleRate() << endl;
+  for (int phase=0; phase<NPhases; phase++)
+    {
+    if (calls[phase]==0) continue;
+    output << "   " << setw(10) << left << getPhaseName(phase) << right
+    << " calls: "   << setw(10) << calls[phase]
+    << " wall(s): " << setw(12) << wallTime[phase]
+    << " cpu(s): "  << setw(12) << cpuTime[phase];
+    if (perfEnabled)
+      {
+      output << " cycles: " << cycles[phase] << " instructions: " << instructions[phase];
+      if (cycles[phase]>0) output << " IPC: " << double(instructions[phase])/double(cycles[phase]);
+      }
+    output << endl;
+    }
+  for (unsigned int k=0; k<valueNames.size(); k++)
+    output << "   " << valueNames[k] << ": " << values[k] << endl;
+}
+
+void TaskProfiler::writeJson(ostream & output, const String & indent) const
+{
+  output << indent << "\"eventsPerSecond\": " << getEventRate() << "," << endl;
+  output << indent << "\"particlesPerSecond\": " << getParticleRate() << "," << endl;
+  output << indent << "\"particles\": " << nParticles << "," << endl;
+  output << indent << "\"phases\": {";
+  bool first = true;
+  for (int phase=0; phase<NPhases; phase++)
+    {
+    if (calls[phase]==0) continue;
+    output << (first ? "" : ",") << endl;
+    output << indent << "  \"" << getPhaseName(phase) << "\": { \"calls\": " << calls[phase]
+    << ", \"wall\": " << wallTime[phase] << ", \"cpu\": " << cpuTime[phase];
+    if (perfEnabled) output << ", \"cycles\": " << cycles[phase] << ", \"instructions\": " << instructions[phase];
+    output << " }";
+    first = false;
+    }
+  output << endl << indent << "}," << endl;
+  output << indent << "\"values\": {";
+  for (unsigned int k=0; k<valueNames.size(); k++)
+    {
+    output << (k==0 ? "" : ",") << endl;
+    output << indent << "  \"" << valueNames[k] << "\": " << values[k];
+    }
+  output << endl << indent << "}";
+}
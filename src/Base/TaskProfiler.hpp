@@ -0,0 +1,190 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__TaskProfiler
+#define CAP__TaskProfiler
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include "TObject.h"
+#include "Aliases.hpp"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace CAP
+{
+
+//!
+//! Per-task performance accumulator. For each phase of a task (execute, event import, event creation, event analysis, event export),
+//! the profiler accumulates the number of calls, the wall time, and the CPU time of the calling thread and, optionally, the number of
+//! CPU cycles and instructions retired read from Linux perf_event hardware counters. It also counts the particles processed and holds
+//! named values (e.g., factory occupancy) reported by the task. Profilers are disabled by default and cost a single test per phase
+//! when disabled. The execute phase is timed by the caller and includes the subtasks of the task; the other phases are exclusive.
+//!
+class TaskProfiler
+{
+public:
+
+  enum Phase { Execute=0, Import, Create, Analyze, Export, NPhases };
+
+  //!
+  //! CTOR
+  //!
+  TaskProfiler();
+
+  //!
+  //! Copy CTOR: the copy holds the counts, times, and values of the source but does not hold the hardware counters.
+  //!
+  TaskProfiler(const TaskProfiler & source);
+
+  //!
+  //! DTOR: release the hardware counters, which are closed when no profiler uses them anymore.
+  //!
+  virtual ~TaskProfiler();
+
+  TaskProfiler & operator=(const TaskProfiler & source);
+
+  //!
+  //! Enable this profiler and, if requested and available, the hardware counters. Returns false if hardware counters were requested
+  //! but could not be opened (e.g., not on Linux or insufficient perf_event permissions); timing is enabled regardless.
+  //!
+  bool enable(bool usePerfCounters);
+
+  inline void disable()
+  {
+  enabled = false;
+  releasePerfCounters();
+  }
+
+  inline bool isEnabled() const
+  {
+  return enabled;
+  }
+
+  inline void start(int phase)
+  {
+  startWall[phase] = steady_clock::now();
+  startCpu[phase]  = getCpuTime();
+  if (perfEnabled) readPerfCounters(startCycles[phase],startInstructions[phase]);
+  }
+
+  inline void stop(int phase)
+  {
+  wallTime[phase] += duration<double>(steady_clock::now()-startWall[phase]).count();
+  cpuTime[phase]  += getCpuTime()-startCpu[phase];
+  if (perfEnabled)
+    {
+    long long c, i;
+    readPerfCounters(c,i);
+    cycles[phase]       += c-startCycles[phase];
+    instructions[phase] += i-startInstructions[phase];
+    }
+  calls[phase]++;
+  }
+
+  //!
+  //! Count the given number of particles read from the given source (e.g., an event stream). Tasks sharing a source are counted
+  //! once in aggregated profiles.
+  //!
+  inline void addParticles(long n, const void * source)
+  {
+  nParticles     += n;
+  particleSource  = source;
+  }
+
+  inline const void * getParticleSource() const
+  {
+  return particleSource;
+  }
+
+  //!
+  //! Set the named value (created if needed).
+  //!
+  void setValue(const String & name, double value);
+
+  //!
+  //! Add the counts and times of the given profiler to this one. The execute phase is added only if includeExecute is true and
+  //! the particle count only if includeParticles is true.
+  //!
+  void add(const TaskProfiler & other, bool includeExecute, bool includeParticles=true);
+
+  //!
+  //! Clear all counts, times, and values.
+  //!
+  void reset();
+
+  inline long   getCalls(int phase) const        { return calls[phase];    }
+  inline double getWallTime(int phase) const     { return wallTime[phase]; }
+  inline double getCpuTime(int phase) const      { return cpuTime[phase];  }
+  inline long   getNParticles() const            { return nParticles;      }
+
+  //!
+  //! Executions (events) and particles processed per second of execute wall time.
+  //!
+  double getEventRate() const;
+  double getParticleRate() const;
+
+  //!
+  //! Print a one-block summary of this profiler.
+  //!
+  void print(ostream & output, const String & taskName) const;
+
+  //!
+  //! Write the content of this profiler as JSON object members (no enclosing braces) with the given indentation.
+  //!
+  void writeJson(ostream & output, const String & indent) const;
+
+  static const char * getPhaseName(int phase);
+
+  //!
+  //! CPU time of the calling thread, in seconds.
+  //!
+  static double getCpuTime();
+
+protected:
+
+  static void readPerfCounters(long long & nCycles, long long & nInstructions);
+
+  //!
+  //! Release the hardware counters held by this profiler and close them if no other profiler holds them.
+  //!
+  void releasePerfCounters();
+
+  void copyCounts(const TaskProfiler & source);
+
+  bool enabled;
+  bool perfEnabled;
+  bool perfHeld;                //!< this profiler holds a reference to the shared perf_event counters
+  long nParticles;
+  const void * particleSource;  //!< source of the counted particles
+  steady_clock::time_point startWall[NPhases];
+  double    startCpu[NPhases];
+  long long startCycles[NPhases];
+  long long startInstructions[NPhases];
+  long      calls[NPhases];
+  double    wallTime[NPhases];
+  double    cpuTime[NPhases];
+  long long cycles[NPhases];
+  long long instructions[NPhases];
+  vector<String> valueNames;
+  vector<double> values;
+
+  static int perfCyclesFd;       //!< perf_event file descriptor (shared by all profilers) counting CPU cycles
+  static int perfInstructionsFd; //!< perf_event file descriptor (shared by all profilers) counting instructions
+  static int perfUsers;          //!< number of profilers holding the perf_event file descriptors
+
+  ClassDef(TaskProfiler,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__TaskProfiler */
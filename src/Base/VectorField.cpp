@@ -28,6 +28,7 @@
 
 #include "THGlobal.hpp"
 #include "VectorField.hpp"
+#include <algorithm>
 using CAP::VectorField;
 using CAP::Factory;
 // STATIC VARIABLES
@@ -50,7 +51,7 @@ double& VectorField::operator()(unsigned int iX, unsigned int iY, unsigned int i
     exit(1);
     }
   else
-    return field[iX][iY][iZ];
+    return field[iX*mStrideX + iY*mStrideY + iZ];
 }
 
 // CLASS FUNCTIONS
@@ -62,6 +63,7 @@ constValue(0.0),
 mXmin(0.0), mXampx(1.0), mXpts(0), mDi(0.0),
 mYmin(0.0), mYampx(1.0), mYpts(0), mDj(0.0),
 mZmin(0.0), mZampx(1.0), mZpts(0), mDk(0.0),
+mStrideX(0), mStrideY(0),
 field(nullptr)
 {
   // no field array initialization -- this field is constant type == 0
@@ -74,6 +76,7 @@ constValue(constValue),
 mXmin(0.0), mXampx(1.0), mXpts(0), mDi(0.0),
 mYmin(0.0), mYampx(1.0), mYpts(0), mDj(0.0),
 mZmin(0.0), mZampx(1.0), mZpts(0), mDk(0.0),
+mStrideX(0), mStrideY(0),
 field(nullptr)
 {
   // no field array initialization -- this field is constant type == 0
@@ -90,6 +93,7 @@ constValue(0.0),
 mXmin(aXmin), mXampx(aXampx), mXpts(aXpts), mDi(0.0),
 mYmin(aYmin), mYampx(aYampx), mYpts(aYpts), mDj(0.0),
 mZmin(aZmin), mZampx(aZampx), mZpts(aZpts), mDk(0.0),
+mStrideX(0), mStrideY(0),
 field(nullptr)
 {
   if(mXpts < 1) mXpts = 1;
@@ -103,7 +107,7 @@ field(nullptr)
   mDi = (mXpts - 1) / (mXampx - mXmin);
   mDj = (mYpts - 1) / (mYampx - mYmin);
   mDk = (mZpts - 1) / (mZampx - mZmin);
-  initialize(mXpts, mYpts, mYpts,initValue);
+  initialize(mXpts, mYpts, mZpts,initValue);
 }
 
 VectorField::VectorField(const VectorField& field)
@@ -113,10 +117,14 @@ constValue(field.constValue),
 mXmin(field.mXmin), mXampx(field.mXampx), mXpts(field.mXpts), mDi(field.mDi),
 mYmin(field.mYmin), mYampx(field.mYampx), mYpts(field.mYpts), mDj(field.mDj),
 mZmin(field.mZmin), mZampx(field.mZampx), mZpts(field.mZpts), mDk(field.mDk),
+mStrideX(0), mStrideY(0),
 field(nullptr)
 {
   if (getType()==1 || mXpts>0)
-    initialize(mXpts, mYpts, mYpts);
+    {
+    initialize(mXpts, mYpts, mZpts);
+    if (field.field) std::copy(field.field, field.field + mXpts*mStrideX, this->field);
+    }
 }
 
 VectorField::~VectorField()
@@ -129,17 +137,11 @@ void VectorField::initialize(unsigned int nX, unsigned int nY, unsigned int nZ,
   if (field) clear();
   setType(1);
   constValue = 0;
-  field = new double** [nX];
-  for (unsigned int i=0; i<nX; i++)
-    {
-    field[i] = new double* [nY];
-    for (unsigned int j=0; j<nY; j++)
-      {
-      field[i][j] = new double [nZ];
-      for (unsigned int k=0; k<nZ; k++)
-        field[i][j][k] = initialValue;
-      }
-    }
+  mStrideY = nZ;
+  mStrideX = nY*nZ;
+  unsigned int size = nX*mStrideX;
+  field = new double[size];
+  std::fill(field, field+size, initialValue);
 }
 
 void VectorField::reset(double value)
@@ -147,30 +149,13 @@ void VectorField::reset(double value)
   if (getType()==0)
     constValue = value;
   else
-    {
-    for (unsigned int i=0; i<mXpts; i++)
-      {
-      for (unsigned int j=0; j<mYpts; j++)
-        {
-        for (unsigned int k=0; k<mZpts; k++)
-          field[i][j][k] = value;
-        }
-      }
-    }
+    std::fill(field, field+mXpts*mStrideX, value);
 }
 
 void VectorField::clear()
 {
-  if (field)
-    {
-    for (unsigned int i=0; i<mXpts; i++)
-      {
-      for (unsigned int j=0; j<mYpts; j++)
-        delete[] field[i][j];
-      delete[] field[i];
-      }
-    delete[] field;
-    }
+  delete[] field;
+  field = nullptr;
 }
 
 
@@ -188,6 +173,7 @@ void VectorField::setValue(const VectorField & field)
   mYmin = field.mYmin; mYampx = field.mYampx; mYpts = field.mYpts; mDj = field.mDj;
   mZmin = field.mZmin; mZampx = field.mZampx; mZpts = field.mZpts; mDk = field.mDk;
   initialize(mXpts,mYpts,mZpts);
+  if (field.field) std::copy(field.field, field.field + mXpts*mStrideX, this->field);
 }
 
 void VectorField::setValue(const TString & aName,
@@ -214,7 +200,7 @@ void VectorField::setValue(const TString & aName,
   mDi = (mXpts - 1) / (mXampx - mXmin);
   mDj = (mYpts - 1) / (mYampx - mYmin);
   mDk = (mZpts - 1) / (mZampx - mZmin);
-  initialize(mXpts, mYpts, mYpts,initValue);
+  initialize(mXpts, mYpts, mZpts,initValue);
 }
 
 double VectorField::getValue() const
@@ -229,7 +215,7 @@ double VectorField::getValueAt(unsigned int iX, unsigned int iY, unsigned int iZ
   else if (iX>=mXpts || iY>=mYpts || iZ>=mZpts)
     return -1.0E50;
   else
-    return field[iX][iY][iZ];
+    return field[iX*mStrideX + iY*mStrideY + iZ];
 }
 
 double VectorField::getValueAt(double aX, double aY, double aZ) const
@@ -259,7 +245,48 @@ double VectorField::interpolate(double aX, double aY, double aZ) const
   else if (mXpts>1)
     return interpolate1D(aX);
   else
-    return field[0][0][0];
+    return field[0];
+}
+
+void VectorField::interpolate(unsigned int nPoints, const double * aX, const double * aY, const double * aZ, double * values) const
+{
+  double ti, tj, tk;
+  if (type==0)
+    {
+    std::fill(values, values+nPoints, constValue);
+    return;
+    }
+  for (unsigned int iPoint=0; iPoint<nPoints; iPoint++)
+    {
+    unsigned int idx = locate(aX[iPoint], aY[iPoint], aZ[iPoint], ti, tj, tk);
+    values[iPoint] = interpolateAt(idx, ti, tj, tk);
+    }
+}
+
+void VectorField::interpolate(unsigned int nFields, const VectorField * const * fields, double aX, double aY, double aZ, double * values)
+{
+  if (nFields<1) return;
+  const VectorField & reference = *fields[0];
+  double ti, tj, tk;
+  unsigned int idx = reference.locate(aX, aY, aZ, ti, tj, tk);
+  for (unsigned int iField=0; iField<nFields; iField++)
+    {
+    const VectorField & f = *fields[iField];
+    if (f.type==0)
+      values[iField] = f.constValue;
+    else if (f.hasSameGrid(reference))
+      values[iField] = f.interpolateAt(idx, ti, tj, tk);
+    else
+      values[iField] = f.interpolate(aX, aY, aZ);
+    }
+}
+
+bool VectorField::hasSameGrid(const VectorField & other) const
+{
+  return type==1 && other.type==1 &&
+  mXpts==other.mXpts && mXmin==other.mXmin && mXampx==other.mXampx &&
+  mYpts==other.mYpts && mYmin==other.mYmin && mYampx==other.mYampx &&
+  mZpts==other.mZpts && mZmin==other.mZmin && mZampx==other.mZampx;
 }
 
 VectorField* VectorField::DerivativeX(const char* aName)
@@ -275,7 +302,7 @@ VectorField* VectorField::DerivativeX(const char* aName)
     ti = initDerivative(i, mXmin, mXampx, mXpts);
     for (unsigned int j=0; j<mYpts; j++)
       for (unsigned int k=0; k<mZpts; k++)
-	(*tVec)(i,j,k) = derivative(field[ti-1][j][k], field[ti][j][k], field[ti+1][j][k]);
+	(*tVec)(i,j,k) = derivative(field[(ti-1)*mStrideX + j*mStrideY + k], field[ti*mStrideX + j*mStrideY + k], field[(ti+1)*mStrideX + j*mStrideY + k]);
   }
   return tVec;
 }
@@ -292,7 +319,7 @@ VectorField* VectorField::DerivativeY(const char* aName)
     for (unsigned int j=0; j<mYpts; j++) {
       tj = initDerivative(j, mYmin, mYampx, mYpts);
       for (unsigned int k=0; k<mZpts; k++)
-	(*tVec)(i,j,k) = derivative(field[i][tj-1][k], field[i][tj][k], field[i][tj+1][k]);
+	(*tVec)(i,j,k) = derivative(field[i*mStrideX + (tj-1)*mStrideY + k], field[i*mStrideX + tj*mStrideY + k], field[i*mStrideX + (tj+1)*mStrideY + k]);
     }
   return tVec;
 }
@@ -309,52 +336,40 @@ VectorField* VectorField::DerivativeZ(const char* aName)
     for (unsigned int j=0; j<mYpts; j++)
       for (unsigned int k=0; k<mZpts; k++) {
 	tk = initDerivative(k, mZmin, mZampx, mZpts);
-	(*tVec)(i,j,k) = derivative(field[i][j][tk-1], field[i][j][tk], field[i][j][tk+1]);
+	(*tVec)(i,j,k) = derivative(field[i*mStrideX + j*mStrideY + tk-1], field[i*mStrideX + j*mStrideY + tk], field[i*mStrideX + j*mStrideY + tk+1]);
       }
   return tVec;
 }
 
 double VectorField::interpolate1D(double aX)  const
 {
-  unsigned int    i, j, k;
+  unsigned int    i;
   double ti;
 
   ti = (aX - mXmin) * mDi;	i = (unsigned int) ti;	if(i+1 > mXpts-1) i--;	ti -= i;
-  j  = 0;
-  k  = 0;
+  const double * f = field + i*mStrideX;
   return
-    field[i  ][j  ][k  ] * (1-ti) + field[i+1][j  ][k  ] * ti;
+    f[0] * (1-ti) + f[mStrideX] * ti;
 }
 
 double VectorField::interpolate2D(double aX, double aY) const
 {
-  unsigned int    i, j, k;
+  unsigned int    i, j;
   double ti,tj;
 
   ti = (aX - mXmin) * mDi;	i = (unsigned int) ti;	if(i+1 > mXpts-1) i--;	ti -= i;
   tj = (aY - mYmin) * mDj;	j = (unsigned int) tj;	if(j+1 > mYpts-1) j--;	tj -= j;
-  k  = 0;
+  const double * f = field + i*mStrideX + j*mStrideY;
   return
-    (field[i  ][j  ][k  ] * (1-ti) + field[i+1][j  ][k  ] * ti) * (1-tj) +
-    (field[i  ][j+1][k  ] * (1-ti) + field[i+1][j+1][k  ] * ti) *    tj;
+    (f[0       ] * (1-ti) + f[mStrideX         ] * ti) * (1-tj) +
+    (f[mStrideY] * (1-ti) + f[mStrideX+mStrideY] * ti) *    tj;
 }
 
 double VectorField::interpolate3D(double aX, double aY, double aZ)  const
 {
-  unsigned int    i, j, k;
   double ti,tj,tk;
-
-  ti = (aX - mXmin) * mDi;	i = (unsigned int) ti;	if(i+1 > mXpts-1) i--;	ti -= i;
-  tj = (aY - mYmin) * mDj;	j = (unsigned int) tj;	if(j+1 > mYpts-1) j--;	tj -= j;
-  tk = (aZ - mZmin) * mDk;	k = (unsigned int) tk;	if(k+1 > mZpts-1) k--;	tk -= k;
-  return
-    (
-      (field[i  ][j  ][k  ] * (1-ti) + field[i+1][j  ][k  ] * ti) * (1-tj) +
-      (field[i  ][j+1][k  ] * (1-ti) + field[i+1][j+1][k  ] * ti) *    tj
-    ) * (1-tk) + (
-      (field[i  ][j  ][k+1] * (1-ti) + field[i+1][j  ][k+1] * ti) * (1-tj) +
-      (field[i  ][j+1][k+1] * (1-ti) + field[i+1][j+1][k+1] * ti) *    tj
-    ) *    tk;
+  unsigned int idx = locate(aX, aY, aZ, ti, tj, tk);
+  return interpolateAt(idx, ti, tj, tk);
 }
 
 inline int VectorField::initDerivative(int aIdx, double aAMin, double aAampx, int aAPts)
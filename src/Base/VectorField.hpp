@@ -80,6 +80,10 @@ public:
   int         getZPts() const;
 
   double	interpolate(double aX, double aY, double aZ) const;
+  void    interpolate(unsigned int nPoints, const double * aX, const double * aY, const double * aZ, double * values) const;
+  static void interpolate(unsigned int nFields, const VectorField * const * fields, double aX, double aY, double aZ, double * values);
+  bool    hasSameGrid(const VectorField & other) const;
+  const double * getData() const { return field; }
   VectorField*	DerivativeX(const char* aName);
   VectorField*	DerivativeY(const char* aName);
   VectorField*	DerivativeZ(const char* aName);
@@ -94,6 +98,40 @@ protected:
   double	interpolate2D(double aX, double aY)  const;
   double	interpolate3D(double aX, double aY, double aZ) const;
 
+  //!
+  //! Locate the lower grid corner (as a flat index into field) and the fractional weights of the
+  //! given point. Points of lower dimension fields get zero weights along the unused axes.
+  //!
+  inline unsigned int locate(double aX, double aY, double aZ, double & ti, double & tj, double & tk) const
+  {
+  unsigned int i = 0, j = 0, k = 0;
+  ti = tj = tk = 0.0;
+  if (mXpts>1) { ti = (aX - mXmin) * mDi;	i = (unsigned int) ti;	if(i+1 > mXpts-1) i--;	ti -= i; }
+  if (mYpts>1) { tj = (aY - mYmin) * mDj;	j = (unsigned int) tj;	if(j+1 > mYpts-1) j--;	tj -= j; }
+  if (mZpts>1) { tk = (aZ - mZmin) * mDk;	k = (unsigned int) tk;	if(k+1 > mZpts-1) k--;	tk -= k; }
+  return i*mStrideX + j*mStrideY + k;
+  }
+
+  //!
+  //! Trilinear combination of the 8 corners anchored at the flat index \a idx. Strides are zeroed
+  //! along axes with a single point so the same expression serves 1D, 2D and 3D fields.
+  //!
+  inline double interpolateAt(unsigned int idx, double ti, double tj, double tk) const
+  {
+  const double * f = field + idx;
+  const unsigned int sx = (mXpts>1) ? mStrideX : 0;
+  const unsigned int sy = (mYpts>1) ? mStrideY : 0;
+  const unsigned int sz = (mZpts>1) ? 1 : 0;
+  return
+    (
+      (f[0      ] * (1-ti) + f[sx      ] * ti) * (1-tj) +
+      (f[sy     ] * (1-ti) + f[sx+sy   ] * ti) *    tj
+    ) * (1-tk) + (
+      (f[sz     ] * (1-ti) + f[sx+sz   ] * ti) * (1-tj) +
+      (f[sy+sz  ] * (1-ti) + f[sx+sy+sz] * ti) *    tj
+    ) *    tk;
+  }
+
   inline int	  initDerivative(int aIdx, double aAMin, double aAampx, int aAPts);
   inline double derivative(double aFin, double aFi, double aFip);
 
@@ -114,7 +152,11 @@ protected:
   unsigned int mZpts;
   double mDk;
 
-  double***  field;
+  // field values are stored in a single contiguous array, row-major in (x,y,z):
+  // value(i,j,k) = field[i*mStrideX + j*mStrideY + k]
+  unsigned int mStrideX;
+  unsigned int mStrideY;
+  double *  field;
 
 
   // used by initDerivative() and derivative()
@@ -209,6 +251,28 @@ public:
  * @param [in] aY y-coordinate
  * @param [in] aZ z-coordinate
  *
+ * @fn void VectorField::interpolate(unsigned int nPoints, const double * aX, const double * aY, const double * aZ, double * values) const
+ * @brief Interpolates the vector field at nPoints points in one pass.
+ * @param [in] nPoints number of points
+ * @param [in] aX array of x-coordinates
+ * @param [in] aY array of y-coordinates
+ * @param [in] aZ array of z-coordinates
+ * @param [out] values array of (at least nPoints) interpolated values
+ *
+ * @fn void VectorField::interpolate(unsigned int nFields, const VectorField * const * fields, double aX, double aY, double aZ, double * values)
+ * @brief Interpolates several vector fields at the same point. The grid index and interpolation weights
+ * are computed once and shared by all fields defined on the same grid as the first one; other fields are
+ * interpolated individually.
+ * @param [in] nFields number of fields
+ * @param [in] fields array of pointers to the fields
+ * @param [in] aX x-coordinate
+ * @param [in] aY y-coordinate
+ * @param [in] aZ z-coordinate
+ * @param [out] values array of (at least nFields) interpolated values
+ *
+ * @fn bool VectorField::hasSameGrid(const VectorField & other) const
+ * @brief Returns true if the other field is defined on the same grid (limits and number of points) as this one.
+ *
  * @fn VectorField* VectorField::DerivativeX(const char* aName)
  * @brief Calculates the derivative of the vector field along the X-axis
  * @param [in] aName name of the derived vector field
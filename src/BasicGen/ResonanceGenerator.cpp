@@ -180,6 +180,7 @@ void ResonanceGenerator::generate(Particle * parentInteraction)
     LorentzVector parentMomentum;
     parentMomentum.SetPxPyPzE (px,py,pz,e);
     parent->set(parentType,parentMomentum,parentPosition,false);
+    parent->setKinematics(pt,asinh(pz/pt),phi,y,mt);
 
     Particle * child1 = particleFactory->getNextObject();
     Particle * child2 = particleFactory->getNextObject();
@@ -0,0 +1,44 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <iostream>
+#include "Configuration.hpp"
+#include "Exceptions.hpp"
+#include "RunBenchmark.hpp"
+using namespace std;
+
+//!
+//! Benchmark driver: CapBenchmark [configurationPath configurationFile]
+//! Without arguments, the benchmark runs with its default configuration (see RunBenchmark).
+//!
+int main(int argc, char ** argv)
+{
+  CAP::Configuration configuration;
+  try
+  {
+  if (argc>2)
+    {
+    cout << "Configuration path......... : " << argv[1] << endl;
+    cout << "Configuration file......... : " << argv[2] << endl;
+    configuration.readFromFile(argv[1],argv[2]);
+    }
+  CAP::RunBenchmark * benchmark = new CAP::RunBenchmark("Benchmark", configuration);
+  benchmark->configure();
+  benchmark->execute();
+  delete benchmark;
+  }
+  catch (CAP::Exception exception)
+  {
+  exception.print();
+  return 1;
+  }
+  return 0;
+}
@@ -5,4 +5,5 @@
 #pragma link C++ class CAP::RunAnalysis+;
 #pragma link C++ class CAP::RunDerivedCalculation+;
 #pragma link C++ class CAP::RunSubsample+;
+#pragma link C++ class CAP::RunBenchmark+;
 #endif
@@ -9,6 +9,10 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <unistd.h>
+#include <csignal>
+#include <sys/wait.h>
+#include "TRandom.h"
 #include "RunAnalysis.hpp"
 #include "TaskIterator.hpp"
 #include "DerivedHistoIterator.hpp"
@@ -16,6 +20,7 @@
 #include "SubSampleStatCalculator.hpp"
 #include "ClosureIterator.hpp"
 #include "ParticleDbManager.hpp"
+#include "EventCacheTask.hpp"
 //#include "PythiaEventReader.hpp"
 #include "PythiaEventGenerator.hpp"
 //#include "HerwigEventReader.hpp"
@@ -32,6 +37,7 @@
 #include "ParticleSingleAnalyzer.hpp"
 #include "ParticlePairAnalyzer.hpp"
 #include "NuDynAnalyzer.hpp"
+#include "FlowAnalyzer.hpp"
 using CAP::RunAnalysis;
 
 ClassImp(RunAnalysis);
@@ -39,7 +45,13 @@ ClassImp(RunAnalysis);
 RunAnalysis::RunAnalysis(const String & _name,
                          const Configuration & _configuration)
 :
-EventTask(_name, _configuration)
+EventTask(_name, _configuration),
+nWorkers(1),
+workerLabel("Worker"),
+mergeWorkers(true),
+workerIndex(-1),
+workerPids(),
+analysisConfiguration()
 {
   appendClassName("RunAnalysis");
 }
@@ -55,6 +67,7 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("PartLabel",       TString("Part"));
   addParameter("PairLabel",       TString("Pair"));
   addParameter("NuDynLabel",      TString("NuDyn"));
+  addParameter("FlowLabel",       TString("Flow"));
   addParameter("SimAnaLabel",     TString("SimAna"));
   addParameter("RootExt",         TString(".root"));
   addParameter("DerivedLabel",    TString("Derived"));
@@ -72,6 +85,7 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("TherminatorLabel",TString("Therminator"));
   addParameter("ResoLabel",       TString("RESO"));
   addParameter("PerformLabel",    TString("Perform"));
+  addParameter("EventCacheLabel", TString("EventCache"));
 
   //  addParameter("histoModelDataName",      TString("none"));
   //  addParameter("histoAnalyzerName",       TString("none"));
@@ -110,6 +124,9 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("RunPartPairAnalysisReco",    NO);
   addParameter("RunNuDynAnalysisGen",        NO);
   addParameter("RunNuDynAnalysisReco",       NO);
+  addParameter("RunFlowAnalysisGen",         NO);
+  addParameter("RunFlowAnalysisReco",        NO);
+  addParameter("RunEventCache",              NO);
   addParameter("RunFillEta",                 NO);
   addParameter("RunFillY",                   YES);
   addParameter("nEventsPerSubbunch",      long(100));
@@ -121,6 +138,9 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("EventsUseStream1",         false);
   addParameter("SetSeed",                 true);
   addParameter("SeedValue",               long(121212121));
+  addParameter("nWorkers",                int(1));
+  addParameter("WorkerLabel",             TString("Worker"));
+  addParameter("MergeWorkers",            YES);
 
   addParameter("EventFilterModelOption",     TString("All"));
   addParameter("EventFilterModelNValues",    0);
@@ -137,6 +157,14 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("EventFilterModelValue10",     0.0);
   addParameter("EventFilterModelValue11",     0.0);
   addParameter("EventFilterModelValue12",     0.0);
+  addParameter("EventFilterModelValue13",     0.0);
+  addParameter("EventFilterModelValue14",     0.0);
+  addParameter("EventFilterModelValue15",     0.0);
+  addParameter("EventFilterModelValue16",     0.0);
+  addParameter("EventFilterModelValue17",     0.0);
+  addParameter("EventFilterModelValue18",     0.0);
+  addParameter("EventFilterModelValue19",     0.0);
+  addParameter("EventFilterModelValue20",     0.0);
 
   addParameter("EventFilterAnaOption",     TString("All"));
   addParameter("EventFilterAnaNValues",    0);
@@ -153,6 +181,14 @@ void RunAnalysis::setDefaultConfiguration()
   addParameter("EventFilterAnaValue10",     0.0);
   addParameter("EventFilterAnaValue11",     0.0);
   addParameter("EventFilterAnaValue12",     0.0);
+  addParameter("EventFilterAnaValue13",     0.0);
+  addParameter("EventFilterAnaValue14",     0.0);
+  addParameter("EventFilterAnaValue15",     0.0);
+  addParameter("EventFilterAnaValue16",     0.0);
+  addParameter("EventFilterAnaValue17",     0.0);
+  addParameter("EventFilterAnaValue18",     0.0);
+  addParameter("EventFilterAnaValue19",     0.0);
+  addParameter("EventFilterAnaValue20",     0.0);
 
   addParameter("PartFilterModelOption",     TString("All"));
   addParameter("PartFilterModelPt",         true);
@@ -191,6 +227,7 @@ void RunAnalysis::configure()
   String PartLabel        = getValueString("PartLabel");
   String PairLabel        = getValueString("PairLabel");
   String NuDynLabel       = getValueString("NuDynLabel");
+  String FlowLabel        = getValueString("FlowLabel");
   String SimAnaLabel      = getValueString("SimAnaLabel");
   String RootExt          = getValueString("RootExt");
   String DerivedLabel     = getValueString("DerivedLabel");
@@ -208,6 +245,7 @@ void RunAnalysis::configure()
   String TherminatorLabel = getValueString("TherminatorLabel");
   String ResoLabel        = getValueString("ResoLabel");
   String PerformLabel     = getValueString("PerformLabel");
+  String EventCacheLabel  = getValueString("EventCacheLabel");
   bool    runParticleDbManager            = getValueBool("RunParticleDbManager");
   bool    runEventAnalysis                = getValueBool("RunEventAnalysis");
   bool    runEventAnalysisGen             = getValueBool("RunEventAnalysisGen");
@@ -227,6 +265,7 @@ void RunAnalysis::configure()
   bool    runPerformanceAna               = getValueBool("RunPerformanceAna");
   bool    runClosure                      = getValueBool("RunClosure");
   bool    runPythiaGenerator              = getValueBool("RunPythiaGenerator");
+  bool    runEventCache                   = getValueBool("RunEventCache");
   bool    runPythiaReader                 = getValueBool("RunPythiaReader");
   bool    runHerwigGenerator              = getValueBool("RunHerwigGenerator");
   bool    runHerwigReader                 = getValueBool("RunHerwigReader");
@@ -248,6 +287,8 @@ void RunAnalysis::configure()
   bool    runPartPairAnalysisReco         = getValueBool("RunPartPairAnalysisReco");
   bool    runNuDynAnalysisGen             = getValueBool("RunNuDynAnalysisGen");
   bool    runNuDynAnalysisReco            = getValueBool("RunNuDynAnalysisReco");
+  bool    runFlowAnalysisGen              = getValueBool("RunFlowAnalysisGen");
+  bool    runFlowAnalysisReco             = getValueBool("RunFlowAnalysisReco");
   bool    runFillEta                      = getValueBool("RunFillEta");
   bool    runFillY                        = getValueBool("RunFillY");
   String inputPathName                    = getValueString("HistogramsImportPath");
@@ -274,6 +315,9 @@ void RunAnalysis::configure()
   double partFilterAnaMaxY                = getValueDouble("PartFilterAnaMaxY");
   bool   setSeed                          = getValueBool(  "SetSeed");
   long   seedValue                        = getValueLong(  "SeedValue");
+  nWorkers                                = getValueInt(   "nWorkers");
+  workerLabel                             = getValueString("WorkerLabel");
+  mergeWorkers                            = getValueBool(  "MergeWorkers");
 
 //  if (reportDebug(__FUNCTION__)) printConfiguration(cout);
 
@@ -285,6 +329,7 @@ void RunAnalysis::configure()
     printItem("PartLabel",PartLabel);
     printItem("PairLabel",PairLabel);
     printItem("NuDynLabel",NuDynLabel);
+    printItem("FlowLabel",FlowLabel);
     printItem("SimAnaLabel",SimAnaLabel);
     printItem("RootExt",RootExt);
     printItem("DerivedLabel",DerivedLabel);
@@ -302,6 +347,7 @@ void RunAnalysis::configure()
     printItem("TherminatorLabel",TherminatorLabel);
     printItem("ResoLabel",ResoLabel);
     printItem("PerformLabel",PerformLabel);
+    printItem("EventCacheLabel",EventCacheLabel);
     printItem("RunParticleDbManager",runParticleDbManager);
     printItem("RunEventAnalysis",runEventAnalysis);
     printItem("RunEventAnalysisGen",runEventAnalysisGen);
@@ -315,6 +361,7 @@ void RunAnalysis::configure()
     printItem("RunPerformanceAna",runPerformanceAna);
     printItem("RunClosure",runClosure);
     printItem("RunPythiaGenerator",runPythiaGenerator);
+    printItem("RunEventCache",runEventCache);
     printItem("RunPythiaReader",runPythiaReader);
     printItem("RunHerwigGenerator",runHerwigGenerator);
     printItem("RunHerwigReader",runHerwigReader);
@@ -336,6 +383,8 @@ void RunAnalysis::configure()
     printItem("RunPartPairAnalysisReco",runPartPairAnalysisReco);
     printItem("RunNuDynAnalysisGen",runNuDynAnalysisGen);
     printItem("RunNuDynAnalysisReco",runNuDynAnalysisReco);
+    printItem("RunFlowAnalysisGen",runFlowAnalysisGen);
+    printItem("RunFlowAnalysisReco",runFlowAnalysisReco);
     printItem("RunFillEta",runFillEta);
     printItem("RunFillY",runFillY);
     printItem("HistogramsImportPath",inputPathName);
@@ -362,6 +411,9 @@ void RunAnalysis::configure()
     printItem("PartFilterAnaMaxY",partFilterAnaMaxY);
     printItem("SetSeed",setSeed);
     printItem("SeedValue",seedValue);
+    printItem("nWorkers",nWorkers);
+    printItem("WorkerLabel",workerLabel);
+    printItem("MergeWorkers",mergeWorkers);
     cout << endl;
     }
 
@@ -380,13 +432,16 @@ void RunAnalysis::configure()
     {
     String key = "EventFilterModelValue";
     key += k;
-    modelBounds.push_back( getValueBool(key));
+    modelBounds.push_back( getValueDouble(key));
     }
   if (eventFilterModelOption.EqualTo("All"))                   eventFilterModels = EventFilter::createOpenEventFilter();
   else if (eventFilterModelOption.EqualTo("AliceMB"))          eventFilterModels = EventFilter::createAliceMBEventFilter();
   else if (eventFilterModelOption.EqualTo("ImpactParameter"))  eventFilterModels = EventFilter::createImpactParameterFilters(modelBounds);
   else if (eventFilterModelOption.EqualTo("V0Mult"))           eventFilterModels = EventFilter::createV0MultiplicityFilters(modelBounds);
   else if (eventFilterModelOption.EqualTo("TpcMult"))          eventFilterModels = EventFilter::createTpcMultiplicityFilters(modelBounds);
+  else if (eventFilterModelOption.EqualTo("ImpactParameterClasses"))  eventFilterModels = EventFilter::createEventClassFilters(EventClassifier::ImpactParameter,modelBounds);
+  else if (eventFilterModelOption.EqualTo("XSectionClasses"))         eventFilterModels = EventFilter::createEventClassFilters(EventClassifier::FractionalXSection,modelBounds);
+  else if (eventFilterModelOption.EqualTo("RefMultClasses"))          eventFilterModels = EventFilter::createEventClassFilters(EventClassifier::RefMultiplicity,modelBounds);
 
   vector<double> anaBounds;
   String eventFilterAnaOption = getValueString("EventFilterAnaOption");
@@ -395,13 +450,16 @@ void RunAnalysis::configure()
     {
     String key = "EventFilterAnaValue";
     key += k;
-    anaBounds.push_back( getValueBool(key));
+    anaBounds.push_back( getValueDouble(key));
     }
   if (eventFilterAnaOption.EqualTo("All"))                   eventFilterAnalysis = EventFilter::createOpenEventFilter();
   else if (eventFilterAnaOption.EqualTo("AliceMB"))          eventFilterAnalysis = EventFilter::createAliceMBEventFilter();
   else if (eventFilterAnaOption.EqualTo("ImpactParameter"))  eventFilterAnalysis = EventFilter::createImpactParameterFilters(anaBounds);
   else if (eventFilterAnaOption.EqualTo("V0Mult"))           eventFilterAnalysis = EventFilter::createV0MultiplicityFilters(anaBounds);
   else if (eventFilterAnaOption.EqualTo("TpcMult"))          eventFilterAnalysis = EventFilter::createTpcMultiplicityFilters(anaBounds);
+  else if (eventFilterAnaOption.EqualTo("ImpactParameterClasses"))  eventFilterAnalysis = EventFilter::createEventClassFilters(EventClassifier::ImpactParameter,anaBounds);
+  else if (eventFilterAnaOption.EqualTo("XSectionClasses"))         eventFilterAnalysis = EventFilter::createEventClassFilters(EventClassifier::FractionalXSection,anaBounds);
+  else if (eventFilterAnaOption.EqualTo("RefMultClasses"))          eventFilterAnalysis = EventFilter::createEventClassFilters(EventClassifier::RefMultiplicity,anaBounds);
 
   if (eventFilterAnalysis.size()<1)
     {
@@ -473,9 +531,34 @@ void RunAnalysis::configure()
     cout << "==================================================================================" << std::endl;
     }
 
+  analysisConfiguration = *requestedConfiguration;
+  workerIndex = -1;
+  if (nWorkers>1 && forkWorkers()<0)
+    {
+    // driver process: the analysis proper is carried out by the workers, the driver only merges their outputs.
+    if (mergeWorkers)
+      {
+      if (runGlobalAnalysisGen)      addMergeTask(outputPathName,GlobalLabel+GenLabel);
+      if (runSpherocityAnalysisGen)  addMergeTask(outputPathName,SpherocityLabel+GenLabel);
+      if (runPartSingleAnalysisGen)  addMergeTask(outputPathName,PartLabel+GenLabel);
+      if (runPartPairAnalysisGen)    addMergeTask(outputPathName,PairLabel+GenLabel);
+      if (runNuDynAnalysisGen)       addMergeTask(outputPathName,NuDynLabel+GenLabel);
+      if (runFlowAnalysisGen)        addMergeTask(outputPathName,FlowLabel+GenLabel);
+      if (runGlobalAnalysisReco)     addMergeTask(outputPathName,GlobalLabel+RecoLabel);
+      if (runSpherocityAnalysisReco) addMergeTask(outputPathName,SpherocityLabel+RecoLabel);
+      if (runPartSingleAnalysisReco) addMergeTask(outputPathName,PartLabel+RecoLabel);
+      if (runPartPairAnalysisReco)   addMergeTask(outputPathName,PairLabel+RecoLabel);
+      if (runNuDynAnalysisReco)      addMergeTask(outputPathName,NuDynLabel+RecoLabel);
+      if (runFlowAnalysisReco)       addMergeTask(outputPathName,FlowLabel+RecoLabel);
+      if (runPerformanceAna)         addMergeTask(outputPathName,SimAnaLabel);
+      }
+    runParticleDbManager = false;
+    runEventAnalysis     = false;
+    }
+
   if (runParticleDbManager)
     {
-    ParticleDbManager * particleDbManager = new ParticleDbManager("ParticleDb",*requestedConfiguration);
+    ParticleDbManager * particleDbManager = new ParticleDbManager("ParticleDb",analysisConfiguration);
     addSubTask(particleDbManager);
     }
 
@@ -489,33 +572,42 @@ void RunAnalysis::configure()
       cout << "Setting up event analysis" << std::endl;
       cout << "==================================================================================" << std::endl;
       }
-    eventAnalysis = new TaskIterator("Analysis",*requestedConfiguration);
+    eventAnalysis = new TaskIterator("Analysis",analysisConfiguration);
     addSubTask(eventAnalysis);
 
-    //if (runPythiaReader)         eventAnalysis->addSubTask(new PythiaEventReader(PythiaLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-    if (runPythiaGenerator)      eventAnalysis->addSubTask(new PythiaEventGenerator(PythiaLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-//    if (runHerwigReader)         eventAnalysis->addSubTask(new HerwigEventReader(HerwigLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-    if (runAmptReader)           eventAnalysis->addSubTask(new AmptEventReader(AmptLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-//    if (runEposReader)           eventAnalysis->addSubTask(new EposEventReader(EposLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-//    if (runUrqmdReader)          eventAnalysis->addSubTask(new UrqmdEventReader(UrqmdLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-//    if (runHijingReader)         eventAnalysis->addSubTask(new HijingEventReader(HijingLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-    if (runTherminatorGenerator) eventAnalysis->addSubTask(new TherminatorGenerator(TherminatorLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-    if (runResonanceGenerator)   eventAnalysis->addSubTask(new ResonanceGenerator(ResoLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-
-    if (runPerformanceSim)       eventAnalysis->addSubTask(new MeasurementPerformanceSimulator(PerformLabel,*requestedConfiguration,eventFilterModels,particleFiltersModels));
-
-    if (runGlobalAnalysisGen)       eventAnalysis->addSubTask(new GlobalAnalyzer(GlobalLabel+GenLabel, *requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runSpherocityAnalysisGen)   eventAnalysis->addSubTask(new TransverseSpherocityAnalyzer(SpherocityLabel+GenLabel, *requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runPartSingleAnalysisGen)   eventAnalysis->addSubTask(new ParticleSingleAnalyzer(PartLabel+GenLabel, *requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runPartPairAnalysisGen)     eventAnalysis->addSubTask(new ParticlePairAnalyzer(PairLabel+GenLabel, *requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runNuDynAnalysisGen)        eventAnalysis->addSubTask(new NuDynAnalyzer(NuDynLabel+GenLabel,*requestedConfiguration,eventFilterAnalysis,particleFiltersAnalysis));
-
-    if (runGlobalAnalysisReco)      eventAnalysis->addSubTask(new GlobalAnalyzer(GlobalLabel+RecoLabel,*requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runSpherocityAnalysisReco)  eventAnalysis->addSubTask(new TransverseSpherocityAnalyzer(SpherocityLabel+RecoLabel, *requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runPartSingleAnalysisReco)  eventAnalysis->addSubTask(new ParticleSingleAnalyzer(PartLabel+RecoLabel, *requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runPartPairAnalysisReco)    eventAnalysis->addSubTask(new ParticlePairAnalyzer(PairLabel+RecoLabel, *requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
-    if (runNuDynAnalysisReco)       eventAnalysis->addSubTask(new NuDynAnalyzer(NuDynLabel+RecoLabel,*requestedConfiguration,eventFilterAnalysis,particleFiltersAnalysis));
-    if (runPerformanceAna)          eventAnalysis->addSubTask(new ParticlePerformanceAnalyzer(SimAnaLabel,*requestedConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    // the generators and readers are replaced by the event cache once it holds a complete sample, i.e., from the second analysis
+    // pass run in this process
+    bool replayEventCache = runEventCache && EventCache::getEventCache()->isComplete();
+    if (!replayEventCache)
+      {
+      //if (runPythiaReader)         eventAnalysis->addSubTask(new PythiaEventReader(PythiaLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+      if (runPythiaGenerator)      eventAnalysis->addSubTask(new PythiaEventGenerator(PythiaLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+  //    if (runHerwigReader)         eventAnalysis->addSubTask(new HerwigEventReader(HerwigLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+      if (runAmptReader)           eventAnalysis->addSubTask(new AmptEventReader(AmptLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+  //    if (runEposReader)           eventAnalysis->addSubTask(new EposEventReader(EposLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+  //    if (runUrqmdReader)          eventAnalysis->addSubTask(new UrqmdEventReader(UrqmdLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+  //    if (runHijingReader)         eventAnalysis->addSubTask(new HijingEventReader(HijingLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+      if (runTherminatorGenerator) eventAnalysis->addSubTask(new TherminatorGenerator(TherminatorLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+      if (runResonanceGenerator)   eventAnalysis->addSubTask(new ResonanceGenerator(ResoLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+      }
+    if (runEventCache)           eventAnalysis->addSubTask(new EventCacheTask(EventCacheLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+
+    if (runPerformanceSim)       eventAnalysis->addSubTask(new MeasurementPerformanceSimulator(PerformLabel,analysisConfiguration,eventFilterModels,particleFiltersModels));
+
+    if (runGlobalAnalysisGen)       eventAnalysis->addSubTask(new GlobalAnalyzer(GlobalLabel+GenLabel, analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runSpherocityAnalysisGen)   eventAnalysis->addSubTask(new TransverseSpherocityAnalyzer(SpherocityLabel+GenLabel, analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runPartSingleAnalysisGen)   eventAnalysis->addSubTask(new ParticleSingleAnalyzer(PartLabel+GenLabel, analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runPartPairAnalysisGen)     eventAnalysis->addSubTask(new ParticlePairAnalyzer(PairLabel+GenLabel, analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runNuDynAnalysisGen)        eventAnalysis->addSubTask(new NuDynAnalyzer(NuDynLabel+GenLabel,analysisConfiguration,eventFilterAnalysis,particleFiltersAnalysis));
+    if (runFlowAnalysisGen)         eventAnalysis->addSubTask(new FlowAnalyzer(FlowLabel+GenLabel,analysisConfiguration,eventFilterAnalysis,particleFiltersAnalysis));
+
+    if (runGlobalAnalysisReco)      eventAnalysis->addSubTask(new GlobalAnalyzer(GlobalLabel+RecoLabel,analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runSpherocityAnalysisReco)  eventAnalysis->addSubTask(new TransverseSpherocityAnalyzer(SpherocityLabel+RecoLabel, analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runPartSingleAnalysisReco)  eventAnalysis->addSubTask(new ParticleSingleAnalyzer(PartLabel+RecoLabel, analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runPartPairAnalysisReco)    eventAnalysis->addSubTask(new ParticlePairAnalyzer(PairLabel+RecoLabel, analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
+    if (runNuDynAnalysisReco)       eventAnalysis->addSubTask(new NuDynAnalyzer(NuDynLabel+RecoLabel,analysisConfiguration,eventFilterAnalysis,particleFiltersAnalysis));
+    if (runFlowAnalysisReco)        eventAnalysis->addSubTask(new FlowAnalyzer(FlowLabel+RecoLabel,analysisConfiguration,eventFilterAnalysis,particleFiltersAnalysis));
+    if (runPerformanceAna)          eventAnalysis->addSubTask(new ParticlePerformanceAnalyzer(SimAnaLabel,analysisConfiguration,eventFilterAnalysis, particleFiltersAnalysis));
     }
 
   if (reportInfo(__FUNCTION__))
@@ -526,6 +618,13 @@ void RunAnalysis::configure()
     cout << "==================================================================================" << std::endl;
     }
   gSystem->mkdir(outputPathName,1);
+  if (workerIndex>=0)
+    {
+    long seedBase = setSeed ? seedValue : long(121212121);
+    // a distinct seed per worker: the state of gRandom is otherwise inherited from the driver by all workers.
+    gRandom->SetSeed(seedBase+workerIndex+1);
+    for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++) configureWorker(subTasks[iTask],outputPathName,seedBase);
+    }
   if (hasSubTasks())
     for (unsigned int  iTask=0; iTask<subTasks.size(); iTask++)
       {
@@ -545,6 +644,16 @@ void RunAnalysis::execute()
     cout << "==================================================================================" << std::endl;
     }
   //initializeSubTasks();
+  if (nWorkers>1 && workerIndex<0)
+    {
+    // driver process
+    if (!waitWorkers())
+      {
+      if (reportError(__FUNCTION__)) cout << "One or more workers failed. Outputs are not merged." << endl;
+      postTaskError();
+      return;
+      }
+    }
   executeSubTasks();
 
   if (reportInfo(__FUNCTION__))
@@ -554,5 +663,105 @@ void RunAnalysis::execute()
     cout << "Analysis Completed" << std::endl;
     cout << "==================================================================================" << std::endl;
     }
+  if (workerIndex>=0)
+    {
+    // worker process: must not return to the caller which would carry on as if it were the driver.
+    exit(isTaskOk() ? 0 : 1);
+    }
+}
+
+int RunAnalysis::forkWorkers()
+{
+  cout.flush();
+  workerPids.clear();
+  for (int iWorker=0; iWorker<nWorkers; iWorker++)
+    {
+    pid_t pid = fork();
+    if (pid<0)
+      {
+      if (reportFatal(__FUNCTION__)) cout << "Could not fork worker " << iWorker << ". Abort." << endl;
+      for (unsigned int k=0; k<workerPids.size(); k++) kill(workerPids[k],SIGTERM);
+      exit(1);
+      }
+    if (pid==0)
+      {
+      workerIndex = iWorker;
+      workerPids.clear();
+      if (reportInfo(__FUNCTION__)) cout << "Worker " << iWorker << " started with pid " << getpid() << endl;
+      return workerIndex;
+      }
+    workerPids.push_back(pid);
+    }
+  return -1;
+}
+
+bool RunAnalysis::waitWorkers()
+{
+  bool success = true;
+  for (unsigned int iWorker=0; iWorker<workerPids.size(); iWorker++)
+    {
+    int status = 0;
+    if (waitpid(workerPids[iWorker],&status,0)<0 || !WIFEXITED(status) || WEXITSTATUS(status)!=0)
+      {
+      if (reportError(__FUNCTION__)) cout << "Worker " << iWorker << " (pid " << workerPids[iWorker] << ") failed." << endl;
+      success = false;
+      }
+    else if (reportInfo(__FUNCTION__))
+      {
+      cout << "Worker " << iWorker << " completed." << endl;
+      }
+    }
+  workerPids.clear();
+  return success;
 }
 
+void RunAnalysis::configureWorker(Task * task, const String & exportPathBase, long seedBase)
+{
+  String path = task->getFullTaskPath();
+  String key  = analysisConfiguration.standardize(path,"HistogramsExportPath");
+  String exportPath = analysisConfiguration.isFound(key) ? analysisConfiguration.getValueString(key) : exportPathBase;
+  if (exportPath.Length()>0 && !exportPath.EndsWith("/")) exportPath += "/";
+  exportPath += Form("%s%02d/",workerLabel.Data(),workerIndex);
+  analysisConfiguration.addParameter(path,"HistogramsExportPath",exportPath);
+
+  key = analysisConfiguration.standardize(path,"SeedValue");
+  long seed = analysisConfiguration.isFound(key) ? analysisConfiguration.getValueLong(key) : seedBase;
+  analysisConfiguration.addParameter(path,"SetSeed",true);
+  analysisConfiguration.addParameter(path,"SeedValue",seed+workerIndex+1);
+
+  analysisConfiguration.addParameter(path,"EventsImportFileShard",workerIndex);
+  analysisConfiguration.addParameter(path,"EventsImportFileNShards",nWorkers);
+
+  if (dynamic_cast<TaskIterator*>(task))
+    {
+    key = analysisConfiguration.standardize(path,"nEventsRequested");
+    if (analysisConfiguration.isFound(key))
+      {
+      long nEvents = analysisConfiguration.getValueLong(key);
+      long nEventsWorker = nEvents/nWorkers + ((nEvents%nWorkers>workerIndex) ? 1 : 0);
+      analysisConfiguration.addParameter(path,"nEventsRequested",nEventsWorker);
+      }
+    else if (reportWarning(__FUNCTION__))
+      {
+      cout << "nEventsRequested is not set for " << path << ": each worker processes the default number of events." << endl;
+      }
+    }
+  for (unsigned int iTask=0; iTask<task->getNSubTasks(); iTask++)
+    configureWorker(task->getSubTaskAt(iTask),exportPathBase,seedBase);
+}
+
+void RunAnalysis::addMergeTask(const String & basePath, const String & taskName)
+{
+  String prefix = getFullTaskPath() + taskName + TString(":");
+  Configuration & subConfig = * new Configuration();
+  subConfig.addParameter(prefix+TString("HistogramsImportPath"),basePath);
+  subConfig.addParameter(prefix+TString("HistogramsExportPath"),basePath);
+  subConfig.addParameter(prefix+TString("IncludedPattern0"),workerLabel);
+  subConfig.addParameter(prefix+TString("ExcludedPattern0"),TString("Derived"));
+  subConfig.addParameter(prefix+TString("ExcludedPattern1"),TString("BalFct"));
+  subConfig.addParameter(prefix+TString("ExcludedPattern2"),TString("Sum"));
+  subConfig.addParameter(prefix+TString("AppendedString"),TString("Sum"));
+  subConfig.addParameter(prefix+TString("DefaultGroupSize"),nWorkers);
+  subConfig.addParameter(prefix+TString("MaximumDepth"),1);
+  addSubTask(new SubSampleStatCalculator(taskName,subConfig));
+}
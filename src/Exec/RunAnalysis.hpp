@@ -11,6 +11,7 @@
  * *********************************************************************/
 #ifndef CAP__RunAnalysis
 #define CAP__RunAnalysis
+#include <sys/types.h>
 #include "EventTask.hpp"
 #include "Event.hpp"
 #include "Particle.hpp"
@@ -19,7 +20,15 @@
 namespace CAP
 {
 
-
+//!
+//! Top level analysis task. The task tree (particle database, event generators or readers, analyzers) is assembled at configuration
+//! based on the Run* flags of the configuration.
+//!
+//! If nWorkers is larger than one, the analysis runs locally in nWorkers forked processes. Each worker gets its own output folder
+//! (HistogramsExportPath/WorkerLabel##/), its share of nEventsRequested, its own seeds (gRandom and the SeedValue parameter of its
+//! tasks), and its shard of the input files of event readers. The parent process (driver) waits for the workers and, if MergeWorkers
+//! is true, combines their outputs with a SubSampleStatCalculator per analyzer (files written in HistogramsExportPath).
+//!
 class RunAnalysis : public EventTask
 {
 public:
@@ -47,6 +56,40 @@ public:
   //!
   void execute();
 
+protected:
+
+  //!
+  //! Fork the worker processes. Returns the index of the worker in the worker processes and -1 in the driver process.
+  //!
+  int forkWorkers();
+
+  //!
+  //! Wait for the completion of all worker processes. Returns true if all workers completed successfully.
+  //!
+  bool waitWorkers();
+
+  //!
+  //! Set the worker specific parameters (output path, seeds, event count, input file shard) of the given task and its subtasks in the
+  //! configuration used by the tasks of this worker.
+  //!
+  void configureWorker(Task * task, const String & exportPathBase, long seedBase);
+
+  //!
+  //! Add a task merging the outputs of the workers for the analyzer with the given name.
+  //!
+  void addMergeTask(const String & basePath, const String & taskName);
+
+  int           nWorkers;
+  String        workerLabel;
+  bool          mergeWorkers;
+  int           workerIndex;
+  vector<pid_t> workerPids;
+
+  //!
+  //! Configuration used by the tasks of this analysis, i.e., the requested configuration with the worker specific overrides.
+  //!
+  Configuration analysisConfiguration;
+
   ClassDef(RunAnalysis,0)
 };
 
@@ -0,0 +1,435 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include "TMath.h"
+#include "RunBenchmark.hpp"
+#include "TaskProfiler.hpp"
+#include "EventFilter.hpp"
+#include "EventAnalysisContext.hpp"
+#include "ParticleDigit.hpp"
+#include "ParticleSingleHistos.hpp"
+#include "ParticlePairHistos.hpp"
+using CAP::RunBenchmark;
+
+ClassImp(RunBenchmark);
+
+RunBenchmark::RunBenchmark(const String & _name,
+                           const Configuration & _configuration)
+:
+Task(_name, _configuration),
+nEventsPerPoint(100),
+nMultiplicities(4),
+minMultiplicity(10),
+maxMultiplicity(10000),
+maxPairMultiplicity(2000),
+nBenchmarkFilters(2),
+seed(12345),
+temperature(0.3),
+maxEta(1.0),
+outputFile("Benchmark.json"),
+random(),
+decayer(),
+piPlusType(),
+piMinusType(),
+rhoType(),
+eventFilters(),
+particleFilters(),
+analyzer(nullptr),
+multiplicities(),
+nEvents(),
+wallTimes(),
+cpuTimes(),
+nItems()
+{
+  appendClassName("RunBenchmark");
+}
+
+RunBenchmark::~RunBenchmark()
+{
+  for (unsigned int k=0; k<eventFilters.size(); k++)    delete eventFilters[k];
+  for (unsigned int k=0; k<particleFilters.size(); k++) delete particleFilters[k];
+}
+
+void RunBenchmark::setDefaultConfiguration()
+{
+  Task::setDefaultConfiguration();
+  addParameter("nEventsPerPoint",       nEventsPerPoint);
+  addParameter("nMultiplicities",       nMultiplicities);
+  addParameter("Min_Multiplicity",      minMultiplicity);
+  addParameter("Max_Multiplicity",      maxMultiplicity);
+  addParameter("Max_PairMultiplicity",  maxPairMultiplicity);
+  addParameter("nParticleFilters",      nBenchmarkFilters);
+  addParameter("Seed",                  seed);
+  addParameter("Temperature",           temperature);
+  addParameter("Max_eta",               maxEta);
+  addParameter("BenchmarkOutputFile",   outputFile);
+}
+
+void RunBenchmark::configure()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  Task::configure();
+  nEventsPerPoint     = getValueLong(  "nEventsPerPoint");
+  nMultiplicities     = getValueInt(   "nMultiplicities");
+  minMultiplicity     = getValueInt(   "Min_Multiplicity");
+  maxMultiplicity     = getValueInt(   "Max_Multiplicity");
+  maxPairMultiplicity = getValueInt(   "Max_PairMultiplicity");
+  nBenchmarkFilters   = getValueInt(   "nParticleFilters");
+  seed                = getValueLong(  "Seed");
+  temperature         = getValueDouble("Temperature");
+  maxEta              = getValueDouble("Max_eta");
+  outputFile          = getValueString("BenchmarkOutputFile");
+  if (nBenchmarkFilters<1) nBenchmarkFilters = 1;
+  if (nBenchmarkFilters>4) nBenchmarkFilters = 4;
+  if (nMultiplicities<1)   nMultiplicities   = 1;
+  if (minMultiplicity<2)   minMultiplicity   = 2;
+  if (maxMultiplicity<minMultiplicity) maxMultiplicity = minMultiplicity;
+
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("nEventsPerPoint",     nEventsPerPoint);
+    printItem("nMultiplicities",     nMultiplicities);
+    printItem("Min_Multiplicity",    minMultiplicity);
+    printItem("Max_Multiplicity",    maxMultiplicity);
+    printItem("Max_PairMultiplicity",maxPairMultiplicity);
+    printItem("nParticleFilters",    nBenchmarkFilters);
+    printItem("Seed",                seed);
+    printItem("Temperature",         temperature);
+    printItem("Max_eta",             maxEta);
+    printItem("BenchmarkOutputFile", outputFile);
+    }
+
+  random.SetSeed(seed);
+  decayer.setRandomGenerator(&random);
+  piPlusType.setName("PiP");
+  piPlusType.setPdgCode(211);
+  piPlusType.setMass(0.13957);
+  piPlusType.setCharge(1);
+  piMinusType.setName("PiM");
+  piMinusType.setPdgCode(-211);
+  piMinusType.setMass(0.13957);
+  piMinusType.setCharge(-1);
+  rhoType.setName("Rho0");
+  rhoType.setPdgCode(113);
+  rhoType.setMass(0.77526);
+  rhoType.setWidth(0.1491);
+  rhoType.setCharge(0);
+
+  // filters with the same kinematic bounds as the default pair analysis binning
+  double minPt = 0.2;
+  double maxPt = 2.0;
+  vector<ParticleFilter*> filters;
+  eventFilters = EventFilter::createOpenEventFilter();
+  filters = ParticleFilter::createPositiveParticleFilter(true,minPt,maxPt,true,-maxEta,maxEta,false,0.0,0.0);
+  particleFilters.insert(particleFilters.end(),filters.begin(),filters.end());
+  filters = ParticleFilter::createNegativeParticleFilter(true,minPt,maxPt,true,-maxEta,maxEta,false,0.0,0.0);
+  particleFilters.insert(particleFilters.end(),filters.begin(),filters.end());
+  filters = ParticleFilter::createChargedParticleFilter(true,minPt,maxPt,true,-maxEta,maxEta,false,0.0,0.0);
+  particleFilters.insert(particleFilters.end(),filters.begin(),filters.end());
+  filters = ParticleFilter::createChargedParticleFilter(false,0.0,0.0,false,0.0,0.0,false,0.0,0.0);
+  particleFilters.insert(particleFilters.end(),filters.begin(),filters.end());
+  while (int(particleFilters.size())>nBenchmarkFilters)
+    {
+    delete particleFilters.back();
+    particleFilters.pop_back();
+    }
+  analyzer = new ParticlePairAnalyzer("Pair", *requestedConfiguration, eventFilters, particleFilters);
+  addSubTask(analyzer);
+  analyzer->configure();
+
+  multiplicities.clear();
+  for (int k=0; k<nMultiplicities; k++)
+    {
+    double f = (nMultiplicities>1) ? double(k)/double(nMultiplicities-1) : 0.0;
+    int m = int(0.5 + minMultiplicity*pow(double(maxMultiplicity)/double(minMultiplicity),f));
+    multiplicities.push_back(m);
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void RunBenchmark::execute()
+{
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    cout << "==================================================================================" << std::endl;
+    cout << "Benchmark Started" << std::endl;
+    cout << "==================================================================================" << std::endl;
+    }
+  timer.start();
+  analyzer->createHistograms();
+  analyzer->createDerivedHistograms();
+  nEvents.clear();
+  wallTimes.clear();
+  cpuTimes.clear();
+  nItems.clear();
+  for (unsigned int iPoint=0; iPoint<multiplicities.size(); iPoint++) runPoint(multiplicities[iPoint]);
+  timer.stop();
+
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    cout << setw(12) << "Multiplicity";
+    for (int stage=0; stage<NStages; stage++) cout << setw(18) << getStageName(stage);
+    cout << endl << setw(12) << "" ;
+    for (int stage=0; stage<NStages; stage++) cout << setw(18) << "(ns/item)";
+    cout << endl;
+    for (unsigned int iPoint=0; iPoint<multiplicities.size(); iPoint++)
+      {
+      cout << setw(12) << multiplicities[iPoint];
+      for (int stage=0; stage<NStages; stage++)
+        {
+        double items = nItems[iPoint][stage];
+        if (items>0) cout << setw(18) << 1.0E9*wallTimes[iPoint][stage]/items;
+        else         cout << setw(18) << "-";
+        }
+      cout << endl;
+      }
+    timer.print(cout);
+    }
+  ofstream output(outputFile.Data());
+  if (output.is_open())
+    {
+    writeResults(output);
+    if (reportInfo(__FUNCTION__)) cout << "Benchmark results written to: " << outputFile << endl;
+    }
+  else if (reportError(__FUNCTION__)) cout << "Unable to open benchmark output file: " << outputFile << endl;
+}
+
+void RunBenchmark::generateEvent(int multiplicity, vector<Particle*> & particles)
+{
+  Factory<Particle> * factory = Particle::getFactory();
+  factory->reset();
+  particles.clear();
+  double mass = piPlusType.getMass();
+  for (int iParticle=0; iParticle<multiplicity; iParticle++)
+    {
+    // pt sampled from pt*exp(-pt/T)
+    double pt  = -temperature*log(random.Rndm()*random.Rndm());
+    double eta = maxEta*(2.0*random.Rndm()-1.0);
+    double phi = TMath::TwoPi()*random.Rndm();
+    double px  = pt*cos(phi);
+    double py  = pt*sin(phi);
+    double pz  = pt*sinh(eta);
+    double e   = sqrt(px*px+py*py+pz*pz+mass*mass);
+    Particle * particle = factory->getNextObject();
+    particle->set((iParticle%2==0) ? &piPlusType : &piMinusType, px,py,pz,e, 0.0,0.0,0.0,0.0, true);
+    particles.push_back(particle);
+    }
+}
+
+void RunBenchmark::runPoint(int multiplicity)
+{
+  using std::chrono::steady_clock;
+  using std::chrono::duration;
+  if (reportInfo(__FUNCTION__)) cout << "Benchmarking multiplicity: " << multiplicity << endl;
+  unsigned int nFilters = particleFilters.size();
+  HistogramManager & histograms = analyzer->getHistogramManager();
+  histograms.reset();
+  ParticleBinning binning(analyzer->getValueInt("nBins_pt"),  analyzer->getValueDouble("Min_pt"),  analyzer->getValueDouble("Max_pt"),
+                          analyzer->getValueInt("nBins_phi"), analyzer->getValueDouble("Min_phi"), analyzer->getValueDouble("Max_phi"),
+                          analyzer->getValueInt("nBins_eta"), analyzer->getValueDouble("Min_eta"), analyzer->getValueDouble("Max_eta"),
+                          analyzer->getValueInt("nBins_y"),   analyzer->getValueDouble("Min_y"),   analyzer->getValueDouble("Max_y"),
+                          analyzer->getValueBool("FillEta"),  analyzer->getValueBool("FillY"));
+  Factory<ParticleDigit> * digitFactory = ParticleDigit::getFactory();
+  Factory<Particle> *      particleFactory = Particle::getFactory();
+  vector<Particle*>        particles;
+  vector<unsigned char>    accepted;
+  vector< vector<ParticleDigit*> > digits(nFilters);
+  vector<Particle*>        parents;
+  vector<Particle*>        children;
+  vector<double> wall(NStages,0.0);
+  vector<double> cpu(NStages,0.0);
+  vector<double> items(NStages,0.0);
+  bool doPairs = multiplicity<=maxPairMultiplicity;
+  int  nDecays = multiplicity/2;
+  steady_clock::time_point wallStart;
+  double cpuStart;
+
+  for (long iEvent=0; iEvent<nEventsPerPoint; iEvent++)
+    {
+    generateEvent(multiplicity,particles);
+    unsigned int nParticles = particles.size();
+    accepted.assign(nParticles*nFilters,0);
+
+    // particle filters
+    wallStart = steady_clock::now();
+    cpuStart  = TaskProfiler::getCpuTime();
+    for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      {
+      Particle & particle = *particles[iParticle];
+      for (unsigned int iFilter=0; iFilter<nFilters; iFilter++)
+        accepted[iParticle*nFilters+iFilter] = particleFilters[iFilter]->accept(particle);
+      }
+    wall[FilterStage]  += duration<double>(steady_clock::now()-wallStart).count();
+    cpu[FilterStage]   += TaskProfiler::getCpuTime()-cpuStart;
+    items[FilterStage] += nParticles*nFilters;
+
+    // digitization
+    wallStart = steady_clock::now();
+    cpuStart  = TaskProfiler::getCpuTime();
+    digitFactory->reset();
+    for (unsigned int iFilter=0; iFilter<nFilters; iFilter++) digits[iFilter].clear();
+    for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      {
+      ParticleDigit * digit = nullptr;
+      bool digitized = false;
+      for (unsigned int iFilter=0; iFilter<nFilters; iFilter++)
+        {
+        if (!accepted[iParticle*nFilters+iFilter]) continue;
+        if (!digitized)
+          {
+          digitized = true;
+          digit = digitFactory->getNextObject();
+          if (!binning.digitize(*particles[iParticle],*digit)) digit = nullptr;
+          }
+        if (digit) digits[iFilter].push_back(digit);
+        }
+      }
+    wall[DigitizeStage]  += duration<double>(steady_clock::now()-wallStart).count();
+    cpu[DigitizeStage]   += TaskProfiler::getCpuTime()-cpuStart;
+    items[DigitizeStage] += nParticles;
+
+    // singles
+    wallStart = steady_clock::now();
+    cpuStart  = TaskProfiler::getCpuTime();
+    for (unsigned int iFilter=0; iFilter<nFilters; iFilter++)
+      {
+      ParticleSingleHistos * singleHistos = (ParticleSingleHistos *) histograms.getGroup(0,iFilter);
+      singleHistos->fill(digits[iFilter],1.0);
+      }
+    wall[SingleFillStage]  += duration<double>(steady_clock::now()-wallStart).count();
+    cpu[SingleFillStage]   += TaskProfiler::getCpuTime()-cpuStart;
+    for (unsigned int iFilter=0; iFilter<nFilters; iFilter++) items[SingleFillStage] += digits[iFilter].size();
+
+    // pairs
+    if (doPairs)
+      {
+      wallStart = steady_clock::now();
+      cpuStart  = TaskProfiler::getCpuTime();
+      for (unsigned int iFilter1=0; iFilter1<nFilters; iFilter1++)
+        {
+        for (unsigned int iFilter2=0; iFilter2<nFilters; iFilter2++)
+          {
+          ParticlePairHistos * pairHistos = (ParticlePairHistos *) histograms.getGroup(1,iFilter1*nFilters+iFilter2);
+          pairHistos->fill(digits[iFilter1],digits[iFilter2],iFilter1==iFilter2,1.0);
+          }
+        }
+      wall[PairFillStage] += duration<double>(steady_clock::now()-wallStart).count();
+      cpu[PairFillStage]  += TaskProfiler::getCpuTime()-cpuStart;
+      for (unsigned int iFilter1=0; iFilter1<nFilters; iFilter1++)
+        {
+        for (unsigned int iFilter2=0; iFilter2<nFilters; iFilter2++)
+          {
+          double n1 = digits[iFilter1].size();
+          double n2 = digits[iFilter2].size();
+          items[PairFillStage] += (iFilter1==iFilter2) ? n1*(n1-1.0) : n1*n2;
+          }
+        }
+      }
+
+    // decays: rho0 parents with the momenta of the event particles
+    parents.clear();
+    children.clear();
+    double rhoMass = rhoType.getMass();
+    for (int iDecay=0; iDecay<nDecays; iDecay++)
+      {
+      LorentzVector & p = particles[iDecay]->getMomentum();
+      Particle * parent = particleFactory->getNextObject();
+      parent->set(&rhoType, p.Px(),p.Py(),p.Pz(),sqrt(p.P()*p.P()+rhoMass*rhoMass), 0.0,0.0,0.0,0.0, false);
+      Particle * child1 = particleFactory->getNextObject();
+      Particle * child2 = particleFactory->getNextObject();
+      child1->setType(&piPlusType);
+      child2->setType(&piMinusType);
+      parents.push_back(parent);
+      children.push_back(child1);
+      children.push_back(child2);
+      }
+    wallStart = steady_clock::now();
+    cpuStart  = TaskProfiler::getCpuTime();
+    for (int iDecay=0; iDecay<nDecays; iDecay++)
+      {
+      Particle & child1 = *children[2*iDecay];
+      Particle & child2 = *children[2*iDecay+1];
+      decayer.decay2(*parents[iDecay],child1,child2);
+      child1.invalidateKinematics();
+      child2.invalidateKinematics();
+      }
+    wall[DecayStage]  += duration<double>(steady_clock::now()-wallStart).count();
+    cpu[DecayStage]   += TaskProfiler::getCpuTime()-cpuStart;
+    items[DecayStage] += nDecays;
+    }
+
+  // derived histograms (HistogramCollection operations)
+  wallStart = steady_clock::now();
+  cpuStart  = TaskProfiler::getCpuTime();
+  analyzer->calculateDerivedHistograms();
+  wall[DerivedStage]  += duration<double>(steady_clock::now()-wallStart).count();
+  cpu[DerivedStage]   += TaskProfiler::getCpuTime()-cpuStart;
+  items[DerivedStage] += 1;
+
+  nEvents.push_back(nEventsPerPoint);
+  wallTimes.push_back(wall);
+  cpuTimes.push_back(cpu);
+  nItems.push_back(items);
+}
+
+const char * RunBenchmark::getStageName(int stage)
+{
+  switch (stage)
+    {
+      case FilterStage:     return "ParticleFilter";
+      case DigitizeStage:   return "Digitization";
+      case SingleFillStage: return "SingleFill";
+      case PairFillStage:   return "PairFill";
+      case DecayStage:      return "Decay";
+      case DerivedStage:    return "Derived";
+      default:              return "Unknown";
+    }
+}
+
+void RunBenchmark::writeResults(ostream & output)
+{
+  output << "{" << endl;
+  output << "  \"name\": \"" << getName() << "\"," << endl;
+  output << "  \"seed\": " << seed << "," << endl;
+  output << "  \"nEventsPerPoint\": " << nEventsPerPoint << "," << endl;
+  output << "  \"nParticleFilters\": " << particleFilters.size() << "," << endl;
+  output << "  \"points\": [";
+  for (unsigned int iPoint=0; iPoint<multiplicities.size() && iPoint<wallTimes.size(); iPoint++)
+    {
+    output << (iPoint==0 ? "" : ",") << endl;
+    output << "    {" << endl;
+    output << "      \"multiplicity\": " << multiplicities[iPoint] << "," << endl;
+    output << "      \"events\": " << nEvents[iPoint] << "," << endl;
+    output << "      \"stages\": {";
+    for (int stage=0; stage<NStages; stage++)
+      {
+      double items = nItems[iPoint][stage];
+      output << (stage==0 ? "" : ",") << endl;
+      output << "        \"" << getStageName(stage) << "\": { \"wall\": " << wallTimes[iPoint][stage]
+      << ", \"cpu\": " << cpuTimes[iPoint][stage]
+      << ", \"items\": " << items
+      << ", \"nsPerItem\": " << (items>0 ? 1.0E9*wallTimes[iPoint][stage]/items : 0.0) << " }";
+      }
+    output << endl << "      }" << endl;
+    output << "    }";
+    }
+  output << endl << "  ]" << endl;
+  output << "}" << endl;
+}
@@ -0,0 +1,121 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__RunBenchmark
+#define CAP__RunBenchmark
+#include <vector>
+#include "TRandom3.h"
+#include "Task.hpp"
+#include "Particle.hpp"
+#include "ParticleType.hpp"
+#include "ParticleFilter.hpp"
+#include "ParticleDecayer.hpp"
+#include "ParticlePairAnalyzer.hpp"
+
+namespace CAP
+{
+
+//!
+//! Reproducible benchmark of the analysis hot paths. Synthetic events (pions with exponential pt spectra, uniform eta and phi) are
+//! generated with a fixed seed for a set of multiplicities spaced logarithmically between Min_Multiplicity and Max_Multiplicity.
+//! For each multiplicity, the following stages are timed independently (wall and CPU time) over nEventsPerPoint events:
+//!
+//!  - ParticleFilter::accept for all particles and all particle filters,
+//!  - digitization of the accepted particles (as done by ParticlePairAnalyzer),
+//!  - ParticleSingleHistos::fill,
+//!  - ParticlePairHistos::fill (skipped above Max_PairMultiplicity),
+//!  - ParticleDecayer::decay2 of rho0 into pion pairs,
+//!  - the derived histogram calculations of ParticlePairAnalyzer (HistogramCollection operations), once per multiplicity.
+//!
+//! The histogram groups are those of a ParticlePairAnalyzer subtask so the binning and fill options are configured exactly as for an
+//! analysis. Results are printed and written in JSON format to BenchmarkOutputFile so they can be compared against a baseline
+//! obtained on the same machine.
+//!
+class RunBenchmark : public Task
+{
+public:
+
+  enum Stage { FilterStage=0, DigitizeStage, SingleFillStage, PairFillStage, DecayStage, DerivedStage, NStages };
+
+  RunBenchmark(const String & _name,
+               const Configuration & _configuration);
+
+  //!
+  //! dtor
+  //!
+  virtual ~RunBenchmark();
+
+  //!
+  //! Initialize the configuration parameter of the task to their default value;
+  //!
+  virtual void setDefaultConfiguration();
+
+  //!
+  //! Configure  this benchmark task
+  //!
+  virtual void configure();
+
+  //!
+  //! Run the benchmark
+  //!
+  virtual void execute();
+
+  //!
+  //! Write the results in JSON format to the given stream.
+  //!
+  void writeResults(ostream & output);
+
+  static const char * getStageName(int stage);
+
+protected:
+
+  //!
+  //! Fill the given particle list with a synthetic event of the given multiplicity.
+  //!
+  void generateEvent(int multiplicity, vector<Particle*> & particles);
+
+  //!
+  //! Run all the stages for the given multiplicity and record their times.
+  //!
+  void runPoint(int multiplicity);
+
+  long   nEventsPerPoint;
+  int    nMultiplicities;
+  int    minMultiplicity;
+  int    maxMultiplicity;
+  int    maxPairMultiplicity;
+  int    nBenchmarkFilters;
+  long   seed;
+  double temperature;
+  double maxEta;
+  String outputFile;
+
+  TRandom3        random;
+  ParticleDecayer decayer;
+  ParticleType    piPlusType;
+  ParticleType    piMinusType;
+  ParticleType    rhoType;
+  vector<EventFilter*>    eventFilters;
+  vector<ParticleFilter*> particleFilters;
+  ParticlePairAnalyzer *  analyzer;
+
+  vector<int>             multiplicities;
+  vector<long>            nEvents;
+  vector< vector<double> > wallTimes;
+  vector< vector<double> > cpuTimes;
+  vector< vector<double> > nItems;
+
+  ClassDef(RunBenchmark,0)
+};
+
+}
+
+#endif /* CAP__RunBenchmark */
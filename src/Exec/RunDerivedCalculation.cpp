@@ -29,6 +29,7 @@
 #include "ParticleSingleAnalyzer.hpp"
 #include "ParticlePairAnalyzer.hpp"
 #include "NuDynAnalyzer.hpp"
+#include "FlowAnalyzer.hpp"
 using CAP::RunDerivedCalculation;
 
 ClassImp(RunDerivedCalculation);
@@ -55,6 +56,7 @@ void RunDerivedCalculation::setDefaultConfiguration()
   addParameter("PartLabel",       TString("Part"));
   addParameter("PairLabel",       TString("Pair"));
   addParameter("NuDynLabel",      TString("NuDyn"));
+  addParameter("FlowLabel",       TString("Flow"));
   addParameter("SimAnaLabel",     TString("SimAna"));
   addParameter("DerivedLabel",    TString("Derived"));
   addParameter("SumLabel",        TString("Sum"));
@@ -74,6 +76,8 @@ void RunDerivedCalculation::setDefaultConfiguration()
   addParameter("RunPartPairAnalysisReco",       NO);
   addParameter("RunNuDynAnalysisGen",           NO);
   addParameter("RunNuDynAnalysisReco",          NO);
+  addParameter("RunFlowAnalysisGen",            NO);
+  addParameter("RunFlowAnalysisReco",           NO);
   addParameter("RunFillEta",                     NO);
   addParameter("RunFillY",                   YES);
   addParameter("HistogramsForceRewrite",  YES);
@@ -151,6 +155,7 @@ void RunDerivedCalculation::configure()
   String PartLabel        = getValueString("PartLabel");
   String PairLabel        = getValueString("PairLabel");
   String NuDynLabel       = getValueString("NuDynLabel");
+  String FlowLabel        = getValueString("FlowLabel");
   String SimAnaLabel      = getValueString("SimAnaLabel");
   String DerivedLabel     = getValueString("DerivedLabel");
   String SumLabel         = getValueString("SumLabel");
@@ -169,6 +174,8 @@ void RunDerivedCalculation::configure()
   bool    runPartPairAnalysisReco         = getValueBool("RunPartPairAnalysisReco");
   bool    runNuDynAnalysisGen             = getValueBool("RunNuDynAnalysisGen");
   bool    runNuDynAnalysisReco            = getValueBool("RunNuDynAnalysisReco");
+  bool    runFlowAnalysisGen              = getValueBool("RunFlowAnalysisGen");
+  bool    runFlowAnalysisReco             = getValueBool("RunFlowAnalysisReco");
   bool    runFillEta                      = getValueBool("RunFillEta");
   bool    runFillY                        = getValueBool("RunFillY");
   String inputPathName                    = getValueString("HistogramsImportPath");
@@ -366,12 +373,14 @@ void RunDerivedCalculation::configure()
     if (runPartSingleAnalysisGen)      derived->addSubTask(new ParticleSingleAnalyzer(PartLabel+GenLabel, configuration,analysisEventFilters, analysisParticleFilters));
     if (runPartPairAnalysisGen)        derived->addSubTask(new ParticlePairAnalyzer(PairLabel+GenLabel, configuration,analysisEventFilters, analysisParticleFilters));
     if (runNuDynAnalysisGen)           derived->addSubTask(new NuDynAnalyzer(NuDynLabel+GenLabel,configuration,analysisEventFilters,analysisParticleFilters));
+    if (runFlowAnalysisGen)            derived->addSubTask(new FlowAnalyzer(FlowLabel+GenLabel,configuration,analysisEventFilters,analysisParticleFilters));
 
     if (runGlobalAnalysisReco)         derived->addSubTask(new GlobalAnalyzer(GlobalLabel+RecoLabel, configuration,analysisEventFilters, analysisParticleFilters));
     if (runSpherocityAnalysisReco)     derived->addSubTask(new TransverseSpherocityAnalyzer(SpherocityLabel+RecoLabel, configuration,analysisEventFilters, analysisParticleFilters));
     if (runPartSingleAnalysisReco)     derived->addSubTask(new ParticleSingleAnalyzer(PartLabel+RecoLabel, configuration,analysisEventFilters, analysisParticleFilters));
     if (runPartPairAnalysisReco)       derived->addSubTask(new ParticlePairAnalyzer(PairLabel+RecoLabel, configuration,analysisEventFilters, analysisParticleFilters));
     if (runNuDynAnalysisReco)          derived->addSubTask(new NuDynAnalyzer(NuDynLabel+RecoLabel,configuration,analysisEventFilters,analysisParticleFilters));
+    if (runFlowAnalysisReco)           derived->addSubTask(new FlowAnalyzer(FlowLabel+RecoLabel,configuration,analysisEventFilters,analysisParticleFilters));
     }
 
   if (runBalFct && runPartPairAnalysisGen)
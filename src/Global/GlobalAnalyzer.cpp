@@ -31,7 +31,14 @@ e(),
 q(),
 s(),
 b(),
-ptSum()
+ptSum(),
+nMaskWords(0),
+particleE(),
+particlePt(),
+particleQ(),
+particleS(),
+particleB(),
+particleMasks()
 {
   appendClassName("GlobalAnalyzer");
 }
@@ -142,6 +149,7 @@ void GlobalAnalyzer::initialize()
   q.assign(nParticleFilters,0.0);
   s.assign(nParticleFilters,0.0);
   b.assign(nParticleFilters,0.0);
+  nMaskWords = (nParticleFilters+63)/64;
   if (reportDebug(__FUNCTION__)) cout << " #event added streams: "  << getNEventStreams() << endl;
 }
 
@@ -215,39 +223,22 @@ void GlobalAnalyzer::analyzeEvent()
   unsigned int nParticleFilters = particleFilters.size();
   unsigned int nParticles       = event.getNParticles();
   resetNParticlesAcceptedEvent();
+  // the particle sums do not depend on the event filter: they are computed once for the first accepting event filter.
+  bool reduced = false;
   for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
     {
-    if (!eventFilters[iEventFilter]->accept(event)) continue;
+    bool accepted = analysisContext ? analysisContext->isEventAccepted(eventFilterSlots[iEventFilter]) : eventFilters[iEventFilter]->accept(event);
+    if (!accepted) continue;
     incrementNEventsAccepted(iEventFilter);
     if (nParticles<1) continue;
-    
-    n.assign(nParticleFilters,0.0);
-    e.assign(nParticleFilters,0.0);
-    q.assign(nParticleFilters,0.0);
-    s.assign(nParticleFilters,0.0);
-    b.assign(nParticleFilters,0.0);
-    ptSum.assign(nParticleFilters,0.0);
-    for (unsigned int iParticle=0; iParticle<event.getNParticles(); iParticle++)
+    if (!reduced)
       {
-      Particle & particle = * event.getParticleAt(iParticle);
-      for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
-        {
-        //cout << iParticleFilter << "  " << particle.getType().getName() << endl;
-        if (particleFilters[iParticleFilter]->accept(particle))
-          {
-          incrementNParticlesAccepted(iEventFilter,iParticleFilter);
-          // // incrementParticlesAccepted();
-          ParticleType & type = particle.getType();
-          LorentzVector & momentum = particle.getMomentum();
-          n[iParticleFilter]++;
-          e[iParticleFilter] += momentum.E();
-          q[iParticleFilter] += type.getCharge();
-          s[iParticleFilter] += type.getNetStrangeness();
-          b[iParticleFilter] += type.getBaryonNumber();
-          ptSum[iParticleFilter] += momentum.Pt();
-          }
-        }
+      fillParticleColumns(event);
+      reduceParticleColumns();
+      reduced = true;
       }
+    for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      addNParticlesAccepted(iEventFilter,iParticleFilter,long(n[iParticleFilter]));
     if (iEventFilter==0 && setEvent)
       {
       EventProperties * ep = event.getEventProperties();
@@ -257,6 +248,94 @@ void GlobalAnalyzer::analyzeEvent()
     GlobalHistos * globalHistos = (GlobalHistos * ) histogramManager.getGroup(0,iEventFilter);
     globalHistos->fill(n,ptSum,e,q,s,b,1.0);
     }
+  // the event properties were modified: event filters must be evaluated anew by the next analyzers
+  if (setEvent && analysisContext) analysisContext->invalidate();
+}
+
+void GlobalAnalyzer::fillParticleColumns(Event & event)
+{
+  vector<Particle*> & particles = event.getParticles();
+  unsigned int nParticles       = particles.size();
+  unsigned int nParticleFilters = particleFilters.size();
+  particleE.resize(nParticles);
+  particlePt.resize(nParticles);
+  particleQ.resize(nParticles);
+  particleS.resize(nParticles);
+  particleB.resize(nParticles);
+  particleMasks.assign(nMaskWords*nParticles,0UL);
+  for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+    {
+    Particle & particle = * particles[iParticle];
+    ParticleType & type = particle.getType();
+    particleE[iParticle]  = particle.getE();
+    particlePt[iParticle] = particle.getPt();
+    particleQ[iParticle]  = type.getCharge();
+    particleS[iParticle]  = type.getNetStrangeness();
+    particleB[iParticle]  = type.getBaryonNumber();
+    }
+  if (analysisContext)
+    {
+    // the accepted particle lists of the context preserve the order of the event particles
+    for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      {
+      const vector<Particle*> & accepted = analysisContext->getAcceptedParticles(particleFilterSlots[iParticleFilter]);
+      unsigned long * masks = &particleMasks[(iParticleFilter>>6)*nParticles];
+      unsigned long   bit   = 1UL<<(iParticleFilter&63);
+      unsigned int    nAccepted = accepted.size();
+      unsigned int    iAccepted = 0;
+      for (unsigned int iParticle=0; iParticle<nParticles && iAccepted<nAccepted; iParticle++)
+        {
+        if (particles[iParticle]!=accepted[iAccepted]) continue;
+        masks[iParticle] |= bit;
+        iAccepted++;
+        }
+      }
+    }
+  else
+    {
+    for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      {
+      Particle & particle = * particles[iParticle];
+      for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        if (particleFilters[iParticleFilter]->accept(particle))
+          particleMasks[(iParticleFilter>>6)*nParticles+iParticle] |= 1UL<<(iParticleFilter&63);
+        }
+      }
+    }
+}
+
+void GlobalAnalyzer::reduceParticleColumns()
+{
+  unsigned int nParticles       = particleE.size();
+  unsigned int nParticleFilters = particleFilters.size();
+  const double * pE  = particleE.data();
+  const double * pPt = particlePt.data();
+  const double * pQ  = particleQ.data();
+  const double * pS  = particleS.data();
+  const double * pB  = particleB.data();
+  for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+    {
+    const unsigned long * masks = &particleMasks[(iParticleFilter>>6)*nParticles];
+    unsigned int shift = iParticleFilter&63;
+    double sumN = 0.0, sumE = 0.0, sumQ = 0.0, sumS = 0.0, sumB = 0.0, sumPt = 0.0;
+    for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+      {
+      double w = double((masks[iParticle]>>shift)&1UL);
+      sumN  += w;
+      sumE  += w*pE[iParticle];
+      sumQ  += w*pQ[iParticle];
+      sumS  += w*pS[iParticle];
+      sumB  += w*pB[iParticle];
+      sumPt += w*pPt[iParticle];
+      }
+    n[iParticleFilter]     = sumN;
+    e[iParticleFilter]     = sumE;
+    q[iParticleFilter]     = sumQ;
+    s[iParticleFilter]     = sumS;
+    b[iParticleFilter]     = sumB;
+    ptSum[iParticleFilter] = sumPt;
+    }
 }
 
 void GlobalAnalyzer::createDerivedHistograms()
@@ -89,6 +89,18 @@ public:
   virtual void calculateDerivedHistograms();
 
 protected:
+
+  //!
+  //! Compute, once per event, the energy, transverse momentum, charge, strangeness, and baryon number columns of the particles of the
+  //! given event along with the particle filter acceptance masks. The masks are read from the analysis context when one is used.
+  //!
+  void fillParticleColumns(Event & event);
+
+  //!
+  //! Reduce the particle columns onto n, e, q, s, b, and ptSum for all particle filters. The sums are branchless: each particle
+  //! contributes with a weight of zero or one selected by its acceptance mask.
+  //!
+  void reduceParticleColumns();
   
   bool setEvent;   //!< bool controling whether this task instance sets the EventProperties record of events it analyzes.
   vector<double> n; //!< array of multiplicities corresponding in kinematic  different particle filters operated by this task.
@@ -97,6 +109,13 @@ protected:
   vector<double> s; //!< array of net strangeness corresponding to the different particle filters operated by this task.
   vector<double> b; //!< array of net baryon number corresponding to the different particle filters operated by this task.
   vector<double> ptSum; //!< array of transverse momentum sums  corresponding to the different particle filters operated by this task.
+  unsigned int nMaskWords;   //!< number of 64-bit words of the particle filter acceptance masks.
+  vector<double> particleE;  //!< energy of the particles of the current event.
+  vector<double> particlePt; //!< transverse momentum of the particles of the current event.
+  vector<double> particleQ;  //!< charge of the particles of the current event.
+  vector<double> particleS;  //!< net strangeness of the particles of the current event.
+  vector<double> particleB;  //!< baryon number of the particles of the current event.
+  vector<unsigned long> particleMasks; //!< particle filter acceptance masks of the particles of the current event, stored word by word: [iWord*nParticles+iParticle].
 
   ClassDef(GlobalAnalyzer,0)
 };
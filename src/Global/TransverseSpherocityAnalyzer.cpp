@@ -189,10 +189,10 @@ void TransverseSpherocityAnalyzer::analyzeEvent()
         num1 = 0;
         for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
           {
-          Particle & particle = * event.getParticleAt(iParticle);
+          const Particle & particle = * event.getParticleAt(iParticle);
           if (!particleFilters[iParticleFilter]->accept(particle)) continue;
-          LorentzVector & momentum = particle.getMomentum();
-          pt = momentum.Pt();
+          const LorentzVector & momentum = particle.getMomentum();
+          pt = particle.getPt();
           px = momentum.Px();
           py = momentum.Py();
           if (fillS0)
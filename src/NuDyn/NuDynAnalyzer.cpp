@@ -22,7 +22,18 @@ NuDynAnalyzer::NuDynAnalyzer(const String & _name,
                              vector<ParticleFilter*> & _particleFilters)
 :
 EventTask(_name, _configuration, _eventFilters, _particleFilters),
-multiplicityType(1)
+multiplicityType(1),
+nBins_rapidity(0),
+min_rapidity(0.0),
+max_rapidity(0.0),
+width_rapidity(0.0),
+deltaRapidtyBin(),
+countsY0(),
+countsY1(),
+nAccepted0(),
+nAccepted1(),
+particles0(),
+particles1()
 {
   appendClassName("NuDynAnalyzer");
 }
@@ -75,11 +86,23 @@ void NuDynAnalyzer::configure()
 void NuDynAnalyzer::initialize()
 {
   EventTask::initialize();
+  deltaRapidtyBin.clear();
   for (int iEta=0; iEta<nBins_rapidity; iEta++)
     {
     deltaRapidtyBin.push_back(min_rapidity+double(iEta)*width_rapidity );
     }
+  countsY0.assign(nBins_rapidity+1,0.0);
+  countsY1.assign(nBins_rapidity+1,0.0);
+  nAccepted0.assign(nBins_rapidity,0.0);
+  nAccepted1.assign(nBins_rapidity,0.0);
+}
 
+void NuDynAnalyzer::countRapidity(const vector<Particle*> & particles, vector<double> & counts) const
+{
+  // the last bin collects the particles beyond the widest window
+  counts.assign(nBins_rapidity+1,0.0);
+  for (unsigned int iParticle=0; iParticle<particles.size(); iParticle++)
+    counts[getRapidityBin(fabs(particles[iParticle]->getY()))]++;
 }
 
 void NuDynAnalyzer::createHistograms()
@@ -163,38 +186,50 @@ void NuDynAnalyzer::analyzeEvent()
   //unsigned int nParticleFilters = particleFilters.size();
   Event * event = eventStreams[0];
   resetNParticlesAcceptedEvent();
+  // the rapidity histograms do not depend on the event filter: they are computed once for the first accepting event filter.
+  bool counted = false;
   for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
     {
-    if (!eventFilters[iEventFilter]->accept(*event)) continue;
+    bool accepted = analysisContext ? analysisContext->isEventAccepted(eventFilterSlots[iEventFilter]) : eventFilters[iEventFilter]->accept(*event);
+    if (!accepted) continue;
     incrementNEventsAccepted(iEventFilter); // count eventStreams used to fill histograms and for scaling at the end..
 
-    int nBins_rapidity = deltaRapidtyBin.size();
-    vector<double> nAccepted0(nBins_rapidity,0.0);
-    vector<double> nAccepted1(nBins_rapidity,0.0);
-    double rapidity;
-    for (unsigned long  iParticle=0; iParticle<event->getNParticles(); iParticle++)
+    if (!counted)
       {
-      Particle & particle = * event->getParticleAt(iParticle);
-      if (particleFilters[0]->accept(particle))
+      if (analysisContext)
         {
-        incrementNParticlesAccepted(iEventFilter,0);
-        rapidity = fabs(particle.getMomentum().Rapidity());
-        for (int iY=0; iY<nBins_rapidity; iY++)
-          {
-          if (rapidity<deltaRapidtyBin[iY]) nAccepted0[iY]++;
-          }
+        // particle filters already evaluated by the shared analysis context
+        countRapidity(analysisContext->getAcceptedParticles(particleFilterSlots[0]),countsY0);
+        countRapidity(analysisContext->getAcceptedParticles(particleFilterSlots[1]),countsY1);
         }
-      if (particleFilters[1]->accept(particle))
+      else
         {
-        incrementNParticlesAccepted(iEventFilter,1);
-        rapidity = fabs(particle.getMomentum().Rapidity());
-        for (int iY=0; iY<nBins_rapidity; iY++)
+        particles0.clear();
+        particles1.clear();
+        for (unsigned long  iParticle=0; iParticle<event->getNParticles(); iParticle++)
           {
-          if (rapidity<deltaRapidtyBin[iY]) nAccepted1[iY]++;
+          Particle * particle = event->getParticleAt(iParticle);
+          if (particleFilters[0]->accept(*particle)) particles0.push_back(particle);
+          if (particleFilters[1]->accept(*particle)) particles1.push_back(particle);
           }
+        countRapidity(particles0,countsY0);
+        countRapidity(particles1,countsY1);
         }
+      counted = true;
       }
-    EventProperties ep = * event->getEventProperties();
+    long nParticles0 = 0, nParticles1 = 0;
+    for (int iY=0; iY<=nBins_rapidity; iY++)
+      {
+      nParticles0 += long(countsY0[iY]);
+      nParticles1 += long(countsY1[iY]);
+      }
+    addNParticlesAccepted(iEventFilter,0,nParticles0);
+    addNParticlesAccepted(iEventFilter,1,nParticles1);
+
+    // NuDynHistos::fill turns the bin counts into window counts in place
+    nAccepted0.assign(countsY0.begin(),countsY0.begin()+nBins_rapidity);
+    nAccepted1.assign(countsY1.begin(),countsY1.begin()+nBins_rapidity);
+    const EventProperties & ep = * event->getEventProperties();
     NuDynHistos * nuDynHistos = (NuDynHistos *)  histogramManager.getGroup(0,iEventFilter);
     switch ( multiplicityType )
       {
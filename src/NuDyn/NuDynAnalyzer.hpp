@@ -87,12 +87,42 @@ public:
   virtual void calculateDerivedHistograms();
 
 protected:
+
+  //!
+  //! Index of the rapidity bin of the given |y|: bin 0 holds |y| < deltaRapidtyBin[0] and bin iY>0 holds
+  //! deltaRapidtyBin[iY-1] <= |y| < deltaRapidtyBin[iY]. Returns nBins_rapidity if |y| is beyond the widest window or is not a number.
+  //!
+  inline int getRapidityBin(double absY) const
+  {
+  if (absY!=absY) return nBins_rapidity;
+  // clamp before the conversion to int: infinite or very large |y| would overflow it
+  double x  = absY<min_rapidity ? -1.0 : (absY-min_rapidity)/width_rapidity;
+  int    iY = x<0.0 ? 0 : (x>=double(nBins_rapidity) ? nBins_rapidity : 1+int(x));
+  if (iY>nBins_rapidity) iY = nBins_rapidity;
+  // align with the window edges exactly
+  while (iY<nBins_rapidity && absY>=deltaRapidtyBin[iY]) iY++;
+  while (iY>0 && absY<deltaRapidtyBin[iY-1]) iY--;
+  return iY;
+  }
+
+  //!
+  //! Histogram the |y| of the given particles in the rapidity bins; the counts of the rapidity windows are obtained by a
+  //! prefix sum over the bins (see NuDynHistos::fill).
+  //!
+  void countRapidity(const vector<Particle*> & particles, vector<double> & counts) const;
+
   int    multiplicityType; //!< variable used to select which event property is used to differential studies of the moments. This variable is set the class parameter "inputType".
   int    nBins_rapidity;
   double min_rapidity;
   double max_rapidity;
   double width_rapidity;
   vector<double> deltaRapidtyBin;
+  vector<double> countsY0;     //!< |y| histogram of the particles of filter 0 of the current event
+  vector<double> countsY1;     //!< |y| histogram of the particles of filter 1 of the current event
+  vector<double> nAccepted0;   //!< counts of particles of filter 0 in the rapidity windows (filled by NuDynHistos::fill)
+  vector<double> nAccepted1;   //!< counts of particles of filter 1 in the rapidity windows (filled by NuDynHistos::fill)
+  vector<Particle*> particles0; //!< particles of the current event accepted by filter 0 (without analysis context)
+  vector<Particle*> particles1; //!< particles of the current event accepted by filter 1 (without analysis context)
 
 
   ClassDef(NuDynAnalyzer,0)
@@ -227,20 +227,21 @@ void NuDynHistos::fill(double mult, vector<double> & nAccepted0, vector<double>
       nAccepted0[iY] += nAccepted0[iY-1];
       nAccepted1[iY] += nAccepted1[iY-1];
       }
+    // falling factorials are built incrementally: n(n-1)(n-2) = [n(n-1)](n-2), etc.
     n1_0    = nAccepted0[iY];
     n1_1    = nAccepted1[iY];
     n2_00   = n1_0 * (n1_0 - 1);
     n2_01   = n1_0 * n1_1;
     n2_11   = n1_1 * (n1_1 - 1);
-    n3_000  = n1_0 * (n1_0 - 1) * (n1_0 - 2);
-    n3_001  = n1_0 * (n1_0 - 1) * n1_1;
-    n3_011  = n1_0 * n1_1 * (n1_1 - 1);
-    n3_111  = n1_1 * (n1_1 - 1) * (n1_1 - 2);
-    n4_0000  = n1_0 * (n1_0 - 1) * (n1_0 - 2) * (n1_0 - 3);
-    n4_0001  = n1_0 * (n1_0 - 1) * (n1_0 - 2) * n1_1;
-    n4_0011  = n1_0 * (n1_0 - 1) * n1_1 * (n1_1 - 1);
-    n4_0111  = n1_0 * n1_1 * (n1_1 - 1) * (n1_1 - 2);
-    n4_1111  = n1_1 * (n1_1 - 1) * (n1_1 - 2) * (n1_1 - 3);
+    n3_000  = n2_00 * (n1_0 - 2);
+    n3_001  = n2_00 * n1_1;
+    n3_011  = n1_0 * n2_11;
+    n3_111  = n2_11 * (n1_1 - 2);
+    n4_0000  = n3_000 * (n1_0 - 3);
+    n4_0001  = n3_000 * n1_1;
+    n4_0011  = n2_00 * n2_11;
+    n4_0111  = n1_0 * n3_111;
+    n4_1111  = n3_111 * (n1_1 - 3);
     deltaY = deltaRapidtyBin[iY];
     h_f1[0]->Fill(mult,deltaY,n1_0);
     h_f1[1]->Fill(mult,deltaY,n1_1);
@@ -0,0 +1,144 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "EventMixingPool.hpp"
+using CAP::EventMixingRecord;
+using CAP::EventMixingPool;
+using CAP::ParticleDigit;
+
+ClassImp(EventMixingRecord);
+
+ClassImp(EventMixingPool);
+
+EventMixingRecord::EventMixingRecord()
+:
+begin(),
+iY(), iEta(), iPhi(), iPt(),
+pt(), phi(), eta(), y(), e()
+{ }
+
+void EventMixingRecord::clear()
+{
+  begin.clear();
+  iY.clear(); iEta.clear(); iPhi.clear(); iPt.clear();
+  pt.clear(); phi.clear(); eta.clear(); y.clear(); e.clear();
+}
+
+EventMixingPool::EventMixingPool()
+:
+nEventFilters(0),
+nParticleFilters(0),
+nBins_mult(0), min_mult(0.0), max_mult(0.0), scale_mult(0.0),
+nBins_z(0),    min_z(0.0),    max_z(0.0),    scale_z(0.0),
+nClasses(0),
+depth(0),
+records(),
+nStored(),
+head(),
+digitBuffer(),
+eventDigits()
+{ }
+
+void EventMixingPool::initialize(int _nEventFilters, int _nParticleFilters,
+                                 int _nBins_mult, double _min_mult, double _max_mult,
+                                 int _nBins_z,    double _min_z,    double _max_z,
+                                 int _depth)
+{
+  nEventFilters    = _nEventFilters;
+  nParticleFilters = _nParticleFilters;
+  nBins_mult = _nBins_mult>0 ? _nBins_mult : 1;
+  min_mult   = _min_mult;
+  max_mult   = _max_mult;
+  scale_mult = double(nBins_mult)/(max_mult-min_mult);
+  nBins_z    = _nBins_z>0 ? _nBins_z : 1;
+  min_z      = _min_z;
+  max_z      = _max_z;
+  scale_z    = double(nBins_z)/(max_z-min_z);
+  nClasses   = nBins_mult*nBins_z;
+  depth      = _depth>0 ? _depth : 1;
+  records.assign(nEventFilters*nClasses*depth, EventMixingRecord());
+  nStored.assign(nEventFilters*nClasses, 0);
+  head.assign(nEventFilters*nClasses, 0);
+  eventDigits.resize(nParticleFilters);
+}
+
+void EventMixingPool::clear()
+{
+  for (unsigned int k=0; k<records.size(); k++) records[k].clear();
+  nStored.assign(nStored.size(), 0);
+  head.assign(head.size(), 0);
+}
+
+int EventMixingPool::getClassIndex(double mult, double z) const
+{
+  if (mult<min_mult || mult>=max_mult) return -1;
+  if (z<min_z || z>=max_z) return -1;
+  int iMult = int(scale_mult*(mult-min_mult));
+  int iZ    = int(scale_z*(z-min_z));
+  return iMult*nBins_z + iZ;
+}
+
+const vector< vector<ParticleDigit*> > & EventMixingPool::getEvent(int iEventFilter, int iClass, unsigned int age)
+{
+  int iPool = iEventFilter*nClasses + iClass;
+  int iSlot = (int(head[iPool]) - 1 - int(age) + 2*depth) % depth;
+  const EventMixingRecord & record = records[iPool*depth + iSlot];
+  unsigned int nDigits = record.pt.size();
+  if (digitBuffer.size()<nDigits) digitBuffer.resize(nDigits);
+  for (unsigned int k=0; k<nDigits; k++)
+    {
+    ParticleDigit & digit = digitBuffer[k];
+    digit.iY   = record.iY[k];
+    digit.iEta = record.iEta[k];
+    digit.iPhi = record.iPhi[k];
+    digit.iPt  = record.iPt[k];
+    digit.pt   = record.pt[k];
+    digit.phi  = record.phi[k];
+    digit.eta  = record.eta[k];
+    digit.y    = record.y[k];
+    digit.e    = record.e[k];
+    }
+  for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++)
+    {
+    vector<ParticleDigit*> & digits = eventDigits[iParticleFilter];
+    digits.clear();
+    for (unsigned int k=record.begin[iParticleFilter]; k<record.begin[iParticleFilter+1]; k++) digits.push_back(&digitBuffer[k]);
+    }
+  return eventDigits;
+}
+
+void EventMixingPool::push(int iEventFilter, int iClass, const vector<const vector<ParticleDigit*>*> & digits)
+{
+  int iPool = iEventFilter*nClasses + iClass;
+  EventMixingRecord & record = records[iPool*depth + head[iPool]];
+  record.clear();
+  record.begin.push_back(0);
+  for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++)
+    {
+    const vector<ParticleDigit*> & list = *digits[iParticleFilter];
+    for (unsigned int k=0; k<list.size(); k++)
+      {
+      const ParticleDigit & digit = *list[k];
+      record.iY.push_back(digit.iY);
+      record.iEta.push_back(digit.iEta);
+      record.iPhi.push_back(digit.iPhi);
+      record.iPt.push_back(digit.iPt);
+      record.pt.push_back(digit.pt);
+      record.phi.push_back(digit.phi);
+      record.eta.push_back(digit.eta);
+      record.y.push_back(digit.y);
+      record.e.push_back(digit.e);
+      }
+    record.begin.push_back(record.pt.size());
+    }
+  head[iPool] = (head[iPool]+1) % depth;
+  if (int(nStored[iPool])<depth) nStored[iPool]++;
+}
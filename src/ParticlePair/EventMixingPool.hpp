@@ -0,0 +1,139 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventMixingPool
+#define CAP__EventMixingPool
+#include <vector>
+#include "TObject.h"
+#include "ParticleDigit.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Digitized particles of one event stored in structure-of-arrays form. The particles accepted by particle filter iFilter occupy
+//! the index range [begin[iFilter], begin[iFilter+1]) of the arrays.
+//!
+class EventMixingRecord
+{
+public:
+
+  EventMixingRecord();
+  virtual ~EventMixingRecord() {}
+
+  void clear();
+
+  vector<unsigned int> begin;
+  vector<unsigned int> iY;
+  vector<unsigned int> iEta;
+  vector<unsigned int> iPhi;
+  vector<unsigned int> iPt;
+  vector<float> pt;
+  vector<float> phi;
+  vector<float> eta;
+  vector<float> y;
+  vector<float> e;
+
+  ClassDef(EventMixingRecord,0)
+};
+
+//!
+//! Bounded pools of recent events used for event mixing. Events are classified by event filter and by event class, the latter
+//! determined by the event multiplicity and a second event variable (e.g., the vertex position), each binned uniformly. Each
+//! (event filter, event class) pool is a ring buffer holding at most depth events: pushing an event into a full pool overwrites its
+//! oldest event. The memory used is thus bounded by the pool depth and the number of classes, and the record storage is reused
+//! from one event to the next. Events are stored as digits (not Particle objects) and can be retrieved as lists of ParticleDigit
+//! suitable for the ParticlePairHistos fill methods.
+//!
+class EventMixingPool
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  EventMixingPool();
+
+  //!
+  //! DTOR
+  //!
+  virtual ~EventMixingPool() {}
+
+  //!
+  //! Set the number of filters, the event class binning, and the pool depth, and allocate the (empty) pools.
+  //!
+  void initialize(int _nEventFilters, int _nParticleFilters,
+                  int _nBins_mult, double _min_mult, double _max_mult,
+                  int _nBins_z,    double _min_z,    double _max_z,
+                  int _depth);
+
+  //!
+  //! Remove all the events from the pools.
+  //!
+  void clear();
+
+  //!
+  //! Return the class index of an event with the given multiplicity and z values, or -1 if the event is out of the class bounds.
+  //!
+  int getClassIndex(double mult, double z) const;
+
+  //!
+  //! Number of events currently held by the pool of the given event filter and class.
+  //!
+  inline unsigned int getNEvents(int iEventFilter, int iClass) const
+  {
+  return nStored[iEventFilter*nClasses + iClass];
+  }
+
+  //!
+  //! Return the digits of the event at the given age (0 being the most recent event) in the pool of the given event filter and class,
+  //! as one list per particle filter. The lists remain valid until the next call of this function.
+  //!
+  const vector< vector<ParticleDigit*> > & getEvent(int iEventFilter, int iClass, unsigned int age);
+
+  //!
+  //! Copy the given digits (one list per particle filter) into the pool of the given event filter and class.
+  //!
+  void push(int iEventFilter, int iClass, const vector<const vector<ParticleDigit*>*> & digits);
+
+  inline int getNClasses() const { return nClasses; }
+  inline int getDepth() const    { return depth;    }
+
+protected:
+
+  int    nEventFilters;
+  int    nParticleFilters;
+  int    nBins_mult;
+  double min_mult;
+  double max_mult;
+  double scale_mult;
+  int    nBins_z;
+  double min_z;
+  double max_z;
+  double scale_z;
+  int    nClasses;   //!< number of event classes: nBins_mult*nBins_z
+  int    depth;      //!< maximum number of events held by each pool
+
+  vector<EventMixingRecord> records; //!< ring buffers: record iPool*depth + iSlot
+  vector<unsigned int> nStored;      //!< number of events held by each pool
+  vector<unsigned int> head;         //!< slot of the next event to be written in each pool
+
+  vector<ParticleDigit> digitBuffer;
+  vector< vector<ParticleDigit*> > eventDigits;
+
+  ClassDef(EventMixingPool,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventMixingPool  */
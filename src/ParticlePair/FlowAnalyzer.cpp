@@ -0,0 +1,277 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "FlowAnalyzer.hpp"
+#include "FlowHistos.hpp"
+#include "FlowDerivedHistos.hpp"
+using CAP::FlowAnalyzer;
+
+ClassImp(FlowAnalyzer);
+
+FlowAnalyzer::FlowAnalyzer(const String & _name,
+                           const Configuration & _configuration,
+                           vector<EventFilter*> & _eventFilters,
+                           vector<ParticleFilter*> & _particleFilters)
+:
+EventTask(_name, _configuration, _eventFilters, _particleFilters),
+maxHarmonic(8),
+etaGap(0.0),
+multiplicityType(2),
+qVectors(),
+particles()
+{
+  appendClassName("FlowAnalyzer");
+}
+
+void FlowAnalyzer::setDefaultConfiguration()
+{
+  EventTask::setDefaultConfiguration();
+  addParameter("EventsAnalyze",     true);
+  addParameter("HistogramsCreate",  true);
+  addParameter("HistogramsExport",  true);
+  addParameter("EventsUseStream0",  true);
+  addParameter("EventsUseStream1",  false);
+  addParameter("MaxHarmonic",       maxHarmonic);
+  addParameter("EtaGap",            etaGap);
+  addParameter("InputType",         multiplicityType);
+  addParameter("nBins_mult",        100);
+  addParameter("Min_mult",          0.0);
+  addParameter("Max_mult",          1000.0);
+}
+
+void FlowAnalyzer::configure()
+{
+  EventTask::configure();
+  maxHarmonic      = getValueInt("MaxHarmonic");
+  etaGap           = getValueDouble("EtaGap");
+  multiplicityType = getValueInt("InputType");
+  if (maxHarmonic<1)
+    {
+    if (reportWarning(__FUNCTION__)) cout << "MaxHarmonic:" << maxHarmonic << " is invalid. Using MaxHarmonic=1" << endl;
+    maxHarmonic = 1;
+    addParameter("MaxHarmonic",maxHarmonic);
+    }
+
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("EventsAnalyze");
+    printItem("EventsUseStream0");
+    printItem("EventsUseStream1");
+    printItem("HistogramsCreate");
+    printItem("HistogramsExport");
+    printItem("MaxHarmonic", maxHarmonic);
+    printItem("EtaGap",      etaGap);
+    printItem("InputType",   multiplicityType);
+    printItem("nBins_mult");
+    printItem("Min_mult");
+    printItem("Max_mult");
+    }
+}
+
+void FlowAnalyzer::initialize()
+{
+  EventTask::initialize();
+  qVectors.assign(3*particleFilters.size(),FlowQVector(maxHarmonic));
+}
+
+void FlowAnalyzer::fillQVectors(int iParticleFilter, const vector<Particle*> & accepted)
+{
+  FlowQVector & q  = qVectors[3*iParticleFilter];
+  FlowQVector & qA = qVectors[3*iParticleFilter+1];
+  FlowQVector & qB = qVectors[3*iParticleFilter+2];
+  q.reset();
+  qA.reset();
+  qB.reset();
+  double halfGap = 0.5*etaGap;
+  for (unsigned int iParticle=0; iParticle<accepted.size(); iParticle++)
+    {
+    const Particle & particle = *accepted[iParticle];
+    double phi = particle.getPhi();
+    double eta = particle.getEta();
+    double cosPhi = cos(phi);
+    double sinPhi = sin(phi);
+    q.fill(cosPhi,sinPhi);
+    if (eta < -halfGap)
+      qA.fill(cosPhi,sinPhi);
+    else if (eta > halfGap)
+      qB.fill(cosPhi,sinPhi);
+    }
+}
+
+void FlowAnalyzer::createHistograms()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("Creating HistogramGroup","");
+    printItem("nEventFilters",    int(nEventFilters));
+    printItem("nParticleFilters", int(nParticleFilters));
+    cout << endl;
+    }
+  histogramManager.addSet("Flow");
+  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    {
+    String efn = eventFilters[iEventFilter]->getName();
+    for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      {
+      String pfn = particleFilters[iParticleFilter]->getName();
+      FlowHistos * histos = new FlowHistos(this,createName(getName(),efn,pfn),configuration);
+      histos->createHistograms();
+      histogramManager.addGroupInSet(0,histos);
+      }
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void FlowAnalyzer::importHistograms(TFile & inputFile)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("Loading HistogramGroup","");
+    printItem("nEventFilters",    int(nEventFilters));
+    printItem("nParticleFilters", int(nParticleFilters));
+    cout << endl;
+    }
+  histogramManager.addSet("Flow");
+  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    {
+    String efn = eventFilters[iEventFilter]->getName();
+    for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      {
+      String pfn = particleFilters[iParticleFilter]->getName();
+      FlowHistos * histos = new FlowHistos(this,createName(getName(),efn,pfn),configuration);
+      histos->importHistograms(inputFile);
+      histogramManager.addGroupInSet(0,histos);
+      }
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void FlowAnalyzer::analyzeEvent()
+{
+  incrementTaskExecuted();
+  Event * event = eventStreams[0];
+  resetNParticlesAcceptedEvent();
+  // the flow vectors do not depend on the event filter: they are computed once for the first accepting event filter.
+  bool computed = false;
+  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    {
+    bool accepted = analysisContext ? analysisContext->isEventAccepted(eventFilterSlots[iEventFilter]) : eventFilters[iEventFilter]->accept(*event);
+    if (!accepted) continue;
+    incrementNEventsAccepted(iEventFilter);
+
+    if (!computed)
+      {
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        if (analysisContext)
+          {
+          // particle filters already evaluated by the shared analysis context
+          fillQVectors(iParticleFilter,analysisContext->getAcceptedParticles(particleFilterSlots[iParticleFilter]));
+          }
+        else
+          {
+          particles.clear();
+          for (unsigned long iParticle=0; iParticle<event->getNParticles(); iParticle++)
+            {
+            Particle * particle = event->getParticleAt(iParticle);
+            if (particleFilters[iParticleFilter]->accept(*particle)) particles.push_back(particle);
+            }
+          fillQVectors(iParticleFilter,particles);
+          }
+        }
+      computed = true;
+      }
+
+    const EventProperties & ep = * event->getEventProperties();
+    for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      {
+      const FlowQVector & q = qVectors[3*iParticleFilter];
+      addNParticlesAccepted(iEventFilter,iParticleFilter,long(q.getMultiplicity()));
+      double mult = q.getMultiplicity();
+      switch ( multiplicityType )
+        {
+          case 0: mult = ep.fractionalXSection; break;
+          case 1: mult = ep.refMultiplicity;    break;
+        }
+      int index = iEventFilter*nParticleFilters + iParticleFilter;
+      FlowHistos * histos = (FlowHistos *) histogramManager.getGroup(0,index);
+      histos->fill(mult,q,qVectors[3*iParticleFilter+1],qVectors[3*iParticleFilter+2],1.0);
+      }
+    }
+}
+
+void FlowAnalyzer::createDerivedHistograms()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("Create Derived HistogramGroup","");
+    printItem("nEventFilters",    int(nEventFilters));
+    printItem("nParticleFilters", int(nParticleFilters));
+    cout << endl;
+    }
+  histogramManager.addSet("FlowDerived");
+  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    {
+    String efn = eventFilters[iEventFilter]->getName();
+    for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      {
+      String pfn = particleFilters[iParticleFilter]->getName();
+      FlowDerivedHistos * histos = new FlowDerivedHistos(this,createName(getName(),efn,pfn),configuration);
+      histos->createHistograms();
+      histogramManager.addGroupInSet(1,histos);
+      }
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void FlowAnalyzer::importDerivedHistograms(TFile & inputFile __attribute__((unused)))
+{
+
+}
+
+void FlowAnalyzer::calculateDerivedHistograms()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("Calculate Derived Histograms","");
+    printItem("nEventFilters",    int(nEventFilters));
+    printItem("nParticleFilters", int(nParticleFilters));
+    cout << endl;
+    }
+  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+    {
+    for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+      {
+      int index = iEventFilter*nParticleFilters + iParticleFilter;
+      FlowHistos        * baseHistos    = (FlowHistos *) histogramManager.getGroup(0,index);
+      FlowDerivedHistos * derivedHistos = (FlowDerivedHistos *) histogramManager.getGroup(1,index);
+      derivedHistos->calculateDerivedHistograms(baseHistos);
+      }
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
@@ -0,0 +1,111 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__FlowAnalyzer
+#define CAP__FlowAnalyzer
+#include "EventTask.hpp"
+#include "Event.hpp"
+#include "Particle.hpp"
+#include "FlowQVector.hpp"
+
+namespace CAP
+{
+
+//!
+//! Task used for the determination of the flow harmonics v_n, n=1..MaxHarmonic, with multi-particle cumulants. For each event
+//! and each particle filter, the flow vectors Q_n of the full event and of two sub-events separated by a pseudorapidity gap are
+//! computed in a single pass over the particles, i.e., in O(N), and used to compute the event-wise correlators <2>, <4>,
+//! <2>_{a,b} and <4>_{a,b} (see FlowQVector). These are averaged with FlowHistos; c_n{2}, c_n{4}, v_n{2}, and v_n{4} (and
+//! their sub-event counterparts) are computed by FlowDerivedHistos. Use ParticlePairAnalyzer only when the full shape of
+//! the pair correlation functions is needed.
+//!
+//! Configuration parameters (default values in brackets):
+//!
+//! - MaxHarmonic [8]: highest harmonic
+//! - EtaGap [0.0]: pseudorapidity gap between the sub-events a (eta < -EtaGap/2) and b (eta > EtaGap/2)
+//! - InputType [2]: event property used as independent variable of the _vsMult histograms:
+//!   0: fractional cross section, 1: reference multiplicity, 2: multiplicity accepted by the particle filter
+//! - nBins_mult [100], Min_mult [0.0], Max_mult [1000.0]: binning of the _vsMult histograms
+//!
+class FlowAnalyzer : public EventTask
+{
+public:
+
+  //!
+  //! Detailed CTOR
+  //!
+  //! @param _name Name given to task instance
+  //! @param _configuration Configuration used to run this task
+  //! @param _eventFilters Array of event filters to be used by this task
+  //! @param _particleFilters Array of particle filters to be used by this task
+  //!
+  FlowAnalyzer(const String & _name,
+               const Configuration & _configuration,
+               vector<EventFilter*> & _eventFilters,
+               vector<ParticleFilter*> & _particleFilters);
+
+  //!
+  //!DTOR
+  //!
+  virtual ~FlowAnalyzer() {}
+
+  //!
+  //! Sets the default  values of the configuration parameters used by this task
+  //!
+  virtual void setDefaultConfiguration();
+
+  virtual void configure();
+
+  //!
+  //!Initialize this task.
+  //!
+  virtual void initialize();
+
+  //!
+  //! Execute this task based on the configuration and class variables specified at construction
+  //!
+  virtual void analyzeEvent();
+
+  //!
+  //! Creates the histograms  filled by this task at execution
+  //!
+  virtual void createHistograms();
+
+  //!
+  //! Loads the histograms retquired by this task at execution
+  //!
+  virtual void importHistograms(TFile & inputFile);
+
+  virtual void createDerivedHistograms();
+
+  virtual void importDerivedHistograms(TFile & inputFile __attribute__((unused)));
+
+  virtual void calculateDerivedHistograms();
+
+protected:
+
+  //!
+  //! Accumulate the flow vectors of the given particles for the given particle filter.
+  //!
+  void fillQVectors(int iParticleFilter, const vector<Particle*> & accepted);
+
+  int    maxHarmonic;
+  double etaGap;
+  int    multiplicityType;
+  vector<FlowQVector> qVectors;      //!< flow vectors of the current event, [3*iParticleFilter+k], k=0: full event, k=1,2: sub-events a,b
+  vector<Particle*>   particles;     //!< particles of the current event accepted by a filter (without analysis context)
+
+  ClassDef(FlowAnalyzer,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__FlowAnalyzer */
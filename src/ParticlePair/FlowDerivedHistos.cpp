@@ -0,0 +1,159 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "FlowDerivedHistos.hpp"
+using CAP::FlowDerivedHistos;
+
+ClassImp(FlowDerivedHistos);
+
+FlowDerivedHistos::FlowDerivedHistos(Task * _parent,
+                                     const String & _name,
+                                     const Configuration & _configuration)
+:
+HistogramGroup(_parent,_name,_configuration),
+maxHarmonic(0),
+nBins_mult(0),
+min_mult(0.0),
+max_mult(0.0),
+h_c2(nullptr),
+h_c4(nullptr),
+h_v2(nullptr),
+h_v4(nullptr),
+h_c2Gap(nullptr),
+h_c4Sub(nullptr),
+h_v2Gap(nullptr),
+h_v4Sub(nullptr),
+h_c2_vsMult(nullptr),
+h_c4_vsMult(nullptr),
+h_v2_vsMult(nullptr),
+h_v4_vsMult(nullptr),
+h_c2Gap_vsMult(nullptr),
+h_c4Sub_vsMult(nullptr),
+h_v2Gap_vsMult(nullptr),
+h_v4Sub_vsMult(nullptr)
+{
+  appendClassName("FlowDerivedHistos");
+}
+
+void FlowDerivedHistos::createHistograms()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  const String & bn  = getName();
+  const String & ppn = getParentPathName();
+  maxHarmonic = configuration.getValueInt(ppn,"MaxHarmonic");
+  nBins_mult  = configuration.getValueInt(ppn,"nBins_mult");
+  min_mult    = configuration.getValueDouble(ppn,"Min_mult");
+  max_mult    = configuration.getValueDouble(ppn,"Max_mult");
+
+  double min_n = 0.5;
+  double max_n = double(maxHarmonic)+0.5;
+  h_c2    = createHistogram(createName(bn,"c2"),   maxHarmonic,min_n,max_n,"n","c_{n}{2}");
+  h_c4    = createHistogram(createName(bn,"c4"),   maxHarmonic,min_n,max_n,"n","c_{n}{4}");
+  h_v2    = createHistogram(createName(bn,"v2"),   maxHarmonic,min_n,max_n,"n","v_{n}{2}");
+  h_v4    = createHistogram(createName(bn,"v4"),   maxHarmonic,min_n,max_n,"n","v_{n}{4}");
+  h_c2Gap = createHistogram(createName(bn,"c2Gap"),maxHarmonic,min_n,max_n,"n","c_{n}{2,|#Delta#eta|}");
+  h_c4Sub = createHistogram(createName(bn,"c4Sub"),maxHarmonic,min_n,max_n,"n","c_{n}{4}_{a,b}");
+  h_v2Gap = createHistogram(createName(bn,"v2Gap"),maxHarmonic,min_n,max_n,"n","v_{n}{2,|#Delta#eta|}");
+  h_v4Sub = createHistogram(createName(bn,"v4Sub"),maxHarmonic,min_n,max_n,"n","v_{n}{4}_{a,b}");
+  h_c2_vsMult    = createHistogram(createName(bn,"c2_vsMult"),   nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","c_{n}{2}");
+  h_c4_vsMult    = createHistogram(createName(bn,"c4_vsMult"),   nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","c_{n}{4}");
+  h_v2_vsMult    = createHistogram(createName(bn,"v2_vsMult"),   nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","v_{n}{2}");
+  h_v4_vsMult    = createHistogram(createName(bn,"v4_vsMult"),   nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","v_{n}{4}");
+  h_c2Gap_vsMult = createHistogram(createName(bn,"c2Gap_vsMult"),nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","c_{n}{2,|#Delta#eta|}");
+  h_c4Sub_vsMult = createHistogram(createName(bn,"c4Sub_vsMult"),nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","c_{n}{4}_{a,b}");
+  h_v2Gap_vsMult = createHistogram(createName(bn,"v2Gap_vsMult"),nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","v_{n}{2,|#Delta#eta|}");
+  h_v4Sub_vsMult = createHistogram(createName(bn,"v4Sub_vsMult"),nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","v_{n}{4}_{a,b}");
+
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+//________________________________________________________________________
+void FlowDerivedHistos::importHistograms(TFile & inputFile)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  const String & bn  = getName();
+  const String & ppn = getParentPathName();
+  maxHarmonic = configuration.getValueInt(ppn,"MaxHarmonic");
+  nBins_mult  = configuration.getValueInt(ppn,"nBins_mult");
+  min_mult    = configuration.getValueDouble(ppn,"Min_mult");
+  max_mult    = configuration.getValueDouble(ppn,"Max_mult");
+
+  h_c2    = loadH1(inputFile,createName(bn,"c2"));
+  h_c4    = loadH1(inputFile,createName(bn,"c4"));
+  h_v2    = loadH1(inputFile,createName(bn,"v2"));
+  h_v4    = loadH1(inputFile,createName(bn,"v4"));
+  h_c2Gap = loadH1(inputFile,createName(bn,"c2Gap"));
+  h_c4Sub = loadH1(inputFile,createName(bn,"c4Sub"));
+  h_v2Gap = loadH1(inputFile,createName(bn,"v2Gap"));
+  h_v4Sub = loadH1(inputFile,createName(bn,"v4Sub"));
+  h_c2_vsMult    = loadH2(inputFile,createName(bn,"c2_vsMult"));
+  h_c4_vsMult    = loadH2(inputFile,createName(bn,"c4_vsMult"));
+  h_v2_vsMult    = loadH2(inputFile,createName(bn,"v2_vsMult"));
+  h_v4_vsMult    = loadH2(inputFile,createName(bn,"v4_vsMult"));
+  h_c2Gap_vsMult = loadH2(inputFile,createName(bn,"c2Gap_vsMult"));
+  h_c4Sub_vsMult = loadH2(inputFile,createName(bn,"c4Sub_vsMult"));
+  h_v2Gap_vsMult = loadH2(inputFile,createName(bn,"v2Gap_vsMult"));
+  h_v4Sub_vsMult = loadH2(inputFile,createName(bn,"v4Sub_vsMult"));
+
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void FlowDerivedHistos::calculateDerivedHistograms(FlowHistos * baseHistos)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  FlowHistos & source = *baseHistos;
+  calculateCumulants(source.h_two,   source.h_four,   h_c2,   h_c4,   h_v2,   h_v4);
+  calculateCumulants(source.h_twoGap,source.h_fourSub,h_c2Gap,h_c4Sub,h_v2Gap,h_v4Sub);
+  calculateCumulants(source.h_two_vsMult,   source.h_four_vsMult,   h_c2_vsMult,   h_c4_vsMult,   h_v2_vsMult,   h_v4_vsMult);
+  calculateCumulants(source.h_twoGap_vsMult,source.h_fourSub_vsMult,h_c2Gap_vsMult,h_c4Sub_vsMult,h_v2Gap_vsMult,h_v4Sub_vsMult);
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void FlowDerivedHistos::calculateCumulants(const TH1 * two, const TH1 * four, TH1 * c2, TH1 * c4, TH1 * v2, TH1 * v4)
+{
+  // the profiles and the derived histograms have the same binning: loop over the global bins
+  int nCells = two->GetNcells();
+  for (int iCell=0; iCell<nCells; iCell++)
+    {
+    double two_v  = two->GetBinContent(iCell);
+    double two_e  = two->GetBinError(iCell);
+    double four_v = four->GetBinContent(iCell);
+    double four_e = four->GetBinError(iCell);
+    if (two_v==0.0 && two_e==0.0) continue;
+    double c2_v = two_v;
+    double c2_e = two_e;
+    c2->SetBinContent(iCell,c2_v);
+    c2->SetBinError(iCell,c2_e);
+    if (c2_v>0.0)
+      {
+      double v2_v = sqrt(c2_v);
+      v2->SetBinContent(iCell,v2_v);
+      v2->SetBinError(iCell,c2_e/(2.0*v2_v));
+      }
+    if (four_v==0.0 && four_e==0.0) continue;
+    double c4_v = four_v - 2.0*two_v*two_v;
+    double c4_e = sqrt(four_e*four_e + 16.0*two_v*two_v*two_e*two_e);
+    c4->SetBinContent(iCell,c4_v);
+    c4->SetBinError(iCell,c4_e);
+    if (c4_v<0.0)
+      {
+      double v4_v = pow(-c4_v,0.25);
+      v4->SetBinContent(iCell,v4_v);
+      v4->SetBinError(iCell,c4_e/(4.0*v4_v*v4_v*v4_v));
+      }
+    }
+}
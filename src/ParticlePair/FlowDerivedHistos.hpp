@@ -0,0 +1,80 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__FlowDerivedHistos
+#define CAP__FlowDerivedHistos
+#include "HistogramGroup.hpp"
+#include "FlowHistos.hpp"
+
+namespace CAP
+{
+
+//!
+//! Cumulants and flow coefficients obtained from the correlators of FlowHistos, vs n and vs (mult, n):
+//!
+//!  c_n{2} = <<2>>,  c_n{4} = <<4>> - 2 <<2>>^2,  v_n{2} = c_n{2}^{1/2},  v_n{4} = (-c_n{4})^{1/4}
+//!
+//! and likewise from the sub-event correlators (c_n{2,|Deta|}, c_n{4}_{a,b}, ...). The flow coefficients are set only where the
+//! cumulants have the expected sign. Uncertainties are propagated from the profile errors neglecting the correlation between
+//! <<2>> and <<4>>; sub-samples should be used for accurate uncertainties.
+//!
+class FlowDerivedHistos : public HistogramGroup
+{
+public:
+
+  FlowDerivedHistos(Task * _parent,
+                    const String & _name,
+                    const Configuration & _configuration);
+  virtual ~FlowDerivedHistos() {}
+  virtual void createHistograms();
+  virtual void importHistograms(TFile & inputFile);
+  virtual void calculateDerivedHistograms(FlowHistos * baseHistos);
+
+protected:
+
+  //!
+  //! Compute the cumulants and flow coefficients bin by bin from the given two- and four-particle correlator profiles.
+  //!
+  void calculateCumulants(const TH1 * two, const TH1 * four, TH1 * c2, TH1 * c4, TH1 * v2, TH1 * v4);
+
+public:
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Data Members - HistogramGroup
+  ////////////////////////////////////////////////////////////////////////////
+  int    maxHarmonic;
+  int    nBins_mult;
+  double min_mult;
+  double max_mult;
+
+  TH1 * h_c2;
+  TH1 * h_c4;
+  TH1 * h_v2;
+  TH1 * h_v4;
+  TH1 * h_c2Gap;
+  TH1 * h_c4Sub;
+  TH1 * h_v2Gap;
+  TH1 * h_v4Sub;
+  TH2 * h_c2_vsMult;
+  TH2 * h_c4_vsMult;
+  TH2 * h_v2_vsMult;
+  TH2 * h_v4_vsMult;
+  TH2 * h_c2Gap_vsMult;
+  TH2 * h_c4Sub_vsMult;
+  TH2 * h_v2Gap_vsMult;
+  TH2 * h_v4Sub_vsMult;
+
+  ClassDef(FlowDerivedHistos,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__FlowDerivedHistos  */
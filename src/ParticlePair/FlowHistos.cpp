@@ -0,0 +1,143 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "FlowHistos.hpp"
+using CAP::FlowHistos;
+
+ClassImp(FlowHistos);
+
+FlowHistos::FlowHistos(Task * _parent,
+                       const String & _name,
+                       const Configuration & _configuration)
+:
+HistogramGroup(_parent,_name,_configuration),
+maxHarmonic(0),
+nBins_mult(0),
+min_mult(0.0),
+max_mult(0.0),
+h_n1(nullptr),
+h_two(nullptr),
+h_four(nullptr),
+h_twoGap(nullptr),
+h_fourSub(nullptr),
+h_two_vsMult(nullptr),
+h_four_vsMult(nullptr),
+h_twoGap_vsMult(nullptr),
+h_fourSub_vsMult(nullptr)
+{
+  appendClassName("FlowHistos");
+}
+
+void FlowHistos::createHistograms()
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  const String & bn  = getName();
+  const String & ptn = getParentName();
+  const String & ppn = getParentPathName();
+  maxHarmonic = configuration.getValueInt(ppn,"MaxHarmonic");
+  nBins_mult  = configuration.getValueInt(ppn,"nBins_mult");
+  min_mult    = configuration.getValueDouble(ppn,"Min_mult");
+  max_mult    = configuration.getValueDouble(ppn,"Max_mult");
+
+  if (reportDebug(__FUNCTION__))
+    {
+    cout << endl;
+    cout << "  Flow:Parent Task Name....................: " << ptn << endl;
+    cout << "  Flow:Parent Path Name....................: " << ppn << endl;
+    cout << "  Flow:Histo Base Name.....................: " << bn << endl;
+    cout << "  Flow:MaxHarmonic.........................: " << maxHarmonic << endl;
+    cout << "  Flow:nBins_mult..........................: " << nBins_mult << endl;
+    cout << "  Flow:Min_mult............................: " << min_mult << endl;
+    cout << "  Flow:Max_mult............................: " << max_mult << endl;
+    }
+
+  double min_n = 0.5;
+  double max_n = double(maxHarmonic)+0.5;
+  h_n1             = createHistogram(createName(bn,"n1"),nBins_mult,min_mult,max_mult,"n_1","N");
+  h_two            = createProfile(createName(bn,"two"),    maxHarmonic,min_n,max_n,"n","<<2>>");
+  h_four           = createProfile(createName(bn,"four"),   maxHarmonic,min_n,max_n,"n","<<4>>");
+  h_twoGap         = createProfile(createName(bn,"twoGap"), maxHarmonic,min_n,max_n,"n","<<2>>_{a,b}");
+  h_fourSub        = createProfile(createName(bn,"fourSub"),maxHarmonic,min_n,max_n,"n","<<4>>_{a,b}");
+  h_two_vsMult     = createProfile(createName(bn,"two_vsMult"),    nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","<<2>>");
+  h_four_vsMult    = createProfile(createName(bn,"four_vsMult"),   nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","<<4>>");
+  h_twoGap_vsMult  = createProfile(createName(bn,"twoGap_vsMult"), nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","<<2>>_{a,b}");
+  h_fourSub_vsMult = createProfile(createName(bn,"fourSub_vsMult"),nBins_mult,min_mult,max_mult,maxHarmonic,min_n,max_n,"mult","n","<<4>>_{a,b}");
+
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+//________________________________________________________________________
+void FlowHistos::importHistograms(TFile & inputFile)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  const String & bn  = getName();
+  const String & ppn = getParentPathName();
+  maxHarmonic = configuration.getValueInt(ppn,"MaxHarmonic");
+  nBins_mult  = configuration.getValueInt(ppn,"nBins_mult");
+  min_mult    = configuration.getValueDouble(ppn,"Min_mult");
+  max_mult    = configuration.getValueDouble(ppn,"Max_mult");
+
+  h_n1             = loadH1(inputFile,createName(bn,"n1"));
+  h_two            = loadProfile(inputFile,createName(bn,"two"));
+  h_four           = loadProfile(inputFile,createName(bn,"four"));
+  h_twoGap         = loadProfile(inputFile,createName(bn,"twoGap"));
+  h_fourSub        = loadProfile(inputFile,createName(bn,"fourSub"));
+  h_two_vsMult     = loadProfile2D(inputFile,createName(bn,"two_vsMult"));
+  h_four_vsMult    = loadProfile2D(inputFile,createName(bn,"four_vsMult"));
+  h_twoGap_vsMult  = loadProfile2D(inputFile,createName(bn,"twoGap_vsMult"));
+  h_fourSub_vsMult = loadProfile2D(inputFile,createName(bn,"fourSub_vsMult"));
+
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
+void FlowHistos::fill(double mult, const FlowQVector & q, const FlowQVector & qA, const FlowQVector & qB, double weight)
+{
+  double m  = q.getMultiplicity();
+  double mA = qA.getMultiplicity();
+  double mB = qB.getMultiplicity();
+  h_n1->Fill(m,weight);
+  // each event is weighted by its number of tuples
+  double wTwo     = weight*q.getTwoWeight();
+  double wFour    = weight*q.getFourWeight();
+  double wTwoGap  = weight*mA*mB;
+  double wFourSub = weight*qA.getTwoWeight()*qB.getTwoWeight();
+  for (int n=1; n<=maxHarmonic; n++)
+    {
+    if (m>=2.0)
+      {
+      double two = q.getTwo(n);
+      h_two->Fill(n,two,wTwo);
+      h_two_vsMult->Fill(mult,n,two,wTwo);
+      }
+    if (m>=4.0)
+      {
+      double four = q.getFour(n);
+      h_four->Fill(n,four,wFour);
+      h_four_vsMult->Fill(mult,n,four,wFour);
+      }
+    if (mA>=1.0 && mB>=1.0)
+      {
+      double twoGap = FlowQVector::getTwo(qA,qB,n);
+      h_twoGap->Fill(n,twoGap,wTwoGap);
+      h_twoGap_vsMult->Fill(mult,n,twoGap,wTwoGap);
+      }
+    if (mA>=2.0 && mB>=2.0)
+      {
+      double fourSub = FlowQVector::getFour(qA,qB,n);
+      h_fourSub->Fill(n,fourSub,wFourSub);
+      h_fourSub_vsMult->Fill(mult,n,fourSub,wFourSub);
+      }
+    }
+}
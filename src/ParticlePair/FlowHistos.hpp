@@ -0,0 +1,70 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__FlowHistos
+#define CAP__FlowHistos
+#include "HistogramGroup.hpp"
+#include "Configuration.hpp"
+#include "FlowQVector.hpp"
+
+namespace CAP
+{
+
+//!
+//! Event averaged multi-particle correlators of one event filter and one particle filter, for harmonics n=1..MaxHarmonic.
+//! Each profile holds the correlators vs n; the _vsMult profiles hold them vs (mult, n). Events are weighted by their number
+//! of tuples (e.g., M(M-1) for <2>) so the profiles hold the all-event averages <<2>>, <<4>>, etc.
+//!
+//!  h_two     : <<2>>_n
+//!  h_four    : <<4>>_n
+//!  h_twoGap  : <<2>>_n{a,b}  with one particle in each of the sub-events a (eta < -EtaGap/2) and b (eta > EtaGap/2)
+//!  h_fourSub : <<4>>_n{a,b}  with two particles in each sub-event
+//!
+class FlowHistos : public HistogramGroup
+{
+public:
+
+  FlowHistos(Task * _parent,
+             const String & _name,
+             const Configuration & _configuration);
+  virtual ~FlowHistos() {}
+  virtual void createHistograms();
+  virtual void importHistograms(TFile & inputFile);
+
+  //!
+  //! Fill the correlators of an event with flow vectors q (full event), qA and qB (sub-events) at the given multiplicity.
+  //!
+  virtual void fill(double mult, const FlowQVector & q, const FlowQVector & qA, const FlowQVector & qB, double weight);
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Data Members - HistogramGroup
+  ////////////////////////////////////////////////////////////////////////////
+  int    maxHarmonic;
+  int    nBins_mult;
+  double min_mult;
+  double max_mult;
+
+  TH1 *      h_n1;
+  TProfile * h_two;
+  TProfile * h_four;
+  TProfile * h_twoGap;
+  TProfile * h_fourSub;
+  TProfile2D * h_two_vsMult;
+  TProfile2D * h_four_vsMult;
+  TProfile2D * h_twoGap_vsMult;
+  TProfile2D * h_fourSub_vsMult;
+
+  ClassDef(FlowHistos,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__FlowHistos  */
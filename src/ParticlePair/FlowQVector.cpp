@@ -0,0 +1,65 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "FlowQVector.hpp"
+using CAP::FlowQVector;
+
+ClassImp(FlowQVector);
+
+FlowQVector::FlowQVector(int _maxHarmonic)
+:
+maxHarmonic(_maxHarmonic),
+nHarmonics(2*_maxHarmonic),
+qRe(2*_maxHarmonic+1,0.0),
+qIm(2*_maxHarmonic+1,0.0)
+{ }
+
+void FlowQVector::reset()
+{
+  qRe.assign(qRe.size(),0.0);
+  qIm.assign(qIm.size(),0.0);
+}
+
+double FlowQVector::getTwo(int n) const
+{
+  double m  = qRe[0];
+  double q2 = qRe[n]*qRe[n] + qIm[n]*qIm[n];
+  return (q2 - m)/(m*(m-1.0));
+}
+
+double FlowQVector::getFour(int n) const
+{
+  double m   = qRe[0];
+  double re  = qRe[n];
+  double im  = qIm[n];
+  double q2  = re*re + im*im;
+  double q2n = qRe[2*n]*qRe[2*n] + qIm[2*n]*qIm[2*n];
+  // Re(Q_2n Q_n* Q_n*)
+  double mixed = qRe[2*n]*(re*re-im*im) + 2.0*qIm[2*n]*re*im;
+  return (q2*q2 + q2n - 2.0*mixed - 4.0*(m-2.0)*q2 + 2.0*m*(m-3.0))/(m*(m-1.0)*(m-2.0)*(m-3.0));
+}
+
+double FlowQVector::getTwo(const FlowQVector & a, const FlowQVector & b, int n)
+{
+  return (a.qRe[n]*b.qRe[n] + a.qIm[n]*b.qIm[n])/(a.qRe[0]*b.qRe[0]);
+}
+
+double FlowQVector::getFour(const FlowQVector & a, const FlowQVector & b, int n)
+{
+  // sums over distinct pairs within each sub-event: Q_n Q_n - Q_2n
+  double aRe = a.qRe[n]*a.qRe[n] - a.qIm[n]*a.qIm[n] - a.qRe[2*n];
+  double aIm = 2.0*a.qRe[n]*a.qIm[n] - a.qIm[2*n];
+  double bRe = b.qRe[n]*b.qRe[n] - b.qIm[n]*b.qIm[n] - b.qRe[2*n];
+  double bIm = 2.0*b.qRe[n]*b.qIm[n] - b.qIm[2*n];
+  double ma  = a.qRe[0];
+  double mb  = b.qRe[0];
+  return (aRe*bRe + aIm*bIm)/(ma*(ma-1.0)*mb*(mb-1.0));
+}
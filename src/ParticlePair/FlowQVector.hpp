@@ -0,0 +1,131 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__FlowQVector
+#define CAP__FlowQVector
+#include <vector>
+#include "TObject.h"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Flow vectors Q_h = sum_i exp(i h phi_i), h=0..2 maxHarmonic, of the particles of one event (or sub-event). The harmonics
+//! up to 2 maxHarmonic are accumulated so the four-particle correlators of all harmonics n <= maxHarmonic can be computed.
+//! The cos(h phi) and sin(h phi) are obtained by recurrence from cos(phi) and sin(phi): filling costs a single pair of
+//! trigonometric calls per particle. Particles have unit weights. The multi-particle correlators, averaged over all tuples of
+//! distinct particles, are computed with the standard Q-cumulant expressions (A. Bilandzic et al., PRC 83, 044913), e.g.,
+//!
+//!   <2>_n = (|Q_n|^2 - M) / (M(M-1))
+//!   <4>_n = (|Q_n|^4 + |Q_2n|^2 - 2 Re(Q_2n Q_n* Q_n*) - 4(M-2)|Q_n|^2 + 2M(M-3)) / (M(M-1)(M-2)(M-3))
+//!
+//! and, for two (non-overlapping) sub-events a and b,
+//!
+//!   <2>_n{a,b} = Re(Q_n^a Q_n^b*) / (M_a M_b)
+//!   <4>_n{a,b} = Re((Q_n^a Q_n^a - Q_2n^a)(Q_n^b Q_n^b - Q_2n^b)*) / (M_a(M_a-1) M_b(M_b-1))
+//!
+class FlowQVector
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  //! @param _maxHarmonic highest harmonic n for which correlators are computed
+  //!
+  FlowQVector(int _maxHarmonic);
+
+  //!
+  //! DTOR
+  //!
+  virtual ~FlowQVector() {}
+
+  //!
+  //! Clear the flow vectors, e.g., at the beginning of an event.
+  //!
+  void reset();
+
+  //!
+  //! Add a particle with the given azimuth to the flow vectors.
+  //!
+  inline void fill(double cosPhi, double sinPhi)
+  {
+  double c = 1.0;
+  double s = 0.0;
+  qRe[0] += 1.0;
+  for (int h=1; h<=nHarmonics; h++)
+    {
+    double ch = c*cosPhi - s*sinPhi;
+    s = s*cosPhi + c*sinPhi;
+    c = ch;
+    qRe[h] += c;
+    qIm[h] += s;
+    }
+  }
+
+  inline double getMultiplicity() const { return qRe[0]; }
+  inline double getRe(int h) const { return qRe[h]; }
+  inline double getIm(int h) const { return qIm[h]; }
+  inline int    getMaxHarmonic() const { return maxHarmonic; }
+
+  //!
+  //! Number of distinct particle pairs, M(M-1), i.e., the weight of the two-particle correlator.
+  //!
+  inline double getTwoWeight() const
+  {
+  double m = qRe[0];
+  return m*(m-1.0);
+  }
+
+  //!
+  //! Number of distinct particle quadruplets, M(M-1)(M-2)(M-3), i.e., the weight of the four-particle correlator.
+  //!
+  inline double getFourWeight() const
+  {
+  double m = qRe[0];
+  return m*(m-1.0)*(m-2.0)*(m-3.0);
+  }
+
+  //!
+  //! Two-particle correlator <2>_n of this event; requires M >= 2.
+  //!
+  double getTwo(int n) const;
+
+  //!
+  //! Four-particle correlator <4>_n of this event; requires M >= 4.
+  //!
+  double getFour(int n) const;
+
+  //!
+  //! Two-particle correlator <2>_n{a,b} with one particle from each sub-event; requires M_a >= 1 and M_b >= 1.
+  //!
+  static double getTwo(const FlowQVector & a, const FlowQVector & b, int n);
+
+  //!
+  //! Four-particle correlator <4>_n{a,b} with two particles from each sub-event; requires M_a >= 2 and M_b >= 2.
+  //!
+  static double getFour(const FlowQVector & a, const FlowQVector & b, int n);
+
+protected:
+
+  int maxHarmonic;
+  int nHarmonics;      //!< number of accumulated harmonics, 2 maxHarmonic
+  vector<double> qRe;  //!< Re(Q_h), h=0..nHarmonics; qRe[0] is the multiplicity
+  vector<double> qIm;  //!< Im(Q_h), h=0..nHarmonics
+
+  ClassDef(FlowQVector,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__FlowQVector */
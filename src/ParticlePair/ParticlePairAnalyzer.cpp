@@ -25,7 +25,17 @@ ParticlePairAnalyzer::ParticlePairAnalyzer(const String & _name,
 EventTask(_name, _configuration, _eventFilters, _particleFilters),
 fillEta(true),
 fillY(false),
-fillP2(false)
+fillP2(false),
+filteredParticles(),
+binningSlot(-1),
+mixEvents(false),
+mixNEvents(5),
+mixingPool(),
+mixingDigits(),
+nMixedEvents(),
+variations(),
+variationMasks(),
+variationDigits()
 {
   appendClassName("ParticlePairAnalyzer");
   for (unsigned int k=0; k<particleFilters.size(); k++)
@@ -45,6 +55,21 @@ void ParticlePairAnalyzer::setDefaultConfiguration()
   addParameter("FillEta",           fillEta);
   addParameter("FillY",             fillY);
   addParameter("FillP2",            fillP2);
+  addParameter("Fill3D",            false);
+  addParameter("Fill3DSparse",      true);
+  addParameter("FillFFT",           false);
+  addParameter("FillFFTMinPairs",   10000);
+  addParameter("UseCounters",       true);
+  addParameter("MixEvents",         mixEvents);
+  addParameter("MixPoolDepth",      10);
+  addParameter("MixNEvents",        mixNEvents);
+  addParameter("nBins_MixMult",     10);
+  addParameter("Min_MixMult",       0.0);
+  addParameter("Max_MixMult",       1000.0);
+  addParameter("nBins_MixZ",        1);
+  addParameter("Min_MixZ",          -10.0);
+  addParameter("Max_MixZ",          10.0);
+  SelectionVariation::addParameters(*this);
   addParameter("nBins_n1",          100);
   addParameter("Min_n1",            0.0);
   addParameter("Max_n1",            100.0);
@@ -88,6 +113,7 @@ void ParticlePairAnalyzer::setDefaultConfiguration()
   addParameter("nBins_DeltaP",   10);
   addParameter("Min_DeltaP",   -4.0);
   addParameter("Max_DeltaP",    4.0);
+  addParameter("binCorrPP",     1.0);
 }
 
 void ParticlePairAnalyzer::configure()
@@ -96,7 +122,12 @@ void ParticlePairAnalyzer::configure()
   fillEta = getValueBool("FillEta");
   fillY   = getValueBool("FillY");
   fillP2  = getValueBool("FillP2");
-
+  mixEvents  = getValueBool("MixEvents");
+  mixNEvents = getValueInt("MixNEvents");
+  SelectionVariation::readVariations(*this,variations);
+  int nVariations = variations.size();
+  // mixing and variations operate on the digits provided by the shared analysis context
+  if (mixEvents || nVariations>0) eventsUseAnalysisContext = true;
 
   if (reportInfo(__FUNCTION__))
     {
@@ -111,6 +142,22 @@ void ParticlePairAnalyzer::configure()
     printItem("fillEta",fillEta);
     printItem("fillY",fillY);
     printItem("fillP2",fillP2);
+    printItem("Fill3D");
+    printItem("Fill3DSparse");
+    printItem("FillFFT");
+    printItem("FillFFTMinPairs");
+    printItem("UseCounters");
+    printItem("MixEvents");
+    printItem("MixPoolDepth");
+    printItem("MixNEvents");
+    printItem("nBins_MixMult");
+    printItem("Min_MixMult");
+    printItem("Max_MixMult");
+    printItem("nBins_MixZ");
+    printItem("Min_MixZ");
+    printItem("Max_MixZ");
+    printItem("nVariations",int(variations.size()));
+    for (unsigned int k=0; k<variations.size(); k++) printItem("Variation",variations[k].name);
     printItem("nBins_n1");
     printItem("Min_n1");
     printItem("Max_n1");
@@ -154,6 +201,27 @@ void ParticlePairAnalyzer::configure()
     }
 }
 
+void ParticlePairAnalyzer::initializeAnalysisContext()
+{
+  EventTask::initializeAnalysisContext();
+  if (!analysisContext) return;
+  ParticleBinning binning(getValueInt("nBins_pt"),  getValueDouble("Min_pt"),  getValueDouble("Max_pt"),
+                          getValueInt("nBins_phi"), getValueDouble("Min_phi"), getValueDouble("Max_phi"),
+                          getValueInt("nBins_eta"), getValueDouble("Min_eta"), getValueDouble("Max_eta"),
+                          getValueInt("nBins_y"),   getValueDouble("Min_y"),   getValueDouble("Max_y"),
+                          fillEta, fillY);
+  binningSlot = analysisContext->addBinning(binning);
+  if (mixEvents)
+    {
+    mixingPool.initialize(nEventFilters, nParticleFilters,
+                          getValueInt("nBins_MixMult"), getValueDouble("Min_MixMult"), getValueDouble("Max_MixMult"),
+                          getValueInt("nBins_MixZ"),    getValueDouble("Min_MixZ"),    getValueDouble("Max_MixZ"),
+                          getValueInt("MixPoolDepth"));
+    mixingDigits.assign(nParticleFilters,nullptr);
+    nMixedEvents.assign(nEventFilters,0);
+    }
+}
+
 void ParticlePairAnalyzer::createHistograms()
 {
   if (reportStart(__FUNCTION__))
@@ -202,6 +270,62 @@ void ParticlePairAnalyzer::createHistograms()
         }
       }
     }
+
+  // mixed-event pairs are appended to the pair set, after all the same-event pairs
+  if (mixEvents)
+    {
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          histos = new ParticlePairHistos(this,createName(bn,"Mixed",efn,pfn1,pfn2),configuration);
+          histos->createHistograms();
+          histogramManager.addGroupInSet(1,histos);
+          }
+        }
+      }
+    }
+
+  // selection variations: singles are appended to the single set, pairs to the pair set after the mixed-event pairs
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        String pfn = particleFilters[iParticleFilter]->getName();
+        histos = new ParticleSingleHistos(this,createName(bn,vn,efn,pfn),configuration);
+        histos->createHistograms();
+        histogramManager.addGroupInSet(0,histos);
+        }
+      }
+    }
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          histos = new ParticlePairHistos(this,createName(bn,vn,efn,pfn1,pfn2),configuration);
+          histos->createHistograms();
+          histogramManager.addGroupInSet(1,histos);
+          }
+        }
+      }
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -218,6 +342,7 @@ void ParticlePairAnalyzer::importHistograms(TFile & inputFile)
   fillEta = getValueBool("FillEta");
   fillY   = getValueBool("FillY");
   fillP2  = getValueBool("FillP2");
+  mixEvents = getValueBool("MixEvents");
 
   if (reportInfo(__FUNCTION__))
     {
@@ -257,6 +382,62 @@ void ParticlePairAnalyzer::importHistograms(TFile & inputFile)
         }
       }
     }
+
+  // mixed-event pairs are appended to the pair set, after all the same-event pairs
+  if (mixEvents)
+    {
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          histos = new ParticlePairHistos(this,createName(bn,"Mixed",efn,pfn1,pfn2),configuration);
+          histos->importHistograms(inputFile);
+          histogramManager.addGroupInSet(1,histos);
+          }
+        }
+      }
+    }
+
+  // selection variations: singles are appended to the single set, pairs to the pair set after the mixed-event pairs
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        String pfn = particleFilters[iParticleFilter]->getName();
+        histos = new ParticleSingleHistos(this,createName(bn,vn,efn,pfn),configuration);
+        histos->importHistograms(inputFile);
+        histogramManager.addGroupInSet(0,histos);
+        }
+      }
+    }
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          histos = new ParticlePairHistos(this,createName(bn,vn,efn,pfn1,pfn2),configuration);
+          histos->importHistograms(inputFile);
+          histogramManager.addGroupInSet(1,histos);
+          }
+        }
+      }
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -265,6 +446,99 @@ void ParticlePairAnalyzer::importHistograms(TFile & inputFile)
 void ParticlePairAnalyzer::analyzeEvent()
 {
   incrementTaskExecuted();
+  if (analysisContext)
+    {
+    // filters and digitization already evaluated (once for all analyzers) by the shared context
+    resetNParticlesAcceptedEvent();
+    int iMixClass = -1;
+    if (mixEvents)
+      {
+      EventProperties * properties = eventStreams[0]->getEventProperties();
+      if (properties) iMixClass = mixingPool.getClassIndex(properties->refMultiplicity,properties->other);
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        mixingDigits[iParticleFilter] = &analysisContext->getDigits(binningSlot,particleFilterSlots[iParticleFilter]);
+      }
+    unsigned int nVariations = variations.size();
+    if (nVariations>0 && analysisContext->isEventAccepted())
+      {
+      // select the digits of all the variations once per particle filter
+      variationDigits.resize(nParticleFilters);
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        const vector<ParticleDigit*> & digits = analysisContext->getDigits(binningSlot,particleFilterSlots[iParticleFilter]);
+        SelectionVariation::select(variations,digits,variationMasks,variationDigits[iParticleFilter]);
+        }
+      }
+    unsigned int nSingleGroups = nEventFilters*nParticleFilters;
+    unsigned int nPairGroups   = nEventFilters*nParticleFilters*nParticleFilters;
+    unsigned int baseVariationPairs = (mixEvents ? 2 : 1)*nPairGroups;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      if (!analysisContext->isEventAccepted(eventFilterSlots[iEventFilter])) continue;
+      incrementNEventsAccepted(iEventFilter);
+      unsigned int  baseSingle   = iEventFilter*nParticleFilters;
+      unsigned int  basePair     = iEventFilter*nParticleFilters*nParticleFilters;
+      unsigned int  index;
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        // particles out of bounds of the binning are not digitized but count in the multiplicities
+        const vector<ParticleDigit*> & digits1 = analysisContext->getDigits(binningSlot,particleFilterSlots[iParticleFilter1]);
+        const vector<Particle*> & accepted1 = analysisContext->getAcceptedParticles(particleFilterSlots[iParticleFilter1]);
+        for (unsigned int iParticle=0; iParticle<accepted1.size(); iParticle++) incrementNParticlesAccepted(iEventFilter,iParticleFilter1);
+        index = baseSingle + iParticleFilter1;
+        ParticleSingleHistos * singleHistos = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
+        singleHistos->fill(digits1,accepted1,1.0);
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          const vector<ParticleDigit*> & digits2 = analysisContext->getDigits(binningSlot,particleFilterSlots[iParticleFilter2]);
+          index = basePair + iParticleFilter1*nParticleFilters + iParticleFilter2;
+          ParticlePairHistos * pairHistos = (ParticlePairHistos *)  histogramManager.getGroup(1,index);
+          pairHistos->fill(digits1,digits2,iParticleFilter1==iParticleFilter2,1.0);
+          }
+        }
+      for (unsigned int iVariation=0; iVariation<nVariations; iVariation++)
+        {
+        for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+          {
+          const vector<ParticleDigit*> & digits1 = variationDigits[iParticleFilter1][iVariation];
+          index = (iVariation+1)*nSingleGroups + baseSingle + iParticleFilter1;
+          ParticleSingleHistos * singleHistos = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
+          singleHistos->fill(digits1,1.0);
+          for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+            {
+            const vector<ParticleDigit*> & digits2 = variationDigits[iParticleFilter2][iVariation];
+            index = baseVariationPairs + iVariation*nPairGroups + basePair + iParticleFilter1*nParticleFilters + iParticleFilter2;
+            ParticlePairHistos * pairHistos = (ParticlePairHistos *)  histogramManager.getGroup(1,index);
+            pairHistos->fill(digits1,digits2,iParticleFilter1==iParticleFilter2,1.0);
+            }
+          }
+        }
+      if (iMixClass<0) continue;
+
+      // pair the current event with the most recent events of the same class, then add it to the pool
+      unsigned int baseMixed = nEventFilters*nParticleFilters*nParticleFilters + basePair;
+      unsigned int nMix = mixingPool.getNEvents(iEventFilter,iMixClass);
+      if (nMix>(unsigned int)mixNEvents) nMix = mixNEvents;
+      for (unsigned int iMix=0; iMix<nMix; iMix++)
+        {
+        const vector< vector<ParticleDigit*> > & mixedDigits = mixingPool.getEvent(iEventFilter,iMixClass,iMix);
+        for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+          {
+          const vector<ParticleDigit*> & digits1 = *mixingDigits[iParticleFilter1];
+          for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+            {
+            index = baseMixed + iParticleFilter1*nParticleFilters + iParticleFilter2;
+            ParticlePairHistos * pairHistos = (ParticlePairHistos *)  histogramManager.getGroup(1,index);
+            pairHistos->fill(digits1,mixedDigits[iParticleFilter2],false,1.0);
+            }
+          }
+        }
+      nMixedEvents[iEventFilter] += nMix;
+      mixingPool.push(iEventFilter,iMixClass,mixingDigits);
+      }
+    return;
+    }
+
   Event & event = *eventStreams[0];
 
   vector<Particle*> & particles = event.getParticles();
@@ -314,17 +588,15 @@ void ParticlePairAnalyzer::analyzeEvent()
           {
           if (!digitized)
             {
-            LorentzVector & momentum = particle.getMomentum();
-            pt        = momentum.Pt();
-            e         = momentum.E();
-            phi       = momentum.Phi();
-            if (phi<0.0) phi += TMath::TwoPi();
+            pt        = particle.getPt();
+            e         = particle.getE();
+            phi       = particle.getPhi();
             iPt       = histos->getPtBinFor(pt);
             if (iPt==0) continue;
             iPhi      = histos->getPhiBinFor(phi);
             if (iPhi==0) continue;
-            iEta = fillEta ? histos->getEtaBinFor(momentum.Eta())    : 0;
-            iY   = fillY   ? histos->getYBinFor(momentum.Rapidity()) : 0;
+            iEta = fillEta ? histos->getEtaBinFor(particle.getEta()) : 0;
+            iY   = fillY   ? histos->getYBinFor(particle.getY())     : 0;
             if (iEta==0 && iY==0) continue;
             pd        = factory->getNextObject();
             pd->iY    = iY;
@@ -442,6 +714,24 @@ void ParticlePairAnalyzer::scaleHistograms()
           histogramManager.getGroup(1,index)->scale(scalingFactor);
           }
         }
+      // the selection variations share the event selection of the base histograms
+      int baseVariationPairs = (mixEvents ? 2 : 1)*nEventFilters*nParticleFilters*nParticleFilters;
+      for (int iVariation=0; iVariation<int(variations.size()); iVariation++)
+        {
+        for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+          {
+          index = ((iVariation+1)*nEventFilters + iEventFilter)*nParticleFilters + iParticleFilter;
+          histogramManager.getGroup(0,index)->scale(scalingFactor);
+          }
+        for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+          {
+          for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+            {
+            index = baseVariationPairs + (iVariation*nEventFilters + iEventFilter)*nParticleFilters*nParticleFilters + iParticleFilter1*nParticleFilters + iParticleFilter2;
+            histogramManager.getGroup(1,index)->scale(scalingFactor);
+            }
+          }
+        }
       }
     else
       {
@@ -453,6 +743,19 @@ void ParticlePairAnalyzer::scaleHistograms()
         cout << "                    no scaling performed: " <<  endl;
         }
       }
+    // mixed-event pairs are normalized per mixed event pair
+    if (mixEvents && iEventFilter<int(nMixedEvents.size()) && nMixedEvents[iEventFilter]>0)
+      {
+      scalingFactor = 1.0/double(nMixedEvents[iEventFilter]);
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          index = (nEventFilters+iEventFilter)*nParticleFilters*nParticleFilters + iParticleFilter1*nParticleFilters + iParticleFilter2;
+          histogramManager.getGroup(1,index)->scale(scalingFactor);
+          }
+        }
+      }
     }
   if (reportEnd(__FUNCTION__))
     ;
@@ -501,6 +804,33 @@ void ParticlePairAnalyzer::createDerivedHistograms()
         }
       }
     }
+  // selection variations are appended to the derived single and pair sets
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        histos = new ParticleSingleDerivedHistos(this,createName(bn,vn,efn,pfn1),configuration);
+        histos->createHistograms();
+        histogramManager.addGroupInSet(2,histos);
+        }
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++ )
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++ )
+          {
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          histos = new ParticlePairDerivedHistos(this,createName(bn,vn,efn,pfn1,pfn2),configuration);
+          histos->createHistograms();
+          histogramManager.addGroupInSet(3,histos);
+          }
+        }
+      }
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -530,63 +860,86 @@ void ParticlePairAnalyzer::calculateDerivedHistograms()
   ParticleSingleDerivedHistos * dSingleHistos2;
   ParticlePairDerivedHistos   * dPairHistos;
 
-  for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+  //! The base selection (iVariation=0) is followed by the selection variations, if any. Pair histograms of the variations follow
+  //! the mixed-event pairs in the pair set.
+  unsigned int nPairGroups        = nEventFilters*nParticleFilters*nParticleFilters;
+  unsigned int baseVariationPairs = (mixEvents ? 2 : 1)*nPairGroups;
+  for (unsigned int iVariation=0; iVariation<=variations.size(); iVariation++)
     {
-    if (reportDebug(__FUNCTION__)) cout << "  iEventFilter:" << iEventFilter << endl;
-    unsigned int index;
-    unsigned int baseSingle        = iEventFilter*nParticleFilters;
-    unsigned int basePair          = iEventFilter*nParticleFilters*nParticleFilters;
-    //unsigned int baseDerivedPair   = basePair;
-
-    //! Calculate derived spectra of singles
-    for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++)
-      {
-      String pfn1 = particleFilters[iParticleFilter1]->getName();
-      if (reportDebug(__FUNCTION__)) cout << "  Single: iParticleFilter1:" << iParticleFilter1 << " named:" << pfn1 << endl;
-      index = baseSingle+iParticleFilter1;
-      //if (reportDebug(__FUNCTION__))   cout << " (1) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
-      bSingleHistos1 = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
-      //if (reportDebug(__FUNCTION__))   cout << " (1a) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
-      dSingleHistos1 = (ParticleSingleDerivedHistos *) histogramManager.getGroup(2,index);
-      //if (reportDebug(__FUNCTION__))   cout << " (2) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
-      dSingleHistos1->calculateDerivedHistograms(bSingleHistos1);
-      //if (reportDebug(__FUNCTION__))   cout << " (3) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
-      }
-
-    //! Calculate derived spectra of pairs
-    for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++)
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
       {
-      String pfn1 = particleFilters[iParticleFilter1]->getName();
-      if (reportDebug(__FUNCTION__)) cout << "  Pair: iParticleFilter1:" << iParticleFilter1 << " named:" << pfn1 << endl;
-      index = baseSingle+iParticleFilter1;
-      bSingleHistos1 = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
-      dSingleHistos1 = (ParticleSingleDerivedHistos *) histogramManager.getGroup(2,index);
+      if (reportDebug(__FUNCTION__)) cout << "  iEventFilter:" << iEventFilter << endl;
+      unsigned int index;
+      unsigned int baseSingle        = (iVariation*nEventFilters + iEventFilter)*nParticleFilters;
+      unsigned int basePair          = (iVariation==0 ? 0 : baseVariationPairs + (iVariation-1)*nPairGroups) + iEventFilter*nParticleFilters*nParticleFilters;
+      unsigned int baseDerivedPair   = (iVariation*nEventFilters + iEventFilter)*nParticleFilters*nParticleFilters;
+
+      //! Calculate derived spectra of singles
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++)
+        {
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        if (reportDebug(__FUNCTION__)) cout << "  Single: iParticleFilter1:" << iParticleFilter1 << " named:" << pfn1 << endl;
+        index = baseSingle+iParticleFilter1;
+        //if (reportDebug(__FUNCTION__))   cout << " (1) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
+        bSingleHistos1 = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
+        //if (reportDebug(__FUNCTION__))   cout << " (1a) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
+        dSingleHistos1 = (ParticleSingleDerivedHistos *) histogramManager.getGroup(2,index);
+        //if (reportDebug(__FUNCTION__))   cout << " (2) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
+        dSingleHistos1->calculateDerivedHistograms(bSingleHistos1);
+        //if (reportDebug(__FUNCTION__))   cout << " (3) iParticleFilter1:" << iParticleFilter1 << " named " << pfn1 << " with index:" << index << endl;
+        }
 
-      for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++)
+      //! Calculate derived spectra of pairs
+      for (int iParticleFilter1=0; iParticleFilter1<nParticleFilters; iParticleFilter1++)
         {
-        String pfn2 = particleFilters[iParticleFilter2]->getName();
-        if (reportDebug(__FUNCTION__)) cout << "  Pair: iParticleFilter2:" << iParticleFilter2 << " named:" << pfn2 << endl;
-        index = baseSingle+iParticleFilter2;
-        bSingleHistos2 = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
-        dSingleHistos2 = (ParticleSingleDerivedHistos *) histogramManager.getGroup(2,index);
-        index = basePair+iParticleFilter1*nParticleFilters+iParticleFilter2;
-        bPairHistos = (ParticlePairHistos *) histogramManager.getGroup(1,index);
-        dPairHistos = (ParticlePairDerivedHistos *) histogramManager.getGroup(3,index);
-        if (reportDebug(__FUNCTION__))
+        String pfn1 = particleFilters[iParticleFilter1]->getName();
+        if (reportDebug(__FUNCTION__)) cout << "  Pair: iParticleFilter1:" << iParticleFilter1 << " named:" << pfn1 << endl;
+        index = baseSingle+iParticleFilter1;
+        bSingleHistos1 = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
+        dSingleHistos1 = (ParticleSingleDerivedHistos *) histogramManager.getGroup(2,index);
+
+        for (int iParticleFilter2=0; iParticleFilter2<nParticleFilters; iParticleFilter2++)
           {
-          cout << endl;
-          cout << "  bSingleHistos1.........:" << bSingleHistos1->getName() << endl;
-          cout << "  bSingleHistos2.........:" << bSingleHistos2->getName() << endl;
-          cout << "  dSingleHistos1.........:" << dSingleHistos1->getName() << endl;
-          cout << "  dSingleHistos2.........:" << dSingleHistos2->getName() << endl;
-          cout << "  bPairHistos............:" << bPairHistos->getName() << endl;
-          cout << "  dPairHistos............:" << dPairHistos->getName() << endl;
+          String pfn2 = particleFilters[iParticleFilter2]->getName();
+          if (reportDebug(__FUNCTION__)) cout << "  Pair: iParticleFilter2:" << iParticleFilter2 << " named:" << pfn2 << endl;
+          index = baseSingle+iParticleFilter2;
+          bSingleHistos2 = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
+          dSingleHistos2 = (ParticleSingleDerivedHistos *) histogramManager.getGroup(2,index);
+          index = basePair+iParticleFilter1*nParticleFilters+iParticleFilter2;
+          bPairHistos = (ParticlePairHistos *) histogramManager.getGroup(1,index);
+          bPairHistos->flushCounters();
+          index = baseDerivedPair+iParticleFilter1*nParticleFilters+iParticleFilter2;
+          dPairHistos = (ParticlePairDerivedHistos *) histogramManager.getGroup(3,index);
+          if (reportDebug(__FUNCTION__))
+            {
+            cout << endl;
+            cout << "  bSingleHistos1.........:" << bSingleHistos1->getName() << endl;
+            cout << "  bSingleHistos2.........:" << bSingleHistos2->getName() << endl;
+            cout << "  dSingleHistos1.........:" << dSingleHistos1->getName() << endl;
+            cout << "  dSingleHistos2.........:" << dSingleHistos2->getName() << endl;
+            cout << "  bPairHistos............:" << bPairHistos->getName() << endl;
+            cout << "  dPairHistos............:" << dPairHistos->getName() << endl;
+            }
+          dPairHistos->calculatePairDerivedHistograms(*bSingleHistos1,*bSingleHistos2,*dSingleHistos1,*dSingleHistos2,*bPairHistos,binCorrPP);
+          if (reportDebug(__FUNCTION__)) cout << "   WTF 8" << endl;
           }
-        dPairHistos->calculatePairDerivedHistograms(*bSingleHistos1,*bSingleHistos2,*dSingleHistos1,*dSingleHistos2,*bPairHistos,binCorrPP);
-        if (reportDebug(__FUNCTION__)) cout << "   WTF 8" << endl;
         }
       }
     }
   if (reportEnd(__FUNCTION__))
     ;
 }
+
+void ParticlePairAnalyzer::saveCheckpoint(TFile & outputFile)
+{
+  for (unsigned int k=0; k<nMixedEvents.size(); k++)
+    writeCheckpointValue(outputFile,Form("nMixedEvents%d",k),nMixedEvents[k]);
+  EventTask::saveCheckpoint(outputFile);
+}
+
+void ParticlePairAnalyzer::loadCheckpoint(TFile & inputFile)
+{
+  for (unsigned int k=0; k<nMixedEvents.size(); k++)
+    nMixedEvents[k] = readCheckpointValue(inputFile,Form("nMixedEvents%d",k),nMixedEvents[k]);
+  EventTask::loadCheckpoint(inputFile);
+}
@@ -13,6 +13,8 @@
 #define CAP__ParticlePairAnalyzer
 #include "EventTask.hpp"
 #include "ParticleDigit.hpp"
+#include "EventMixingPool.hpp"
+#include "SelectionVariation.hpp"
 using CAP::EventTask;
 using CAP::Configuration;
 using CAP::EventFilter;
@@ -56,6 +58,27 @@ namespace CAP
 //!  + min_phi [0.0]: Minimum value
 //!  + max_phi [2pi]: Maximum value
 //!
+//! Event mixing (requires and enables the shared analysis context):
+//! - MixEvents [false]: whether to fill mixed-event pair histograms, in addition to the same-event ones
+//! - MixPoolDepth [10]: maximum number of events held by each (event filter, event class) pool
+//! - MixNEvents [5]: number of pool events each new event is paired with
+//! - nBins_MixMult [10], Min_MixMult [0.0], Max_MixMult [1000.0]: event classes vs. the reference multiplicity
+//! - nBins_MixZ [1], Min_MixZ [-10.0], Max_MixZ [10.0]: event classes vs. the event property "other" (e.g., the vertex z position)
+//!
+//! Checkpoints hold the mixed-event histograms and the number of mixed event pairs of each event filter, but not the pools: after a
+//! restore, the pools restart empty and the first events of the resumed run are mixed with fewer (or no) past events. The
+//! normalization of the mixed-event histograms remains correct since it uses the number of event pairs actually mixed.
+//!
+//! Selection variations (systematic studies; requires and enables the shared analysis context):
+//! - nVariations [0]: number of variations, at most SelectionVariation::maxVariations
+//! - VariationK_Name ["VarK"]: name of the variation K, used in the names of its histograms
+//! - VariationK_Min_pt, VariationK_Max_pt, VariationK_Min_eta, VariationK_Max_eta, VariationK_Min_y, VariationK_Max_y,
+//!   VariationK_Min_phi, VariationK_Max_phi [no limit]: kinematic ranges of the variation K
+//!
+//! The single and pair histograms of each variation are filled, in the same event loop, from subsets of the digits of the base particle
+//! filters; the subsets of all the variations are selected in a single pass over the digits. Mixed-event pairs are filled for the base
+//! selection only.
+//!
 class ParticlePairAnalyzer : public EventTask
 {
 public:
@@ -85,6 +108,11 @@ public:
   virtual void setDefaultConfiguration();
 
   virtual void configure();
+
+  //!
+  //! Register the filters of this task and the particle binning it uses with the shared analysis context (if enabled).
+  //!
+  virtual void initializeAnalysisContext();
   
   //!
   //! Executes this task based on the configuration and class variable specified at construction
@@ -112,6 +140,12 @@ public:
 
   virtual void calculateDerivedHistograms();
 
+  //!
+  //! Save (restore) the number of mixed event pairs of each event filter along with the state saved by EventTask.
+  //!
+  virtual void saveCheckpoint(TFile & outputFile);
+  virtual void loadCheckpoint(TFile & inputFile);
+
 protected:
   
   bool fillEta; //!< whether to fill pseudorapidity histograms (set from configuration at initialization)
@@ -119,6 +153,17 @@ protected:
   bool fillP2;  //!< whether to fill P2 and G2 related histograms  (set from configuration at initialization)
   
   vector< vector<ParticleDigit*> > filteredParticles;
+  int binningSlot; //!< slot of the particle binning of this task in the shared analysis context
+
+  bool mixEvents;   //!< whether to fill mixed-event pair histograms (set from configuration at initialization)
+  int  mixNEvents;  //!< number of pool events each new event is mixed with
+  EventMixingPool mixingPool;                     //!< pools of past events used for mixing
+  vector<const vector<ParticleDigit*>*> mixingDigits; //!< digits of the current event, one list per particle filter
+  vector<long> nMixedEvents;                      //!< number of mixed event pairs per event filter
+
+  vector<SelectionVariation> variations;          //!< selection variations (set from configuration at initialization)
+  vector<unsigned int> variationMasks;            //!< variations accepting each digit of the current particle filter
+  vector< vector< vector<ParticleDigit*> > > variationDigits; //!< digits of the current event, [iParticleFilter][iVariation]
 
    ClassDef(ParticlePairAnalyzer,0)
 };
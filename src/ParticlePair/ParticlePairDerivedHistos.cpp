@@ -23,6 +23,8 @@ HistogramGroup(_parent,_name,_configuration),
 fillEta(0),
 fillY(0),
 fillP2(0),
+fill3D(0),
+fill3DSparse(0),
 nBins_pt(0),
 min_pt(0),
 max_pt(0),
@@ -44,6 +46,9 @@ max_Deta(0),
 nBins_Dy(0),
 min_Dy(0),
 max_Dy(0),
+nBins_DeltaP(0),
+min_DeltaP(0),
+max_DeltaP(0),
 h_n1n1_ptpt(nullptr),
 h_A2_ptpt(nullptr),
 h_B2_ptpt(nullptr),
@@ -123,7 +128,11 @@ h_P2_DyDphi_shft(nullptr),
 h_G2_DyDphi_shft(nullptr),
 
 h_pt1pt1_DyDphi(nullptr),
-h_DptDpt_DyDphi(nullptr)
+h_DptDpt_DyDphi(nullptr),
+h_n1n1_Q3D(nullptr),
+h_R2_Q3D(nullptr),
+s_n1n1_Q3D(nullptr),
+s_R2_Q3D(nullptr)
 {
   appendClassName("ParticlePairDerivedHistos");
 }
@@ -151,6 +160,11 @@ void ParticlePairDerivedHistos::createHistograms()
   fillEta    = configuration.getValueBool(ppn,"FillEta");
   fillY      = configuration.getValueBool(ppn,"FillY");
   fillP2     = configuration.getValueBool(ppn,"FillP2");
+  fill3D       = fillEta && configuration.getValueBool(ppn,"Fill3D");
+  fill3DSparse = configuration.getValueBool(ppn,"Fill3DSparse");
+  nBins_DeltaP = configuration.getValueInt(ppn,"nBins_DeltaP");
+  min_DeltaP   = configuration.getValueDouble(ppn,"Min_DeltaP");
+  max_DeltaP   = configuration.getValueDouble(ppn,"Max_DeltaP");
 
   double scale_phi   = max_phi - min_phi;
   double width_Dphi  = scale_phi/nBins_phi;
@@ -224,6 +238,8 @@ void ParticlePairDerivedHistos::createHistograms()
     cout << "  Pair:FillEta.............................: " << fillEta << endl;
     cout << "  Pair:FillY...............................: " << fillY << endl;
     cout << "  Pair:FillP2..............................: " << fillP2 << endl;
+    cout << "  Pair:Fill3D..............................: " << fill3D << endl;
+    cout << "  Pair:Fill3DSparse........................: " << fill3DSparse << endl;
     }
 
 
@@ -331,6 +347,32 @@ void ParticlePairDerivedHistos::createHistograms()
       h_G2_DyDphi_shft    = createHistogram(createName(bn,"G2_DyDphi_shft"),    nBins_Dy,  min_Dy,  max_Dy,  nBins_Dphi,  min_Dphi_shft, max_Dphi_shft, "#Delta y", "#Delta#varphi", "G_{2}");
       }
     }
+  if (fill3D && fill3DSparse)
+    {
+    s_n1n1_Q3D = createSparseHistogram(createName(bn,"n1n1_Q3D"),
+                                       nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                       nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                       nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                       "q_{long}","q_{side}","q_{out}","<n_{1}><n_{2}>");
+    s_R2_Q3D   = createSparseHistogram(createName(bn,"R2_Q3D"),
+                                       nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                       nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                       nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                       "q_{long}","q_{side}","q_{out}","R_{2}");
+    }
+  else if (fill3D)
+    {
+    h_n1n1_Q3D = createHistogram(createName(bn,"n1n1_Q3D"),
+                                 nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                 nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                 nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                 "q_{long}","q_{side}","q_{out}","<n_{1}><n_{2}>");
+    h_R2_Q3D   = createHistogram(createName(bn,"R2_Q3D"),
+                                 nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                 nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                 nBins_DeltaP, min_DeltaP, max_DeltaP,
+                                 "q_{long}","q_{side}","q_{out}","R_{2}");
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -347,6 +389,7 @@ void ParticlePairDerivedHistos::importHistograms(TFile & inputFile)
   fillEta    = configuration.getValueBool(ppn,"FillEta");
   fillY      = configuration.getValueBool(ppn,"FillY");
   fillP2     = configuration.getValueBool(ppn,"FillP2");
+  fill3D     = fillEta && configuration.getValueBool(ppn,"Fill3D");
   if (reportDebug(__FUNCTION__))
     {
     cout << endl;
@@ -460,6 +503,16 @@ void ParticlePairDerivedHistos::importHistograms(TFile & inputFile)
       h_G2_DyDphi_shft    = loadH2(inputFile, CAP::createName(bn,"G2_DyDphi_shft"));
       }
     }
+  if (fill3D && fill3DSparse)
+    {
+    s_n1n1_Q3D = loadSparseH3(inputFile, CAP::createName(bn,"n1n1_Q3D"));
+    s_R2_Q3D   = loadSparseH3(inputFile, CAP::createName(bn,"R2_Q3D"));
+    }
+  else if (fill3D)
+    {
+    h_n1n1_Q3D = loadH3(inputFile, CAP::createName(bn,"n1n1_Q3D"));
+    h_R2_Q3D   = loadH3(inputFile, CAP::createName(bn,"R2_Q3D"));
+    }
 }
 
 void quickCopy(TH2 * source, TH2 * target)
@@ -694,6 +747,25 @@ void ParticlePairDerivedHistos::calculatePairDerivedHistograms(ParticleSingleHis
       shiftY(*h_G2_DetaDphi,*h_G2_DetaDphi_shft,nBins_Dphi_shft);
       }
     }
+
+  if (fill3D)
+    {
+    if (reportDebug(__FUNCTION__))  cout <<  "Calculate XXX_Q3D" << endl;
+    if (s_R2_Q3D && pairHistos.s_n2_DeltaP)
+      {
+      calculateN1N1H3H3_Q3D(part1BaseHistos.h_n1_etaPhiPt, part2BaseHistos.h_n1_etaPhiPt, s_n1n1_Q3D, 1.0, 1.0);
+      calculateR2_Q3D(pairHistos.s_n2_DeltaP, s_n1n1_Q3D, s_R2_Q3D, 1.0, 1.0);
+      }
+    else if (h_R2_Q3D && pairHistos.h_n2_DeltaP)
+      {
+      calculateN1N1H3H3_Q3D(part1BaseHistos.h_n1_etaPhiPt, part2BaseHistos.h_n1_etaPhiPt, h_n1n1_Q3D, 1.0, 1.0);
+      calculateR2_Q3D(pairHistos.h_n2_DeltaP, h_n1n1_Q3D, h_R2_Q3D, 1.0, 1.0);
+      }
+    else
+      {
+      if (reportWarning(__FUNCTION__)) cout << "Q3D pair and derived histograms are not both sparse or both dense. Skip Q3D." << endl;
+      }
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -46,6 +46,8 @@ public:
   bool         fillEta;
   bool         fillY;
   bool         fillP2;
+  bool         fill3D;
+  bool         fill3DSparse;
   unsigned int nBins_n2;
   double       min_n2;
   double       max_n2;
@@ -75,6 +77,10 @@ public:
   double       min_Dphi_shft;
   double       max_Dphi_shft;
 
+  int          nBins_DeltaP;
+  double       min_DeltaP;
+  double       max_DeltaP;
+
   TH2* h_n1n1_ptpt;
   TH2* h_A2_ptpt;
   TH2* h_B2_ptpt;
@@ -162,6 +168,11 @@ public:
   TH2* h_pt1pt1_DyDphi;
   TH2* h_DptDpt_DyDphi;
 
+  TH3* h_n1n1_Q3D;
+  TH3* h_R2_Q3D;
+  SparseHistogram3D * s_n1n1_Q3D; // used instead of h_n1n1_Q3D with Fill3DSparse
+  SparseHistogram3D * s_R2_Q3D;   // used instead of h_R2_Q3D with Fill3DSparse
+
   ClassDef(ParticlePairDerivedHistos,1)
 
 };
@@ -0,0 +1,233 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <cmath>
+#include "ParticlePairGridCorrelator.hpp"
+using CAP::ParticleDensityGrids;
+using CAP::ParticlePairGridCorrelator;
+
+ClassImp(ParticleDensityGrids);
+
+ClassImp(ParticlePairGridCorrelator);
+
+ParticleDensityGrids::ParticleDensityGrids()
+:
+nBins_pt(0),
+nBins_phi(0),
+nBins_eta(0),
+nBins_y(0),
+useEta(false),
+useY(false),
+n(0), nEta(0), nY(0), nEtaPhi(0), nYPhi(0), pt2EtaPhi(0), pt2YPhi(0),
+n_pt(), n_phi(), pt_phi(), pt2_phi(),
+n_eta(), pt_eta(), pt2_eta(),
+n_y(), pt_y(), pt2_y(),
+n_etaPhi(), pt_etaPhi(),
+n_yPhi(), pt_yPhi()
+{ }
+
+void ParticleDensityGrids::initialize(int _nBins_pt, int _nBins_phi, int _nBins_eta, int _nBins_y, bool _useEta, bool _useY)
+{
+  nBins_pt  = _nBins_pt;
+  nBins_phi = _nBins_phi;
+  nBins_eta = _nBins_eta;
+  nBins_y   = _nBins_y;
+  useEta    = _useEta;
+  useY      = _useY;
+}
+
+void ParticleDensityGrids::fill(const vector<ParticleDigit*> & particles)
+{
+  n = nEta = nY = nEtaPhi = nYPhi = pt2EtaPhi = pt2YPhi = 0.0;
+  n_pt.assign(nBins_pt+1,0.0);
+  n_phi.assign(nBins_phi+1,0.0);
+  pt_phi.assign(nBins_phi+1,0.0);
+  pt2_phi.assign(nBins_phi+1,0.0);
+  if (useEta)
+    {
+    n_eta.assign(nBins_eta+1,0.0);
+    pt_eta.assign(nBins_eta+1,0.0);
+    pt2_eta.assign(nBins_eta+1,0.0);
+    n_etaPhi.assign(nBins_eta*nBins_phi,0.0);
+    pt_etaPhi.assign(nBins_eta*nBins_phi,0.0);
+    }
+  if (useY)
+    {
+    n_y.assign(nBins_y+1,0.0);
+    pt_y.assign(nBins_y+1,0.0);
+    pt2_y.assign(nBins_y+1,0.0);
+    n_yPhi.assign(nBins_y*nBins_phi,0.0);
+    pt_yPhi.assign(nBins_y*nBins_phi,0.0);
+    }
+  for (unsigned int iPart=0; iPart<particles.size(); iPart++)
+    {
+    const ParticleDigit & digit = *particles[iPart];
+    double pt  = digit.pt;
+    double pt2 = pt*pt;
+    unsigned int iPhi = digit.iPhi;
+    n++;
+    n_pt[digit.iPt]++;
+    n_phi[iPhi]++;
+    pt_phi[iPhi]  += pt;
+    pt2_phi[iPhi] += pt2;
+    if (useEta && digit.iEta!=0)
+      {
+      unsigned int iEta = digit.iEta;
+      nEta++;
+      n_eta[iEta]++;
+      pt_eta[iEta]  += pt;
+      pt2_eta[iEta] += pt2;
+      if (iPhi!=0)
+        {
+        unsigned int iCell = (iEta-1)*nBins_phi + iPhi-1;
+        nEtaPhi++;
+        pt2EtaPhi += pt2;
+        n_etaPhi[iCell]++;
+        pt_etaPhi[iCell] += pt;
+        }
+      }
+    if (useY && digit.iY!=0)
+      {
+      unsigned int iY = digit.iY;
+      nY++;
+      n_y[iY]++;
+      pt_y[iY]  += pt;
+      pt2_y[iY] += pt2;
+      if (iPhi!=0)
+        {
+        unsigned int iCell = (iY-1)*nBins_phi + iPhi-1;
+        nYPhi++;
+        pt2YPhi += pt2;
+        n_yPhi[iCell]++;
+        pt_yPhi[iCell] += pt;
+        }
+      }
+    }
+}
+
+ParticlePairGridCorrelator::ParticlePairGridCorrelator()
+:
+nBinsX(0),
+nBinsPhi(0),
+sizeX(0),
+sizePhi(0),
+rootsX(),
+rootsPhi(),
+work1(),
+work2(),
+column()
+{ }
+
+void ParticlePairGridCorrelator::initialize(int _nBinsX, int _nBinsPhi)
+{
+  nBinsX   = _nBinsX;
+  nBinsPhi = _nBinsPhi;
+  sizeX    = 1; while (sizeX   < 2*nBinsX-1)   sizeX   *= 2;
+  sizePhi  = 1; while (sizePhi < 2*nBinsPhi-1) sizePhi *= 2;
+  fillRoots(sizeX,   rootsX);
+  fillRoots(sizePhi, rootsPhi);
+  work1.assign(sizeX*sizePhi, complex<double>(0.0,0.0));
+  work2.assign(sizeX*sizePhi, complex<double>(0.0,0.0));
+  column.assign(sizeX, complex<double>(0.0,0.0));
+}
+
+void ParticlePairGridCorrelator::fillRoots(int n, vector< complex<double> > & roots)
+{
+  roots.resize(n/2>0 ? n/2 : 1);
+  for (int k=0; k<n/2; k++)
+    {
+    double angle = -2.0*M_PI*double(k)/double(n);
+    roots[k] = complex<double>(cos(angle),sin(angle));
+    }
+}
+
+void ParticlePairGridCorrelator::fft(complex<double> * data, int n, int stride, const vector< complex<double> > & roots, bool inverse)
+{
+  // bit reversal permutation
+  for (int i=1, j=0; i<n; i++)
+    {
+    int bit = n>>1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i<j) swap(data[i*stride],data[j*stride]);
+    }
+  for (int len=2; len<=n; len <<= 1)
+    {
+    int half = len/2;
+    int step = n/len;
+    for (int i=0; i<n; i += len)
+      {
+      for (int k=0; k<half; k++)
+        {
+        complex<double> w = inverse ? conj(roots[k*step]) : roots[k*step];
+        complex<double> & u = data[(i+k)*stride];
+        complex<double> & v = data[(i+k+half)*stride];
+        complex<double> t = v*w;
+        v = u - t;
+        u = u + t;
+        }
+      }
+    }
+}
+
+void ParticlePairGridCorrelator::fft2D(vector< complex<double> > & data, bool inverse)
+{
+  // rows (phi), then columns (x) through a contiguous copy
+  for (int iX=0; iX<sizeX; iX++) fft(&data[iX*sizePhi], sizePhi, 1, rootsPhi, inverse);
+  for (int iPhi=0; iPhi<sizePhi; iPhi++)
+    {
+    for (int iX=0; iX<sizeX; iX++) column[iX] = data[iX*sizePhi+iPhi];
+    fft(column.data(), sizeX, 1, rootsX, inverse);
+    for (int iX=0; iX<sizeX; iX++) data[iX*sizePhi+iPhi] = column[iX];
+    }
+}
+
+void ParticlePairGridCorrelator::transform(const vector<double> & a, vector< complex<double> > & work)
+{
+  work.assign(sizeX*sizePhi, complex<double>(0.0,0.0));
+  for (int iX=0; iX<nBinsX; iX++)
+    {
+    const double * row = &a[iX*nBinsPhi];
+    complex<double> * out = &work[iX*sizePhi];
+    for (int iPhi=0; iPhi<nBinsPhi; iPhi++) out[iPhi] = row[iPhi];
+    }
+  fft2D(work,false);
+}
+
+void ParticlePairGridCorrelator::correlate(const vector<double> & a1, const vector<double> & a2, bool same, vector<double> & result)
+{
+  transform(a1,work1);
+  if (same)
+    {
+    for (unsigned int k=0; k<work1.size(); k++) work1[k] = complex<double>(norm(work1[k]),0.0);
+    }
+  else
+    {
+    transform(a2,work2);
+    for (unsigned int k=0; k<work1.size(); k++) work1[k] *= conj(work2[k]);
+    }
+  fft2D(work1,true);
+
+  // unpack the linear correlation and fold the phi differences modulo nPhi
+  double scale = 1.0/double(sizeX*sizePhi);
+  int nBinsDeltaX = 2*nBinsX-1;
+  result.assign(nBinsDeltaX*nBinsPhi,0.0);
+  for (int iDeltaX=0; iDeltaX<nBinsDeltaX; iDeltaX++)
+    {
+    int dx = iDeltaX - (nBinsX-1);
+    int jX = (dx<0) ? dx+sizeX : dx;
+    const complex<double> * row = &work1[jX*sizePhi];
+    double * out = &result[iDeltaX*nBinsPhi];
+    out[0] = scale*row[0].real();
+    for (int iDeltaPhi=1; iDeltaPhi<nBinsPhi; iDeltaPhi++)
+      out[iDeltaPhi] = scale*(row[iDeltaPhi].real() + row[sizePhi+iDeltaPhi-nBinsPhi].real());
+    }
+}
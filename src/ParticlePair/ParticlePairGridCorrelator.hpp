@@ -0,0 +1,153 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticlePairGridCorrelator
+#define CAP__ParticlePairGridCorrelator
+#include <complex>
+#include <vector>
+#include "TObject.h"
+#include "ParticleDigit.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Per-event single particle densities of a list of digitized particles: marginal counts vs. pt, phi, eta, and y, pt sums and pt^2 sums
+//! vs. phi, eta, and y, and occupancy (count and pt sum) grids in (eta, phi) and (y, phi). Marginals are indexed by the digit bin index
+//! (0 being the underflow index). Grids are indexed by (iX-1)*nPhi + (iPhi-1) and only include particles with non-zero indices.
+//!
+class ParticleDensityGrids
+{
+public:
+
+  ParticleDensityGrids();
+  virtual ~ParticleDensityGrids() {}
+
+  void initialize(int _nBins_pt, int _nBins_phi, int _nBins_eta, int _nBins_y, bool _useEta, bool _useY);
+
+  //!
+  //! Reset and fill the densities with the given particles.
+  //!
+  void fill(const vector<ParticleDigit*> & particles);
+
+  int  nBins_pt;
+  int  nBins_phi;
+  int  nBins_eta;
+  int  nBins_y;
+  bool useEta;
+  bool useY;
+
+  double n;             //!< number of particles
+  double nEta;          //!< number of particles with a valid eta index
+  double nY;            //!< number of particles with a valid y index
+  double nEtaPhi;       //!< number of particles in the (eta, phi) grid
+  double nYPhi;         //!< number of particles in the (y, phi) grid
+  double pt2EtaPhi;     //!< sum of pt^2 of the particles in the (eta, phi) grid
+  double pt2YPhi;       //!< sum of pt^2 of the particles in the (y, phi) grid
+
+  vector<double> n_pt;
+  vector<double> n_phi;
+  vector<double> pt_phi;
+  vector<double> pt2_phi;
+  vector<double> n_eta;
+  vector<double> pt_eta;
+  vector<double> pt2_eta;
+  vector<double> n_y;
+  vector<double> pt_y;
+  vector<double> pt2_y;
+  vector<double> n_etaPhi;
+  vector<double> pt_etaPhi;
+  vector<double> n_yPhi;
+  vector<double> pt_yPhi;
+
+  ClassDef(ParticleDensityGrids,0)
+};
+
+//!
+//! Computes the pair density in (Delta x, Delta phi) from per-event single particle occupancy grids in (x, phi), where x stands for
+//! the pseudorapidity or the rapidity. For grids a1 and a2 of nX x nPhi cells, the correlation
+//!
+//! C(dx,dphi) = sum_{x2,phi2} a1(x2+dx, phi2+dphi) a2(x2, phi2)
+//!
+//! is computed for dx in [-(nX-1), nX-1] (linear) and dphi in [0, nPhi-1] (circular, i.e., modulo nPhi), which is exactly the content
+//! accumulated by a pair loop with iDeltaX = iX_1-iX_2 and iDeltaPhi = (iPhi_1-iPhi_2) mod nPhi. The correlation is obtained with
+//! radix-2 fast Fourier transforms of the zero-padded grids, i.e., in O(B log B) operations where B is the number of cells, independently
+//! of the number of particles. Circular phi differences are obtained by folding the linear correlation.
+//!
+class ParticlePairGridCorrelator
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  ParticlePairGridCorrelator();
+
+  //!
+  //! DTOR
+  //!
+  virtual ~ParticlePairGridCorrelator() {}
+
+  //!
+  //! Set the grid dimensions and allocate the work buffers.
+  //!
+  void initialize(int _nBinsX, int _nBinsPhi);
+
+  //!
+  //! Compute the correlation of the grids a1 and a2 (nX x nPhi cells, x major). If same is true, a2 is ignored and the
+  //! auto-correlation of a1 is computed. The result has (2nX-1) x nPhi cells (Delta x major) with Delta x index dx+nX-1.
+  //!
+  void correlate(const vector<double> & a1, const vector<double> & a2, bool same, vector<double> & result);
+
+  inline int getNBinsX() const        { return nBinsX;   }
+  inline int getNBinsPhi() const      { return nBinsPhi; }
+  inline int getNBinsDeltaX() const   { return 2*nBinsX-1; }
+
+protected:
+
+  //!
+  //! Copy the given grid into the zero-padded work buffer and transform it.
+  //!
+  void transform(const vector<double> & a, vector< complex<double> > & work);
+
+  //!
+  //! In-place 2D transform of the given padded buffer.
+  //!
+  void fft2D(vector< complex<double> > & data, bool inverse);
+
+  //!
+  //! In-place radix-2 transform of n values separated by the given stride. n must be a power of two.
+  //!
+  void fft(complex<double> * data, int n, int stride, const vector< complex<double> > & roots, bool inverse);
+
+  //!
+  //! Fill the table of the n/2 roots of unity exp(-2 pi i k/n) used by the transform of size n.
+  //!
+  static void fillRoots(int n, vector< complex<double> > & roots);
+
+  int nBinsX;      //!< number of x bins of the grids
+  int nBinsPhi;    //!< number of phi bins of the grids
+  int sizeX;       //!< padded size along x (power of two >= 2nX-1)
+  int sizePhi;     //!< padded size along phi (power of two >= 2nPhi-1)
+  vector< complex<double> > rootsX;
+  vector< complex<double> > rootsPhi;
+  vector< complex<double> > work1;
+  vector< complex<double> > work2;
+  vector< complex<double> > column;
+
+  ClassDef(ParticlePairGridCorrelator,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__ParticlePairGridCorrelator  */
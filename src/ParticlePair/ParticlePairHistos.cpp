@@ -9,6 +9,7 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <algorithm>
 #include "ParticlePairHistos.hpp"
 using CAP::ParticlePairHistos;
 
@@ -58,9 +59,17 @@ max_Dy(0),
 nBins_Dphi_shft(0),
 min_Dphi_shft(0),
 max_Dphi_shft(0),
+nBins_DeltaP(0),
+min_DeltaP(0),
+max_DeltaP(0),
 fillEta(false),
 fillY(false),
 fillP2(false),
+fill3D(false),
+fill3DSparse(false),
+fillFFT(false),
+fillFFTMinPairs(0),
+useCounters(false),
 h_n2(nullptr),
 h_n2_ptpt(nullptr),
 h_n2_etaEta(nullptr),
@@ -72,7 +81,22 @@ h_DptDpt_yY(nullptr),
 h_n2_DetaDphi(nullptr),
 h_DptDpt_DetaDphi(nullptr),
 h_n2_DyDphi(nullptr),
-h_DptDpt_DyDphi(nullptr)
+h_DptDpt_DyDphi(nullptr),
+h_n2_DeltaP(nullptr),
+s_n2_DeltaP(nullptr),
+c_n2_ptpt(nullptr),
+c_n2_phiPhi(nullptr),
+c_n2_etaEta(nullptr),
+c_n2_DetaDphi(nullptr),
+c_n2_yY(nullptr),
+c_n2_DyDphi(nullptr),
+densities1(),
+densities2(),
+densitiesShared(),
+correlatorEta(),
+correlatorY(),
+correlationN(),
+correlationPtPt()
 {
   appendClassName("ParticlePairHistos");
 }
@@ -131,9 +155,9 @@ void ParticlePairHistos::createHistograms()
   range_y = max_y - min_y;
   scale_y = double(nBins_y)/range_y;
 
-  //  nBins_DeltaP  = configuration.getValueInt(ppn,"nBins_DeltaP");
-  //  min_DeltaP    = configuration.getValueDouble(ppn,"Min_DeltaP");
-  //  max_DeltaP    = configuration.getValueDouble(ppn,"Max_DeltaP");
+  nBins_DeltaP  = configuration.getValueInt(ppn,"nBins_DeltaP");
+  min_DeltaP    = configuration.getValueDouble(ppn,"Min_DeltaP");
+  max_DeltaP    = configuration.getValueDouble(ppn,"Max_DeltaP");
 
   nBins_Dy  = 2*nBins_y-1;
   min_Dy    = -range_y;
@@ -142,7 +166,20 @@ void ParticlePairHistos::createHistograms()
   fillEta    = configuration.getValueBool(ppn,"FillEta");
   fillY      = configuration.getValueBool(ppn,"FillY");
   fillP2     = configuration.getValueBool(ppn,"FillP2");
-  //fill3D     = configuration.getValueBool(ppn,"Fill3D");
+  // the Q3D histogram is normalized with the (eta,phi,pt) singles, which are filled only with FillEta
+  fill3D       = fillEta && configuration.getValueBool(ppn,"Fill3D");
+  fill3DSparse = configuration.getValueBool(ppn,"Fill3DSparse");
+  fillFFT         = configuration.getValueBool(ppn,"FillFFT");
+  fillFFTMinPairs = configuration.getValueInt(ppn, "FillFFTMinPairs");
+  useCounters     = configuration.getValueBool(ppn,"UseCounters");
+  if (fillFFT)
+    {
+    densities1.initialize(nBins_pt,nBins_phi,nBins_eta,nBins_y,fillEta,fillY);
+    densities2.initialize(nBins_pt,nBins_phi,nBins_eta,nBins_y,fillEta,fillY);
+    densitiesShared.initialize(nBins_pt,nBins_phi,nBins_eta,nBins_y,fillEta,fillY);
+    if (fillEta) correlatorEta.initialize(nBins_eta,nBins_phi);
+    if (fillY)   correlatorY.initialize(nBins_y,nBins_phi);
+    }
 
   if (reportInfo(__FUNCTION__))
     {
@@ -153,6 +190,11 @@ void ParticlePairHistos::createHistograms()
     cout << "  Pair:FillEta.............................: " << fillEta     << endl;
     cout << "  Pair:FillY...............................: " << fillY       << endl;
     cout << "  Pair:FillP2..............................: " << fillP2      << endl;
+    cout << "  Pair:Fill3D..............................: " << fill3D      << endl;
+    cout << "  Pair:Fill3DSparse........................: " << fill3DSparse << endl;
+    cout << "  Pair:FillFFT.............................: " << fillFFT     << endl;
+    cout << "  Pair:FillFFTMinPairs.....................: " << fillFFTMinPairs << endl;
+    cout << "  Pair:UseCounters.........................: " << useCounters << endl;
     cout << "  Pair:nBins_n2............................: " << nBins_n2    << endl;
     cout << "  Pair:Min_n2..............................: " << min_n2      << endl;
     cout << "  Pair:Max_n2..............................: " << max_n2      << endl;
@@ -189,9 +231,9 @@ void ParticlePairHistos::createHistograms()
     cout << "  Pair:nBins_Dy............................: " << nBins_Dy     << endl;
     cout << "  Pair:Min_Dy..............................: " << min_Dy       << endl;
     cout << "  Pair:Max_Dy..............................: " << max_Dy       << endl;
-//    cout << "  Pair:nBins_DeltaP........................: " << standaloneMode      << endl;
-//    cout << "  Pair:Min_DeltaP..........................: " << standaloneMode      << endl;
-//    cout << "  Pair:Max_DeltaP..........................: " << standaloneMode      << endl;
+    cout << "  Pair:nBins_DeltaP........................: " << nBins_DeltaP << endl;
+    cout << "  Pair:Min_DeltaP..........................: " << min_DeltaP   << endl;
+    cout << "  Pair:Max_DeltaP..........................: " << max_DeltaP   << endl;
     }
 
   h_n2          = createHistogram(createName(bn,"n2"),         nBins_n2,  min_n2,  max_n2, "n_{2}", "Yield");
@@ -225,14 +267,38 @@ void ParticlePairHistos::createHistograms()
       }
     }
 
-  //  if (fill3D)
-  //    {
-  //    h_n2_DeltaP    = createHistogram(createName(bn,"n2_DeltaP"),
-  //                                     nBins_DeltaP,  min_DeltaP, max_DeltaP,
-  //                                     nBins_DeltaP,  min_DeltaP, max_DeltaP,
-  //                                     nBins_DeltaP,  min_DeltaP, max_DeltaP,
-  //                                     "p_{s}","p_{o}", "p_{l}","n_{2}");
-  //    }
+  if (useCounters)
+    {
+    c_n2_ptpt   = createCounter(h_n2_ptpt);
+    c_n2_phiPhi = createCounter(h_n2_phiPhi);
+    if (fillEta)
+      {
+      c_n2_etaEta   = createCounter(h_n2_etaEta);
+      c_n2_DetaDphi = createCounter(h_n2_DetaDphi);
+      }
+    if (fillY)
+      {
+      c_n2_yY     = createCounter(h_n2_yY);
+      c_n2_DyDphi = createCounter(h_n2_DyDphi);
+      }
+    }
+
+  if (fill3D && fill3DSparse)
+    {
+    s_n2_DeltaP    = createSparseHistogram(createName(bn,"n2_DeltaP"),
+                                           nBins_DeltaP,  min_DeltaP, max_DeltaP,
+                                           nBins_DeltaP,  min_DeltaP, max_DeltaP,
+                                           nBins_DeltaP,  min_DeltaP, max_DeltaP,
+                                           "q_{long}","q_{side}", "q_{out}","n_{2}");
+    }
+  else if (fill3D)
+    {
+    h_n2_DeltaP    = createHistogram(createName(bn,"n2_DeltaP"),
+                                     nBins_DeltaP,  min_DeltaP, max_DeltaP,
+                                     nBins_DeltaP,  min_DeltaP, max_DeltaP,
+                                     nBins_DeltaP,  min_DeltaP, max_DeltaP,
+                                     "q_{long}","q_{side}", "q_{out}","n_{2}");
+    }
 
   if ( reportEnd(__FUNCTION__))
     { }
@@ -249,6 +315,8 @@ void ParticlePairHistos::importHistograms(TFile & inputFile)
   fillEta       = configuration.getValueBool(ppn,"FillEta");
   fillY         = configuration.getValueBool(ppn,"FillY");
   fillP2        = configuration.getValueBool(ppn,"FillP2");
+  fill3D        = fillEta && configuration.getValueBool(ppn,"Fill3D");
+  fill3DSparse  = configuration.getValueBool(ppn,"Fill3DSparse");
   if (reportInfo(__FUNCTION__))
     {
     cout << endl;
@@ -258,6 +326,8 @@ void ParticlePairHistos::importHistograms(TFile & inputFile)
     cout << "  Pair:FillEta.............................: " << fillEta     << endl;
     cout << "  Pair:FillY...............................: " << fillY       << endl;
     cout << "  Pair:FillP2..............................: " << fillP2      << endl;
+    cout << "  Pair:Fill3D..............................: " << fill3D      << endl;
+    cout << "  Pair:Fill3DSparse........................: " << fill3DSparse << endl;
     }
   h_n2          = loadH1(inputFile, CAP::createName(bn,"n2"));
   h_n2_ptpt     = loadH2(inputFile, CAP::createName(bn,"n2_ptpt"));
@@ -277,6 +347,14 @@ void ParticlePairHistos::importHistograms(TFile & inputFile)
       h_DptDpt_etaEta   = loadH2(inputFile, CAP::createName(bn,"ptpt_etaEta"));
       h_DptDpt_DetaDphi = loadH2(inputFile, CAP::createName(bn,"ptpt_DetaDphi"));
       }
+    if (fill3D && fill3DSparse)
+      {
+      s_n2_DeltaP   = loadSparseH3(inputFile, CAP::createName(bn,"n2_DeltaP"));
+      }
+    else if (fill3D)
+      {
+      h_n2_DeltaP   = loadH3(inputFile, CAP::createName(bn,"n2_DeltaP"));
+      }
     }
   if (fillY)
     {
@@ -292,8 +370,14 @@ void ParticlePairHistos::importHistograms(TFile & inputFile)
     ;
 }
 
-void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<ParticleDigit*> & particle2, bool same, double weight)
+void ParticlePairHistos::fill(const vector<ParticleDigit*> & particle1, const vector<ParticleDigit*> & particle2, bool same, double weight)
 {
+  // the grid correlations do not provide the pair momentum differences: the Q3D histogram requires the pair loop
+  if (fillFFT && !fill3D && double(particle1.size())*double(particle2.size()) >= double(fillFFTMinPairs))
+    {
+    fillWithGrids(particle1,particle2,same,weight);
+    return;
+    }
   double nPairs    = 0;
   double nPairsEta = 0;
   double nPairsY   = 0;
@@ -310,6 +394,8 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
 
     for (unsigned int iPart_2=(same?iPart_1+1: 0); iPart_2<particle2.size(); iPart_2++)
       {
+      // overlapping filters share the digits of the particles they both accept: no self-pairs
+      if (particle1[iPart_1]==particle2[iPart_2]) continue;
       float pt2 = particle2[iPart_2]->pt;
       float dpt2 = pt2; // - avgPt2
       unsigned int iPt_2  = particle2[iPart_2]->iPt;
@@ -319,10 +405,10 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
 
       nPairs++;
       iG = h_n2_ptpt->GetBin(iPt_1,iPt_2);
-      h_n2_ptpt->AddBinContent(iG,  weight);
+      addToBin(h_n2_ptpt,c_n2_ptpt,iG,weight);
 
       iG = h_n2_phiPhi->GetBin(iPhi_1,iPhi_2);
-      h_n2_phiPhi->AddBinContent(iG,  weight);
+      addToBin(h_n2_phiPhi,c_n2_phiPhi,iG,weight);
       if (fillP2)
         {
         h_DptDpt_phiPhi ->AddBinContent(iG,weight*dpt1*dpt2);
@@ -331,9 +417,9 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
         {
         nPairs++;
         iG = h_n2_ptpt->GetBin(iPt_2,iPt_1);
-        h_n2_ptpt->AddBinContent(iG,  weight);
+        addToBin(h_n2_ptpt,c_n2_ptpt,iG,weight);
         iG = h_n2_phiPhi->GetBin(iPhi_2,iPhi_1);
-        h_n2_phiPhi->AddBinContent(iG,  weight);
+        addToBin(h_n2_phiPhi,c_n2_phiPhi,iG,weight);
         if (fillP2)
           {
           h_DptDpt_phiPhi->AddBinContent(iG,weight*pt1*pt2);
@@ -349,14 +435,14 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
         if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
 
         iG = h_n2_etaEta->GetBin(iEta_1,iEta_2);
-        h_n2_etaEta->AddBinContent(iG,weight);
+        addToBin(h_n2_etaEta,c_n2_etaEta,iG,weight);
         if (fillP2)
           {
           h_DptDpt_etaEta->AddBinContent(iG,weight*pt1*pt2);
           }
 
         iG = h_n2_DetaDphi->GetBin(iDeltaEta+1,iDeltaPhi+1);
-        h_n2_DetaDphi->AddBinContent(iG,weight);
+        addToBin(h_n2_DetaDphi,c_n2_DetaDphi,iG,weight);
         if (fillP2)
           {
           h_DptDpt_DetaDphi->AddBinContent(iG,weight*pt1*pt2);
@@ -369,14 +455,14 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
           iDeltaPhi  = iPhi_2-iPhi_1;
           if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
           iG = h_n2_etaEta->GetBin(iEta_2,iEta_1);
-          h_n2_etaEta->AddBinContent(iG,weight);
+          addToBin(h_n2_etaEta,c_n2_etaEta,iG,weight);
           if (fillP2)
             {
             h_DptDpt_etaEta->AddBinContent(iG,weight*pt1*pt2);
             }
 
           iG = h_n2_DetaDphi->GetBin(iDeltaEta+1,iDeltaPhi+1);
-          h_n2_DetaDphi->AddBinContent(iG,weight);
+          addToBin(h_n2_DetaDphi,c_n2_DetaDphi,iG,weight);
           if (fillP2)
             {
             h_DptDpt_DetaDphi->AddBinContent(iG,weight*pt1*pt2);
@@ -392,14 +478,14 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
         if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
 
         iG = h_n2_yY->GetBin(iY_1,iY_2);
-        h_n2_yY->AddBinContent(iG,weight);
+        addToBin(h_n2_yY,c_n2_yY,iG,weight);
         if (fillP2)
           {
           h_DptDpt_yY->AddBinContent(iG,weight*pt1*pt2);
           }
 
         iG = h_n2_DyDphi->GetBin(iDeltaY+1,iDeltaPhi+1);
-        h_n2_DyDphi  ->AddBinContent(iG,weight);
+        addToBin(h_n2_DyDphi,c_n2_DyDphi,iG,weight);
         if (fillP2)
           {
           h_DptDpt_DyDphi->AddBinContent(iG,weight*pt1*pt2);
@@ -412,14 +498,14 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
           if (iDeltaPhi < 0) iDeltaPhi += nBins_phi;
 
           iG = h_n2_yY->GetBin(iY_1,iY_2);
-          h_n2_yY->AddBinContent(iG,weight);
+          addToBin(h_n2_yY,c_n2_yY,iG,weight);
           if (fillP2)
             {
             h_DptDpt_yY->AddBinContent(iG,weight*pt1*pt2);
             }
 
           iG = h_n2_DyDphi->GetBin(iDeltaY+1,iDeltaPhi+1);
-          h_n2_DyDphi  ->AddBinContent(iG,weight);
+          addToBin(h_n2_DyDphi,c_n2_DyDphi,iG,weight);
           if (fillP2)
             {
             h_DptDpt_DyDphi->AddBinContent(iG,weight*pt1*pt2);
@@ -427,33 +513,11 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
           }
         }
 
-      //      if (fill3D)
-      //        {
-      //        //decompose(double *pa,double *pb,double &qlong,double &qout,double &qside,double &qinv)
-      //
-      //        // Method from Scott Pratt to do three dimensional qinv components
-      //        double pt,s,Mlong,roots;
-      //        double ptot[4],q[4];
-      //        const int g[4]={1,-1,-1,-1};
-      //        int alpha;
-      //        qinv=0.0;
-      //        s=0.0;
-      //        for(alpha=0;alpha<4;alpha++)
-      //          {
-      //          ptot[alpha]=pa[alpha]+pb[alpha];
-      //          s+=g[alpha]*ptot[alpha]*ptot[alpha];
-      //          q[alpha]=pa[alpha]-pb[alpha];
-      //          qinv-=g[alpha]*q[alpha]*q[alpha];
-      //          }
-      //        pt=sqrt(ptot[1]*ptot[1]+ptot[2]*ptot[2]);
-      //        Mlong=sqrt(s+pt*pt);
-      //        roots=sqrt(s);
-      //
-      //        qside=(ptot[1]*q[2]-ptot[2]*q[1])/pt;
-      //        qlong=(ptot[0]*q[3]-ptot[3]*q[0])/Mlong;
-      //        qout=(roots/Mlong)*(ptot[1]*q[1]+ptot[2]*q[2])/pt;
-      //        qinv=sqrt(qinv);
-      //        }
+      if (fill3D && iEta_1!=0 && iEta_2!=0)
+        {
+        fillQ3D(pt1, particle1[iPart_1]->phi, particle1[iPart_1]->eta,
+                pt2, particle2[iPart_2]->phi, particle2[iPart_2]->eta, same, weight);
+        }
       }
     }
 
@@ -488,24 +552,153 @@ void ParticlePairHistos::fill(vector<ParticleDigit*> & particle1, vector<Particl
   h_n2->Fill(double(nPairs),weight);
 }
 
+void ParticlePairHistos::fillWithGrids(const vector<ParticleDigit*> & particle1, const vector<ParticleDigit*> & particle2, bool same, double weight)
+{
+  densities1.fill(particle1);
+  if (!same) densities2.fill(particle2);
+  ParticleDensityGrids & d1 = densities1;
+  ParticleDensityGrids & d2 = same ? densities1 : densities2;
+
+  // self pairs: all the particles of the list if same, the particles shared by overlapping filters otherwise
+  const ParticleDensityGrids * self = same ? &densities1 : nullptr;
+  if (!same)
+    {
+    findSharedParticles(particle1,particle2,sharedParticles);
+    if (sharedParticles.size()>0)
+      {
+      densitiesShared.fill(sharedParticles);
+      self = &densitiesShared;
+      }
+    }
+
+  double nPairs = d1.n*d2.n - (self ? self->n : 0.0);
+  fillOuterProduct(h_n2_ptpt,   c_n2_ptpt,   d1.n_pt,  d2.n_pt,  self ? &self->n_pt  : nullptr, weight);
+  fillOuterProduct(h_n2_phiPhi, c_n2_phiPhi, d1.n_phi, d2.n_phi, self ? &self->n_phi : nullptr, weight);
+  h_n2_ptpt->SetEntries(h_n2_ptpt->GetEntries()+nPairs);
+  h_n2_phiPhi->SetEntries(h_n2_phiPhi->GetEntries()+nPairs);
+  if (fillP2)
+    {
+    fillOuterProduct(h_DptDpt_phiPhi, nullptr, d1.pt_phi, d2.pt_phi, self ? &self->pt2_phi : nullptr, weight);
+    h_DptDpt_phiPhi->SetEntries(h_DptDpt_phiPhi->GetEntries()+nPairs);
+    }
+
+  if (fillEta)
+    {
+    double nPairsEta = d1.nEta*d2.nEta - (self ? self->nEta : 0.0);
+    fillOuterProduct(h_n2_etaEta, c_n2_etaEta, d1.n_eta, d2.n_eta, self ? &self->n_eta : nullptr, weight);
+    correlatorEta.correlate(d1.n_etaPhi, d2.n_etaPhi, same, correlationN);
+    if (fillP2)
+      {
+      fillOuterProduct(h_DptDpt_etaEta, nullptr, d1.pt_eta, d2.pt_eta, self ? &self->pt2_eta : nullptr, weight);
+      correlatorEta.correlate(d1.pt_etaPhi, d2.pt_etaPhi, same, correlationPtPt);
+      }
+    fillDeltaCorrelation(h_n2_DetaDphi, c_n2_DetaDphi, fillP2 ? h_DptDpt_DetaDphi : nullptr, nBins_eta, correlationN, correlationPtPt,
+                         self ? self->nEtaPhi : 0.0, self ? self->pt2EtaPhi : 0.0, weight);
+    h_n2_etaEta->SetEntries(h_n2_etaEta->GetEntries()+nPairsEta);
+    h_n2_DetaDphi->SetEntries(h_n2_DetaDphi->GetEntries()+nPairsEta);
+    if (fillP2)
+      {
+      h_DptDpt_etaEta->SetEntries(h_DptDpt_etaEta->GetEntries()+nPairsEta);
+      h_DptDpt_DetaDphi->SetEntries(h_DptDpt_DetaDphi->GetEntries()+nPairsEta);
+      }
+    }
+
+  if (fillY)
+    {
+    double nPairsY = d1.nY*d2.nY - (self ? self->nY : 0.0);
+    fillOuterProduct(h_n2_yY, c_n2_yY, d1.n_y, d2.n_y, self ? &self->n_y : nullptr, weight);
+    correlatorY.correlate(d1.n_yPhi, d2.n_yPhi, same, correlationN);
+    if (fillP2)
+      {
+      fillOuterProduct(h_DptDpt_yY, nullptr, d1.pt_y, d2.pt_y, self ? &self->pt2_y : nullptr, weight);
+      correlatorY.correlate(d1.pt_yPhi, d2.pt_yPhi, same, correlationPtPt);
+      }
+    fillDeltaCorrelation(h_n2_DyDphi, c_n2_DyDphi, fillP2 ? h_DptDpt_DyDphi : nullptr, nBins_y, correlationN, correlationPtPt,
+                         self ? self->nYPhi : 0.0, self ? self->pt2YPhi : 0.0, weight);
+    h_n2_yY->SetEntries(h_n2_yY->GetEntries()+nPairsY);
+    h_n2_DyDphi->SetEntries(h_n2_DyDphi->GetEntries()+nPairsY);
+    if (fillP2)
+      {
+      h_DptDpt_yY->SetEntries(h_DptDpt_yY->GetEntries()+nPairsY);
+      h_DptDpt_DyDphi->SetEntries(h_DptDpt_DyDphi->GetEntries()+nPairsY);
+      }
+    }
+  h_n2->Fill(nPairs,weight);
+}
+
+void ParticlePairHistos::findSharedParticles(const vector<ParticleDigit*> & particle1, const vector<ParticleDigit*> & particle2, vector<ParticleDigit*> & shared)
+{
+  shared.clear();
+  sortedParticles.assign(particle2.begin(),particle2.end());
+  std::sort(sortedParticles.begin(),sortedParticles.end());
+  for (unsigned int iPart=0; iPart<particle1.size(); iPart++)
+    {
+    if (std::binary_search(sortedParticles.begin(),sortedParticles.end(),particle1[iPart])) shared.push_back(particle1[iPart]);
+    }
+}
+
+void ParticlePairHistos::fillOuterProduct(TH2 * h, HistogramCounter * counter, const vector<double> & a1, const vector<double> & a2, const vector<double> * self, double weight)
+{
+  unsigned int n1 = a1.size();
+  unsigned int n2 = a2.size();
+  for (unsigned int i=0; i<n1; i++)
+    {
+    if (a1[i]==0.0) continue;
+    for (unsigned int j=0; j<n2; j++)
+      {
+      double v = a1[i]*a2[j];
+      if (self && i==j) v -= (*self)[i];
+      if (v==0.0) continue;
+      int iG = h->GetBin(i,j);
+      if (counter)
+        counter->fill(iG,weight,(unsigned long)(v+0.5));
+      else
+        h->AddBinContent(iG,weight*v);
+      }
+    }
+}
+
+void ParticlePairHistos::fillDeltaCorrelation(TH2 * hN, HistogramCounter * cN, TH2 * hPtPt, int nBinsX, const vector<double> & n2, const vector<double> & ptpt,
+                                              double selfN, double selfPtPt, double weight)
+{
+  int nBinsDeltaX = 2*nBinsX-1;
+  int iDeltaX0    = nBinsX-1;
+  for (int iDeltaX=0; iDeltaX<nBinsDeltaX; iDeltaX++)
+    {
+    for (int iDeltaPhi=0; iDeltaPhi<nBins_phi; iDeltaPhi++)
+      {
+      int k = iDeltaX*nBins_phi + iDeltaPhi;
+      double vN = n2[k];
+      double vPtPt = hPtPt ? ptpt[k] : 0.0;
+      if (iDeltaX==iDeltaX0 && iDeltaPhi==0)
+        {
+        vN    -= selfN;
+        vPtPt -= selfPtPt;
+        }
+      vN = floor(vN+0.5);
+      if (vN==0.0) continue;
+      int iG = hN->GetBin(iDeltaX+1,iDeltaPhi+1);
+      if (cN)
+        cN->fill(iG,weight,(unsigned long) vN);
+      else
+        hN->AddBinContent(iG,weight*vN);
+      if (hPtPt) hPtPt->AddBinContent(iG,weight*vPtPt);
+      }
+    }
+}
+
 void ParticlePairHistos::fill(Particle & particle1, Particle & particle2, double weight)
 {
 //  if (reportInfo(__FUNCTION__))
 //    ;
-  LorentzVector & momentum1 = particle1.getMomentum();
-  double pt1   = momentum1.Pt();
-  //double e1    = momentum1.E();
-  double phi1  = momentum1.Phi();
-  double eta1  = momentum1.Eta();
-  double y1    = momentum1.Rapidity();
-  LorentzVector & momentum2 = particle2.getMomentum();
-  double pt2   = momentum2.Pt();
-  //double e2    = momentum2.E();
-  double phi2  = momentum2.Phi();
-  double eta2  = momentum2.Eta();
-  double y2    = momentum2.Rapidity();
-  if (phi1<0.0) phi1 += TMath::TwoPi();
-  if (phi2<0.0) phi2 += TMath::TwoPi();
+  double pt1   = particle1.getPt();
+  double phi1  = particle1.getPhi();
+  double eta1  = particle1.getEta();
+  double y1    = particle1.getY();
+  double pt2   = particle2.getPt();
+  double phi2  = particle2.getPhi();
+  double eta2  = particle2.getEta();
+  double y2    = particle2.getY();
   double dphi = phi1 - phi2;
   if (dphi<0.0) dphi += TMath::TwoPi();
   else if (dphi>TMath::TwoPi()) dphi -= TMath::TwoPi();
@@ -524,6 +717,7 @@ void ParticlePairHistos::fill(Particle & particle1, Particle & particle2, double
       h_DptDpt_etaEta->Fill(eta1,eta2,weight*pt1*pt2);  // needs attention
       h_DptDpt_DetaDphi->Fill(deta,dphi,weight*pt1*pt2); // needs attention
       }
+    if (fill3D) fillQ3D(pt1,phi1,eta1,pt2,phi2,eta2,false,weight);
     }
   if (fillY)
     {
@@ -540,3 +734,18 @@ void ParticlePairHistos::fill(Particle & particle1, Particle & particle2, double
 //    ;
 }
 
+void ParticlePairHistos::fillQ3D(double pt1, double phi1, double eta1, double pt2, double phi2, double eta2, bool both, double weight)
+{
+  double Qlong, Qout, Qside;
+  if (calculateQ3DwPtPhiEta(pt1, phi1, eta1, pt2, phi2, eta2, Qlong, Qout, Qside)!=0) return;
+  if (s_n2_DeltaP)
+    {
+    s_n2_DeltaP->fill(Qlong,Qside,Qout,weight);
+    if (both) s_n2_DeltaP->fill(-Qlong,-Qside,-Qout,weight);
+    }
+  else
+    {
+    h_n2_DeltaP->Fill(Qlong,Qside,Qout,weight);
+    if (both) h_n2_DeltaP->Fill(-Qlong,-Qside,-Qout,weight);
+    }
+}
@@ -15,6 +15,7 @@
 #include "HistogramGroup.hpp"
 #include "Particle.hpp"
 #include "ParticleDigit.hpp"
+#include "ParticlePairGridCorrelator.hpp"
 
 namespace CAP
 {
@@ -31,9 +32,29 @@ public:
   virtual void createHistograms();
   virtual void importHistograms(TFile & inputFile);
 
-  virtual void fill(vector<ParticleDigit*> & particle1, vector<ParticleDigit*> & particle2, bool same, double weight);
+  //!
+  //! Fill the pair histograms with the pairs of the two given lists. Both orderings of each pair are filled when same is true. The two
+  //! lists may share digits (particles accepted by two overlapping filters): such a digit is never paired with itself.
+  //!
+  virtual void fill(const vector<ParticleDigit*> & particle1, const vector<ParticleDigit*> & particle2, bool same, double weight);
   virtual void fill(Particle & particle1, Particle & particle2, double weight);
 
+  //!
+  //! Add the (q_long, q_side, q_out) components of the pair (and of the reversed pair if both) to the n2 Q3D histogram.
+  //! The components are computed with HistogramCollection::calculateQ3DwPtPhiEta as for the n1n1 Q3D normalization.
+  //!
+  void fillQ3D(double pt1, double phi1, double eta1, double pt2, double phi2, double eta2, bool both, double weight);
+
+  //!
+  //! Fill the pair histograms from the per-event single particle densities of the two given lists rather than with a pair loop.
+  //! The (eta1,eta2), (phi1,phi2), (pt1,pt2) histograms are filled with outer products of the single particle marginals, and the
+  //! (Delta eta, Delta phi) histograms with the FFT correlation of the (eta, phi) occupancy grids. Self pairs are removed: those of all the
+  //! particles when same is true, and those of the particles shared by the two lists (overlapping filters) otherwise.
+  //! Counts are identical to those of the pair loop; pt-weighted sums are identical up to floating point rounding. This mode is used
+  //! automatically by fill(vector<ParticleDigit*>...) when FillFFT is enabled and the number of pairs exceeds FillFFTMinPairs.
+  //!
+  virtual void fillWithGrids(const vector<ParticleDigit*> & particle1, const vector<ParticleDigit*> & particle2, bool same, double weight);
+
   inline int getPtBinFor(float v) const
   {
   int index = 0; // indicates a value out of bounds
@@ -118,10 +139,18 @@ public:
   double min_Dphi_shft;
   double max_Dphi_shft;
 
+  int    nBins_DeltaP;
+  double min_DeltaP;
+  double max_DeltaP;
+
   bool fillEta;
   bool fillY;
   bool fillP2;
   bool fill3D;
+  bool fill3DSparse;
+  bool fillFFT;
+  long fillFFTMinPairs;
+  bool useCounters;
 
   TH1 * h_n2;
 
@@ -143,6 +172,52 @@ public:
   TH2* h_DptDpt_DyDphi;
 
   TH3 * h_n2_DeltaP;
+  SparseHistogram3D * s_n2_DeltaP; // used instead of h_n2_DeltaP with Fill3DSparse
+
+  // integer-exact counters of the pair count histograms (null if not used)
+  HistogramCounter * c_n2_ptpt;
+  HistogramCounter * c_n2_phiPhi;
+  HistogramCounter * c_n2_etaEta;
+  HistogramCounter * c_n2_DetaDphi;
+  HistogramCounter * c_n2_yY;
+  HistogramCounter * c_n2_DyDphi;
+
+protected:
+
+  inline void addToBin(TH1 * h, HistogramCounter * counter, int iG, double weight)
+  {
+  if (counter)
+    counter->fill(iG,weight);
+  else
+    h->AddBinContent(iG,weight);
+  }
+
+  //!
+  //! Add weight*(a1[i]*a2[j] - self[i] delta_ij) to the bins (i,j) of the given histogram. The self term is ignored if null.
+  //!
+  void fillOuterProduct(TH2 * h, HistogramCounter * counter, const vector<double> & a1, const vector<double> & a2, const vector<double> * self, double weight);
+
+  //!
+  //! Add the given (Delta x, Delta phi) correlations of the count and pt grids to the given histograms. The self terms are subtracted
+  //! at Delta x = Delta phi = 0. Count correlations are rounded to integers; pt correlations are only added where the count correlation is non-zero.
+  //!
+  void fillDeltaCorrelation(TH2 * hN, HistogramCounter * cN, TH2 * hPtPt, int nBinsX, const vector<double> & n2, const vector<double> & ptpt,
+                            double selfN, double selfPtPt, double weight);
+
+  //!
+  //! Collect in shared the digits present in both lists, i.e., the particles accepted by two overlapping filters.
+  //!
+  void findSharedParticles(const vector<ParticleDigit*> & particle1, const vector<ParticleDigit*> & particle2, vector<ParticleDigit*> & shared);
+
+  ParticleDensityGrids       densities1;
+  ParticleDensityGrids       densities2;
+  ParticleDensityGrids       densitiesShared; //!< densities of the particles shared by the two lists
+  vector<ParticleDigit*>     sharedParticles;
+  vector<ParticleDigit*>     sortedParticles;
+  ParticlePairGridCorrelator correlatorEta;
+  ParticlePairGridCorrelator correlatorY;
+  vector<double>             correlationN;
+  vector<double>             correlationPtPt;
 
   ClassDef(ParticlePairHistos,0)
 };
@@ -6,4 +6,12 @@
 #pragma link C++ class CAP::ParticlePairDerivedHistos+;
 #pragma link C++ class CAP::ParticlePairAnalyzer+;
 #pragma link C++ class CAP::BalanceFunctionCalculator+;
+#pragma link C++ class CAP::ParticleDensityGrids+;
+#pragma link C++ class CAP::ParticlePairGridCorrelator+;
+#pragma link C++ class CAP::EventMixingRecord+;
+#pragma link C++ class CAP::EventMixingPool+;
+#pragma link C++ class CAP::FlowQVector+;
+#pragma link C++ class CAP::FlowHistos+;
+#pragma link C++ class CAP::FlowDerivedHistos+;
+#pragma link C++ class CAP::FlowAnalyzer+;
 #endif
@@ -24,7 +24,12 @@ ParticleSingleAnalyzer::ParticleSingleAnalyzer(const String & _name,
 EventTask(_name,_configuration,_eventFilters,_particleFilters),
 fillEta(true),
 fillY(false),
-fillP2(false)
+fillP2(false),
+filteredParticles(),
+binningSlot(-1),
+variations(),
+variationMasks(),
+variationDigits()
 {
   appendClassName("ParticleSingleAnalyzer");
   for (unsigned int k=0; k<particleFilters.size(); k++)
@@ -73,6 +78,8 @@ void ParticleSingleAnalyzer::setDefaultConfiguration()
   addParameter( "FillEta",  fillEta);
   addParameter( "FillY",    fillY);
   addParameter( "FillP2",   fillP2);
+  addParameter( "Fill3D",   false);
+  SelectionVariation::addParameters(*this);
 }
 
 void ParticleSingleAnalyzer::configure()
@@ -81,6 +88,10 @@ void ParticleSingleAnalyzer::configure()
   fillEta = getValueBool("FillEta");
   fillY   = getValueBool("FillY");
   fillP2  = getValueBool("FillP2");
+  SelectionVariation::readVariations(*this,variations);
+  int nVariations = variations.size();
+  // variations operate on the digits provided by the shared analysis context
+  if (nVariations>0) eventsUseAnalysisContext = true;
   //configuration.sanityCheck("EventsAnalyze");
   if (reportInfo(__FUNCTION__))
     {
@@ -115,10 +126,25 @@ void ParticleSingleAnalyzer::configure()
     printItem("FillEta",fillEta);
     printItem("FillY",fillY);
     printItem("FillP2",fillP2);
+    printItem("Fill3D");
+    printItem("nVariations",int(variations.size()));
+    for (unsigned int k=0; k<variations.size(); k++) printItem("Variation",variations[k].name);
     cout << endl;
     }
 }
 
+void ParticleSingleAnalyzer::initializeAnalysisContext()
+{
+  EventTask::initializeAnalysisContext();
+  if (!analysisContext) return;
+  ParticleBinning binning(getValueInt("nBins_pt"),  getValueDouble("Min_pt"),  getValueDouble("Max_pt"),
+                          getValueInt("nBins_phi"), getValueDouble("Min_phi"), getValueDouble("Max_phi"),
+                          getValueInt("nBins_eta"), getValueDouble("Min_eta"), getValueDouble("Max_eta"),
+                          getValueInt("nBins_y"),   getValueDouble("Min_y"),   getValueDouble("Max_y"),
+                          fillEta, fillY);
+  binningSlot = analysisContext->addBinning(binning);
+}
+
 void ParticleSingleAnalyzer::createHistograms()
 {
   if (reportInfo(__FUNCTION__))
@@ -142,6 +168,22 @@ void ParticleSingleAnalyzer::createHistograms()
       histogramManager.addGroupInSet(0,histos);
       }
     }
+  // histograms of the selection variations are appended to the set, one block of nEventFilters*nParticleFilters groups per variation
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        String pfn = particleFilters[iParticleFilter]->getName();
+        ParticleSingleHistos * histos = new ParticleSingleHistos(this,createName(getName(),vn,efn,pfn),configuration);
+        histos->createHistograms();
+        histogramManager.addGroupInSet(0,histos);
+        }
+      }
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -171,12 +213,66 @@ void ParticleSingleAnalyzer::importHistograms(TFile & inputFile)
       histogramManager.addGroupInSet(0,histos);
       }
     }
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        String pfn = particleFilters[iParticleFilter]->getName();
+        ParticleSingleHistos * histos = new ParticleSingleHistos(this,createName(getName(),vn,efn,pfn),configuration);
+        histos->importHistograms(inputFile);
+        histogramManager.addGroupInSet(0,histos);
+        }
+      }
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
 
 void ParticleSingleAnalyzer::analyzeEvent()
 {
+  if (analysisContext)
+    {
+    // filters and digitization already evaluated (once for all analyzers) by the shared context
+    resetNParticlesAcceptedEvent();
+    unsigned int nVariations = variations.size();
+    if (nVariations>0 && analysisContext->isEventAccepted())
+      {
+      // select the digits of all the variations once per particle filter
+      variationDigits.resize(nParticleFilters);
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        const vector<ParticleDigit*> & digits = analysisContext->getDigits(binningSlot,particleFilterSlots[iParticleFilter]);
+        SelectionVariation::select(variations,digits,variationMasks,variationDigits[iParticleFilter]);
+        }
+      }
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      if (!analysisContext->isEventAccepted(eventFilterSlots[iEventFilter])) continue;
+      incrementNEventsAccepted(iEventFilter);
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        // particles out of bounds of the binning are not digitized but count in the multiplicities, as without the context
+        const vector<ParticleDigit*> & digits = analysisContext->getDigits(binningSlot,particleFilterSlots[iParticleFilter]);
+        const vector<Particle*> & accepted = analysisContext->getAcceptedParticles(particleFilterSlots[iParticleFilter]);
+        for (unsigned int iParticle=0; iParticle<accepted.size(); iParticle++) incrementNParticlesAccepted(iEventFilter,iParticleFilter);
+        int index = iParticleFilter+iEventFilter*nParticleFilters;
+        ParticleSingleHistos * histos = (ParticleSingleHistos *) histogramManager.getGroup(0,index);
+        histos->fill(digits,accepted,1.0);
+        for (unsigned int iVariation=0; iVariation<nVariations; iVariation++)
+          {
+          int variationIndex = (iVariation+1)*nEventFilters*nParticleFilters + index;
+          histos = (ParticleSingleHistos *) histogramManager.getGroup(0,variationIndex);
+          histos->fill(variationDigits[iParticleFilter][iVariation],1.0);
+          }
+        }
+      }
+    return;
+    }
+
   Event & event = *eventStreams[0];
   //Is this event accepted by this task's event filters?
   bool analyzeThisEvent = false;
@@ -231,15 +327,13 @@ void ParticleSingleAnalyzer::analyzeEvent()
           incrementNParticlesAccepted(iEventFilter,iParticleFilter);
           if (!digitized)
             {
-            LorentzVector & momentum = particle.getMomentum();
-            pt     = momentum.Pt();
-            e      = momentum.E();
-            phi    = momentum.Phi();
-            if (phi<0.0) phi += TMath::TwoPi();
+            pt     = particle.getPt();
+            e      = particle.getE();
+            phi    = particle.getPhi();
             iPt    = histos->getPtBinFor(pt);
             iPhi   = histos->getPhiBinFor(phi);
-            iEta   = histos->getEtaBinFor(momentum.Eta());
-            iY     = histos->getYBinFor(momentum.Rapidity());
+            iEta   = histos->getEtaBinFor(particle.getEta());
+            iY     = histos->getYBinFor(particle.getY());
             pd     = factory->getNextObject();
             pd->iY   = iY;
             pd->iEta = iEta;
@@ -320,6 +414,21 @@ void ParticleSingleAnalyzer::createDerivedHistograms()
       histogramManager.addGroupInSet(1,histos);
       }
     }
+  for (unsigned int iVariation=0; iVariation<variations.size(); iVariation++)
+    {
+    String vn = variations[iVariation].name;
+    for (int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+      {
+      String efn = eventFilters[iEventFilter]->getName();
+      for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
+        {
+        String pfn = particleFilters[iParticleFilter]->getName();
+        histos = new ParticleSingleDerivedHistos(this,createName(bn,vn,efn,pfn),configuration);
+        histos->createHistograms();
+        histogramManager.addGroupInSet(1,histos);
+        }
+      }
+    }
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -351,15 +460,13 @@ void ParticleSingleAnalyzer::calculateDerivedHistograms()
 
   //!Mode 1: Running rigth after Analysis: base histograms pointers  are copied from analyzer to baseSingleHistograms
   //!Mode 2: Running as standalone: base histograms are loaded from file.
-  for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++ )
+  //!The base selection is followed by the selection variations, if any.
+  unsigned int nGroups = (1+variations.size())*nEventFilters*nParticleFilters;
+  for (index=0; index<nGroups; index++)
     {
-    for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
-      {
-      index = iEventFilter*nParticleFilters + iParticleFilter;
-      baseHistos    = (ParticleSingleHistos *)  histogramManager.getGroup(0,index);
-      derivedHistos = (ParticleSingleDerivedHistos *)  histogramManager.getGroup(1,index);
-      derivedHistos->calculateDerivedHistograms(baseHistos);
-      }
+    baseHistos    = (ParticleSingleHistos *)  histogramManager.getGroup(0,index);
+    derivedHistos = (ParticleSingleDerivedHistos *)  histogramManager.getGroup(1,index);
+    derivedHistos->calculateDerivedHistograms(baseHistos);
     }
   if (reportEnd(__FUNCTION__))
     { }
@@ -387,9 +494,12 @@ void ParticleSingleAnalyzer::scaleHistograms()
     double scalingFactor = 1.0/double(nEvents);
     for (int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++ )
       {
-      int groupIndex = iEventFilter*nParticleFilters + iParticleFilter;
-      ParticleSingleHistos * group = (ParticleSingleHistos*) histogramManager.getGroup(0,groupIndex);
-      group->scale(scalingFactor);
+      for (unsigned int iVariation=0; iVariation<=variations.size(); iVariation++)
+        {
+        int groupIndex = (iVariation*nEventFilters + iEventFilter)*nParticleFilters + iParticleFilter;
+        ParticleSingleHistos * group = (ParticleSingleHistos*) histogramManager.getGroup(0,groupIndex);
+        group->scale(scalingFactor);
+        }
       }
     }
   if (reportEnd(__FUNCTION__))
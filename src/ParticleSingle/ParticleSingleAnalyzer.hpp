@@ -13,6 +13,7 @@
 #define CAP__ParticleSingleAnalyzer
 #include "EventTask.hpp"
 #include "ParticleDigit.hpp"
+#include "SelectionVariation.hpp"
 
 namespace CAP
 {
@@ -56,6 +57,15 @@ namespace CAP
 //!  + min_phi [0.0]: Minimum value
 //!  + max_phi [2pi]: Maximum value
 //!
+//! Selection variations (systematic studies; requires and enables the shared analysis context):
+//! - nVariations [0]: number of variations, at most SelectionVariation::maxVariations
+//! - VariationK_Name ["VarK"]: name of the variation K, used in the names of its histograms
+//! - VariationK_Min_pt, VariationK_Max_pt, VariationK_Min_eta, VariationK_Max_eta, VariationK_Min_y, VariationK_Max_y,
+//!   VariationK_Min_phi, VariationK_Max_phi [no limit]: kinematic ranges of the variation K
+//!
+//! The particles accepted and digitized once by the base filters are selected by all the variations in a single pass, and the histograms
+//! of each variation are filled from the same digits in the same event loop as the base histograms.
+//!
 class ParticleSingleAnalyzer : public EventTask
 {
 public:
@@ -85,6 +95,11 @@ public:
   virtual void setDefaultConfiguration();
 
   virtual void configure();
+
+  //!
+  //! Register the filters of this task and the particle binning it uses with the shared analysis context (if enabled).
+  //!
+  virtual void initializeAnalysisContext();
   //!
   //! Execute a single particle analysis  based on event and particle fileter operated with this task instance.
   //! Two options are implemented and chosen automatically by the code. 
@@ -123,6 +138,11 @@ protected:
   bool fillP2;  //!< whether to fill P2 and G2 related histograms  (set from configuration at initialization)
 
   vector< vector<ParticleDigit*> > filteredParticles;
+  int binningSlot; //!< slot of the particle binning of this task in the shared analysis context
+
+  vector<SelectionVariation> variations;          //!< selection variations (set from configuration at initialization)
+  vector<unsigned int> variationMasks;            //!< variations accepting each digit of the current particle filter
+  vector< vector< vector<ParticleDigit*> > > variationDigits; //!< digits of the current event, [iParticleFilter][iVariation]
 
   ClassDef(ParticleSingleAnalyzer,0)
 };
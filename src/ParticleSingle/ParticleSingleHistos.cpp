@@ -23,6 +23,7 @@ HistogramGroup(_parent,_name,_configuration),
 fillEta(0),
 fillY(0),
 fillP2(0),
+fill3D(0),
 useEffCorrection(0),
 efficiencyOpt(0),
 nBins_n1(0),
@@ -50,6 +51,7 @@ h_n1_pt(nullptr),
 h_n1_ptXS(nullptr),
 h_n1_phiEta(nullptr),
 h_spt_phiEta(nullptr),
+h_n1_etaPhiPt(nullptr),
 h_n1_phiY(nullptr),
 h_spt_phiY(nullptr),
 h_pdgId(nullptr)
@@ -97,6 +99,7 @@ void ParticleSingleHistos::createHistograms()
   fillEta = configuration.getValueBool(ppn,"FillEta");
   fillY   = configuration.getValueBool(ppn,"FillY");
   fillP2  = configuration.getValueBool(ppn,"FillP2");
+  fill3D  = configuration.getValueBool(ppn,"Fill3D");
 
   if (reportDebug(__FUNCTION__))
     {
@@ -107,6 +110,7 @@ void ParticleSingleHistos::createHistograms()
     cout << "  Part:FillEta.............................: " << fillEta << endl;
     cout << "  Part:FillY...............................: " << fillY   << endl;
     cout << "  Part:FillP2..............................: " << fillP2  << endl;
+    cout << "  Part:Fill3D..............................: " << fill3D  << endl;
     cout << "  Part:nBins_n1............................: " << nBins_n1 << endl;
     cout << "  Part:Min_n1..............................: " << min_n1 << endl;
     cout << "  Part:Max_n1..............................: " << max_n1 << endl;
@@ -143,6 +147,10 @@ void ParticleSingleHistos::createHistograms()
       {
       h_spt_phiEta  = createHistogram(createName(bn,"spt_phiEta"),  nBins_eta, min_eta, max_eta, nBins_phi, min_phi, max_phi, "#eta", "#varphi","N");
       }
+    if (fill3D)
+      {
+      h_n1_etaPhiPt = createHistogram(createName(bn,"n1_etaPhiPt"), nBins_eta, min_eta, max_eta, nBins_phi, min_phi, max_phi, nBins_pt, min_pt, max_pt, "#eta", "#varphi", "p_{T}", "N");
+      }
     }
   if (fillY)
     {
@@ -185,6 +193,7 @@ void ParticleSingleHistos::importHistograms(TFile & inputFile)
   fillEta      = configuration.getValueBool(ppn,"FillEta");
   fillY        = configuration.getValueBool(ppn,"FillY");
   fillP2       = configuration.getValueBool(ppn,"FillP2");
+  fill3D       = configuration.getValueBool(ppn,"Fill3D");
   h_n1         = loadH1(inputFile,  createName(bn,"n1"));
   h_n1_eTotal  = loadH1(inputFile,  createName(bn,"n1_eTotal"));
   h_n1_pt      = loadH1(inputFile,  createName(bn,"n1_pt"));
@@ -197,6 +206,10 @@ void ParticleSingleHistos::importHistograms(TFile & inputFile)
       {
       h_spt_phiEta  = loadH2(inputFile,  createName(bn,"spt_phiEta"));
       }
+    if (fill3D)
+      {
+      h_n1_etaPhiPt = loadH3(inputFile,  createName(bn,"n1_etaPhiPt"));
+      }
     }
   if (fillY)
     {
@@ -262,7 +275,24 @@ void ParticleSingleHistos::loadCalibration(TFile & inputFile)
 //!
 //! Fiil  single particle histograms of this class with the particles contained in the given list.
 //!
-void ParticleSingleHistos::fill(vector<ParticleDigit*> & particles, double weight)
+void ParticleSingleHistos::fill(const vector<ParticleDigit*> & particles, double weight)
+{
+  double totalEnergy = fillDigits(particles,weight);
+  fillMultiplicity(particles.size(),totalEnergy,weight);
+}
+
+//!
+//! Fiil  single particle histograms of this class with the given digits, and the multiplicity histograms with the given accepted particles.
+//!
+void ParticleSingleHistos::fill(const vector<ParticleDigit*> & particles, const vector<Particle*> & accepted, double weight)
+{
+  fillDigits(particles,weight);
+  double totalEnergy = 0;
+  for (unsigned int iPart=0; iPart<accepted.size(); iPart++) totalEnergy += accepted[iPart]->getE();
+  fillMultiplicity(accepted.size(),totalEnergy,weight);
+}
+
+double ParticleSingleHistos::fillDigits(const vector<ParticleDigit*> & particles, double weight)
 {
   double nSingles      = 0;
   double nSinglesEta   = 0;
@@ -332,6 +362,7 @@ void ParticleSingleHistos::fill(vector<ParticleDigit*> & particles, double weigh
       nSinglesEta++;
       h_n1_phiEta->AddBinContent(iG,weight);
       if (fillP2) h_spt_phiEta->AddBinContent(iG,weight*pt);
+      if (fill3D) h_n1_etaPhiPt->AddBinContent(h_n1_etaPhiPt->GetBin(iEta,iPhi,iPt),weight);
       }
 
     if (fillY)
@@ -352,14 +383,14 @@ void ParticleSingleHistos::fill(vector<ParticleDigit*> & particles, double weigh
     {
     h_n1_phiEta->SetEntries(h_n1_phiEta->GetEntries()+nSinglesEta);
     if (fillP2) h_spt_phiEta->SetEntries(h_spt_phiEta->GetEntries()+nSinglesEta);
+    if (fill3D) h_n1_etaPhiPt->SetEntries(h_n1_etaPhiPt->GetEntries()+nSinglesEta);
     }
   if (fillY)
     {
     h_n1_phiY->SetEntries(h_n1_phiY->GetEntries()+nSinglesY);
     if (fillP2) h_spt_phiY->SetEntries(h_spt_phiY->GetEntries()+nSinglesY);
     }
-  h_n1->Fill(nSingles, weight);
-  h_n1_eTotal->Fill(totalEnergy, weight);
+  return totalEnergy;
 }
 
 //!
@@ -367,12 +398,10 @@ void ParticleSingleHistos::fill(vector<ParticleDigit*> & particles, double weigh
 //!
 void ParticleSingleHistos::fill(Particle & particle, double weight)
 {
-  LorentzVector & momentum = particle.getMomentum();
-  float pt   = momentum.Pt();
-  float eta  = momentum.Eta();
-  float phi  = momentum.Phi();
-  float rapidity = momentum.Rapidity();
-  if (phi<0) phi += TMath::TwoPi();
+  float pt   = particle.getPt();
+  float eta  = particle.getEta();
+  float phi  = particle.getPhi();
+  float rapidity = particle.getY();
 
   if (useEffCorrection)
     {
@@ -414,6 +443,7 @@ void ParticleSingleHistos::fill(Particle & particle, double weight)
     {
     h_n1_phiEta->Fill(eta,phi,weight);
     if (fillP2) h_spt_phiEta->Fill(eta,phi,weight*pt);
+    if (fill3D) h_n1_etaPhiPt->Fill(eta,phi,pt,weight);
     }
   if (fillY)
     {
@@ -30,9 +30,20 @@ public:
   virtual void createHistograms();
   virtual void importHistograms(TFile & inputFile);
   virtual void loadCalibration(TFile & inputFile);
-  virtual void fill(vector<ParticleDigit*> & particles, double weight);
+  virtual void fill(const vector<ParticleDigit*> & particles, double weight);
+
+  //!
+  //! Fill the kinematic histograms with the given digits, and the multiplicity and total energy histograms with the given accepted
+  //! particles, which include the particles out of bounds of the binning (not digitized).
+  //!
+  virtual void fill(const vector<ParticleDigit*> & particles, const vector<Particle*> & accepted, double weight);
   virtual void fill(Particle & particle, double weight);
   virtual void fillMultiplicity(double nAccepted, double totalEnergy, double weight);
+
+  //!
+  //! Fill the kinematic histograms with the given digits and return their total energy.
+  //!
+  double fillDigits(const vector<ParticleDigit*> & particles, double weight);
   
   inline int getPtBinFor(float v) const
   {
@@ -70,6 +81,7 @@ public:
   bool fillEta;
   bool fillY;
   bool fillP2;
+  bool fill3D;
   bool useEffCorrection;
   int  efficiencyOpt;
 
@@ -106,6 +118,7 @@ public:
 
   TH2 * h_n1_phiEta;
   TH2 * h_spt_phiEta;
+  TH3 * h_n1_etaPhiPt; // (eta,phi,pt) density used by the Q3D pair normalization
 
   TH2 * h_n1_phiY;
   TH2 * h_spt_phiY;
@@ -19,6 +19,7 @@ Event::Event()
  :
 eventIndex(0),
 eventNumber(0),
+stamp(++stampCounter),
 particles(),
 eventProperties(new EventProperties() ),
 //b(-9999.0),
@@ -51,6 +52,7 @@ void Event::clear()
 {
   eventIndex      = 0;
   eventNumber     = 0;
+  stamp           = ++stampCounter;
   //b               = -99999;
   particles.clear();
   if (nucleusA) nucleusA->clear();
@@ -68,6 +70,7 @@ void Event::reset()
 {
   eventIndex++;
   eventNumber   = 0;
+  stamp         = ++stampCounter;
   //b             = -99999;
   particles.clear();
   if (nucleusA) nucleusA->reset();
@@ -84,6 +87,7 @@ void Event::reset()
 void Event::add(Particle * particle)
 {
   particles.push_back(particle);
+  stamp = ++stampCounter;
 }
 
 
@@ -193,6 +197,7 @@ void Event::printProperties(ostream & output)
  }
 
 vector<Event*> Event::eventStreamsStore;
+unsigned long Event::stampCounter = 0;
 
 Event * Event::getEventStream(unsigned int index)
 {
@@ -166,12 +166,22 @@ protected:
    return streamIndex;
   }
 
+  //!
+  //! Return the modification stamp of this event. The stamp is unique across all events and changes whenever the event is
+  //! reset, cleared, or a particle is added to it. It is used to detect whether data derived from the event are up to date.
+  //!
+  unsigned long getStamp() const
+  {
+   return stamp;
+  }
+
 
 protected:
 
   unsigned int  streamIndex;
   unsigned long eventIndex;
   unsigned long eventNumber;
+  unsigned long stamp;
   vector<Particle*> particles;
   EventProperties * eventProperties;
   //double b;
@@ -181,6 +191,7 @@ protected:
   //CollisionGeometryMoments * participantMoments;
 
   static vector<Event*> eventStreamsStore;
+  static unsigned long stampCounter;
 
   ClassDef(Event,0)
 
@@ -0,0 +1,236 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "EventAnalysisContext.hpp"
+using CAP::ParticleBinning;
+using CAP::EventAnalysisContext;
+
+ClassImp(ParticleBinning);
+
+ClassImp(EventAnalysisContext);
+
+ParticleBinning::ParticleBinning()
+:
+nBins_pt(0),  min_pt(0.0),  max_pt(0.0),  scale_pt(0.0),
+nBins_phi(0), min_phi(0.0), max_phi(0.0), scale_phi(0.0),
+nBins_eta(0), min_eta(0.0), max_eta(0.0), scale_eta(0.0),
+nBins_y(0),   min_y(0.0),   max_y(0.0),   scale_y(0.0),
+useEta(false),
+useY(false)
+{ }
+
+ParticleBinning::ParticleBinning(int _nBins_pt,  double _min_pt,  double _max_pt,
+                                 int _nBins_phi, double _min_phi, double _max_phi,
+                                 int _nBins_eta, double _min_eta, double _max_eta,
+                                 int _nBins_y,   double _min_y,   double _max_y,
+                                 bool _useEta, bool _useY)
+:
+nBins_pt(_nBins_pt),   min_pt(_min_pt),   max_pt(_max_pt),   scale_pt(double(_nBins_pt)/(_max_pt-_min_pt)),
+nBins_phi(_nBins_phi), min_phi(_min_phi), max_phi(_max_phi), scale_phi(double(_nBins_phi)/(_max_phi-_min_phi)),
+nBins_eta(_nBins_eta), min_eta(_min_eta), max_eta(_max_eta), scale_eta(double(_nBins_eta)/(_max_eta-_min_eta)),
+nBins_y(_nBins_y),     min_y(_min_y),     max_y(_max_y),     scale_y(double(_nBins_y)/(_max_y-_min_y)),
+useEta(_useEta),
+useY(_useY)
+{ }
+
+bool ParticleBinning::operator==(const ParticleBinning & other) const
+{
+  return nBins_pt==other.nBins_pt   && min_pt==other.min_pt   && max_pt==other.max_pt &&
+         nBins_phi==other.nBins_phi && min_phi==other.min_phi && max_phi==other.max_phi &&
+         nBins_eta==other.nBins_eta && min_eta==other.min_eta && max_eta==other.max_eta &&
+         nBins_y==other.nBins_y     && min_y==other.min_y     && max_y==other.max_y &&
+         useEta==other.useEta       && useY==other.useY;
+}
+
+bool ParticleBinning::digitize(const Particle & particle, ParticleDigit & digit) const
+{
+  double pt  = particle.getPt();
+  double phi = particle.getPhi();
+  int iPt  = getPtBinFor(pt);
+  if (iPt==0) return false;
+  int iPhi = getPhiBinFor(phi);
+  if (iPhi==0) return false;
+  double eta = particle.getEta();
+  double y   = particle.getY();
+  int iEta = useEta ? getEtaBinFor(eta) : 0;
+  int iY   = useY   ? getYBinFor(y)     : 0;
+  if (iEta==0 && iY==0) return false;
+  digit.iPt  = iPt;
+  digit.iPhi = iPhi;
+  digit.iEta = iEta;
+  digit.iY   = iY;
+  digit.pt   = pt;
+  digit.phi  = phi;
+  digit.eta  = eta;
+  digit.y    = y;
+  digit.e    = particle.getE();
+  return true;
+}
+
+vector<EventAnalysisContext*> EventAnalysisContext::contexts;
+
+EventAnalysisContext::EventAnalysisContext()
+:
+event(nullptr),
+stamp(0),
+nEventsAccepted(0),
+eventFilters(),
+eventFilterClassifierSlots(),
+classifiers(),
+classIndices(),
+particleFilters(),
+binnings(),
+eventAccepted(),
+acceptedParticles(),
+digits(),
+particleAccepted(),
+scratchDigit(),
+digitFactory()
+{
+  digitFactory.initialize(1000);
+}
+
+EventAnalysisContext::~EventAnalysisContext()
+{ }
+
+void EventAnalysisContext::clear()
+{
+  event = nullptr;
+  stamp = 0;
+  nEventsAccepted = 0;
+  eventFilters.clear();
+  eventFilterClassifierSlots.clear();
+  classifiers.clear();
+  classIndices.clear();
+  particleFilters.clear();
+  binnings.clear();
+  eventAccepted.clear();
+  acceptedParticles.clear();
+  digits.clear();
+  digitFactory.reset();
+}
+
+int EventAnalysisContext::addEventFilter(EventFilter * filter)
+{
+  for (unsigned int k=0; k<eventFilters.size(); k++) if (eventFilters[k]==filter) return k;
+  eventFilters.push_back(filter);
+  eventAccepted.push_back(false);
+  int classifierSlot = -1;
+  EventClassifier * classifier = filter->getClassifier();
+  if (classifier)
+    {
+    for (unsigned int k=0; k<classifiers.size(); k++) if (classifiers[k]==classifier) classifierSlot = k;
+    if (classifierSlot<0)
+      {
+      classifiers.push_back(classifier);
+      classIndices.push_back(-1);
+      classifierSlot = classifiers.size()-1;
+      }
+    }
+  eventFilterClassifierSlots.push_back(classifierSlot);
+  stamp = 0;
+  return eventFilters.size()-1;
+}
+
+int EventAnalysisContext::addParticleFilter(ParticleFilter * filter)
+{
+  for (unsigned int k=0; k<particleFilters.size(); k++) if (particleFilters[k]==filter) return k;
+  particleFilters.push_back(filter);
+  acceptedParticles.push_back(vector<Particle*>());
+  for (unsigned int iBinning=0; iBinning<binnings.size(); iBinning++) digits[iBinning].push_back(vector<ParticleDigit*>());
+  stamp = 0;
+  return particleFilters.size()-1;
+}
+
+int EventAnalysisContext::addBinning(const ParticleBinning & binning)
+{
+  for (unsigned int k=0; k<binnings.size(); k++) if (binnings[k]==binning) return k;
+  binnings.push_back(binning);
+  digits.push_back(vector< vector<ParticleDigit*> >(particleFilters.size()));
+  stamp = 0;
+  return binnings.size()-1;
+}
+
+void EventAnalysisContext::update(Event & _event)
+{
+  if (&_event==event && _event.getStamp()==stamp) return;
+  event = &_event;
+  stamp = _event.getStamp();
+
+  unsigned int nEventFilters    = eventFilters.size();
+  unsigned int nParticleFilters = particleFilters.size();
+  unsigned int nBinnings        = binnings.size();
+  nEventsAccepted = 0;
+  // one lookup per classifier; the filters of event classes then only compare class indices.
+  EventProperties * properties = _event.getEventProperties();
+  for (unsigned int iClassifier=0; iClassifier<classifiers.size(); iClassifier++)
+    classIndices[iClassifier] = properties ? classifiers[iClassifier]->getClassIndex(*properties) : -1;
+  for (unsigned int iEventFilter=0; iEventFilter<nEventFilters; iEventFilter++)
+    {
+    EventFilter * filter = eventFilters[iEventFilter];
+    int classifierSlot = eventFilterClassifierSlots[iEventFilter];
+    bool accepted;
+    if (classifierSlot>=0 && filter->getNConditions()==0)
+      accepted = classIndices[classifierSlot]==filter->getClassIndex();
+    else
+      accepted = filter->accept(_event);
+    eventAccepted[iEventFilter] = accepted;
+    if (accepted) nEventsAccepted++;
+    }
+  for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++)
+    {
+    acceptedParticles[iParticleFilter].clear();
+    for (unsigned int iBinning=0; iBinning<nBinnings; iBinning++) digits[iBinning][iParticleFilter].clear();
+    }
+  digitFactory.reset();
+  if (nEventsAccepted==0) return;
+
+  particleAccepted.resize(nParticleFilters);
+  vector<Particle*> & particles = _event.getParticles();
+  unsigned int nParticles = particles.size();
+  for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
+    {
+    Particle * particle = particles[iParticle];
+    bool accepted = false;
+    for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++)
+      {
+      particleAccepted[iParticleFilter] = particleFilters[iParticleFilter]->accept(*particle);
+      if (!particleAccepted[iParticleFilter]) continue;
+      acceptedParticles[iParticleFilter].push_back(particle);
+      accepted = true;
+      }
+    if (!accepted) continue;
+    for (unsigned int iBinning=0; iBinning<nBinnings; iBinning++)
+      {
+      if (!binnings[iBinning].digitize(*particle,scratchDigit)) continue;
+      ParticleDigit * digit = digitFactory.getNextObject();
+      *digit = scratchDigit;
+      for (unsigned int iParticleFilter=0; iParticleFilter<nParticleFilters; iParticleFilter++)
+        {
+        if (particleAccepted[iParticleFilter]) digits[iBinning][iParticleFilter].push_back(digit);
+        }
+      }
+    }
+}
+
+EventAnalysisContext * EventAnalysisContext::getContext(const Event & event)
+{
+  unsigned int index = event.getStreamIndex();
+  if (index>=contexts.size()) contexts.resize(index+1,nullptr);
+  if (!contexts[index]) contexts[index] = new EventAnalysisContext();
+  return contexts[index];
+}
+
+void EventAnalysisContext::clearContexts()
+{
+  for (unsigned int k=0; k<contexts.size(); k++) delete contexts[k];
+  contexts.clear();
+}
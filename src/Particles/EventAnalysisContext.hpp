@@ -0,0 +1,212 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventAnalysisContext
+#define CAP__EventAnalysisContext
+#include <vector>
+#include "Factory.hpp"
+#include "Event.hpp"
+#include "EventFilter.hpp"
+#include "ParticleFilter.hpp"
+#include "ParticleDigit.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Binning of the single particle kinematic variables (pt, phi, eta, y) used to digitize particles. Bin indices run from 1 to nBins;
+//! the index 0 indicates a value out of bounds. The eta (y) index is computed only if useEta (useY) is true.
+//!
+class ParticleBinning
+{
+public:
+
+  ParticleBinning();
+
+  ParticleBinning(int _nBins_pt,  double _min_pt,  double _max_pt,
+                  int _nBins_phi, double _min_phi, double _max_phi,
+                  int _nBins_eta, double _min_eta, double _max_eta,
+                  int _nBins_y,   double _min_y,   double _max_y,
+                  bool _useEta, bool _useY);
+
+  virtual ~ParticleBinning() {}
+
+  bool operator==(const ParticleBinning & other) const;
+
+  inline int getPtBinFor(double v) const
+  {
+  if (v<min_pt || v>=max_pt) return 0;
+  return 1+int(scale_pt*(v-min_pt));
+  }
+
+  inline int getPhiBinFor(double v) const
+  {
+  if (v<min_phi || v>=max_phi) return 0;
+  return 1+int(scale_phi*(v-min_phi));
+  }
+
+  inline int getEtaBinFor(double v) const
+  {
+  if (v<min_eta || v>=max_eta) return 0;
+  return 1+int(scale_eta*(v-min_eta));
+  }
+
+  inline int getYBinFor(double v) const
+  {
+  if (v<min_y || v>=max_y) return 0;
+  return 1+int(scale_y*(v-min_y));
+  }
+
+  //!
+  //! Digitize the given particle into the given digit. Returns false if the particle is out of bounds, i.e., if its pt or phi is out
+  //! of bounds or if both its eta and y are out of bounds (or not used).
+  //!
+  bool digitize(const Particle & particle, ParticleDigit & digit) const;
+
+  int    nBins_pt;
+  double min_pt;
+  double max_pt;
+  double scale_pt;
+  int    nBins_phi;
+  double min_phi;
+  double max_phi;
+  double scale_phi;
+  int    nBins_eta;
+  double min_eta;
+  double max_eta;
+  double scale_eta;
+  int    nBins_y;
+  double min_y;
+  double max_y;
+  double scale_y;
+  bool   useEta;
+  bool   useY;
+
+  ClassDef(ParticleBinning,0)
+};
+
+//!
+//! Per-event analysis context shared by all the analyzers working on the same event stream. Analyzers register the event filters,
+//! particle filters, and particle binnings they use (filters and binnings are shared by pointer or by value so each is evaluated once).
+//! The first analyzer that requests the context for a new event triggers a single pass over the event which evaluates all the registered
+//! event filters, builds the lists of particles accepted by each registered particle filter, and digitizes the accepted particles
+//! once per registered binning. Event filters of event classes (see EventClassifier) sharing a classifier are evaluated with a single
+//! class lookup per event. Subsequent analyzers of the same event consume the results read-only. The context detects new events
+//! based on the Event stamp.
+//!
+class EventAnalysisContext
+{
+public:
+
+  EventAnalysisContext();
+  virtual ~EventAnalysisContext();
+
+  //!
+  //! Clear all the registered filters and binnings as well as the results of the last update.
+  //!
+  void clear();
+
+  //!
+  //! Register the given event filter and return its slot in this context.
+  //!
+  int addEventFilter(EventFilter * filter);
+
+  //!
+  //! Register the given particle filter and return its slot in this context.
+  //!
+  int addParticleFilter(ParticleFilter * filter);
+
+  //!
+  //! Register the given binning and return its slot in this context.
+  //!
+  int addBinning(const ParticleBinning & binning);
+
+  //!
+  //! Evaluate the filters and digitize the particles of the given event unless this was already done for this event.
+  //!
+  void update(Event & event);
+
+  //!
+  //! Force the filters to be evaluated anew at the next update, e.g., after the event properties used by event filters were modified.
+  //!
+  inline void invalidate()
+  {
+  stamp = 0;
+  }
+
+  inline bool isEventAccepted(int eventFilterSlot) const
+  {
+  return eventAccepted[eventFilterSlot];
+  }
+
+  //!
+  //! Return true if at least one of the registered event filters accepts the event.
+  //!
+  inline bool isEventAccepted() const
+  {
+  return nEventsAccepted>0;
+  }
+
+  //!
+  //! Particles accepted by the particle filter at the given slot (empty if no event filter accepted the event).
+  //!
+  inline const vector<Particle*> & getAcceptedParticles(int particleFilterSlot) const
+  {
+  return acceptedParticles[particleFilterSlot];
+  }
+
+  //!
+  //! Digits, in the binning at the given slot, of the particles accepted by the particle filter at the given slot. Particles
+  //! out of bounds of the binning are not included; use getAcceptedParticles() for multiplicities.
+  //!
+  inline const vector<ParticleDigit*> & getDigits(int binningSlot, int particleFilterSlot) const
+  {
+  return digits[binningSlot][particleFilterSlot];
+  }
+
+  //!
+  //! Return the context of the event stream of the given event. Contexts are created as needed.
+  //!
+  static EventAnalysisContext * getContext(const Event & event);
+
+  //!
+  //! Delete all the contexts.
+  //!
+  static void clearContexts();
+
+protected:
+
+  Event *       event;
+  unsigned long stamp;
+  int           nEventsAccepted;
+  vector<EventFilter*>    eventFilters;
+  vector<int>             eventFilterClassifierSlots;
+  vector<EventClassifier*> classifiers;
+  vector<int>             classIndices;
+  vector<ParticleFilter*> particleFilters;
+  vector<ParticleBinning> binnings;
+  vector<bool>            eventAccepted;
+  vector< vector<Particle*> > acceptedParticles;
+  vector< vector< vector<ParticleDigit*> > > digits;
+  vector<unsigned char>   particleAccepted;
+  ParticleDigit           scratchDigit;
+  Factory<ParticleDigit>  digitFactory;
+
+  static vector<EventAnalysisContext*> contexts;
+
+  ClassDef(EventAnalysisContext,0)
+};
+
+}
+
+#endif  // CAP__EventAnalysisContext
@@ -0,0 +1,415 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <cstring>
+#include <cstdio>
+#include <climits>
+#include "RZip.h"
+#include "Compression.h"
+#include "EventCache.hpp"
+using CAP::EventCacheBlock;
+using CAP::EventCache;
+
+ClassImp(EventCacheBlock);
+
+ClassImp(EventCache);
+
+// largest buffer compressed in a single call by the ROOT compression engine
+const long maxCompressedBlockSize = 0xffffff;
+
+EventCacheBlock::EventCacheBlock()
+:
+firstEvent(0),
+nEvents(0),
+nParticles(0),
+rawSize(0),
+storedSize(0),
+compressed(false),
+fileOffset(-1),
+data()
+{ }
+
+EventCache::EventCache()
+:
+memoryBudget(2048L*1024L*1024L),
+blockSize(4L*1024L*1024L),
+compressionLevel(0),
+spillFileName("EventCache.spill"),
+spillFile(),
+spillFileSize(0),
+nEvents(0),
+nParticles(0),
+memoryUsed(0),
+complete(false),
+blocks(),
+types(),
+typeIndices(),
+currentBlock(-1),
+eventFirstParticle(1,0),
+eventValues(),
+px(), py(), pz(), e(), x(), y(), z(), t(),
+typeIndex(),
+live(),
+buffer()
+{ }
+
+EventCache::~EventCache()
+{
+  clear();
+}
+
+void EventCache::configure(long _memoryBudget, long _blockSize, int _compressionLevel, const String & _spillFileName)
+{
+  memoryBudget     = _memoryBudget;
+  blockSize        = (_blockSize>1024) ? _blockSize : 1024;
+  compressionLevel = _compressionLevel;
+  spillFileName    = _spillFileName;
+}
+
+int EventCache::getTypeIndex(ParticleType * type)
+{
+  unordered_map<const ParticleType*,int>::const_iterator it = typeIndices.find(type);
+  if (it!=typeIndices.end()) return it->second;
+  int index = types.size();
+  types.push_back(type);
+  typeIndices.emplace(type,index);
+  return index;
+}
+
+void EventCache::record(Event & event)
+{
+  if (complete) return; // the sample was already closed for replay
+  const vector<Particle*> & particles = event.getParticles();
+  unsigned int n = particles.size();
+  EventProperties & ep = *event.getEventProperties();
+  double values[nEventValues] =
+    {
+    double(event.getEventNumber()),
+    double(ep.zProjectile),
+    double(ep.aProjectile),
+    double(ep.nPartProjectile),
+    double(ep.zTarget),
+    double(ep.aTarget),
+    double(ep.nPartTarget),
+    double(ep.nParticipantsTotal),
+    double(ep.nBinaryTotal),
+    ep.impactParameter,
+    ep.fractionalXSection,
+    ep.refMultiplicity,
+    ep.other,
+    double(ep.particlesCounted),
+    double(ep.particlesAccepted)
+    };
+  eventValues.insert(eventValues.end(),values,values+nEventValues);
+  for (unsigned int iParticle=0; iParticle<n; iParticle++)
+    {
+    const Particle & particle = *particles[iParticle];
+    const LorentzVector & momentum = particle.getMomentum();
+    const LorentzVector & position = particle.getPosition();
+    px.push_back(momentum.Px());
+    py.push_back(momentum.Py());
+    pz.push_back(momentum.Pz());
+    e.push_back(momentum.E());
+    x.push_back(position.X());
+    y.push_back(position.Y());
+    z.push_back(position.Z());
+    t.push_back(position.T());
+    typeIndex.push_back(getTypeIndex(&particle.getType()));
+    live.push_back(particle.isLive());
+    }
+  eventFirstParticle.push_back(eventFirstParticle.back()+n);
+  nEvents++;
+  nParticles += n;
+  long nBlockEvents    = eventFirstParticle.size()-1;
+  long nBlockParticles = eventFirstParticle.back();
+  long size = (nBlockEvents+1)*sizeof(int) + nBlockEvents*nEventValues*sizeof(double) + nBlockParticles*(8*sizeof(float)+sizeof(int)+sizeof(char));
+  if (size>=blockSize) sealBlock();
+}
+
+void EventCache::sealBlock()
+{
+  int nBlockEvents    = eventFirstParticle.size()-1;
+  int nBlockParticles = eventFirstParticle.back();
+  if (nBlockEvents<1) return;
+  EventCacheBlock block;
+  block.firstEvent = nEvents - nBlockEvents;
+  block.nEvents    = nBlockEvents;
+  block.nParticles = nBlockParticles;
+
+  // columns are written one after the other
+  long sizes[12] =
+    {
+    long((nBlockEvents+1)*sizeof(int)),
+    long(nBlockEvents*nEventValues*sizeof(double)),
+    long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)),
+    long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)),
+    long(nBlockParticles*sizeof(int)),
+    long(nBlockParticles*sizeof(char))
+    };
+  const void * columns[12] =
+    {
+    eventFirstParticle.data(), eventValues.data(),
+    px.data(), py.data(), pz.data(), e.data(),
+    x.data(), y.data(), z.data(), t.data(),
+    typeIndex.data(), live.data()
+    };
+  block.rawSize = 0;
+  for (int k=0; k<12; k++) block.rawSize += sizes[k];
+  buffer.resize(block.rawSize);
+  char * p = buffer.data();
+  for (int k=0; k<12; k++)
+    {
+    if (sizes[k]>0) memcpy(p,columns[k],sizes[k]);
+    p += sizes[k];
+    }
+
+  block.compressed = false;
+  if (compressionLevel>0 && block.rawSize<=maxCompressedBlockSize)
+    {
+    int srcSize = block.rawSize;
+    int tgtSize = block.rawSize;
+    int nOut    = 0;
+    block.data.resize(block.rawSize);
+    R__zipMultipleAlgorithm(compressionLevel, &srcSize, buffer.data(), &tgtSize, block.data.data(), &nOut, ROOT::RCompressionSetting::EAlgorithm::kLZ4);
+    // keep the block uncompressed if the compression failed or did not help
+    if (nOut>0 && nOut<block.rawSize)
+      {
+      block.data.resize(nOut);
+      block.compressed = true;
+      }
+    }
+  if (!block.compressed) block.data.assign(buffer.begin(),buffer.end());
+  block.storedSize = block.data.size();
+  memoryUsed += block.storedSize;
+  blocks.push_back(block);
+
+  eventFirstParticle.assign(1,0);
+  eventValues.clear();
+  px.clear(); py.clear(); pz.clear(); e.clear();
+  x.clear();  y.clear();  z.clear();  t.clear();
+  typeIndex.clear();
+  live.clear();
+  spillBlocks();
+}
+
+void EventCache::spillBlocks()
+{
+  for (unsigned int iBlock=0; iBlock<blocks.size() && memoryUsed>memoryBudget; iBlock++)
+    {
+    EventCacheBlock & block = blocks[iBlock];
+    if (block.fileOffset>=0) continue;
+    if (!spillFile.is_open())
+      {
+      spillFile.open(spillFileName.Data(),ios_base::in|ios_base::out|ios_base::trunc|ios_base::binary);
+      spillFileSize = 0;
+      if (!spillFile.is_open())
+        {
+        cout << "<W> EventCache::spillBlocks() Unable to open spill file " << spillFileName << ". Keeping all blocks in memory." << endl;
+        memoryBudget = LONG_MAX;
+        return;
+        }
+      // unlink the file right away: the open stream keeps it readable and the system reclaims it when the stream is closed,
+      // including when the process exits without destroying the cache
+      remove(spillFileName.Data());
+      }
+    spillFile.seekp(spillFileSize);
+    spillFile.write(block.data.data(),block.storedSize);
+    if (!spillFile)
+      {
+      cout << "<W> EventCache::spillBlocks() Unable to write spill file " << spillFileName << ". Keeping the remaining blocks in memory." << endl;
+      spillFile.clear();
+      memoryBudget = LONG_MAX;
+      return;
+      }
+    block.fileOffset = spillFileSize;
+    spillFileSize   += block.storedSize;
+    memoryUsed      -= block.storedSize;
+    vector<char>().swap(block.data);
+    }
+}
+
+void EventCache::close()
+{
+  sealBlock();
+  complete = true;
+}
+
+bool EventCache::loadBlock(unsigned int iBlock)
+{
+  if (currentBlock==int(iBlock)) return true;
+  currentBlock = -1;
+  EventCacheBlock & block = blocks[iBlock];
+  vector<char> stored;
+  const char * source = block.data.data();
+  if (block.fileOffset>=0)
+    {
+    stored.resize(block.storedSize);
+    spillFile.clear();
+    spillFile.seekg(block.fileOffset);
+    spillFile.read(stored.data(),block.storedSize);
+    if (!spillFile)
+      {
+      cout << "<E> EventCache::loadBlock() Unable to read block " << iBlock << " from spill file " << spillFileName << endl;
+      spillFile.clear();
+      return false;
+      }
+    source = stored.data();
+    }
+  if (block.compressed)
+    {
+    buffer.resize(block.rawSize);
+    int srcSize = block.storedSize;
+    int tgtSize = block.rawSize;
+    int nOut    = 0;
+    R__unzip(&srcSize, (unsigned char *) source, &tgtSize, (unsigned char *) buffer.data(), &nOut);
+    if (nOut!=block.rawSize)
+      {
+      cout << "<E> EventCache::loadBlock() Unable to decompress block " << iBlock << endl;
+      return false;
+      }
+    source = buffer.data();
+    }
+
+  int nBlockEvents    = block.nEvents;
+  int nBlockParticles = block.nParticles;
+  eventFirstParticle.resize(nBlockEvents+1);
+  eventValues.resize(nBlockEvents*nEventValues);
+  px.resize(nBlockParticles); py.resize(nBlockParticles); pz.resize(nBlockParticles); e.resize(nBlockParticles);
+  x.resize(nBlockParticles);  y.resize(nBlockParticles);  z.resize(nBlockParticles);  t.resize(nBlockParticles);
+  typeIndex.resize(nBlockParticles);
+  live.resize(nBlockParticles);
+  long sizes[12] =
+    {
+    long((nBlockEvents+1)*sizeof(int)),
+    long(nBlockEvents*nEventValues*sizeof(double)),
+    long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)),
+    long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)), long(nBlockParticles*sizeof(float)),
+    long(nBlockParticles*sizeof(int)),
+    long(nBlockParticles*sizeof(char))
+    };
+  void * columns[12] =
+    {
+    eventFirstParticle.data(), eventValues.data(),
+    px.data(), py.data(), pz.data(), e.data(),
+    x.data(), y.data(), z.data(), t.data(),
+    typeIndex.data(), live.data()
+    };
+  for (int k=0; k<12; k++)
+    {
+    if (sizes[k]>0) memcpy(columns[k],source,sizes[k]);
+    source += sizes[k];
+    }
+  currentBlock = iBlock;
+  return true;
+}
+
+bool EventCache::replay(long iEvent, Event & event, Factory<Particle> & factory)
+{
+  if (iEvent<0 || iEvent>=nEvents || !complete) return false;
+  // events are usually replayed in sequence: check the current block first, next search the blocks
+  unsigned int iBlock;
+  if (currentBlock>=0 && iEvent>=blocks[currentBlock].firstEvent && iEvent<blocks[currentBlock].firstEvent+blocks[currentBlock].nEvents)
+    iBlock = currentBlock;
+  else
+    {
+    unsigned int low  = 0;
+    unsigned int high = blocks.size();
+    while (high-low>1)
+      {
+      unsigned int middle = (low+high)/2;
+      if (blocks[middle].firstEvent<=iEvent) low = middle; else high = middle;
+      }
+    iBlock = low;
+    }
+  if (!loadBlock(iBlock)) return false;
+
+  int k = iEvent - blocks[iBlock].firstEvent;
+  event.reset();
+  factory.reset();
+  const double * values = &eventValues[k*nEventValues];
+  event.setEventNumber((unsigned long) values[0]);
+  EventProperties & ep = *event.getEventProperties();
+  ep.zProjectile        = (unsigned int) values[1];
+  ep.aProjectile        = (unsigned int) values[2];
+  ep.nPartProjectile    = (unsigned int) values[3];
+  ep.zTarget            = (unsigned int) values[4];
+  ep.aTarget            = (unsigned int) values[5];
+  ep.nPartTarget        = (unsigned int) values[6];
+  ep.nParticipantsTotal = (unsigned int) values[7];
+  ep.nBinaryTotal       = (unsigned int) values[8];
+  ep.impactParameter    = values[9];
+  ep.fractionalXSection = values[10];
+  ep.refMultiplicity    = values[11];
+  ep.other              = values[12];
+  ep.particlesCounted   = (unsigned int) values[13];
+  ep.particlesAccepted  = (unsigned int) values[14];
+  int first = eventFirstParticle[k];
+  int last  = eventFirstParticle[k+1];
+  for (int iParticle=first; iParticle<last; iParticle++)
+    {
+    Particle & particle = *factory.getNextObject();
+    particle.set(types[typeIndex[iParticle]],
+                 px[iParticle], py[iParticle], pz[iParticle], e[iParticle],
+                 x[iParticle],  y[iParticle],  z[iParticle],  t[iParticle],
+                 live[iParticle]);
+    event.add(&particle);
+    }
+  return true;
+}
+
+void EventCache::resolveTypes(ParticleDb & particleDb)
+{
+  for (unsigned int iType=0; iType<types.size(); iType++)
+    {
+    unsigned int index = particleDb.findIndexForPdgCode(types[iType]->getPdgCode());
+    if (index>=particleDb.size()) continue;
+    typeIndices.erase(types[iType]);
+    types[iType] = particleDb.getParticleType(index);
+    typeIndices.emplace(types[iType],iType);
+    }
+}
+
+long EventCache::getNBlocksSpilled() const
+{
+  long n = 0;
+  for (unsigned int iBlock=0; iBlock<blocks.size(); iBlock++)
+    if (blocks[iBlock].fileOffset>=0) n++;
+  return n;
+}
+
+void EventCache::clear()
+{
+  blocks.clear();
+  types.clear();
+  typeIndices.clear();
+  eventFirstParticle.assign(1,0);
+  eventValues.clear();
+  px.clear(); py.clear(); pz.clear(); e.clear();
+  x.clear();  y.clear();  z.clear();  t.clear();
+  typeIndex.clear();
+  live.clear();
+  vector<char>().swap(buffer);
+  nEvents      = 0;
+  nParticles   = 0;
+  memoryUsed   = 0;
+  complete     = false;
+  currentBlock = -1;
+  if (spillFile.is_open()) spillFile.close();
+  spillFileSize = 0;
+}
+
+EventCache * EventCache::eventCache = nullptr;
+
+EventCache * EventCache::getEventCache()
+{
+  if (!eventCache) eventCache = new EventCache();
+  return eventCache;
+}
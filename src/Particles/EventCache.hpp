@@ -0,0 +1,165 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventCache
+#define CAP__EventCache
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+#include "Factory.hpp"
+#include "Event.hpp"
+#include "Particle.hpp"
+#include "ParticleDb.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Block of consecutive events of an EventCache, stored as a single buffer, possibly compressed, held in memory or spilled to disk.
+//!
+class EventCacheBlock
+{
+public:
+
+  EventCacheBlock();
+  virtual ~EventCacheBlock() {}
+
+  long         firstEvent;   //!< index of the first event of this block
+  int          nEvents;      //!< number of events of this block
+  int          nParticles;   //!< number of particles of this block
+  long         rawSize;      //!< size of the uncompressed block in bytes
+  long         storedSize;   //!< size of the stored block in bytes
+  bool         compressed;   //!< whether the stored block is compressed
+  long         fileOffset;   //!< offset of the stored block in the spill file, -1 if held in memory
+  vector<char> data;         //!< stored block, empty if spilled
+
+  ClassDef(EventCacheBlock,0)
+};
+
+//!
+//! Compact in-memory store of a sample of events, used to replay the same sample several times (e.g., once per analysis configuration)
+//! without re-generating or re-reading it. Events are recorded in blocks of about blockSize bytes. Within a block, the particles are
+//! stored as columns (structure of arrays) of floats: px, py, pz, e, x, y, z, t, plus an index in the table of particle types of the cache
+//! and the live flag; the event number and the scalar event properties are stored per event. Complete blocks are optionally compressed
+//! (LZ4). Once the blocks held in memory exceed the memory budget, the oldest ones are spilled to a local file and read back on replay.
+//! Replay decodes one block at a time and fills the event with particles obtained from a particle factory.
+//!
+//! Only the particle type, momentum, position and live flag of particles are kept: parent/child links and the nuclei of the event are not
+//! cached. Momenta and positions are stored in single precision.
+//!
+class EventCache
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  EventCache();
+
+  //!
+  //! DTOR: closes the spill file, if any. The spill file is unlinked as soon as it is created and never outlives the process.
+  //!
+  virtual ~EventCache();
+
+  //!
+  //! Set the storage parameters of the cache. Must be called before the first event is recorded.
+  //!
+  //! @param _memoryBudget maximum size in bytes of the blocks held in memory
+  //! @param _blockSize target size in bytes of the uncompressed blocks
+  //! @param _compressionLevel compression level of the blocks (0: no compression)
+  //! @param _spillFileName file where blocks exceeding the memory budget are written
+  //!
+  void configure(long _memoryBudget, long _blockSize, int _compressionLevel, const String & _spillFileName);
+
+  //!
+  //! Append the given event to the cache.
+  //!
+  void record(Event & event);
+
+  //!
+  //! Seal the last block and declare the cache complete, i.e., ready for replay.
+  //!
+  void close();
+
+  //!
+  //! Fill the given event with the cached event at index iEvent, using particles obtained from the given factory. Returns false if the
+  //! index is out of range or if the block cannot be read back.
+  //!
+  bool replay(long iEvent, Event & event, Factory<Particle> & factory);
+
+  //!
+  //! Replace the cached particle types by the types with the same PDG code in the given data base, if any. Used when the data base is
+  //! reloaded between the recording and the replay.
+  //!
+  void resolveTypes(ParticleDb & particleDb);
+
+  //!
+  //! Remove all the events and close the spill file.
+  //!
+  void clear();
+
+  inline long getNEvents() const     { return nEvents;    }
+  inline long getNParticles() const  { return nParticles; }
+  inline long getMemoryUsed() const  { return memoryUsed; }
+  inline long getNBlocks() const     { return blocks.size(); }
+  inline bool isComplete() const     { return complete;   }
+  long getNBlocksSpilled() const;
+
+  //!
+  //! Cache shared by all the tasks of the process.
+  //!
+  static EventCache * getEventCache();
+
+  static const int nEventValues = 15; //!< number of values stored per event
+
+protected:
+
+  int  getTypeIndex(ParticleType * type);
+  void sealBlock();
+  void spillBlocks();
+  bool loadBlock(unsigned int iBlock);
+
+  long   memoryBudget;
+  long   blockSize;
+  int    compressionLevel;
+  String spillFileName;
+  fstream spillFile;             //!
+  long   spillFileSize;
+
+  long   nEvents;
+  long   nParticles;
+  long   memoryUsed;             //!< bytes held by the stored blocks in memory
+  bool   complete;
+  vector<EventCacheBlock> blocks;
+
+  // particle types referenced by the cache
+  vector<ParticleType*> types;
+  unordered_map<const ParticleType*,int> typeIndices;
+
+  // columns of the block being recorded, or of the block decoded for replay
+  int            currentBlock;   //!< index of the decoded block, -1 if none
+  vector<int>    eventFirstParticle;
+  vector<double> eventValues;
+  vector<float>  px, py, pz, e, x, y, z, t;
+  vector<int>    typeIndex;
+  vector<char>   live;
+  vector<char>   buffer;         //!< raw block buffer
+
+  static EventCache * eventCache;
+
+  ClassDef(EventCache,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventCache */
@@ -0,0 +1,124 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "TSystem.h"
+#include "EventCacheTask.hpp"
+using CAP::EventCacheTask;
+
+ClassImp(EventCacheTask);
+
+EventCacheTask::EventCacheTask(const String & _name,
+                               const Configuration & _configuration,
+                               vector<EventFilter*> & _eventFilters,
+                               vector<ParticleFilter*> & _particleFilters)
+:
+EventTask(_name, _configuration, _eventFilters, _particleFilters),
+cache(nullptr),
+replaying(false),
+iReplay(0),
+memoryBudget(2048),
+blockSize(4),
+compressionLevel(0),
+spillPath("/tmp")
+{
+  appendClassName("EventCacheTask");
+}
+
+void EventCacheTask::setDefaultConfiguration()
+{
+  EventTask::setDefaultConfiguration();
+  addParameter("EventsUseStream0", true);
+  addParameter("MemoryBudget",     memoryBudget);
+  addParameter("BlockSize",        blockSize);
+  addParameter("Compression",      compressionLevel);
+  addParameter("SpillPath",        spillPath);
+}
+
+void EventCacheTask::configure()
+{
+  EventTask::configure();
+  memoryBudget     = getValueLong("MemoryBudget");
+  blockSize        = getValueLong("BlockSize");
+  compressionLevel = getValueInt("Compression");
+  spillPath        = getValueString("SpillPath");
+  if (reportInfo(__FUNCTION__))
+    {
+    cout << endl;
+    printItem("MemoryBudget", memoryBudget);
+    printItem("BlockSize",    blockSize);
+    printItem("Compression",  compressionLevel);
+    printItem("SpillPath",    spillPath);
+    }
+}
+
+void EventCacheTask::initialize()
+{
+  EventTask::initialize();
+  cache     = EventCache::getEventCache();
+  replaying = cache->isComplete();
+  iReplay   = 0;
+  if (replaying)
+    {
+    if (particleDb) cache->resolveTypes(*particleDb);
+    if (reportInfo(__FUNCTION__)) cout << "Replaying " << cache->getNEvents() << " cached events." << endl;
+    }
+  else
+    {
+    String spillFileName = spillPath;
+    if (spillFileName.Length()>0 && !spillFileName.EndsWith("/")) spillFileName += "/";
+    spillFileName += "EventCache_";
+    spillFileName += gSystem->GetPid();
+    spillFileName += ".spill";
+    cache->clear();
+    cache->configure(memoryBudget*1024L*1024L, blockSize*1024L*1024L, compressionLevel, spillFileName);
+    if (reportInfo(__FUNCTION__)) cout << "Recording events in the event cache." << endl;
+    }
+}
+
+void EventCacheTask::execute()
+{
+  incrementTaskExecuted();
+  Event & event = *eventStreams[0];
+  if (!replaying)
+    {
+    cache->record(event);
+    return;
+    }
+  if (!cache->replay(iReplay,event,*particleFactory))
+    {
+    if (iReplay<cache->getNEvents() && reportError(__FUNCTION__)) cout << "Unable to replay cached event " << iReplay << endl;
+    event.reset();
+    postTaskEod();
+    return;
+    }
+  iReplay++;
+  incrementNEventsAccepted(0);
+  // signal the end of data with the last cached event so no empty event is analyzed
+  if (iReplay>=cache->getNEvents()) postTaskEod();
+}
+
+void EventCacheTask::finalize()
+{
+  if (!replaying && cache)
+    {
+    cache->close();
+    if (reportInfo(__FUNCTION__))
+      {
+      cout << endl;
+      printItem("Events cached",    cache->getNEvents());
+      printItem("Particles cached", cache->getNParticles());
+      printItem("Blocks",           cache->getNBlocks());
+      printItem("Blocks spilled",   cache->getNBlocksSpilled());
+      printItem("Memory used (MB)", double(cache->getMemoryUsed())/(1024.0*1024.0));
+      }
+    }
+  EventTask::finalize();
+}
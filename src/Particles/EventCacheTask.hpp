@@ -0,0 +1,98 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventCacheTask
+#define CAP__EventCacheTask
+#include "EventTask.hpp"
+#include "EventCache.hpp"
+
+namespace CAP
+{
+
+//!
+//! Task recording the events of stream 0 into the process-wide EventCache, or replaying them from it. If the cache does not hold a
+//! complete sample when this task is initialized, the task records: it must then be placed after the event generators or readers, and
+//! the sample is closed when the task is finalized. Otherwise the task replays: it replaces the generators or readers, fills stream 0
+//! with the cached events in sequence, and signals the end of data once all the cached events have been replayed. A sample generated
+//! once can thus be analyzed repeatedly, e.g., with different filters or binnings, within the same process.
+//!
+//! Configuration parameters (default values in brackets):
+//!
+//! - MemoryBudget [2048]: size in MB of the blocks kept in memory; further blocks are spilled to disk
+//! - BlockSize [4]: size in MB of the uncompressed blocks
+//! - Compression [0]: LZ4 compression level of the blocks (0: no compression)
+//! - SpillPath ["/tmp"]: folder of the spill file
+//!
+class EventCacheTask : public EventTask
+{
+public:
+
+  //!
+  //! Detailed CTOR
+  //!
+  //! @param _name Name given to task instance
+  //! @param _configuration Configuration used to run this task
+  //! @param _eventFilters Array of event filters to be used by this task
+  //! @param _particleFilters Array of particle filters to be used by this task
+  //!
+  EventCacheTask(const String & _name,
+                 const Configuration & _configuration,
+                 vector<EventFilter*> & _eventFilters,
+                 vector<ParticleFilter*> & _particleFilters);
+
+  //!
+  //! DTOR
+  //!
+  virtual ~EventCacheTask() {}
+
+  //!
+  //! Sets the default  values of the configuration parameters used by this task
+  //!
+  virtual void setDefaultConfiguration();
+
+  virtual void configure();
+
+  //!
+  //! Initialize this task: select the record or replay mode based on the state of the cache.
+  //!
+  virtual void initialize();
+
+  //!
+  //! Record or replay one event.
+  //!
+  virtual void execute();
+
+  //!
+  //! Close the recorded sample.
+  //!
+  virtual void finalize();
+
+  //!
+  //! Return true if this task replays events from the cache.
+  //!
+  inline bool isReplaying() const { return replaying; }
+
+protected:
+
+  EventCache * cache;
+  bool   replaying;
+  long   iReplay;
+  long   memoryBudget;
+  long   blockSize;
+  int    compressionLevel;
+  String spillPath;
+
+  ClassDef(EventCacheTask,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventCacheTask */
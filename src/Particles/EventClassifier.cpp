@@ -0,0 +1,39 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <algorithm>
+#include "EventClassifier.hpp"
+using CAP::EventClassifier;
+
+ClassImp(EventClassifier);
+
+EventClassifier::EventClassifier(int _observable, const vector<double> & _boundaries)
+:
+observable(_observable),
+boundaries(_boundaries)
+{ }
+
+int EventClassifier::getClassIndex(double value) const
+{
+  if (boundaries.size()<2 || value<boundaries.front() || value>=boundaries.back()) return -1;
+  return int(upper_bound(boundaries.begin(),boundaries.end(),value) - boundaries.begin()) - 1;
+}
+
+const char * EventClassifier::getObservableName() const
+{
+  switch (observable)
+    {
+      case ImpactParameter:    return "b";
+      case FractionalXSection: return "xSect";
+      case RefMultiplicity:    return "mult";
+      default:                 return "other";
+    }
+}
@@ -0,0 +1,106 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__EventClassifier
+#define CAP__EventClassifier
+#include <vector>
+#include "TObject.h"
+#include "Aliases.hpp"
+#include "EventProperties.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Event-class axis: maps the value of a selected event property (impact parameter, fractional cross section, reference
+//! multiplicity, or other) onto a class index using a table of class boundaries. Class k covers [boundaries[k],boundaries[k+1]).
+//! The class of an event is obtained with a single binary search of the boundary table so the cost of classifying events does not
+//! depend (noticeably) on the number of classes. Event filters created with EventFilter::createEventClassFilters() share a classifier
+//! and each accepts one class; EventAnalysisContext evaluates the classifier once per event for all such filters.
+//!
+class EventClassifier
+{
+public:
+
+  enum Observable { ImpactParameter=0, FractionalXSection, RefMultiplicity, Other };
+
+  //!
+  //! CTOR: the boundaries must be in increasing order; n boundaries define n-1 classes.
+  //!
+  EventClassifier(int _observable, const vector<double> & _boundaries);
+
+  //!
+  //! DTOR
+  //!
+  virtual ~EventClassifier() {}
+
+  //!
+  //! Value of the observable used by this classifier for the given event properties.
+  //!
+  inline double getValue(const EventProperties & properties) const
+  {
+  switch (observable)
+    {
+      case ImpactParameter:    return properties.impactParameter;
+      case FractionalXSection: return properties.fractionalXSection;
+      case RefMultiplicity:    return properties.refMultiplicity;
+      default:                 return properties.other;
+    }
+  }
+
+  //!
+  //! Class index of the given value, or -1 if the value is outside the range of the boundaries.
+  //!
+  int getClassIndex(double value) const;
+
+  inline int getClassIndex(const EventProperties & properties) const
+  {
+  return getClassIndex(getValue(properties));
+  }
+
+  inline int getNClasses() const
+  {
+  return boundaries.size()>1 ? boundaries.size()-1 : 0;
+  }
+
+  inline int getObservable() const
+  {
+  return observable;
+  }
+
+  inline double getLowerBound(int classIndex) const
+  {
+  return boundaries[classIndex];
+  }
+
+  inline double getUpperBound(int classIndex) const
+  {
+  return boundaries[classIndex+1];
+  }
+
+  //!
+  //! Short name of the observable used in the names of the event filters (e.g., "b" for the impact parameter).
+  //!
+  const char * getObservableName() const;
+
+protected:
+
+  int            observable;
+  vector<double> boundaries;
+
+  ClassDef(EventClassifier,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__EventClassifier */
@@ -23,7 +23,9 @@ ClassImp(EventFilter);
 //!
 EventFilter::EventFilter()
 :
-Filter<Event>()
+Filter<Event>(),
+classifier(nullptr),
+classIndex(-1)
 {
   // no ops
 }
@@ -43,7 +45,7 @@ EventFilter::~EventFilter()
 bool EventFilter::accept(const Event & event)
 {
   unsigned int nComponents = getNConditions();
-  if (nComponents<1) return true;
+  if (nComponents<1 && !classifier) return true;
   EventProperties * eventProperties = event.getEventProperties();
   if (!eventProperties)
     {
@@ -108,9 +110,16 @@ bool EventFilter::accept(const Event & event)
       }
     if (!condition.accept(value))  return false;
     }
+  if (classifier) return classifier->getClassIndex(*eventProperties)==classIndex;
   return true;
 }
 
+void EventFilter::setEventClass(EventClassifier * _classifier, int _classIndex)
+{
+  classifier = _classifier;
+  classIndex = _classIndex;
+}
+
 
 vector<EventFilter*> EventFilter::createOpenEventFilter()
 {
@@ -161,8 +170,8 @@ vector<EventFilter*> EventFilter::createImpactParameterFilters(vector<double> &
     filter->setTitle(title);
     filter->setLongTitle(title);
     filter->addCondition(0, 0, low, high); // meant to cut on b
+    filters.push_back(filter);
     }
-  filters.push_back(filter);
   return filters;
 }
 
@@ -189,8 +198,8 @@ vector<EventFilter*> EventFilter::createV0MultiplicityFilters(vector<double> & b
     filter->setTitle(title);
     filter->setLongTitle(title);
     filter->addCondition(1, 0, low, high); // meant to cut on V0M
+    filters.push_back(filter);
     }
-  filters.push_back(filter);
   return filters;
 }
 
@@ -218,7 +227,36 @@ vector<EventFilter*> EventFilter::createTpcMultiplicityFilters(vector<double> &
     filter->setTitle(title);
     filter->setLongTitle(title);
     filter->addCondition(1, 1, low, high); // meant to cut on V0M
+    filters.push_back(filter);
+    }
+  return filters;
+}
+
+vector<EventFilter*> EventFilter::createEventClassFilters(int observable, vector<double> & bounds)
+{
+  vector<EventFilter*> filters;
+  EventClassifier * classifier = new EventClassifier(observable,bounds);
+  for (int k=0; k<classifier->getNClasses(); k++)
+    {
+    double low  = classifier->getLowerBound(k);
+    double high = classifier->getUpperBound(k);
+    String name = classifier->getObservableName();
+    name += int(1000*low);
+    name +="To";
+    name += int(1000*high);
+    String title;
+    title += low;
+    title += "#LT ";
+    title += classifier->getObservableName();
+    title += " <";
+    title += high;
+    EventFilter * filter = new EventFilter();
+    filter->setName(name);
+    filter->setLongName(name);
+    filter->setTitle(title);
+    filter->setLongTitle(title);
+    filter->setEventClass(classifier,k);
+    filters.push_back(filter);
     }
-  filters.push_back(filter);
   return filters;
 }
@@ -14,6 +14,7 @@
 #define CAP__EventFilter
 #include "Event.hpp"
 #include "Filter.hpp"
+#include "EventClassifier.hpp"
 
 namespace CAP
 {
@@ -26,12 +27,38 @@ public:
   virtual ~EventFilter();
   virtual bool accept(const Event & event);
 
+  //!
+  //! Make this filter accept the events of the given class of the given classifier (in addition to its conditions, if any).
+  //!
+  void setEventClass(EventClassifier * _classifier, int _classIndex);
+
+  inline EventClassifier * getClassifier() const
+  {
+  return classifier;
+  }
+
+  inline int getClassIndex() const
+  {
+  return classIndex;
+  }
+
   static vector<EventFilter*> createOpenEventFilter();
   static vector<EventFilter*> createAliceMBEventFilter();
   static vector<EventFilter*> createImpactParameterFilters(vector<double> & bounds);
   static vector<EventFilter*> createV0MultiplicityFilters(vector<double>  & bounds);
   static vector<EventFilter*> createTpcMultiplicityFilters(vector<double> & bounds);
 
+  //!
+  //! Create one filter per event class defined by the given observable (see EventClassifier::Observable) and class boundaries. The
+  //! filters share a single classifier so the class of an event is determined with one lookup for all the filters.
+  //!
+  static vector<EventFilter*> createEventClassFilters(int observable, vector<double> & bounds);
+
+protected:
+
+  EventClassifier * classifier; //!< classifier used by this filter (if any), shared by the filters of all the classes
+  int               classIndex; //!< index of the class accepted by this filter
+
   ClassDef(EventFilter,0)
 };
 
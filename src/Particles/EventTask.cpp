@@ -43,6 +43,7 @@ eventsUseStream1         (false),
 eventsUseStream2         (false),
 eventsUseStream3         (false),
 eventsAnalyze            (false),
+eventsUseAnalysisContext (false),
 calibsCreate             (false),
 calibsReset              (false),
 calibsClear              (false),
@@ -62,6 +63,9 @@ nEventFilters(0),
 nParticleFilters(0),
 eventFilters(),
 particleFilters(),
+analysisContext(nullptr),
+eventFilterSlots(),
+particleFilterSlots(),
 nEventsAccepted(),
 nEventsAcceptedTotal(),
 nParticlesAcceptedEvent(),
@@ -100,6 +104,7 @@ eventsUseStream1         (false),
 eventsUseStream2         (false),
 eventsUseStream3         (false),
 eventsAnalyze            (false),
+eventsUseAnalysisContext (false),
 calibsCreate             (false),
 calibsReset              (false),
 calibsClear              (false),
@@ -119,6 +124,9 @@ nEventFilters(0),
 nParticleFilters(0),
 eventFilters(),
 particleFilters(),
+analysisContext(nullptr),
+eventFilterSlots(),
+particleFilterSlots(),
 nEventsAccepted(),
 nEventsAcceptedTotal(),
 nParticlesAcceptedEvent(),
@@ -159,6 +167,7 @@ eventsUseStream1         (false),
 eventsUseStream2         (false),
 eventsUseStream3         (false),
 eventsAnalyze            (false),
+eventsUseAnalysisContext (false),
 calibsCreate             (false),
 calibsReset              (false),
 calibsClear              (false),
@@ -174,10 +183,13 @@ calibsExportFile         (""),
 particleDb(nullptr),
 particleFactory(nullptr),
 eventStreams(),
-nEventFilters(_particleFilters.size()),
+nEventFilters(_eventFilters.size()),
 nParticleFilters(_particleFilters.size()),
 eventFilters(_eventFilters),
 particleFilters(_particleFilters),
+analysisContext(nullptr),
+eventFilterSlots(),
+particleFilterSlots(),
 nEventsAccepted(),
 nEventsAcceptedTotal(),
 nParticlesAcceptedEvent(),
@@ -214,6 +226,7 @@ void EventTask::setDefaultConfiguration()
   addParameter("EventsUseStream2",            eventsUseStream2);
   addParameter("EventsUseStream3",            eventsUseStream3);
   addParameter("EventsAnalyze",               eventsAnalyze);
+  addParameter("EventsUseAnalysisContext",    eventsUseAnalysisContext);
 
   addParameter("CalibrationsCreate",          calibsCreate);
   addParameter("CalibrationsReset",           calibsReset);
@@ -257,6 +270,7 @@ void EventTask::configure()
   eventsUseStream2         = getValueBool("EventsUseStream2");
   eventsUseStream3         = getValueBool("EventsUseStream3");
   eventsAnalyze            = getValueBool("EventsAnalyze");
+  eventsUseAnalysisContext = getValueBool("EventsUseAnalysisContext");
 
   calibsCreate       = getValueBool("CalibrationsCreate");
   calibsReset        = getValueBool("CalibrationsReset");
@@ -295,6 +309,7 @@ void EventTask::configure()
     cout << "EventsUseStream2.............: " << eventsUseStream2<< endl;
     cout << "EventsUseStream3.............: " << eventsUseStream3<< endl;
     cout << "EventsAnalyze................: " << eventsAnalyze<< endl;
+    cout << "EventsUseAnalysisContext.....: " << eventsUseAnalysisContext<< endl;
     cout << "CalibrationsCreate...........: " << calibsCreate<< endl;
     cout << "CalibrationsReset............: " << calibsReset<< endl;
     cout << "CalibrationsClear............: " << calibsClear<< endl;
@@ -318,6 +333,19 @@ void EventTask::initializeEventStreams()
   if (eventsUseStream3)  addEventStream(Event::getEventStream(3));
 }
 
+void EventTask::initializeAnalysisContext()
+{
+  analysisContext = nullptr;
+  eventFilterSlots.clear();
+  particleFilterSlots.clear();
+  if (!eventsUseAnalysisContext || eventStreams.size()<1) return;
+  analysisContext = EventAnalysisContext::getContext(*eventStreams[0]);
+  for (unsigned int iEventFilter=0; iEventFilter<eventFilters.size(); iEventFilter++)
+    eventFilterSlots.push_back(analysisContext->addEventFilter(eventFilters[iEventFilter]));
+  for (unsigned int iParticleFilter=0; iParticleFilter<particleFilters.size(); iParticleFilter++)
+    particleFilterSlots.push_back(analysisContext->addParticleFilter(particleFilters[iParticleFilter]));
+}
+
 //void initializeEvent();
 //virtual void initializeEventCAP();
 //virtual void initializeEventNative();
@@ -372,6 +400,7 @@ void EventTask::initialize()
   initializeNEventsAccepted();
   initializeNParticlesAccepted();
   initializeEventStreams();
+  initializeAnalysisContext();
   initializeParticleDbLink();
   initializeParticleFactory();
   if (eventsCreate)  initializeEventGenerator();
@@ -389,6 +418,8 @@ void EventTask::initialize()
 void EventTask::finalizeEventStreams()
 {
   Event::clearEventStreams();
+  EventAnalysisContext::clearContexts();
+  analysisContext = nullptr;
 }
 
 void EventTask::finalizeEventGenerator()
@@ -489,13 +520,62 @@ void EventTask::execute()
 //    }
 
   incrementTaskExecuted();
+  if (profiler.isEnabled())
+    {
+    executeProfiledPhases();
+    return;
+    }
   if (eventsImport)  importEvent();
   if (eventsCreate)  createEvent();
-  if (eventsAnalyze) analyzeEvent();
+  if (eventsAnalyze)
+    {
+    if (analysisContext) analysisContext->update(*eventStreams[0]);
+    analyzeEvent();
+    }
   if (eventsExport)  exportEvent();
   if (hasSubTasks()) executeSubTasks();
 }
 
+void EventTask::executeProfiledPhases()
+{
+  if (eventsImport)
+    {
+    profiler.start(TaskProfiler::Import);
+    importEvent();
+    profiler.stop(TaskProfiler::Import);
+    }
+  if (eventsCreate)
+    {
+    profiler.start(TaskProfiler::Create);
+    createEvent();
+    profiler.stop(TaskProfiler::Create);
+    }
+  if (eventsAnalyze)
+    {
+    profiler.start(TaskProfiler::Analyze);
+    if (analysisContext) analysisContext->update(*eventStreams[0]);
+    analyzeEvent();
+    profiler.stop(TaskProfiler::Analyze);
+    }
+  if (eventsExport)
+    {
+    profiler.start(TaskProfiler::Export);
+    exportEvent();
+    profiler.stop(TaskProfiler::Export);
+    }
+  if (eventStreams.size()>0 && eventStreams[0]) profiler.addParticles(eventStreams[0]->getNParticles(),eventStreams[0]);
+  if (hasSubTasks()) executeSubTasks();
+}
+
+void EventTask::fillProfile()
+{
+  Factory<Particle> * factory = Particle::getFactory();
+  if (!factory) return;
+  profiler.setValue("ParticleFactoryCapacity",   factory->getCapacity());
+  profiler.setValue("ParticleFactoryPeakSize",   factory->getPeakSize());
+  profiler.setValue("ParticleFactoryExpansions", factory->getNExpansions());
+}
+
 
 //!
 //! Reset this Task instance. Implement this method in a derived class if the functionality provided in this base class is insufficient.
@@ -543,6 +623,13 @@ void EventTask::incrementNParticlesAccepted(int iEventFilter, int iParticleFilte
   nParticlesAccepted[index]++;
 }
 
+void EventTask::addNParticlesAccepted(int iEventFilter, int iParticleFilter, long nAccepted)
+{
+  int index = iEventFilter*nParticleFilters+iParticleFilter;
+  nParticlesAcceptedTotal[index] += nAccepted;
+  nParticlesAccepted[index]      += nAccepted;
+}
+
 void EventTask::resetNParticlesAcceptedEvent()
 {
   int n = nEventFilters*nParticleFilters;
@@ -617,6 +704,22 @@ void EventTask::writeNEventsAccepted(TFile & outputFile)
     ;
 }
 
+void EventTask::snapshotNEventsAccepted(vector<TObject*> & snapshot)
+{
+  if (reportStart(__FUNCTION__))
+    ;
+  String parameterName = "nEventFilters";
+  snapshot.push_back(new TParameter<Long64_t>(parameterName,nEventFilters,'+'));
+  for (int iFilter=0; iFilter<nEventFilters; iFilter++)
+    {
+    parameterName = "EventFilter";
+    parameterName += iFilter;
+    snapshot.push_back(new TParameter<Long64_t>(parameterName,nEventsAccepted[iFilter],'+'));
+    }
+  if (reportEnd(__FUNCTION__))
+    ;
+}
+
 void EventTask::loadNEventsAccepted(TFile & inputFile)
 {
   if (reportStart(__FUNCTION__))
@@ -800,7 +903,34 @@ void EventTask::exportEventCAP() {}
 void EventTask::exportEventNative() {}
 
 
-} // namespace CAP
-
+void EventTask::saveCheckpoint(TFile & outputFile)
+{
+  for (unsigned int k=0; k<nEventsAccepted.size(); k++)
+    {
+    writeCheckpointValue(outputFile,Form("nEventsAccepted%d",k),nEventsAccepted[k]);
+    writeCheckpointValue(outputFile,Form("nEventsAcceptedTotal%d",k),nEventsAcceptedTotal[k]);
+    }
+  for (unsigned int k=0; k<nParticlesAccepted.size(); k++)
+    {
+    writeCheckpointValue(outputFile,Form("nParticlesAccepted%d",k),nParticlesAccepted[k]);
+    writeCheckpointValue(outputFile,Form("nParticlesAcceptedTotal%d",k),nParticlesAcceptedTotal[k]);
+    }
+  Task::saveCheckpoint(outputFile);
+}
 
+void EventTask::loadCheckpoint(TFile & inputFile)
+{
+  for (unsigned int k=0; k<nEventsAccepted.size(); k++)
+    {
+    nEventsAccepted[k]      = readCheckpointValue(inputFile,Form("nEventsAccepted%d",k),nEventsAccepted[k]);
+    nEventsAcceptedTotal[k] = readCheckpointValue(inputFile,Form("nEventsAcceptedTotal%d",k),nEventsAcceptedTotal[k]);
+    }
+  for (unsigned int k=0; k<nParticlesAccepted.size(); k++)
+    {
+    nParticlesAccepted[k]      = readCheckpointValue(inputFile,Form("nParticlesAccepted%d",k),nParticlesAccepted[k]);
+    nParticlesAcceptedTotal[k] = readCheckpointValue(inputFile,Form("nParticlesAcceptedTotal%d",k),nParticlesAcceptedTotal[k]);
+    }
+  Task::loadCheckpoint(inputFile);
+}
 
+} // namespace CAP
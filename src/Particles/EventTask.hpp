@@ -18,6 +18,7 @@
 #include "ParticleType.hpp"
 #include "ParticleDb.hpp"
 #include "HistogramGroup.hpp"
+#include "EventAnalysisContext.hpp"
 
 namespace CAP
 {
@@ -56,6 +57,7 @@ protected:
   bool   eventsUseStream2;
   bool   eventsUseStream3;
   bool   eventsAnalyze;
+  bool   eventsUseAnalysisContext;
 
   bool   calibsCreate;
   bool   calibsReset;
@@ -104,6 +106,22 @@ protected:
   //!
   vector<ParticleFilter*>  particleFilters;
 
+  //!
+  //! Analysis context shared by the analyzers working on the same event stream, if enabled with the EventsUseAnalysisContext parameter.
+  //! The context is updated once per event, before analyzeEvent() is called.
+  //!
+  EventAnalysisContext * analysisContext;
+
+  //!
+  //! Slots of the event filters of this task in the analysis context.
+  //!
+  vector<int> eventFilterSlots;
+
+  //!
+  //! Slots of the particle filters of this task in the analysis context.
+  //!
+  vector<int> particleFilterSlots;
+
 
   //!
   //! Array of filter particles (ParticleDigits).
@@ -201,10 +219,20 @@ public:
 
   virtual void execute();
 
+  //!
+  //! Report the occupancy of the particle factory in the profile of this task.
+  //!
+  virtual void fillProfile();
+
   virtual void initializeEventGenerator();
   virtual void initializeEventReader();
   virtual void initializeEventWriter();
   virtual void initializeEventStreams();
+
+  //!
+  //! Register the event filters and particle filters of this task with the analysis context of its first event stream.
+  //!
+  virtual void initializeAnalysisContext();
 //  virtual void initializeEvent();
 //  virtual void initializeEventCAP();
 //  virtual void initializeEventNative();
@@ -214,6 +242,12 @@ public:
   virtual void convertEventCAPToNative();
   virtual void convertEventNativeToCAP();
   virtual void partial(const String & outputPathBase);
+
+  //!
+  //! Save (restore) the state of this task, including its accepted event and particle counters, in (from) a checkpoint file.
+  //!
+  virtual void saveCheckpoint(TFile & outputFile);
+  virtual void loadCheckpoint(TFile & inputFile);
   virtual void exportEvent();
   virtual void exportEventCAP();
   virtual void exportEventNative();
@@ -226,6 +260,11 @@ public:
   virtual void createEvent();
   virtual void analyzeEvent();
 
+  //!
+  //! Same as execute() but with each phase (import, create, analyze, export) timed by the profiler of this task.
+  //!
+  void executeProfiledPhases();
+
   //!
   //! Reset this Task instance. Implement this method in a derived class if the functionality provided in this base class is insufficient.
   //!
@@ -238,6 +277,7 @@ public:
 
   virtual void initializeNParticlesAccepted();
   virtual void incrementNParticlesAccepted(int iEventFilter=0, int iParticleFilter=0);
+  virtual void addNParticlesAccepted(int iEventFilter, int iParticleFilter, long nAccepted);
   virtual void resetNParticlesAcceptedEvent();
   virtual void resetNParticlesAccepted();
   virtual void clearNParticlesAccepted();
@@ -325,6 +365,7 @@ public:
   }
 
   void writeNEventsAccepted(TFile & outputFile);
+  void snapshotNEventsAccepted(vector<TObject*> & snapshot);
   void loadNEventsAccepted(TFile & inputFile);
 
   void printEventStatistics() const;
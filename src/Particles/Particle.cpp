@@ -10,6 +10,8 @@
  *
  * *********************************************************************/
 #include <ostream>
+#include <cmath>
+#include "TMath.h"
 #include "Factory.hpp"
 #include "Particle.hpp"
 using CAP::Factory;
@@ -30,6 +32,12 @@ truth    (nullptr),
 live     (false),
 pid      (-1),
 sourceIndex(-1),
+kinematicsValid(false),
+cachedPt (0.0),
+cachedEta(0.0),
+cachedPhi(0.0),
+cachedY  (0.0),
+cachedMt (0.0),
 ixEtaPhi (0),
 ixYPhi   (0)
 {  }
@@ -45,6 +53,12 @@ truth    (other.truth),
 live     (other.live),
 pid      (other.pid),
 sourceIndex(other.sourceIndex),
+kinematicsValid(other.kinematicsValid),
+cachedPt (other.cachedPt),
+cachedEta(other.cachedEta),
+cachedPhi(other.cachedPhi),
+cachedY  (other.cachedY),
+cachedMt (other.cachedMt),
 ixEtaPhi(other.ixEtaPhi),
 ixYPhi(other.ixYPhi)
 {  }
@@ -64,6 +78,12 @@ Particle & Particle::operator=(const Particle & other)
     live        = other.live;
     pid         = other.pid;
     sourceIndex = other.sourceIndex;
+    kinematicsValid = other.kinematicsValid;
+    cachedPt    = other.cachedPt;
+    cachedEta   = other.cachedEta;
+    cachedPhi   = other.cachedPhi;
+    cachedY     = other.cachedY;
+    cachedMt    = other.cachedMt;
     }
   return *this;
 }
@@ -77,6 +97,7 @@ void Particle::clear()
   ixYPhi     = -1;
   momentum.SetPxPyPzE (0.0,0.0,0.0,0.0);
   position.SetXYZT    (0.0,0.0,0.0,0.0);
+  kinematicsValid = false;
   parents.clear();
   children.clear();
   truth = nullptr;
@@ -90,6 +111,7 @@ void Particle::reset()
   ixYPhi     = -1;
   momentum.SetPxPyPzE (0.0,0.0,0.0,0.0);
   position.SetXYZT    (0.0,0.0,0.0,0.0);
+  kinematicsValid = false;
   parents.clear();
   children.clear();
   truth = nullptr;
@@ -104,6 +126,7 @@ void Particle::set(ParticleType * _type,
   type = _type;
   momentum.SetPxPyPzE (p_x,p_y,p_z,p_e);
   position.SetXYZT    (_x,_y,_z,_t);
+  computeKinematics(p_x,p_y,p_z,p_e);
   live       = _live;
   parents.clear();
   children.clear();
@@ -168,6 +191,31 @@ void Particle::setPidPxPyPzE(long _pid, double p_x, double p_y, double p_z, doub
 {
   pid = _pid;
   momentum.SetPxPyPzE (p_x,p_y,p_z,p_e);
+  computeKinematics(p_x,p_y,p_z,p_e);
+}
+
+void Particle::computeKinematics() const
+{
+  computeKinematics(momentum.Px(),momentum.Py(),momentum.Pz(),momentum.E());
+}
+
+//!
+//! Same conventions as TLorentzVector::Pt(), Eta(), Phi(), Rapidity() and Mt() except that phi is returned in [0, 2pi).
+//!
+void Particle::computeKinematics(double p_x, double p_y, double p_z, double p_e) const
+{
+  double pt2 = p_x*p_x + p_y*p_y;
+  double mt2 = p_e*p_e - p_z*p_z;
+  cachedPt  = sqrt(pt2);
+  if (cachedPt>0.0)
+    cachedEta = asinh(p_z/cachedPt);
+  else
+    cachedEta = (p_z==0.0) ? 0.0 : ((p_z>0.0) ? 10e10 : -10e10);
+  cachedPhi = (p_x==0.0 && p_y==0.0) ? 0.0 : atan2(p_y,p_x);
+  if (cachedPhi<0.0) cachedPhi += TMath::TwoPi();
+  cachedY   = 0.5*log((p_e+p_z)/(p_e-p_z));
+  cachedMt  = (mt2<0.0) ? -sqrt(-mt2) : sqrt(mt2);
+  kinematicsValid = true;
 }
 
 void Particle::setRThetaPhiT(double r, double theta, double phi,double t)
@@ -191,6 +239,7 @@ void Particle::setRCosThetaPhiT(double r, double cosTheta, double phi,double t)
 void Particle::boost(double ax, double ay, double az)
 {
   momentum.Boost(ax,ay,az);
+  kinematicsValid = false;
   unsigned int nChildren = children.size();
   for (unsigned int iChildren=0; iChildren<nChildren; iChildren++)
     {
@@ -210,6 +259,7 @@ void Particle::boostRapidity(double boost)
   pz = mt * sinh(rapidity);
   e  = mt * cosh(rapidity);
   momentum.SetPxPyPzE (px,py,pz,e);
+  kinematicsValid = false;
   unsigned int nChildren = children.size();
   for (unsigned int iChildren=0; iChildren<nChildren; iChildren++)
     {
@@ -268,8 +318,9 @@ void Particle::setParent(Particle * _parent)
 {
   parents.clear();
   parents.push_back(_parent);
-  momentum = _parent->getMomentum();
-  position = _parent->getPosition();
+  momentum = _parent->momentum;
+  position = _parent->position;
+  kinematicsValid = false;
 
 }
 
@@ -279,9 +330,10 @@ void Particle::setParents(Particle * parent1, Particle * parent2)
   parents.clear();
   parents.push_back(parent1);
   parents.push_back(parent2);
-  momentum = parent1->getMomentum(); momentum += parent2->getMomentum();
+  momentum = parent1->momentum; momentum += parent2->momentum;
   position = parent1->getPosition(); position += parent2->getPosition();
   position *= 0.5;
+  kinematicsValid = false;
 
 }
 
@@ -292,9 +344,10 @@ void Particle::setParents(Particle * parent1, Particle * parent2, Particle * par
   parents.push_back(parent1);
   parents.push_back(parent2);
   parents.push_back(parent3);
-  momentum = parent1->getMomentum(); momentum += parent2->getMomentum(); momentum += parent3->getMomentum();
+  momentum = parent1->momentum; momentum += parent2->momentum; momentum += parent3->momentum;
   position = parent1->getPosition(); position += parent2->getPosition(); position += parent3->getPosition();
   position *= 0.3333333333;
+  kinematicsValid = false;
 
 }
 
@@ -303,17 +356,18 @@ void Particle::setParents(const vector<Particle*> &  newParents)
 {
   parents.clear();
   Particle * parent = newParents[0];
-  momentum = parent->getMomentum();
+  momentum = parent->momentum;
   position = parent->getPosition();
   unsigned int nParents = newParents.size();
   for (unsigned int iParent=1;iParent<nParents;iParent++)
   {
   parent   =  newParents[iParent];
-  momentum += parent->getMomentum();
+  momentum += parent->momentum;
   position += parent->getPosition();
   parents.push_back(parent);
   }
   position *= 1.0/double(nParents);
+  kinematicsValid = false;
 }
 
 void Particle::addChild(Particle* child)
@@ -50,6 +50,11 @@ namespace CAP
 //!
 //! The particle can also hold a pointer to a "truth" particle or reference particle. This is used, in particular, in simple one-to-one simulation studies of the performance of a detection device (i.e., resolution and efficiency studies, closure test, etc).
 //!
+//!The kinematic variables most used by analyzers (pt, eta, phi, y, mT) are cached: they are computed at most once after the momentum
+//!is set and invalidated whenever the momentum is modified through this class. Calling the non-const getMomentum() also invalidates the
+//!cache since the momentum may be modified through the returned reference; code that keeps such a reference and modifies the momentum
+//!later must call invalidateKinematics().
+//!
 class Particle
 {
 public:
@@ -170,25 +175,79 @@ public:
   const LorentzVector & getMomentum() const { return momentum;  }
 
   //!
-  //! Get a changeable reference to the  4-momentum vector of this particle (as a LorentzVector reference)
+  //! Get a changeable reference to the  4-momentum vector of this particle (as a LorentzVector reference). The cached kinematics are invalidated.
   //!
-  LorentzVector & getMomentum() { return momentum;  }
+  LorentzVector & getMomentum() { kinematicsValid = false; return momentum;  }
   
   //!
   //! Set the  4-momentum vector of this particle based on its four components.
   //!
   void setPxPyPzE(double p_x, double p_y, double p_z, double p_e)
-  {  momentum.SetPxPyPzE(p_x,p_y,p_z,p_e);  }
+  {  momentum.SetPxPyPzE(p_x,p_y,p_z,p_e); kinematicsValid = false; }
 
   //!
   //! Set the  4-momentum vector of this particle based on a LorentzVector object
   //!
-  void setPxPyPzE(const LorentzVector & _momentum)           { momentum = _momentum;  }
+  void setPxPyPzE(const LorentzVector & _momentum)           { momentum = _momentum; kinematicsValid = false; }
   
   //!
   //! Set the  4-momentum vector of this particle based on a LorentzVector object
   //!
-  void setMomentum(const LorentzVector & _momentum)          { momentum = _momentum;  }
+  void setMomentum(const LorentzVector & _momentum)          { momentum = _momentum; kinematicsValid = false; }
+
+  //!
+  //! Get the energy of this particle.
+  //!
+  double getE() const   { return momentum.E(); }
+
+  //!
+  //! Get the (cached) transverse momentum of this particle.
+  //!
+  double getPt() const  { if (!kinematicsValid) computeKinematics(); return cachedPt;  }
+
+  //!
+  //! Get the (cached) pseudorapidity of this particle.
+  //!
+  double getEta() const { if (!kinematicsValid) computeKinematics(); return cachedEta; }
+
+  //!
+  //! Get the (cached) azimuthal angle of this particle in the range [0, 2pi).
+  //!
+  double getPhi() const { if (!kinematicsValid) computeKinematics(); return cachedPhi; }
+
+  //!
+  //! Get the (cached) rapidity of this particle.
+  //!
+  double getY() const   { if (!kinematicsValid) computeKinematics(); return cachedY;   }
+
+  //!
+  //! Get the (cached) transverse mass, sqrt(E^2-p_z^2), of this particle.
+  //!
+  double getMt() const  { if (!kinematicsValid) computeKinematics(); return cachedMt;  }
+
+  //!
+  //! Fill the kinematics cache with values already known by the caller (e.g., a generator that samples pt, eta, phi, y).
+  //! The values must be consistent with the momentum of this particle and phi must be in the range [0, 2pi).
+  //!
+  void setKinematics(double _pt, double _eta, double _phi, double _y, double _mt)
+  {
+  cachedPt  = _pt;
+  cachedEta = _eta;
+  cachedPhi = _phi;
+  cachedY   = _y;
+  cachedMt  = _mt;
+  kinematicsValid = true;
+  }
+
+  //!
+  //! Invalidate the kinematics cache. Must be called if the momentum is modified through a reference obtained earlier from getMomentum().
+  //!
+  void invalidateKinematics()   { kinematicsValid = false; }
+
+  //!
+  //! Return true if the kinematics cache is up to date.
+  //!
+  bool hasValidKinematics() const { return kinematicsValid; }
 
   //!
   //! Get the  4-position  vector of this particle as a changeable LorentzVector object
@@ -574,6 +633,23 @@ protected:
   long pid;  //!< used defined identified used in some applications
   int  sourceIndex;  //!<  source index  used in some applications
 
+  //!
+  //! Compute the cached kinematic variables from the components of the momentum.
+  //!
+  void computeKinematics() const;
+
+  //!
+  //! Compute the cached kinematic variables from the given momentum components.
+  //!
+  void computeKinematics(double p_x, double p_y, double p_z, double p_e) const;
+
+  mutable bool   kinematicsValid; //!< whether the cached kinematics are up to date
+  mutable double cachedPt;   //!< cached transverse momentum
+  mutable double cachedEta;  //!< cached pseudorapidity
+  mutable double cachedPhi;  //!< cached azimuth in [0, 2pi)
+  mutable double cachedY;    //!< cached rapidity
+  mutable double cachedMt;   //!< cached transverse mass
+
 public:
   int   ixEtaPhi, ixYPhi;
 
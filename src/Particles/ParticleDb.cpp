@@ -22,6 +22,7 @@
 using CAP::Collection;
 using CAP::ParticleType;
 using CAP::ParticleDb;
+using CAP::ParticleDecayMode;
 using namespace std;
 
 ClassImp(Collection<ParticleType>);
@@ -31,7 +32,11 @@ ClassImp(ParticleDb);
 
 ParticleDb::ParticleDb()
 :
-Collection<ParticleType>()
+Collection<ParticleType>(),
+pdgCodeIndices(),
+nameIndices(),
+indexedSize(0),
+indicesValid(false)
 {
 }
 
@@ -188,6 +193,7 @@ void ParticleDb::sortByMass()
     j--;
     }
   }
+  indicesValid = false;
 }
 
 void ParticleDb::resolveTypes()
@@ -263,21 +269,17 @@ unsigned int ParticleDb::findIndexForType(ParticleType * type)
 
 unsigned int ParticleDb::findIndexForName(const CAP::String & name)
 {
-  for (unsigned int iPart = 0; iPart < size(); iPart++)
-    {
-    if (objects[iPart]->getName().EqualTo(name)) return iPart;
-    }
-  return -1;
+  updateIndices();
+  unordered_map<std::string,unsigned int>::const_iterator it = nameIndices.find(name.Data());
+  return (it==nameIndices.end()) ? -1 : it->second;
 }
 
 
 unsigned int ParticleDb::findIndexForPdgCode(int pdgCode)
 {
-  for (unsigned int iPart = 0; iPart < size(); iPart++)
-  {
-  if (pdgCode == objects[iPart]->getPdgCode()) return iPart;
-  }
-  return -1;
+  updateIndices();
+  unordered_map<int,unsigned int>::const_iterator it = pdgCodeIndices.find(pdgCode);
+  return (it==pdgCodeIndices.end()) ? -1 : it->second;
 }
 
 unsigned int ParticleDb::findIndexForPrivateCode(int privateCode)
@@ -291,20 +293,13 @@ unsigned int ParticleDb::findIndexForPrivateCode(int privateCode)
 
 bool ParticleDb::containsTypeNamed(CAP::String name)
 {
-  for (unsigned int iPart = 0; iPart < size(); iPart++)
-    {
-    if (objects[iPart]->getName().EqualTo(name)) return true;
-    }
-  return false;
+  return findIndexForName(name) < size();
 }
 
 ParticleType * ParticleDb::findPdgCode(int pdgCode)
 {
-  for (unsigned int iPart = 0; iPart<size(); iPart++)
-  {
-  if (pdgCode == objects[iPart]->getPdgCode())
-    return objects[iPart];
-  }
+  unsigned int index = findIndexForPdgCode(pdgCode);
+  if (index < size()) return objects[index];
   // code not found in the current table.
   // create new type and add to the table.
   ParticleType * newType = new ParticleType();
@@ -334,7 +329,7 @@ void ParticleDb::addParticleType(ParticleType * particleType)
 ParticleType * ParticleDb::getParticleType(String name)
 {
   unsigned int index = findIndexForName(name);
-  if (index>=0)
+  if (index<size())
     return objects[index];
   else
     return nullptr;
@@ -433,3 +428,115 @@ vector<int> ParticleDb::getListOfPdgCodes()
   }
   return pdgCodes;
 }
+
+void ParticleDb::updateIndices()
+{
+  if (indicesValid && indexedSize==size()) return;
+  pdgCodeIndices.clear();
+  nameIndices.clear();
+  for (unsigned int iPart = 0; iPart < size(); iPart++)
+    {
+    // emplace does not replace an existing entry: the first type found is kept as with a linear search
+    pdgCodeIndices.emplace(objects[iPart]->getPdgCode(),iPart);
+    nameIndices.emplace(objects[iPart]->getName().Data(),iPart);
+    }
+  indexedSize  = size();
+  indicesValid = true;
+}
+
+void ParticleDb::writeBinary(ostream & os)
+{
+  unsigned int nTypes = size();
+  unordered_map<const ParticleType*,int> typeIndices;
+  for (unsigned int iType=0; iType<nTypes; iType++) typeIndices.emplace(objects[iType],iType);
+  os.write((const char*) &nTypes, sizeof(nTypes));
+  for (unsigned int iType=0; iType<nTypes; iType++) objects[iType]->writeProperties(os);
+  for (unsigned int iType=0; iType<nTypes; iType++)
+    {
+    ParticleType & type = *objects[iType];
+    int nModes = type.getNDecayModes();
+    os.write((const char*) &nModes, sizeof(nModes));
+    for (int iMode=0; iMode<nModes; iMode++)
+      {
+      ParticleDecayMode & decayMode = type.getDecayMode(iMode);
+      double branchingRatio = decayMode.getBranchingRatio();
+      const vector<ParticleType*> & childrenTypes = decayMode.getChildrenTypes();
+      int nChildren = decayMode.getNChildren();
+      os.write((const char*) &branchingRatio, sizeof(branchingRatio));
+      os.write((const char*) &nChildren, sizeof(nChildren));
+      for (int iChild=0; iChild<nChildren; iChild++)
+        {
+        int pdgCode    = decayMode.getChildPdgCode(iChild);
+        int childIndex = -1;
+        if (iChild<int(childrenTypes.size()))
+          {
+          unordered_map<const ParticleType*,int>::const_iterator it = typeIndices.find(childrenTypes[iChild]);
+          if (it!=typeIndices.end()) childIndex = it->second;
+          }
+        os.write((const char*) &pdgCode, sizeof(pdgCode));
+        os.write((const char*) &childIndex, sizeof(childIndex));
+        }
+      }
+    }
+}
+
+bool ParticleDb::readBinary(istream & is)
+{
+  unsigned int nTypes = 0;
+  is.read((char*) &nTypes, sizeof(nTypes));
+  if (!is) return false;
+  vector<ParticleType*> types;
+  types.reserve(nTypes);
+  for (unsigned int iType=0; iType<nTypes; iType++)
+    {
+    ParticleType * type = new ParticleType();
+    types.push_back(type);
+    if (!type->readProperties(is))
+      {
+      for (unsigned int k=0; k<types.size(); k++) delete types[k];
+      return false;
+      }
+    }
+  bool ok = true;
+  for (unsigned int iType=0; ok && iType<nTypes; iType++)
+    {
+    int nModes = 0;
+    is.read((char*) &nModes, sizeof(nModes));
+    ok = is && nModes>=0;
+    for (int iMode=0; ok && iMode<nModes; iMode++)
+      {
+      double branchingRatio = 0.0;
+      int    nChildren = 0;
+      is.read((char*) &branchingRatio, sizeof(branchingRatio));
+      is.read((char*) &nChildren, sizeof(nChildren));
+      ok = is && nChildren>=0;
+      ParticleDecayMode decayMode;
+      decayMode.setBranchingRatio(branchingRatio);
+      for (int iChild=0; ok && iChild<nChildren; iChild++)
+        {
+        int pdgCode    = 0;
+        int childIndex = -1;
+        is.read((char*) &pdgCode, sizeof(pdgCode));
+        is.read((char*) &childIndex, sizeof(childIndex));
+        ok = is && childIndex<int(nTypes);
+        if (!ok) break;
+        if (childIndex>=0)
+          decayMode.addChild(types[childIndex]);
+        else
+          decayMode.addChild(pdgCode);
+        }
+      if (ok) types[iType]->addDecayMode(decayMode);
+      }
+    }
+  if (!ok)
+    {
+    for (unsigned int k=0; k<types.size(); k++) delete types[k];
+    return false;
+    }
+  for (unsigned int iType=0; iType<nTypes; iType++)
+    {
+    append(types[iType]);
+    types[iType]->setupDecayGenerator();
+    }
+  return true;
+}
@@ -19,6 +19,7 @@
 #include <fstream>
 #include <vector>
 #include <iomanip>
+#include <unordered_map>
 #include "Collection.hpp"
 #include "ParticleType.hpp"
 
@@ -68,6 +69,18 @@ public:
 
   vector<int> getListOfPdgCodes();
 
+  //!
+  //! Write the particle types of this collection and their decay modes to the given binary stream. The children of the
+  //! decay modes are written as indices in this collection so they are resolved without lookup when read back.
+  //!
+  void writeBinary(ostream & os);
+
+  //!
+  //! Read particle types and their decay modes written by writeBinary and append them to this collection; the decay
+  //! generators of the types are set up. Returns false if the stream is exhausted or corrupted.
+  //!
+  bool readBinary(istream & is);
+
   ostream & printProperties(ostream & os);
   ostream & printDecayProperties(ostream & os);
 
@@ -75,6 +88,19 @@ public:
   static void setDefaultParticleDb(ParticleDb * newDb);
   static ParticleDb * getDefaultParticleDb();
 
+protected:
+
+  //!
+  //! Rebuild the pdg code and name lookup indices if types were added or reordered since they were built. The name and pdg code
+  //! of a type must thus be set before it is added to the collection.
+  //!
+  void updateIndices();
+
+  unordered_map<int,unsigned int>         pdgCodeIndices; //!< index of the first type with a given pdg code
+  unordered_map<std::string,unsigned int> nameIndices;    //!< index of the first type with a given name
+  unsigned int indexedSize;                               //!< size of the collection when the indices were built
+  bool         indicesValid;
+
   ClassDef(ParticleDb,0)
 };
 
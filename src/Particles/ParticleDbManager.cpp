@@ -11,6 +11,8 @@
  * *********************************************************************/
 #include "ParticleDbManager.hpp"
 #include <string.h>
+#include <iterator>
+#include "TSystem.h"
 using CAP::ParticleDbManager;
 using namespace std;
 
@@ -18,6 +20,10 @@ ClassImp(ParticleDbManager);
 
 const double factorials[7] = {1.0, 1.0, 2.0, 6.0, 24.0, 120.0, 720.0 };
 
+// identification and version of the binary cache format
+const char particleDbCacheMagic[8]  = "CAPPDB";
+const int  particleDbCacheVersion   = 1;
+
 
 ParticleDbManager:: ParticleDbManager(const String & _name,
                                       const Configuration & _configuration)
@@ -37,6 +43,8 @@ particleDbExportFile("newParticles.data"),
 particleDbExportDecaysFile("neweDecays.data"),
 particleDbExportNative(0),
 particleDbExportCAP(0),
+particleDbCache(1),
+particleDbCachePath(""),
 particleDbs()
 {
   appendClassName("ParticleDbManager");
@@ -59,6 +67,8 @@ void ParticleDbManager::setDefaultConfiguration()
   addParameter("ParticleDbExportDecaysFile",  particleDbExportDecaysFile);
   addParameter("ParticleDbExportNative",      particleDbExportNative);
   addParameter("ParticleDbExportCAP",         particleDbExportCAP);
+  addParameter("ParticleDbCache",             particleDbCache);
+  addParameter("ParticleDbCachePath",         particleDbCachePath);
 }
 
 
@@ -77,6 +87,9 @@ void ParticleDbManager::configure()
   particleDbExportDecaysFile = getValueString("ParticleDbExportDecaysFile"  );
   particleDbExportNative     = getValueBool(  "ParticleDbExportNative"      );
   particleDbExportCAP        = getValueBool(  "ParticleDbExportCAP"         );
+  particleDbCache            = getValueBool(  "ParticleDbCache"             );
+  particleDbCachePath        = getValueString("ParticleDbCachePath"         );
+  if (particleDbCachePath.Length()<1) particleDbCachePath = particleDbImportPath;
   if (reportInfo(__FUNCTION__))
     {
     cout << endl;
@@ -92,6 +105,8 @@ void ParticleDbManager::configure()
     printItem("ParticleDbExportDecaysFile" ,particleDbExportDecaysFile);
     printItem("ParticleDbExportNative"     ,particleDbExportNative);
     printItem("ParticleDbExportCAP"        ,particleDbExportCAP);
+    printItem("ParticleDbCache"            ,particleDbCache);
+    printItem("ParticleDbCachePath"        ,particleDbCachePath);
     cout << endl;
     }
   if (reportDebug(__FUNCTION__)) printConfiguration(cout);
@@ -116,9 +131,119 @@ void ParticleDbManager::execute()
 void ParticleDbManager::importParticleDb()
 {
   if (particleDbImportCAP || !particleDbImportNative)
-    importParticleDbCAP();
+    {
+    if (!particleDbCache || !importParticleDbCache(false))
+      {
+      importParticleDbCAP();
+      if (particleDbCache) exportParticleDbCache(false);
+      }
+    }
   if (particleDbImportNative)
-    importParticleDbNative();
+    {
+    if (!particleDbCache || !importParticleDbCache(true))
+      {
+      importParticleDbNative();
+      if (particleDbCache) exportParticleDbCache(true);
+      }
+    }
+}
+
+//!
+//! The data files are ".dat" (CAP) or ".data" (native) files; the native format also has a decays file.
+//!
+String ParticleDbManager::getParticleDbCacheFileName(bool native) const
+{
+  String fileName = particleDbCachePath;
+  if (fileName.Length()>0 && !fileName.EndsWith("/")) fileName += "/";
+  fileName += particleDbImportFile;
+  String extension = native ? ".data" : ".dat";
+  if (!fileName.EndsWith(extension)) fileName += extension;
+  fileName += ".cache";
+  return fileName;
+}
+
+unsigned int ParticleDbManager::getParticleDbSourceHash(bool native) const
+{
+  String extension = native ? ".data" : ".dat";
+  vector<String> sourceFiles;
+  sourceFiles.push_back(particleDbImportFile);
+  if (native) sourceFiles.push_back(particleDbImportDecaysFile);
+  std::string contents;
+  for (unsigned int iFile=0; iFile<sourceFiles.size(); iFile++)
+    {
+    String fileName = particleDbImportPath;
+    if (fileName.Length()>0 && !fileName.EndsWith("/")) fileName += "/";
+    fileName += sourceFiles[iFile];
+    if (!fileName.EndsWith(extension)) fileName += extension;
+    ifstream inputFile(fileName.Data(),ios_base::in|ios_base::binary);
+    if (!inputFile.is_open()) return 0;
+    contents.append(std::istreambuf_iterator<char>(inputFile),std::istreambuf_iterator<char>());
+    contents += '\0';
+    }
+  return TString::Hash(contents.data(),contents.size());
+}
+
+bool ParticleDbManager::importParticleDbCache(bool native)
+{
+  String cacheFileName = getParticleDbCacheFileName(native);
+  if (gSystem->AccessPathName(cacheFileName)) return false;
+  unsigned int sourceHash = getParticleDbSourceHash(native);
+  if (sourceHash==0) return false;
+  ifstream inputFile(cacheFileName.Data(),ios_base::in|ios_base::binary);
+  if (!inputFile.is_open()) return false;
+  char magic[8];
+  int version = 0;
+  unsigned int hash = 0;
+  inputFile.read(magic,sizeof(magic));
+  inputFile.read((char*) &version,sizeof(version));
+  inputFile.read((char*) &hash,sizeof(hash));
+  if (!inputFile || strncmp(magic,particleDbCacheMagic,sizeof(magic))!=0 || version!=particleDbCacheVersion || hash!=sourceHash)
+    {
+    if (reportInfo(__FUNCTION__)) cout << "Particle data base cache " << cacheFileName << " is out of date." << endl;
+    return false;
+    }
+  ParticleDb * particleDb = new ParticleDb();
+  if (!particleDb->readBinary(inputFile))
+    {
+    if (reportWarning(__FUNCTION__)) cout << "Particle data base cache " << cacheFileName << " is corrupted. Reading the data files." << endl;
+    delete particleDb;
+    return false;
+    }
+  particleDbs.push_back(particleDb);
+  ParticleDb::setDefaultParticleDb(particleDb);
+  if (reportInfo(__FUNCTION__))
+    cout << "Loaded " << particleDb->getNumberOfTypes() << " particle types from cache " << cacheFileName << endl;
+  return true;
+}
+
+void ParticleDbManager::exportParticleDbCache(bool native)
+{
+  if (particleDbs.size()<1) return;
+  unsigned int sourceHash = getParticleDbSourceHash(native);
+  if (sourceHash==0) return;
+  String cacheFileName = getParticleDbCacheFileName(native);
+  // write to a temporary file renamed once complete so concurrent jobs never read a partial cache
+  String tempFileName = cacheFileName;
+  tempFileName += ".";
+  tempFileName += gSystem->GetPid();
+  ofstream outputFile(tempFileName.Data(),ios_base::out|ios_base::binary);
+  if (!outputFile.is_open())
+    {
+    if (reportWarning(__FUNCTION__)) cout << "Unable to write particle data base cache " << cacheFileName << endl;
+    return;
+    }
+  outputFile.write(particleDbCacheMagic,sizeof(particleDbCacheMagic));
+  outputFile.write((const char*) &particleDbCacheVersion,sizeof(particleDbCacheVersion));
+  outputFile.write((const char*) &sourceHash,sizeof(sourceHash));
+  particleDbs.back()->writeBinary(outputFile);
+  outputFile.close();
+  if (!outputFile || gSystem->Rename(tempFileName,cacheFileName)!=0)
+    {
+    if (reportWarning(__FUNCTION__)) cout << "Unable to write particle data base cache " << cacheFileName << endl;
+    gSystem->Unlink(tempFileName);
+    return;
+    }
+  if (reportInfo(__FUNCTION__)) cout << "Particle data base cache written to " << cacheFileName << endl;
 }
 
 void ParticleDbManager::importParticleDbCAP() throw (FileException)
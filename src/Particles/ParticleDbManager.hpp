@@ -30,6 +30,10 @@ namespace CAP
 //! - EventsExport [true] : whether particle type data will be written to file
 //! - EventsExportPath [getenv("CAP_DATA") : folder (file path) where to write a particle type PDG data file.
 //! - EventsExportFileName ["NewParticleTypeData.dat"] : name of the file containing on output particle type PDG data.
+//! - ParticleDbCache [true] : whether the particle data base is loaded from, or saved to, a binary cache file keyed by a hash
+//!   of the contents of the particle (and decay) data files. The cache holds the particle types, their decay modes with
+//!   children resolved as indices, and is read without parsing or lookups.
+//! - ParticleDbCachePath [""] : folder of the cache files; the import folder is used if empty.
 //!
 //!
 class ParticleDbManager : public EventTask
@@ -82,6 +86,17 @@ public:
   virtual void exportParticleDbCAP();
   virtual void exportParticleDbNative();
 
+  //!
+  //! Load the particle data base from the binary cache of the CAP (native=false) or native (native=true) data files. Returns
+  //! false if there is no cache or if it does not match the current contents of the data files.
+  //!
+  virtual bool importParticleDbCache(bool native);
+
+  //!
+  //! Save the last particle data base imported to the binary cache of the CAP or native data files.
+  //!
+  virtual void exportParticleDbCache(bool native);
+
 
 protected:
 
@@ -90,6 +105,9 @@ protected:
                        double aJot2, double aEm2);
   double deltaJ(double aJot1, double aJot2, double aJot);
 
+  String getParticleDbCacheFileName(bool native) const;
+  unsigned int getParticleDbSourceHash(bool native) const;
+
   bool   particleDbImport;
   String particleDbImportPath;
   String particleDbImportFile;
@@ -104,6 +122,8 @@ protected:
   String particleDbExportDecaysFile;
   bool   particleDbExportNative;
   bool   particleDbExportCAP;
+  bool   particleDbCache;
+  String particleDbCachePath;
 
   vector<ParticleDb*> particleDbs;
 
@@ -0,0 +1,364 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include <cmath>
+#include <algorithm>
+#include "ParticleDecayCascade.hpp"
+using CAP::ParticleDecayCascade;
+
+ClassImp(ParticleDecayCascade);
+
+double ParticleDecayCascade::twoPi = 2.0*3.1415927;
+
+ParticleDecayCascade::ParticleDecayCascade()
+:
+decayTable(),
+random(gRandom),
+disable2Prong(false),
+disable3Prong(false),
+storeDecayedParents(true),
+nSkippedDecays(0),
+parents(),
+parentTypes(),
+parentChannels(),
+parentPx(), parentPy(), parentPz(), parentE(),
+parentX(),  parentY(),  parentZ(),  parentT(),
+parentMasses(),
+vx(), vy(), vz(),
+randoms(),
+childParents(),
+childTypes(),
+childPx(), childPy(), childPz(), childE(),
+decayedParents(),
+bodyMasses(), bodyInvMasses(), bodyMomenta(), bodyRandoms(),
+bodyPx(), bodyPy(), bodyPz(), bodyE()
+{ }
+
+void ParticleDecayCascade::initialize(ParticleDb & particleDb)
+{
+  decayTable.initialize(particleDb);
+}
+
+unsigned int ParticleDecayCascade::decay(Event & event, Factory<Particle> & factory, unsigned long firstIndex, int maxGenerations)
+{
+  unsigned int nDecayed = 0;
+  unsigned long begin = firstIndex;
+  unsigned long end   = event.getNParticles();
+  int generation = 0;
+  decayedParents.clear();
+  while (begin<end && (maxGenerations<0 || generation<maxGenerations))
+    {
+    gatherParents(event, begin, end);
+    if (parents.size()<1) break;
+    generateChannelsAndVertices();
+    childParents.clear();
+    childTypes.clear();
+    childPx.clear(); childPy.clear(); childPz.clear(); childE.clear();
+    decayTwoBody();
+    decayThreeBody();
+    decayNBody();
+    nDecayed += emitChildren(event, factory);
+    begin = end;
+    end   = event.getNParticles();
+    generation++;
+    }
+  if (!storeDecayedParents && decayedParents.size()>0) removeDecayedParents(event, firstIndex);
+  return nDecayed;
+}
+
+void ParticleDecayCascade::gatherParents(Event & event, unsigned long begin, unsigned long end)
+{
+  parents.clear();
+  parentTypes.clear();
+  parentPx.clear(); parentPy.clear(); parentPz.clear(); parentE.clear();
+  parentX.clear();  parentY.clear();  parentZ.clear();  parentT.clear();
+  vector<Particle*> & particles = event.getParticles();
+  for (unsigned long iParticle=begin; iParticle<end; iParticle++)
+    {
+    Particle & particle = *particles[iParticle];
+    if (!particle.isLive() || particle.isStable() || particle.isInteraction()) continue;
+    int iType = decayTable.getTypeIndex(particle.getTypePtr());
+    if (iType<0 || !decayTable.isDecayable(iType)) continue;
+    const LorentzVector & momentum = particle.getMomentum();
+    const LorentzVector & position = particle.getPosition();
+    parents.push_back(&particle);
+    parentTypes.push_back(iType);
+    parentPx.push_back(momentum.Px());
+    parentPy.push_back(momentum.Py());
+    parentPz.push_back(momentum.Pz());
+    parentE.push_back(momentum.E());
+    parentX.push_back(position.X());
+    parentY.push_back(position.Y());
+    parentZ.push_back(position.Z());
+    parentT.push_back(position.T());
+    }
+}
+
+void ParticleDecayCascade::generateChannelsAndVertices()
+{
+  unsigned int nParents = parents.size();
+  parentChannels.resize(nParents);
+  parentMasses.resize(nParents);
+  vx.resize(nParents);
+  vy.resize(nParents);
+  vz.resize(nParents);
+  randoms.resize(2*nParents);
+  random->RndmArray(2*nParents, randoms.data());
+  const double * rChannel = randoms.data();
+  const double * rTime    = randoms.data() + nParents;
+
+  for (unsigned int iParent=0; iParent<nParents; iParent++)
+    {
+    int iChannel = decayTable.generateChannel(parentTypes[iParent], rChannel[iParent]);
+    int nChildren = decayTable.getNChildren(iChannel);
+    if (nChildren<2)
+      {
+      nSkippedDecays++;
+      iChannel = -1;
+      }
+    else if ((nChildren==2 && disable2Prong) || (nChildren==3 && disable3Prong))
+      iChannel = -1;
+    parentChannels[iParent] = iChannel;
+    }
+
+  // decay vertices: straight loop over the parent buffers
+  for (unsigned int iParent=0; iParent<nParents; iParent++)
+    {
+    double e  = parentE[iParent];
+    double px = parentPx[iParent];
+    double py = parentPy[iParent];
+    double pz = parentPz[iParent];
+    double m2 = e*e - px*px - py*py - pz*pz;
+    double m  = (m2>0.0) ? sqrt(m2) : 0.0;
+    double gamma = (m>0.0) ? e/m : 1.0;
+    vx[iParent] = px/e;
+    vy[iParent] = py/e;
+    vz[iParent] = pz/e;
+    parentMasses[iParent] = m;
+    double timeToDecay = -3.0E23 * gamma * decayTable.getLifeTime(parentTypes[iParent]) * log(rTime[iParent]); // fm
+    parentX[iParent] += vx[iParent]*timeToDecay;
+    parentY[iParent] += vy[iParent]*timeToDecay;
+    parentZ[iParent] += vz[iParent]*timeToDecay;
+    parentT[iParent] += timeToDecay;
+    }
+}
+
+void ParticleDecayCascade::decayTwoBody()
+{
+  unsigned int nParents = parents.size();
+  randoms.resize(2*nParents);
+  random->RndmArray(2*nParents, randoms.data());
+  for (unsigned int iParent=0; iParent<nParents; iParent++)
+    {
+    int iChannel = parentChannels[iParent];
+    if (iChannel<0 || decayTable.getNChildren(iChannel)!=2) continue;
+    int    iType = parentTypes[iParent];
+    double m1 = decayTable.getChildMass(iChannel,0);
+    double m2 = decayTable.getChildMass(iChannel,1);
+    double minMass = decayTable.getMinMass(iChannel);
+    double mp = parentMasses[iParent];
+    double p;
+    if (fabs(mp-decayTable.getMass(iType)) < 1.0E-9*mp)
+      p = decayTable.getTwoBodyMomentum(iChannel);
+    else
+      {
+      if (mp < minMass) mp = 1.02*minMass;
+      p = ParticleDecayTable::twoBodyMomentum(mp, m1, m2);
+      }
+    double phi      = twoPi*randoms[2*iParent];
+    double cosTheta = 2.0*randoms[2*iParent+1] - 1.0;
+    double sinTheta = sqrt(1.0 - cosTheta*cosTheta);
+    double px = p*sinTheta*cos(phi);
+    double py = p*sinTheta*sin(phi);
+    double pz = p*cosTheta;
+    addChild(iParent, decayTable.getChildType(iChannel,0),  px,  py,  pz, sqrt(p*p + m1*m1));
+    addChild(iParent, decayTable.getChildType(iChannel,1), -px, -py, -pz, sqrt(p*p + m2*m2));
+    }
+}
+
+void ParticleDecayCascade::decayThreeBody()
+{
+  unsigned int nParents = parents.size();
+  double e1, e2, e3, p1, p2, cos12;
+  for (unsigned int iParent=0; iParent<nParents; iParent++)
+    {
+    int iChannel = parentChannels[iParent];
+    if (iChannel<0 || decayTable.getNChildren(iChannel)!=3) continue;
+    double m1 = decayTable.getChildMass(iChannel,0);
+    double m2 = decayTable.getChildMass(iChannel,1);
+    double m3 = decayTable.getChildMass(iChannel,2);
+    double minMass = decayTable.getMinMass(iChannel);
+    double mp = parentMasses[iParent];
+    if (mp < minMass) mp = 1.02*minMass;
+    double deltaM = mp - minMass;
+    do {
+      do {
+        e1 = random->Rndm()*deltaM + m1;
+        e2 = random->Rndm()*deltaM + m2;
+      } while (e1 + e2 > mp);
+      p1 = sqrt(e1*e1 - m1*m1);
+      p2 = sqrt(e2*e2 - m2*m2);
+      e3 = mp - e1 - e2;
+      cos12 = (e3*e3 - p1*p1 - p2*p2 - m3*m3)/(2.*p1*p2);
+    } while (cos12 < - 1.0 || cos12 > 1.0);
+
+    double tp2x = p2*sqrt(1. - cos12*cos12);
+    double tp2z = p2*cos12;
+    double tp3x = - tp2x;
+    double tp3z = - (p1 + tp2z);
+    double phi      = twoPi*random->Rndm();
+    double ksi      = twoPi*random->Rndm();
+    double cosTheta = 2.0*random->Rndm() - 1.0;
+    double sinPhi   = sin(phi);
+    double cosPhi   = cos(phi);
+    double sinKsi   = sin(ksi);
+    double cosKsi   = cos(ksi);
+    double sinTheta = sqrt(1. - cosTheta*cosTheta);
+
+    double p1x = - p1*sinTheta*cosKsi;
+    double p1y =   p1*sinTheta*sinKsi;
+    double p1z =   p1*cosTheta;
+    double p2x = tp2x*( cosPhi*cosTheta*cosKsi - sinPhi*sinKsi) - tp2z*sinTheta*cosKsi;
+    double p2y = tp2x*(-cosPhi*cosTheta*sinKsi - sinPhi*cosKsi) + tp2z*sinTheta*sinKsi;
+    double p2z = tp2x*cosPhi*sinTheta + tp2z*cosTheta;
+    double p3x = tp3x*( cosPhi*cosTheta*cosKsi - sinPhi*sinKsi) - tp3z*sinTheta*cosKsi;
+    double p3y = tp3x*(-cosPhi*cosTheta*sinKsi - sinPhi*cosKsi) + tp3z*sinTheta*sinKsi;
+    double p3z = tp3x*cosPhi*sinTheta + tp3z*cosTheta;
+    addChild(iParent, decayTable.getChildType(iChannel,0), p1x, p1y, p1z, sqrt(m1*m1 + p1x*p1x + p1y*p1y + p1z*p1z));
+    addChild(iParent, decayTable.getChildType(iChannel,1), p2x, p2y, p2z, sqrt(m2*m2 + p2x*p2x + p2y*p2y + p2z*p2z));
+    addChild(iParent, decayTable.getChildType(iChannel,2), p3x, p3y, p3z, sqrt(m3*m3 + p3x*p3x + p3y*p3y + p3z*p3z));
+    }
+}
+
+void ParticleDecayCascade::decayNBody()
+{
+  unsigned int nParents = parents.size();
+  for (unsigned int iParent=0; iParent<nParents; iParent++)
+    {
+    int iChannel = parentChannels[iParent];
+    if (iChannel<0) continue;
+    int nChildren = decayTable.getNChildren(iChannel);
+    if (nChildren<4) continue;
+    bodyMasses.resize(nChildren);
+    bodyInvMasses.resize(nChildren);
+    bodyMomenta.resize(nChildren);
+    bodyRandoms.resize(nChildren);
+    bodyPx.resize(nChildren); bodyPy.resize(nChildren); bodyPz.resize(nChildren); bodyE.resize(nChildren);
+    for (int k=0; k<nChildren; k++) bodyMasses[k] = decayTable.getChildMass(iChannel,k);
+    double minMass = decayTable.getMinMass(iChannel);
+    double mp = parentMasses[iParent];
+    if (mp < minMass) mp = 1.02*minMass;
+    double tKin = mp - minMass;
+
+    // maximum weight of the phase space sampling
+    double eMax = tKin + bodyMasses[0];
+    double eMin = 0.0;
+    double weightMax = 1.0;
+    for (int k=1; k<nChildren; k++)
+      {
+      eMin += bodyMasses[k-1];
+      eMax += bodyMasses[k];
+      weightMax *= ParticleDecayTable::twoBodyMomentum(eMax, eMin, bodyMasses[k]);
+      }
+
+    // invariant masses of the sub-systems (0..k), sampled with the phase space weight
+    double weight;
+    do {
+      bodyRandoms[0] = 0.0;
+      for (int k=1; k<nChildren-1; k++) bodyRandoms[k] = random->Rndm();
+      bodyRandoms[nChildren-1] = 1.0;
+      sort(bodyRandoms.begin()+1, bodyRandoms.begin()+nChildren-1);
+      double sum = 0.0;
+      for (int k=0; k<nChildren; k++)
+        {
+        sum += bodyMasses[k];
+        bodyInvMasses[k] = bodyRandoms[k]*tKin + sum;
+        }
+      weight = 1.0;
+      for (int k=0; k<nChildren-1; k++)
+        {
+        bodyMomenta[k] = ParticleDecayTable::twoBodyMomentum(bodyInvMasses[k+1], bodyInvMasses[k], bodyMasses[k+1]);
+        weight *= bodyMomenta[k];
+        }
+    } while (weight < random->Rndm()*weightMax);
+
+    // momenta in the parent rest frame: each sub-system (0..k) is rotated randomly and boosted into the frame of the sub-system (0..k+1)
+    bodyPx[0] = 0.0; bodyPy[0] = bodyMomenta[0]; bodyPz[0] = 0.0;
+    bodyE[0]  = sqrt(bodyMomenta[0]*bodyMomenta[0] + bodyMasses[0]*bodyMasses[0]);
+    for (int k=1; k<nChildren; k++)
+      {
+      bodyPx[k] = 0.0; bodyPy[k] = -bodyMomenta[k-1]; bodyPz[k] = 0.0;
+      bodyE[k]  = sqrt(bodyMomenta[k-1]*bodyMomenta[k-1] + bodyMasses[k]*bodyMasses[k]);
+      double cosZ = 2.0*random->Rndm() - 1.0;
+      double sinZ = sqrt(1.0 - cosZ*cosZ);
+      double angY = twoPi*random->Rndm();
+      double cosY = cos(angY);
+      double sinY = sin(angY);
+      for (int j=0; j<=k; j++)
+        {
+        double x = bodyPx[j];
+        double y = bodyPy[j];
+        bodyPx[j] = cosZ*x - sinZ*y;
+        bodyPy[j] = sinZ*x + cosZ*y;
+        x = bodyPx[j];
+        double z = bodyPz[j];
+        bodyPx[j] = cosY*x - sinY*z;
+        bodyPz[j] = sinY*x + cosY*z;
+        }
+      if (k==nChildren-1) break;
+      double beta  = bodyMomenta[k]/sqrt(bodyMomenta[k]*bodyMomenta[k] + bodyInvMasses[k]*bodyInvMasses[k]);
+      double gamma = 1.0/sqrt(1.0 - beta*beta);
+      for (int j=0; j<=k; j++)
+        {
+        double y = bodyPy[j];
+        double e = bodyE[j];
+        bodyPy[j] = gamma*(y + beta*e);
+        bodyE[j]  = gamma*(e + beta*y);
+        }
+      }
+    for (int k=0; k<nChildren; k++)
+      addChild(iParent, decayTable.getChildType(iChannel,k), bodyPx[k], bodyPy[k], bodyPz[k], bodyE[k]);
+    }
+}
+
+unsigned int ParticleDecayCascade::emitChildren(Event & event, Factory<Particle> & factory)
+{
+  unsigned int nDecayed = 0;
+  unsigned int nChildren = childTypes.size();
+  for (unsigned int iChild=0; iChild<nChildren; iChild++)
+    {
+    unsigned int iParent = childParents[iChild];
+    Particle * child = factory.getNextObject();
+    child->set(decayTable.getType(childTypes[iChild]),
+               childPx[iChild], childPy[iChild], childPz[iChild], childE[iChild],
+               parentX[iParent], parentY[iParent], parentZ[iParent], parentT[iParent],
+               true);
+    event.add(child);
+    Particle * parent = parents[iParent];
+    if (parent->isLive())
+      {
+      parent->setDecayed(true);
+      if (!storeDecayedParents) decayedParents.push_back(parent);
+      nDecayed++;
+      }
+    }
+  return nDecayed;
+}
+
+void ParticleDecayCascade::removeDecayedParents(Event & event, unsigned long firstIndex)
+{
+  sort(decayedParents.begin(), decayedParents.end());
+  vector<Particle*> & particles = event.getParticles();
+  vector<Particle*>::iterator last = remove_if(particles.begin()+firstIndex, particles.end(),
+                                               [this](Particle * particle) { return binary_search(decayedParents.begin(), decayedParents.end(), particle); });
+  particles.erase(last, particles.end());
+  decayedParents.clear();
+}
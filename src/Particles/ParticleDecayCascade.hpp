@@ -0,0 +1,184 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticleDecayCascade
+#define CAP__ParticleDecayCascade
+#include <vector>
+#include "TRandom.h"
+#include "Factory.hpp"
+#include "Event.hpp"
+#include "Particle.hpp"
+#include "ParticleDecayTable.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Incremental resonance-decay cascade engine. All the decayable particles of an event are processed as a batch, generation by generation:
+//! the live, unstable particles of the current generation are gathered into flat (structure of arrays) momentum and position buffers,
+//! their decay channels are chosen with the alias tables of a ParticleDecayTable, the decay vertices and children momenta are computed
+//! with straight loops over the buffers, and the children are finally appended to the event. The children that are themselves unstable
+//! constitute the next generation. Parents are kept in the event and flagged as decayed.
+//!
+//! Two-body decays use the rest-frame momentum precomputed in the decay table (when the parent is at its nominal mass). Three-body decays
+//! use the same phase-space sampling as ParticleDecayer::decay3(). Channels with more than three children are sampled uniformly in
+//! N-body phase space (Raubold-Lynch method, as in TGenPhaseSpace). Channels with fewer than two children are not decayed; they are
+//! counted (see getNSkippedDecays()).
+//!
+class ParticleDecayCascade
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  ParticleDecayCascade();
+
+  //!
+  //! DTOR
+  //!
+  virtual ~ParticleDecayCascade() {}
+
+  //!
+  //! Build the decay tables for the types of the given particle database.
+  //!
+  void initialize(ParticleDb & particleDb);
+
+  //!
+  //! Decay the live, unstable particles of the given event starting at index firstIndex. Children are obtained from the given factory
+  //! and appended to the event. At most maxGenerations generations are processed (all generations if maxGenerations<0).
+  //! @return number of particles decayed.
+  //!
+  unsigned int decay(Event & event, Factory<Particle> & factory, unsigned long firstIndex=0, int maxGenerations=-1);
+
+  void setRandomGenerator(TRandom * _random) { random = _random; }
+  TRandom * getRandomGenerator() { return random; }
+
+  //!
+  //! Disable/enable the decay of particles through channels with two children.
+  //!
+  void setDisable2Prong(bool disable) { disable2Prong = disable; }
+
+  //!
+  //! Disable/enable the decay of particles through channels with three children.
+  //!
+  void setDisable3Prong(bool disable) { disable3Prong = disable; }
+
+  //!
+  //! Keep (default) or remove the decayed parents from the event.
+  //!
+  void setStoreDecayedParents(bool store) { storeDecayedParents = store; }
+
+  //!
+  //! Number of decays skipped because their channel has fewer than two children.
+  //!
+  unsigned long getNSkippedDecays() const { return nSkippedDecays; }
+
+  const ParticleDecayTable & getDecayTable() const { return decayTable; }
+
+protected:
+
+  //!
+  //! Gather the decayable particles of the event in the range [begin,end) into the parent buffers.
+  //!
+  void gatherParents(Event & event, unsigned long begin, unsigned long end);
+
+  //!
+  //! Select the decay channels and compute the decay vertices of all the parents of the current generation.
+  //!
+  void generateChannelsAndVertices();
+
+  //!
+  //! Compute the momenta of the children of all two-body decays of the current generation.
+  //!
+  void decayTwoBody();
+
+  //!
+  //! Compute the momenta of the children of all three-body decays of the current generation.
+  //!
+  void decayThreeBody();
+
+  //!
+  //! Compute the momenta of the children of all decays with more than three children of the current generation.
+  //!
+  void decayNBody();
+
+  //!
+  //! Remove the given decayed parents from the event, starting at index firstIndex.
+  //!
+  void removeDecayedParents(Event & event, unsigned long firstIndex);
+
+  //!
+  //! Append the children of the current generation to the event and flag their parents as decayed.
+  //!
+  unsigned int emitChildren(Event & event, Factory<Particle> & factory);
+
+  //!
+  //! Add a child of the given type, with momentum given in the parent rest frame, to the children buffers. The momentum is boosted
+  //! by the velocity of the parent.
+  //!
+  inline void addChild(unsigned int iParent, int iType, double px, double py, double pz, double e)
+  {
+  double bx = vx[iParent];
+  double by = vy[iParent];
+  double bz = vz[iParent];
+  double b2 = bx*bx + by*by + bz*bz;
+  double gamma = 1.0/sqrt(1.0 - b2);
+  double bp = bx*px + by*py + bz*pz;
+  double gamma2 = (b2>0.0) ? (gamma-1.0)/b2 : 0.0;
+  double f = gamma2*bp + gamma*e;
+  childParents.push_back(iParent);
+  childTypes.push_back(iType);
+  childPx.push_back(px + f*bx);
+  childPy.push_back(py + f*by);
+  childPz.push_back(pz + f*bz);
+  childE.push_back(gamma*(e + bp));
+  }
+
+  static double twoPi;
+
+  ParticleDecayTable decayTable;
+  TRandom * random;
+  bool disable2Prong;
+  bool disable3Prong;
+  bool storeDecayedParents;
+  unsigned long nSkippedDecays;
+
+  // parents of the current generation
+  vector<Particle*> parents;
+  vector<int>    parentTypes;
+  vector<int>    parentChannels;
+  vector<double> parentPx, parentPy, parentPz, parentE;
+  vector<double> parentX,  parentY,  parentZ,  parentT;
+  vector<double> parentMasses;
+  vector<double> vx, vy, vz;
+  vector<double> randoms;
+
+  // children of the current generation
+  vector<unsigned int> childParents;
+  vector<int>    childTypes;
+  vector<double> childPx, childPy, childPz, childE;
+
+  // decayed parents of all generations (used only if they are removed from the event)
+  vector<Particle*> decayedParents;
+
+  // scratch buffers of the N-body decays
+  vector<double> bodyMasses, bodyInvMasses, bodyMomenta, bodyRandoms;
+  vector<double> bodyPx, bodyPy, bodyPz, bodyE;
+
+  ClassDef(ParticleDecayCascade,0)
+};
+
+}
+
+#endif  // CAP__ParticleDecayCascade
@@ -0,0 +1,138 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "ParticleDecayTable.hpp"
+using CAP::ParticleDecayTable;
+
+ClassImp(ParticleDecayTable);
+
+ParticleDecayTable::ParticleDecayTable()
+:
+types(),
+typeMasses(),
+typeLifeTimes(),
+typeFirstChannel(),
+typeNChannels(),
+channelNChildren(),
+channelFirstChild(),
+channelMinMasses(),
+channelMomenta(),
+aliasProbabilities(),
+aliasChannels(),
+childTypes(),
+childMasses(),
+typeIndices()
+{ }
+
+void ParticleDecayTable::clear()
+{
+  types.clear();
+  typeMasses.clear();
+  typeLifeTimes.clear();
+  typeFirstChannel.clear();
+  typeNChannels.clear();
+  channelNChildren.clear();
+  channelFirstChild.clear();
+  channelMinMasses.clear();
+  channelMomenta.clear();
+  aliasProbabilities.clear();
+  aliasChannels.clear();
+  childTypes.clear();
+  childMasses.clear();
+  typeIndices.clear();
+}
+
+void ParticleDecayTable::initialize(ParticleDb & particleDb)
+{
+  clear();
+  unsigned int nTypes = particleDb.getNumberOfTypes();
+  types.reserve(nTypes);
+  for (unsigned int iType=0; iType<nTypes; iType++)
+    {
+    ParticleType * type = particleDb.getParticleType(iType);
+    types.push_back(type);
+    typeIndices[type] = iType;
+    typeMasses.push_back(type->getMass());
+    typeLifeTimes.push_back(type->getLifeTime());
+    }
+
+  vector<double> branchingRatios;
+  for (unsigned int iType=0; iType<nTypes; iType++)
+    {
+    ParticleType & type = *types[iType];
+    typeFirstChannel.push_back(channelNChildren.size());
+    int nModes = type.isStable() ? 0 : type.getNDecayModes();
+    branchingRatios.clear();
+    for (int iMode=0; iMode<nModes; iMode++)
+      {
+      ParticleDecayMode & decayMode = type.getDecayMode(iMode);
+      int nChildren = decayMode.getNChildren();
+      channelNChildren.push_back(nChildren);
+      channelFirstChild.push_back(childTypes.size());
+      double minMass = 0.0;
+      for (int iChild=0; iChild<nChildren; iChild++)
+        {
+        ParticleType & childType = decayMode.getChildType(iChild);
+        int iChildType = getTypeIndex(&childType);
+        if (iChildType<0)
+          {
+          cout << "<FATAL> ParticleDecayTable::initialize() Child type " << childType.getName() << " of " << type.getName() << " is not in the particle database." << endl;
+          exit(1);
+          }
+        childTypes.push_back(iChildType);
+        childMasses.push_back(childType.getMass());
+        minMass += childType.getMass();
+        }
+      channelMinMasses.push_back(minMass);
+      if (nChildren==2)
+        {
+        double mp = typeMasses[iType];
+        if (mp<minMass) mp = 1.02*minMass;
+        channelMomenta.push_back(twoBodyMomentum(mp, childMasses[childMasses.size()-2], childMasses.back()));
+        }
+      else
+        channelMomenta.push_back(0.0);
+      branchingRatios.push_back(decayMode.getBranchingRatio());
+      }
+    typeNChannels.push_back(nModes);
+    aliasProbabilities.resize(channelNChildren.size(), 1.0);
+    aliasChannels.resize(channelNChildren.size(), 0);
+    if (nModes>0) buildAliasTable(typeFirstChannel[iType], branchingRatios);
+    }
+}
+
+void ParticleDecayTable::buildAliasTable(int first, const vector<double> & branchingRatios)
+{
+  int n = branchingRatios.size();
+  double sum = 0.0;
+  for (int k=0; k<n; k++) sum += branchingRatios[k];
+  vector<double> scaled(n);
+  vector<int> small;
+  vector<int> large;
+  for (int k=0; k<n; k++)
+    {
+    scaled[k] = (sum>0.0) ? n*branchingRatios[k]/sum : 1.0;
+    aliasChannels[first+k] = first+k;
+    if (scaled[k]<1.0) small.push_back(k); else large.push_back(k);
+    }
+  while (!small.empty() && !large.empty())
+    {
+    int s = small.back(); small.pop_back();
+    int l = large.back(); large.pop_back();
+    aliasProbabilities[first+s] = scaled[s];
+    aliasChannels[first+s]      = first+l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+    if (scaled[l]<1.0) small.push_back(l); else large.push_back(l);
+    }
+  // remaining entries are (up to rounding) exactly 1
+  while (!large.empty()) { aliasProbabilities[first+large.back()] = 1.0; large.pop_back(); }
+  while (!small.empty()) { aliasProbabilities[first+small.back()] = 1.0; small.pop_back(); }
+}
@@ -0,0 +1,144 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__ParticleDecayTable
+#define CAP__ParticleDecayTable
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+#include "ParticleType.hpp"
+#include "ParticleDb.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Flat, precomputed decay tables for all the particle types of a ParticleDb. The tables are built once (at task initialization)
+//! and provide, per species, the nominal mass, the mean life time, and the list of decay channels. Per channel, the tables hold the number
+//! of children, the children types and masses, the two-body rest-frame momentum evaluated at the nominal parent mass, and a Walker alias
+//! table used to select a channel with a single random number in O(1), independently of the number of channels.
+//!
+//! Species and channels are identified by plain integer indices into the tables. Use getTypeIndex() to map a ParticleType onto its
+//! species index.
+//!
+class ParticleDecayTable
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  ParticleDecayTable();
+
+  //!
+  //! DTOR
+  //!
+  virtual ~ParticleDecayTable() {}
+
+  //!
+  //! Build the tables for all the types of the given particle database. The decay modes of the types must already be resolved
+  //! (see ParticleDb::resolveTypes()).
+  //!
+  void initialize(ParticleDb & particleDb);
+
+  //!
+  //! Clear the tables.
+  //!
+  void clear();
+
+  //!
+  //! Return the species index of the given type or -1 if the type is not part of the tables.
+  //!
+  inline int getTypeIndex(const ParticleType * type) const
+  {
+  unordered_map<const ParticleType*,int>::const_iterator it = typeIndices.find(type);
+  return (it==typeIndices.end()) ? -1 : it->second;
+  }
+
+  //!
+  //! Return the number of species in the tables.
+  //!
+  inline unsigned int getNTypes() const { return types.size(); }
+
+  //!
+  //! Return true if the species at the given index can be decayed, i.e., it is unstable and has at least one decay channel.
+  //!
+  inline bool isDecayable(int iType) const { return typeNChannels[iType]>0; }
+
+  inline ParticleType * getType(int iType) const    { return types[iType];         }
+  inline double getMass(int iType) const            { return typeMasses[iType];    }
+  inline double getLifeTime(int iType) const        { return typeLifeTimes[iType]; }
+
+  //!
+  //! Select a decay channel of the species at the given index based on the uniform deviate r in [0,1). Returns the (absolute) channel index.
+  //!
+  inline int generateChannel(int iType, double r) const
+  {
+  int n = typeNChannels[iType];
+  double u = r*n;
+  int k = int(u);
+  if (k>=n) k = n-1;
+  int iChannel = typeFirstChannel[iType] + k;
+  return (u-k < aliasProbabilities[iChannel]) ? iChannel : aliasChannels[iChannel];
+  }
+
+  inline int getNChildren(int iChannel) const                  { return channelNChildren[iChannel]; }
+  inline double getMinMass(int iChannel) const                 { return channelMinMasses[iChannel]; }
+  inline double getTwoBodyMomentum(int iChannel) const         { return channelMomenta[iChannel];   }
+  inline int getChildType(int iChannel, int iChild) const      { return childTypes[channelFirstChild[iChannel]+iChild];  }
+  inline double getChildMass(int iChannel, int iChild) const   { return childMasses[channelFirstChild[iChannel]+iChild]; }
+
+  //!
+  //! Compute the two-body decay momentum in the rest frame of a parent of mass mp decaying into children of mass m1 and m2.
+  //!
+  static inline double twoBodyMomentum(double mp, double m1, double m2)
+  {
+  double temp = mp*mp - m1*m1 - m2*m2;
+  double arg  = temp*temp - 4*m1*m1*m2*m2;
+  return (arg>0.0) ? sqrt(arg)/(2*mp) : 0.0;
+  }
+
+protected:
+
+  //!
+  //! Fill the alias table of the channels [first, first+n) from the given branching ratios (Walker/Vose method).
+  //!
+  void buildAliasTable(int first, const vector<double> & branchingRatios);
+
+  // per species
+  vector<ParticleType*> types;           //!< types at each species index
+  vector<double> typeMasses;             //!< nominal mass
+  vector<double> typeLifeTimes;          //!< mean life time
+  vector<int>    typeFirstChannel;       //!< index of the first decay channel of each species
+  vector<int>    typeNChannels;          //!< number of decay channels of each species (0 if stable)
+
+  // per channel
+  vector<int>    channelNChildren;       //!< number of children
+  vector<int>    channelFirstChild;      //!< index of the first child in the children arrays
+  vector<double> channelMinMasses;       //!< sum of the children masses
+  vector<double> channelMomenta;         //!< two-body rest-frame momentum at the nominal parent mass (0 for other channels)
+  vector<double> aliasProbabilities;     //!< alias table: probability of keeping the channel
+  vector<int>    aliasChannels;          //!< alias table: alternative channel
+
+  // per child
+  vector<int>    childTypes;             //!< species index of each child
+  vector<double> childMasses;            //!< nominal mass of each child
+
+  unordered_map<const ParticleType*,int> typeIndices;
+
+  ClassDef(ParticleDecayTable,0)
+};
+
+}
+
+#endif  // CAP__ParticleDecayTable
@@ -12,6 +12,7 @@
 #ifndef CAP__ParticleDecayerTask
 #define CAP__ParticleDecayerTask
 #include "ParticleDecayer.hpp"
+#include "ParticleDecayCascade.hpp"
 #include "EventTask.hpp"
 #include "Event.hpp"
 #include "Particle.hpp"
@@ -23,16 +24,20 @@ namespace CAP
 //!
 //! Task handles the decay of all decayable particles in the incoming event stream. At execution time, i.e., for each event encountered,
 //! each particle of the input stream is examined to determine whether it should be decayed. Particle deemed decayable are passed to the
-//! decay handler (decayer) and decayed.  Currently, the decayer handles two and three particle decays. Decayed particles are kept in the
+//! decay handler (decayer) and decayed.  Decays into two, three, or more particles are handled. Decayed particles are kept in the
 //! event stream but tagged as decayed. Child particles are inserted in the stream and tagged as "live" (undecayed).  Child particles that
 //! are themselves decayable are decayed iteratively. 
 //!
+//! The decays are carried out by a ParticleDecayCascade engine which processes all the decayable particles of the event
+//! generation by generation based on precomputed decay tables.
+//!
 class ParticleDecayerTask : public EventTask
 {
 
 protected:
   
   ParticleDecayer decayer; //!< Particle decay handler
+  ParticleDecayCascade cascade; //!< Batch decay engine used by execute()
 
 public:
 
@@ -59,17 +64,32 @@ public:
   //! Sets the default  values of the configuration parameters used by this task
   //!
   virtual void setDefaultConfiguration();
+
+  //!
+  //! Initialize this task and build the decay tables of the cascade engine.
+  //!
+  virtual void initialize();
   
   //!
   //! Execute this task based on the configuration and class variable specified at construction
   //!
   virtual void execute();
+
+  //!
+  //! Finalize this task and report the decays skipped by the cascade engine.
+  //!
+  virtual void finalize();
   
   //!
   //!Getthe decay handle (decayer) used by this task.
   //!
   ParticleDecayer & getParticleDecayer() { return decayer;}
 
+  //!
+  //! Get the cascade engine used by this task.
+  //!
+  ParticleDecayCascade & getParticleDecayCascade() { return cascade;}
+
   ClassDef(ParticleDecayerTask,0)
 };
 
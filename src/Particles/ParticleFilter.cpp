@@ -505,14 +505,14 @@ bool ParticleFilter::accept(const Particle & particle)
         switch (filterSubType)
           {
             case 0: value = momentum.P(); break;    // momentum
-            case 1: value = momentum.Pt(); break;   // transverse momentum
+            case 1: value = particle.getPt(); break;   // transverse momentum
             case 2: value = momentum.E(); break;    // energy
             case 3: value = momentum.Px(); break;   // p_x
             case 4: value = momentum.Py(); break;   // p_y
             case 5: value = momentum.Pz(); break;   // p_z
-            case 6: value = momentum.Phi(); break;   // phi azimuth
-            case 7: value = momentum.Eta(); break;   // pseudo rapidity
-            case 8: value = momentum.Rapidity(); break;   // rapidity
+            case 6: value = particle.getPhi(); if (value>TMath::Pi()) value -= TMath::TwoPi(); break;   // phi azimuth in (-pi,pi]
+            case 7: value = particle.getEta(); break;   // pseudo rapidity
+            case 8: value = particle.getY(); break;   // rapidity
           }
         accepting = conditions[k]->accept(value);
         break;
@@ -1140,3 +1140,85 @@ std::vector<ParticleDecayMode> ParticleType::getDecayModes() const
   return decayModes; //!<Array of decay modes
 }
 
+namespace
+{
+template <class T> inline void writeBinaryValue(ostream & os, const T & value)
+{
+  os.write((const char*) &value, sizeof(T));
+}
+
+template <class T> inline void readBinaryValue(istream & is, T & value)
+{
+  is.read((char*) &value, sizeof(T));
+}
+
+inline void writeBinaryString(ostream & os, const CAP::String & value)
+{
+  int length = value.Length();
+  writeBinaryValue(os,length);
+  os.write(value.Data(),length);
+}
+
+inline bool readBinaryString(istream & is, CAP::String & value)
+{
+  int length = 0;
+  readBinaryValue(is,length);
+  if (!is || length<0 || length>4096) return false;
+  std::string buffer(length,' ');
+  is.read(&buffer[0],length);
+  value = buffer.c_str();
+  return bool(is);
+}
+}
+
+void ParticleType::writeProperties(ostream & os) const
+{
+  writeBinaryString(os,name);
+  writeBinaryString(os,title);
+  writeBinaryValue(os,index);
+  writeBinaryValue(os,privateCode);
+  writeBinaryValue(os,pdgCode);
+  writeBinaryValue(os,mass);
+  writeBinaryValue(os,charge);
+  writeBinaryValue(os,width);
+  writeBinaryValue(os,spin);
+  writeBinaryValue(os,isospin);
+  writeBinaryValue(os,isospin3);
+  int numbers[15] = { nq, naq, ns, nas, nc, nac, nb, nab, nt, nat, leptonElectron, leptonMuon, leptonTau, stable, weakStable };
+  writeBinaryValue(os,numbers);
+  writeBinaryValue(os,spinFactor);
+  writeBinaryValue(os,isospinFactor);
+  writeBinaryValue(os,statistics);
+}
+
+bool ParticleType::readProperties(istream & is)
+{
+  if (!readBinaryString(is,name))  return false;
+  if (!readBinaryString(is,title)) return false;
+  readBinaryValue(is,index);
+  readBinaryValue(is,privateCode);
+  readBinaryValue(is,pdgCode);
+  readBinaryValue(is,mass);
+  readBinaryValue(is,charge);
+  readBinaryValue(is,width);
+  readBinaryValue(is,spin);
+  readBinaryValue(is,isospin);
+  readBinaryValue(is,isospin3);
+  int numbers[15];
+  readBinaryValue(is,numbers);
+  nq  = numbers[0];  naq = numbers[1];
+  ns  = numbers[2];  nas = numbers[3];
+  nc  = numbers[4];  nac = numbers[5];
+  nb  = numbers[6];  nab = numbers[7];
+  nt  = numbers[8];  nat = numbers[9];
+  leptonElectron = numbers[10];
+  leptonMuon     = numbers[11];
+  leptonTau      = numbers[12];
+  stable         = numbers[13];
+  weakStable     = numbers[14];
+  readBinaryValue(is,spinFactor);
+  readBinaryValue(is,isospinFactor);
+  readBinaryValue(is,statistics);
+  return bool(is);
+}
+
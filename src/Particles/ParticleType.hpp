@@ -367,6 +367,16 @@ public:
   ostream & printProperties(ostream & os);
   ostream & printDecayProperties(ostream & os);
 
+  //!
+  //! Write the properties of this particle type, excluding its decay modes, to the given binary stream.
+  //!
+  void writeProperties(ostream & os) const;
+
+  //!
+  //! Read the properties of this particle type, excluding its decay modes, from the given binary stream. Returns false if the stream is exhausted or corrupted.
+  //!
+  bool readProperties(istream & is);
+
   static  ParticleType * getDecayModeType();
   static  ParticleType * getInteractionType();
   static  ParticleType * getPPInteractionType();
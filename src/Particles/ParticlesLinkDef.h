@@ -10,9 +10,12 @@
 #pragma link C++ class CAP::EventProperties+;
 #pragma link C++ class CAP::EventCountHistos+;
 #pragma link C++ class CAP::EventFilter+;
+#pragma link C++ class CAP::EventClassifier+;
 #pragma link C++ class CAP::Particle+;
 #pragma link C++ class CAP::ParticleDecayMode+;
 #pragma link C++ class CAP::ParticleDecayer+;
+#pragma link C++ class CAP::ParticleDecayTable+;
+#pragma link C++ class CAP::ParticleDecayCascade+;
 #pragma link C++ class CAP::ParticleDecayerTask+;
 #pragma link C++ class CAP::ParticleDigit+;
 #pragma link C++ class CAP::ParticleType+;
@@ -28,4 +31,10 @@
 #pragma link C++ class CAP::Filter<CAP::Particle>+;
 #pragma link C++ class CAP::Collection<CAP::ParticleType>+;
 #pragma link C++ class CAP::EventTask+;
+#pragma link C++ class CAP::ParticleBinning+;
+#pragma link C++ class CAP::EventAnalysisContext+;
+#pragma link C++ class CAP::EventCacheBlock+;
+#pragma link C++ class CAP::EventCache+;
+#pragma link C++ class CAP::EventCacheTask+;
+#pragma link C++ class CAP::SelectionVariation+;
 #endif
@@ -56,6 +56,8 @@ public:
   dataInputTreeName("tree"),
   firstFile(-1),
   lastFile(-1),
+  fileShard(0),
+  nFileShards(1),
   clonesMaxArraySize(1000),
   randomizeEventPlane(false),
   inputRootChain(nullptr),
@@ -95,6 +97,8 @@ public:
   Task::addParameter("DataInputTree",          TString("tree"));
   Task::addParameter("EventsImportFileMinIndex", -1);
   Task::addParameter("EventsImportFileMaxIndex", -1);
+  Task::addParameter("EventsImportFileShard",    0);
+  Task::addParameter("EventsImportFileNShards",  1);
   Task::addParameter("RemovePhotons",         true);
   Task::addParameter("StandaloneMode",        true);
   Task::addParameter("ClonesMaxArraySize",    10000);
@@ -115,6 +119,8 @@ public:
   dataInputTreeName     = Task::getValueString("DataInputTree");
   firstFile             = Task::getValueInt(   "EventsImportFileMinIndex");
   lastFile              = Task::getValueInt(   "EventsImportFileMaxIndex");
+  fileShard             = Task::getValueInt(   "EventsImportFileShard");
+  nFileShards           = Task::getValueInt(   "EventsImportFileNShards");
   clonesMaxArraySize    = Task::getValueInt(   "ClonesMaxArraySize");
   randomizeEventPlane   = Task::getValueBool(  "RandomizeEventPlane");
 
@@ -151,7 +157,9 @@ public:
   if (firstFile < 0) firstFile = 0;
   if (lastFile < 0)  lastFile  = selectedFileNames.size();
   if (lastFile > int(selectedFileNames.size())) lastFile  = selectedFileNames.size();
-  for(int iFile=firstFile; iFile<lastFile; iFile++)
+  // When the input is shared by several processes (see RunAnalysis), this reader uses every nFileShards-th file starting at fileShard.
+  if (nFileShards<1) nFileShards = 1;
+  for(int iFile=firstFile+fileShard; iFile<lastFile; iFile+=nFileShards)
     {
     String fileName = selectedFileNames[iFile];
     if (!fileName.EndsWith(".root")) fileName += ".root";
@@ -217,6 +225,21 @@ public:
   {
   return inputRootTreeIndex;
   }
+
+  //!
+  //! Save (restore) the position of this reader in its input chain in (from) a checkpoint file.
+  //!
+  virtual void saveCheckpoint(TFile & outputFile)
+  {
+  writeCheckpointValue(outputFile,"entryIndex",entryIndex);
+  EventTask::saveCheckpoint(outputFile);
+  }
+
+  virtual void loadCheckpoint(TFile & inputFile)
+  {
+  entryIndex = readCheckpointValue(inputFile,"entryIndex",entryIndex);
+  EventTask::loadCheckpoint(inputFile);
+  }
   
 protected:
   
@@ -280,6 +303,8 @@ protected:
   String dataInputTreeName;
   int  firstFile;
   int  lastFile;
+  int  fileShard;
+  int  nFileShards;
   int  clonesMaxArraySize;
   bool randomizeEventPlane;
   
@@ -0,0 +1,120 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "SelectionVariation.hpp"
+using CAP::SelectionVariation;
+
+ClassImp(SelectionVariation);
+
+SelectionVariation::SelectionVariation()
+:
+name("Variation"),
+min_pt(-1.0E10),
+max_pt(1.0E10),
+min_eta(-1.0E10),
+max_eta(1.0E10),
+min_y(-1.0E10),
+max_y(1.0E10),
+min_phi(-1.0E10),
+max_phi(1.0E10)
+{
+}
+
+SelectionVariation::SelectionVariation(const String & _name,
+                                       double _min_pt,  double _max_pt,
+                                       double _min_eta, double _max_eta,
+                                       double _min_y,   double _max_y,
+                                       double _min_phi, double _max_phi)
+:
+name(_name),
+min_pt(_min_pt),
+max_pt(_max_pt),
+min_eta(_min_eta),
+max_eta(_max_eta),
+min_y(_min_y),
+max_y(_max_y),
+min_phi(_min_phi),
+max_phi(_max_phi)
+{
+}
+
+void SelectionVariation::select(const vector<SelectionVariation> & variations,
+                                const vector<ParticleDigit*> & digits,
+                                vector<unsigned int> & masks,
+                                vector< vector<ParticleDigit*> > & selected)
+{
+  unsigned int nVariations = variations.size();
+  unsigned int nDigits     = digits.size();
+  masks.assign(nDigits,0);
+  selected.resize(nVariations);
+  for (unsigned int k=0; k<nVariations; k++) selected[k].clear();
+  for (unsigned int iDigit=0; iDigit<nDigits; iDigit++)
+    {
+    const ParticleDigit & digit = *digits[iDigit];
+    unsigned int mask = 0;
+    for (unsigned int k=0; k<nVariations; k++)
+      {
+      if (variations[k].accept(digit)) mask |= (1u<<k);
+      }
+    masks[iDigit] = mask;
+    }
+  for (unsigned int k=0; k<nVariations; k++)
+    {
+    unsigned int bit = 1u<<k;
+    vector<ParticleDigit*> & list = selected[k];
+    for (unsigned int iDigit=0; iDigit<nDigits; iDigit++)
+      {
+      if (masks[iDigit] & bit) list.push_back(digits[iDigit]);
+      }
+    }
+}
+
+void SelectionVariation::addParameters(ConfigurationManager & task)
+{
+  task.addParameter("nVariations", 0);
+  for (int k=0; k<maxVariations; k++)
+    {
+    String baseName = "Variation";
+    baseName += k;
+    String name = "Var";
+    name += k;
+    task.addParameter(baseName+"_Name",    name);
+    task.addParameter(baseName+"_Min_pt",  -1.0E10);
+    task.addParameter(baseName+"_Max_pt",   1.0E10);
+    task.addParameter(baseName+"_Min_eta", -1.0E10);
+    task.addParameter(baseName+"_Max_eta",  1.0E10);
+    task.addParameter(baseName+"_Min_y",   -1.0E10);
+    task.addParameter(baseName+"_Max_y",    1.0E10);
+    task.addParameter(baseName+"_Min_phi", -1.0E10);
+    task.addParameter(baseName+"_Max_phi",  1.0E10);
+    }
+}
+
+void SelectionVariation::readVariations(ConfigurationManager & task, vector<SelectionVariation> & variations)
+{
+  int nVariations = task.getValueInt("nVariations");
+  if (nVariations>maxVariations)
+    {
+    if (task.reportWarning(__FUNCTION__)) cout << "nVariations:" << nVariations << " exceeds the maximum:" << maxVariations << endl;
+    nVariations = maxVariations;
+    }
+  variations.clear();
+  for (int k=0; k<nVariations; k++)
+    {
+    String baseName = "Variation";
+    baseName += k;
+    variations.push_back(SelectionVariation(task.getValueString(baseName+"_Name"),
+                                            task.getValueDouble(baseName+"_Min_pt"),  task.getValueDouble(baseName+"_Max_pt"),
+                                            task.getValueDouble(baseName+"_Min_eta"), task.getValueDouble(baseName+"_Max_eta"),
+                                            task.getValueDouble(baseName+"_Min_y"),   task.getValueDouble(baseName+"_Max_y"),
+                                            task.getValueDouble(baseName+"_Min_phi"), task.getValueDouble(baseName+"_Max_phi")));
+    }
+}
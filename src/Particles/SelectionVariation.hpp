@@ -0,0 +1,87 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__SelectionVariation
+#define CAP__SelectionVariation
+#include <vector>
+#include "ParticleDigit.hpp"
+#include "ConfigurationManager.hpp"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Variation of the kinematic selection of particles (pt, eta, y, and phi ranges) applied on top of the particles already accepted and
+//! digitized by the base particle filters of an analyzer. Used to fill the histograms of several systematic variations from the same
+//! digitized particles in a single event loop.
+//!
+class SelectionVariation
+{
+public:
+
+  SelectionVariation();
+
+  SelectionVariation(const String & _name,
+                     double _min_pt,  double _max_pt,
+                     double _min_eta, double _max_eta,
+                     double _min_y,   double _max_y,
+                     double _min_phi, double _max_phi);
+
+  virtual ~SelectionVariation() {}
+
+  inline bool accept(const ParticleDigit & digit) const
+  {
+  return digit.pt>=min_pt   && digit.pt<max_pt &&
+         digit.eta>=min_eta && digit.eta<max_eta &&
+         digit.y>=min_y     && digit.y<max_y &&
+         digit.phi>=min_phi && digit.phi<max_phi;
+  }
+
+  //!
+  //! Select the given digits with the given variations: the bit k of masks[i] is set if the digit i is accepted by the variation k, and
+  //! selected[k] receives the digits accepted by the variation k. Each digit is tested once against all the variations.
+  //!
+  static void select(const vector<SelectionVariation> & variations,
+                     const vector<ParticleDigit*> & digits,
+                     vector<unsigned int> & masks,
+                     vector< vector<ParticleDigit*> > & selected);
+
+  //!
+  //! Register with the given task the parameters of the variations: nVariations and, for k < maxVariations, VariationK_Name and
+  //! VariationK_Min_pt, VariationK_Max_pt, ..., VariationK_Max_phi. Called by the analyzers from setDefaultConfiguration.
+  //!
+  static void addParameters(ConfigurationManager & task);
+
+  //!
+  //! Read the nVariations variations configured for the given task into variations. Called by the analyzers from configure.
+  //!
+  static void readVariations(ConfigurationManager & task, vector<SelectionVariation> & variations);
+
+  static const int maxVariations = 10; //!< maximum number of variations of an analyzer
+
+  String name;
+  double min_pt;
+  double max_pt;
+  double min_eta;
+  double max_eta;
+  double min_y;
+  double max_y;
+  double min_phi;
+  double max_phi;
+
+  ClassDef(SelectionVariation,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__SelectionVariation */
@@ -9,6 +9,7 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <TMath.h>
 #include "MeasurementPerformanceSimulator.hpp"
 using CAP::MeasurementPerformanceSimulator;
 
@@ -20,7 +21,15 @@ MeasurementPerformanceSimulator::MeasurementPerformanceSimulator(const String &
                                                                  vector<ParticleFilter*>& _particleFilters)
 :
 EventTask(_name,_configuration,_eventFilters,_particleFilters),
-allEventsUseSameFilters(true)
+allEventsUseSameFilters(true),
+genParticles(),
+genPt(),
+genEta(),
+genPhi(),
+recoIndices(),
+recoPt(),
+recoEta(),
+recoPhi()
 {
   appendClassName("MeasurementPerformanceSimulator");
 }
@@ -209,23 +218,53 @@ void MeasurementPerformanceSimulator::createEvent()
       {
       ParticleFilter  * particleFilter  = particleFilters[iParticleFilter];
       ParticlePerformanceSimulator * simulator = (ParticlePerformanceSimulator *) histogramManager.getGroup(0,iParticleFilter);
+      // gather the kinematics of the particles accepted by the filter and submit them as a batch to the simulator
+      genParticles.clear();
+      genPt.clear();
+      genEta.clear();
+      genPhi.clear();
       for (unsigned int iParticle=0; iParticle<nParticles; iParticle++)
         {
         Particle * genParticle = genEvent.getParticleAt(iParticle);
-        if (particleFilter->accept(*genParticle))
-          {
-          LorentzVector & genMomentum = genParticle->getMomentum();
-          if (!simulator->accept(genMomentum)) continue;
-          ParticleType * type = genParticle->getTypePtr();
-          LorentzVector & genPosition = genParticle->getPosition();
-          simulator->smearMomentum(genMomentum,recoMomentum);
-          Particle * recoParticle = particleFactory->getNextObject();
-          // we dont smear the position for now..
-          recoParticle->set(type,recoMomentum,genPosition,true);
-          recoParticle->setTruth(genParticle);
-          recoEvent.add(recoParticle);
-          } // particle accepted by filter
+        if (!particleFilter->accept(*genParticle)) continue;
+        double phi = genParticle->getPhi();
+        if (phi>TMath::Pi()) phi -= TMath::TwoPi(); // the resolution maps use phi in (-pi,pi]
+        genParticles.push_back(genParticle);
+        genPt.push_back(genParticle->getPt());
+        genEta.push_back(genParticle->getEta());
+        genPhi.push_back(phi);
         } //particle loop
+      unsigned int nGen = genParticles.size();
+      if (nGen<1) continue;
+      recoIndices.resize(nGen);
+      recoPt.resize(nGen);
+      recoEta.resize(nGen);
+      recoPhi.resize(nGen);
+      unsigned int nReco = simulator->acceptAndSmear(nGen, genPt.data(), genEta.data(), genPhi.data(),
+                                                     recoIndices.data(), recoPt.data(), recoEta.data(), recoPhi.data());
+      for (unsigned int iReco=0; iReco<nReco; iReco++)
+        {
+        Particle * genParticle = genParticles[recoIndices[iReco]];
+        LorentzVector & genPosition = genParticle->getPosition();
+        double smearedPt  = recoPt[iReco];
+        double smearedEta = recoEta[iReco];
+        double smearedPhi = recoPhi[iReco];
+        if (smearedPt<0.001) smearedPt = 0.001;
+        double mt2  = genParticle->getMt()*genParticle->getMt();
+        double mass2 = mt2 - genParticle->getPt()*genParticle->getPt();
+        double mass = (mass2>0.0) ? sqrt(mass2) : 0.0;
+        recoMomentum.SetPtEtaPhiM(smearedPt,smearedEta,smearedPhi,mass);
+        Particle * recoParticle = particleFactory->getNextObject();
+        // we dont smear the position for now..
+        recoParticle->set(genParticle->getTypePtr(),recoMomentum,genPosition,true);
+        // kinematics are at hand: fill the reco particle cache directly
+        double recoMt = sqrt(mass*mass + smearedPt*smearedPt);
+        smearedPhi = atan2(sin(smearedPhi),cos(smearedPhi));
+        if (smearedPhi<0.0) smearedPhi += TMath::TwoPi();
+        recoParticle->setKinematics(smearedPt,smearedEta,smearedPhi,asinh(smearedPt*sinh(smearedEta)/recoMt),recoMt);
+        recoParticle->setTruth(genParticle);
+        recoEvent.add(recoParticle);
+        } // accepted particle loop
       } // particle filter loop
     } // event filter loop
 
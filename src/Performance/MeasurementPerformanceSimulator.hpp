@@ -29,7 +29,8 @@ namespace CAP
 //! class and the momentum (pt, eta, and phi) of each accepted/detected particle is then smeared.
 //! Particles that are accepted and smeared are inserted in event stream 1 (generator level particles are in stream 0).
 //! It is then possible for performance analysis tasks to direct compare particles of the two stream,
-//! carry out closure tests and so on.
+//! carry out closure tests and so on. The particles accepted by each filter are submitted as a single batch to
+//! ParticlePerformanceSimulator::acceptAndSmear().
 //!
 //!Configuration parameters of the MeasurementPerformanceSimulator class are as follows
 //!
@@ -85,6 +86,17 @@ protected:
   bool  allEventsUseSameFilters;
   unsigned int nEventFilters;
   unsigned int nParticleFilters;
+
+  // per filter batch buffers
+  vector<Particle*>    genParticles;
+  vector<double>       genPt;
+  vector<double>       genEta;
+  vector<double>       genPhi;
+  vector<unsigned int> recoIndices;
+  vector<double>       recoPt;
+  vector<double>       recoEta;
+  vector<double>       recoPhi;
+
   ClassDef(MeasurementPerformanceSimulator,0)
 };
 
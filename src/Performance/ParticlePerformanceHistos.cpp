@@ -10,6 +10,7 @@
  *
  * *********************************************************************/
 
+#include <TMath.h>
 #include "ParticlePerformanceHistos.hpp"
 using CAP::ParticlePerformanceHistos;
 
@@ -151,32 +152,30 @@ void ParticlePerformanceHistos::fill(Particle & recoParticle, double weight)
 
   //if (reportInfo(__FUNCTION__)) cout << "got genParticle" << endl;
 
-  LorentzVector & recoMomentum = recoParticle.getMomentum();
-  LorentzVector & genMomentum  = genParticle.getMomentum();
-
-//  if (reportInfo(__FUNCTION__)) cout << "got genMomentum" << endl;
-
   double recoPt, recoEta, recoY, recoPhi;
   double genPt, genEta, genY, genPhi;
   double dPt, dPhi, dEta, dY;
 
-  recoPt   = recoMomentum.Pt();
-  recoEta  = recoMomentum.Eta();
-  if (fillY) recoY = recoMomentum.Y();
-  recoPhi  = recoMomentum.Phi();
+  // y denotes the rapidity, as in the "y" and "#Delta y" axis titles, not p_y.
+  recoPt   = recoParticle.getPt();
+  recoEta  = recoParticle.getEta();
+  if (fillY) recoY = recoParticle.getY();
+  recoPhi  = recoParticle.getPhi();
 
   //if (reportInfo(__FUNCTION__)) cout << "got reco stuff " << endl;
 
 
-  genPt   = genMomentum.Pt();
-  genPhi  = genMomentum.Phi();
-  if (fillEta) genEta  = genMomentum.Eta();
-  if (fillY)   genY    = genMomentum.Y();
+  genPt   = genParticle.getPt();
+  genPhi  = genParticle.getPhi();
+  if (fillEta) genEta  = genParticle.getEta();
+  if (fillY)   genY    = genParticle.getY();
 
   //if (reportInfo(__FUNCTION__)) cout << "got gen stuff also " << endl;
 
   dPt  = recoPt  - genPt;
   dPhi = recoPhi - genPhi;
+  if (dPhi>TMath::Pi())        dPhi -= TMath::TwoPi();
+  else if (dPhi<=-TMath::Pi()) dPhi += TMath::TwoPi();
   if (fillEta) dEta = recoEta - genEta;
   if (fillY)   dY   = recoY   - genY;
 
@@ -12,9 +12,86 @@
 #include <TMath.h>
 #include "ParticlePerformanceSimulator.hpp"
 using CAP::ParticlePerformanceSimulator;
+using CAP::PerformanceMap;
 
 ClassImp(ParticlePerformanceSimulator);
 
+PerformanceMap::PerformanceMap()
+:
+nDimensions(0),
+xAxis(),
+yAxis(),
+zAxis(),
+values()
+{ }
+
+void PerformanceMap::clear()
+{
+  nDimensions = 0;
+  xAxis.clear();
+  yAxis.clear();
+  zAxis.clear();
+  values.assign(1,0.0);
+}
+
+void PerformanceMap::Axis::fill(const TAxis * axis)
+{
+  nBins  = axis->GetNbins();
+  nCells = nBins+2;
+  min    = axis->GetXmin();
+  max    = axis->GetXmax();
+  scale  = double(nBins)/(max-min);
+  edges.resize(nBins+1);
+  uniform = true;
+  double width = (max-min)/double(nBins);
+  for (int iBin=1; iBin<=nBins+1; iBin++)
+    {
+    edges[iBin-1] = axis->GetBinLowEdge(iBin);
+    if (fabs(edges[iBin-1] - (min + (iBin-1)*width)) > 1.0E-9*width) uniform = false;
+    }
+}
+
+void PerformanceMap::fill(const TH1 * histogram)
+{
+  clear();
+  if (!histogram) return;
+  nDimensions = histogram->GetDimension();
+  xAxis.fill(histogram->GetXaxis());
+  if (nDimensions>1) yAxis.fill(histogram->GetYaxis());
+  if (nDimensions>2) zAxis.fill(histogram->GetZaxis());
+  values.resize(xAxis.nCells*yAxis.nCells*zAxis.nCells);
+  for (int iz=0; iz<zAxis.nCells; iz++)
+    {
+    for (int iy=0; iy<yAxis.nCells; iy++)
+      {
+      for (int ix=0; ix<xAxis.nCells; ix++)
+        {
+        int bin = histogram->GetBin(ix,iy,iz);
+        values[ix + xAxis.nCells*(iy + yAxis.nCells*iz)] = histogram->GetBinContent(bin);
+        }
+      }
+    }
+}
+
+void PerformanceMap::getValues(unsigned int n, const double * x, const double * y, const double * z, double * out) const
+{
+  switch (nDimensions)
+    {
+      case 1:
+      for (unsigned int i=0; i<n; i++) out[i] = values[xAxis.findBin(x[i])];
+      break;
+      case 2:
+      for (unsigned int i=0; i<n; i++) out[i] = values[xAxis.findBin(x[i]) + xAxis.nCells*yAxis.findBin(y[i])];
+      break;
+      case 3:
+      for (unsigned int i=0; i<n; i++) out[i] = getValue(x[i],y[i],z[i]);
+      break;
+      default:
+      for (unsigned int i=0; i<n; i++) out[i] = 0.0;
+      break;
+    }
+}
+
 ParticlePerformanceSimulator::ParticlePerformanceSimulator(Task * _parent,
                                                            int _filterIndex,
                                                            const String & _name,
@@ -31,9 +108,27 @@ biasEtaHistogram(),
 rmsEtaHistogram(),
 biasPhiHistogram(),
 rmsPhiHistogram(),
+efficienyHistogram(),
 ptFunction(),
 etaFunction(),
-phiFunction()
+phiFunction(),
+efficiencyFunction(),
+biasPtMap(),
+rmsPtMap(),
+biasEtaMap(),
+rmsEtaMap(),
+biasPhiMap(),
+rmsPhiMap(),
+efficiencyMap(),
+randoms(),
+gaussians(),
+biases(),
+rmss(),
+efficiencies(),
+acceptances(),
+acceptedPt(),
+acceptedEta(),
+acceptedPhi()
 {
   //  initialize();
 }
@@ -227,6 +322,7 @@ void ParticlePerformanceSimulator::importHistograms(TFile & inputFile)
       efficienyHistogram   = loadH1(inputFile,baseName+"_Eff");
       break;
     }
+  resolveMaps();
   if (reportEnd(__FUNCTION__))
     ;
 }
@@ -406,4 +502,129 @@ bool ParticlePerformanceSimulator::acceptFromFunction(double pt, double eta, dou
   return accepting;
 }
 
+void ParticlePerformanceSimulator::resolveMaps()
+{
+  biasPtMap.fill(biasPtHistogram);
+  rmsPtMap.fill(rmsPtHistogram);
+  biasEtaMap.fill(biasEtaHistogram);
+  rmsEtaMap.fill(rmsEtaHistogram);
+  biasPhiMap.fill(biasPhiHistogram);
+  rmsPhiMap.fill(rmsPhiHistogram);
+  efficiencyMap.fill(efficienyHistogram);
+}
 
+void ParticlePerformanceSimulator::generateGaussians(unsigned int n)
+{
+  unsigned int nPairs = (n+1)/2;
+  randoms.resize(2*nPairs);
+  gaussians.resize(2*nPairs);
+  gRandom->RndmArray(2*nPairs, randoms.data());
+  const double twoPi = TMath::TwoPi();
+  for (unsigned int iPair=0; iPair<nPairs; iPair++)
+    {
+    double u1 = randoms[2*iPair];
+    double u2 = randoms[2*iPair+1];
+    if (u1<=0.0) u1 = 1.0E-300;
+    double r   = sqrt(-2.0*log(u1));
+    double phi = twoPi*u2;
+    gaussians[2*iPair]   = r*cos(phi);
+    gaussians[2*iPair+1] = r*sin(phi);
+    }
+}
+
+void ParticlePerformanceSimulator::smearComponent(unsigned int n, const double * pt, const double * eta, const double * phi,
+                                                  const double * in, double * out, const double * gauss,
+                                                  ResolutionFunction * f, const PerformanceMap & biasMap, const PerformanceMap & rmsMap)
+{
+  double * bias = biases.data();
+  double * rms  = rmss.data();
+  if (f)
+    f->getBiasAndRms(n, pt, eta, phi, bias, rms);
+  else
+    {
+    biasMap.getValues(n, pt, eta, phi, bias);
+    rmsMap.getValues(n, pt, eta, phi, rms);
+    }
+  for (unsigned int i=0; i<n; i++) out[i] = in[i] + bias[i] + rms[i]*gauss[i];
+}
+
+void ParticlePerformanceSimulator::smearMomenta(unsigned int n, const double * pt, const double * eta, const double * phi,
+                                                double * smearedPt, double * smearedEta, double * smearedPhi)
+{
+  switch (resolutionOption)
+    {
+      default:
+      case 0:
+      for (unsigned int i=0; i<n; i++)
+        {
+        smearedPt[i]  = pt[i];
+        smearedEta[i] = eta[i];
+        smearedPhi[i] = phi[i];
+        }
+      break;
+
+      case 1:
+      case 2:
+      biases.resize(n);
+      rmss.resize(n);
+      generateGaussians(3*n);
+      if (resolutionOption==1)
+        {
+        smearComponent(n, pt, eta, phi, pt,  smearedPt,  gaussians.data(),     ptFunction,  biasPtMap,  rmsPtMap);
+        smearComponent(n, pt, eta, phi, eta, smearedEta, gaussians.data()+n,   etaFunction, biasEtaMap, rmsEtaMap);
+        smearComponent(n, pt, eta, phi, phi, smearedPhi, gaussians.data()+2*n, phiFunction, biasPhiMap, rmsPhiMap);
+        }
+      else
+        {
+        smearComponent(n, pt, eta, phi, pt,  smearedPt,  gaussians.data(),     nullptr, biasPtMap,  rmsPtMap);
+        smearComponent(n, pt, eta, phi, eta, smearedEta, gaussians.data()+n,   nullptr, biasEtaMap, rmsEtaMap);
+        smearComponent(n, pt, eta, phi, phi, smearedPhi, gaussians.data()+2*n, nullptr, biasPhiMap, rmsPhiMap);
+        }
+      break;
+    }
+}
+
+unsigned int ParticlePerformanceSimulator::accept(unsigned int n, const double * pt, const double * eta, const double * phi, unsigned char * accepted)
+{
+  if (efficiencyOption!=1 && efficiencyOption!=2)
+    {
+    for (unsigned int i=0; i<n; i++) accepted[i] = 1;
+    return n;
+    }
+  efficiencies.resize(n);
+  randoms.resize(n);
+  if (efficiencyOption==1)
+    efficiencyFunction->getEfficiencies(n, pt, eta, phi, efficiencies.data());
+  else
+    efficiencyMap.getValues(n, pt, eta, phi, efficiencies.data());
+  gRandom->RndmArray(n, randoms.data());
+  unsigned int nAccepted = 0;
+  for (unsigned int i=0; i<n; i++)
+    {
+    accepted[i] = randoms[i]<efficiencies[i];
+    nAccepted += accepted[i];
+    }
+  return nAccepted;
+}
+
+unsigned int ParticlePerformanceSimulator::acceptAndSmear(unsigned int n, const double * pt, const double * eta, const double * phi,
+                                                          unsigned int * indices, double * smearedPt, double * smearedEta, double * smearedPhi)
+{
+  acceptances.resize(n);
+  accept(n, pt, eta, phi, acceptances.data());
+  acceptedPt.resize(n);
+  acceptedEta.resize(n);
+  acceptedPhi.resize(n);
+  unsigned int nAccepted = 0;
+  for (unsigned int i=0; i<n; i++)
+    {
+    if (!acceptances[i]) continue;
+    indices[nAccepted]     = i;
+    acceptedPt[nAccepted]  = pt[i];
+    acceptedEta[nAccepted] = eta[i];
+    acceptedPhi[nAccepted] = phi[i];
+    nAccepted++;
+    }
+  smearMomenta(nAccepted, acceptedPt.data(), acceptedEta.data(), acceptedPhi.data(), smearedPt, smearedEta, smearedPhi);
+  return nAccepted;
+}
@@ -11,13 +11,90 @@
  * *********************************************************************/
 #ifndef CAP__ParticlePerformanceSimulator
 #define CAP__ParticlePerformanceSimulator
+#include <vector>
+#include <algorithm>
+#include "TAxis.h"
 #include "HistogramGroup.hpp"
+using namespace std;
 
 namespace CAP
 {
 
 class EfficiencyFunction;
 class ResolutionFunction;
+
+//!
+//! Flat copy of the contents of a 1D, 2D, or 3D resolution or efficiency histogram. The bin contents (including under- and overflow bins)
+//! are copied once into a contiguous array and the bin lookup is carried out with inline arithmetic (uniform axes) or a binary search
+//! (variable axes) so no virtual dispatch nor histogram access is needed when the map is evaluated.
+//!
+class PerformanceMap
+{
+public:
+
+  PerformanceMap();
+  virtual ~PerformanceMap() {}
+
+  //!
+  //! Copy the contents and binning of the given histogram. The map is cleared if the histogram is null.
+  //!
+  void fill(const TH1 * histogram);
+
+  //!
+  //! Clear the map.
+  //!
+  void clear();
+
+  //!
+  //! Return true if the map holds the contents of a histogram.
+  //!
+  inline bool isFilled() const { return nDimensions>0; }
+
+  //!
+  //! Return the value of the map at the given coordinates (pt, eta, phi). Unused coordinates are ignored.
+  //!
+  inline double getValue(double x, double y, double z) const
+  {
+  return values[xAxis.findBin(x) + xAxis.nCells*(yAxis.findBin(y) + yAxis.nCells*zAxis.findBin(z))];
+  }
+
+  //!
+  //! Evaluate the map for n points given as flat arrays.
+  //!
+  void getValues(unsigned int n, const double * x, const double * y, const double * z, double * out) const;
+
+protected:
+
+  class Axis
+  {
+  public:
+    Axis() : nBins(0), nCells(1), min(0.0), max(0.0), scale(0.0), uniform(true), edges() {}
+    void fill(const TAxis * axis);
+    void clear() { nBins = 0; nCells = 1; min = 0.0; max = 0.0; scale = 0.0; uniform = true; edges.clear(); }
+    inline int findBin(double x) const
+    {
+    if (nBins==0) return 0;
+    if (x<min)    return 0;
+    if (x>=max)   return nBins+1;
+    if (uniform)  return 1 + int(scale*(x-min));
+    return int(upper_bound(edges.begin(),edges.end(),x) - edges.begin());
+    }
+    int    nBins;
+    int    nCells;
+    double min;
+    double max;
+    double scale;
+    bool   uniform;
+    vector<double> edges;
+  };
+
+  int  nDimensions;
+  Axis xAxis;
+  Axis yAxis;
+  Axis zAxis;
+  vector<double> values;
+};
+
 //!
 //!Smears the momentum of particles  based on user defined configuration parameters provided at construction
 //!of instances of this class.
@@ -55,9 +132,47 @@ public:
   bool accept(double pt, double eta, double phi);
   bool acceptFromHisto(double pt, double eta, double phi);
   bool acceptFromFunction(double pt, double eta, double phi);
-  
-  
+
+  //!
+  //! Smear the kinematics of n particles given as flat (pt, eta, phi) arrays. The bias and rms of all particles are evaluated first with
+  //! straight loops over the resolution functions or flattened resolution maps, and the Gaussian deviates are generated as a batch.
+  //!
+  virtual void smearMomenta(unsigned int n, const double * pt, const double * eta, const double * phi,
+                            double * smearedPt, double * smearedEta, double * smearedPhi);
+
+  //!
+  //! Decide the acceptance of n particles given as flat (pt, eta, phi) arrays. accepted[i] is set to 1 if particle i is accepted, 0 otherwise.
+  //! @return number of accepted particles.
+  //!
+  virtual unsigned int accept(unsigned int n, const double * pt, const double * eta, const double * phi, unsigned char * accepted);
+
+  //!
+  //! Decide the acceptance of n particles and smear the kinematics of the accepted ones. On return, indices[k] holds the position, in the
+  //! input arrays, of the k-th accepted particle and smearedPt[k], smearedEta[k], smearedPhi[k] its smeared kinematics. All output arrays
+  //! must be able to hold n values.
+  //! @return number of accepted particles.
+  //!
+  unsigned int acceptAndSmear(unsigned int n, const double * pt, const double * eta, const double * phi,
+                              unsigned int * indices, double * smearedPt, double * smearedEta, double * smearedPhi);
+
 protected:
+
+  //!
+  //! Copy the resolution and efficiency histograms into flat maps.
+  //!
+  void resolveMaps();
+
+  //!
+  //! Fill the gaussians buffer with n standard normal deviates (Box-Muller transform of a batch of uniform deviates).
+  //!
+  void generateGaussians(unsigned int n);
+
+  //!
+  //! Smear one of the kinematic variables of n particles using either the given resolution function or the given bias and rms maps.
+  //!
+  void smearComponent(unsigned int n, const double * pt, const double * eta, const double * phi,
+                      const double * in, double * out, const double * gauss,
+                      ResolutionFunction * f, const PerformanceMap & biasMap, const PerformanceMap & rmsMap);
   
   int  filterIndex;
   bool useSameSetForAll;
@@ -77,6 +192,25 @@ protected:
   ResolutionFunction* etaFunction;
   ResolutionFunction* phiFunction;
   EfficiencyFunction* efficiencyFunction;
+
+  PerformanceMap biasPtMap;
+  PerformanceMap rmsPtMap;
+  PerformanceMap biasEtaMap;
+  PerformanceMap rmsEtaMap;
+  PerformanceMap biasPhiMap;
+  PerformanceMap rmsPhiMap;
+  PerformanceMap efficiencyMap;
+
+  // batch work buffers
+  vector<double> randoms;
+  vector<double> gaussians;
+  vector<double> biases;
+  vector<double> rmss;
+  vector<double> efficiencies;
+  vector<unsigned char> acceptances;
+  vector<double> acceptedPt;
+  vector<double> acceptedEta;
+  vector<double> acceptedPhi;
   
   ClassDef(ParticlePerformanceSimulator,0)
 };
@@ -119,6 +253,29 @@ public:
     }
   return (eff<1)? eff : 1.0 ;
   }
+
+  //!
+  //! Evaluate the efficiency of n particles given as flat arrays.
+  //!
+  virtual void getEfficiencies(unsigned int n, const double * pt, const double * eta __attribute__((unused)), const double * phi __attribute__((unused)),
+                               double * eff)
+  {
+  for (unsigned int i=0; i<n; i++)
+    {
+    double arg1 = pt[i]-peakPt;
+    double e;
+    if (pt[i]<peakPt)
+      {
+      double arg2 = arg1/peakRms;
+      e = peakAmp*exp(-arg2*arg2/2.0);
+      }
+    else
+      {
+      e = peakAmp + a1*arg1 + a2*arg1*arg1;
+      }
+    eff[i] = (e<1)? e : 1.0;
+    }
+  }
   
   
 protected:
@@ -187,6 +344,40 @@ public:
   }
   return rms;
   }
+
+  //!
+  //! Evaluate the bias and rms of n particles given as flat arrays.
+  //!
+  virtual void getBiasAndRms(unsigned int n, const double * pt, const double * eta, const double * phi __attribute__((unused)),
+                             double * bias, double * rms)
+  {
+  switch (option)
+    {
+      case 0:
+      for (unsigned int i=0; i<n; i++)
+        {
+        double x = pt[i];
+        bias[i] = aInvBias/x + a0Bias + a1Bias*x + a2Bias*x*x;
+        rms[i]  = aInvRms/x  + a0Rms  + a1Rms*x  + a2Rms*x*x;
+        }
+      break;
+      case 1:
+      for (unsigned int i=0; i<n; i++)
+        {
+        double x = eta[i];
+        bias[i] = a0Bias + a1Bias*x + a2Bias*x*x;
+        rms[i]  = a0Rms  + a1Rms*x  + a2Rms*x*x;
+        }
+      break;
+      default:
+      for (unsigned int i=0; i<n; i++)
+        {
+        bias[i] = 0.0;
+        rms[i]  = 0.0;
+        }
+      break;
+    }
+  }
   
 protected:
   
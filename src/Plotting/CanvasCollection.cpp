@@ -9,6 +9,11 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <fstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "TROOT.h"
+#include "TBufferFile.h"
 #include "CanvasCollection.hpp"
 using CAP::CanvasCollection;
 using CAP::Collection;
@@ -146,6 +151,115 @@ void CanvasCollection::printAllCanvas(const String & outputPath, bool printGif,
     }
 }
 
+unsigned int CanvasCollection::getCanvasHash(TCanvas * canvas)
+{
+  TBufferFile buffer(TBuffer::kWrite);
+  buffer.WriteObject(canvas);
+  return TString::Hash(buffer.Buffer(),buffer.Length());
+}
+
+// /////////////////////////////////////////////////
+// Print Canvases with a pool of worker processes
+// /////////////////////////////////////////////////
+void CanvasCollection::printAllCanvasParallel(const String & outputPath, int nWorkers, bool skipUnchanged, bool printGif, bool printPdf, bool printSvg, bool printPng, bool printC)
+{
+  createDirectory(outputPath);
+  vector<String> extensions;
+  if (printGif) extensions.push_back(".gif");
+  if (printPdf) extensions.push_back(".pdf");
+  if (printSvg) extensions.push_back(".svg");
+  if (printPng) extensions.push_back(".png");
+  if (printC)   extensions.push_back(".C");
+
+  // select the canvases to print
+  vector<TCanvas*>     canvases;
+  vector<unsigned int> hashes;
+  vector<String>       hashFileNames;
+  for (int k=0; k<getNCanvas(); k++)
+    {
+    TCanvas * canvas = getObjectAt(k);
+    String fileName = outputPath;
+    fileName += "/";
+    fileName += canvas->GetName();
+    String hashFileName = outputPath;
+    hashFileName += "/.";
+    hashFileName += canvas->GetName();
+    hashFileName += ".hash";
+    unsigned int hash = skipUnchanged ? getCanvasHash(canvas) : 0;
+    if (skipUnchanged)
+      {
+      bool unchanged = false;
+      ifstream hashFile(hashFileName.Data());
+      unsigned int previousHash;
+      if (hashFile >> previousHash) unchanged = (previousHash==hash);
+      for (unsigned int iExt=0; unchanged && iExt<extensions.size(); iExt++)
+        {
+        // AccessPathName returns true if the file does NOT exist
+        if (gSystem->AccessPathName(fileName+extensions[iExt])) unchanged = false;
+        }
+      if (unchanged) continue;
+      }
+    canvases.push_back(canvas);
+    hashes.push_back(hash);
+    hashFileNames.push_back(hashFileName);
+    }
+  int nCanvases = canvases.size();
+  if (nCanvases<1) return;
+
+  // the canvases can be rendered in forked processes only in batch mode, i.e., without graphics system
+  if (nWorkers>nCanvases) nWorkers = nCanvases;
+  if (!gROOT->IsBatch()) nWorkers = 1;
+  vector<bool> printed(nCanvases,true);
+  if (nWorkers<=1)
+    {
+    for (int k=0; k<nCanvases; k++)
+      printCanvas(canvases[k],outputPath,printGif,printPdf,printSvg,printPng,printC);
+    }
+  else
+    {
+    cout.flush();
+    cerr.flush();
+    vector<pid_t> pids(nWorkers,-1);
+    for (int iWorker=0; iWorker<nWorkers; iWorker++)
+      {
+      pid_t pid = fork();
+      if (pid==0)
+        {
+        for (int k=iWorker; k<nCanvases; k+=nWorkers)
+          printCanvas(canvases[k],outputPath,printGif,printPdf,printSvg,printPng,printC);
+        cout.flush();
+        _exit(0);
+        }
+      pids[iWorker] = pid;
+      if (pid<0)
+        {
+        // could not fork: print this worker's share here
+        cout << "<W> CanvasCollection::printAllCanvasParallel(...) Could not fork worker " << iWorker << ". Printing its canvases sequentially." << endl;
+        for (int k=iWorker; k<nCanvases; k+=nWorkers)
+          printCanvas(canvases[k],outputPath,printGif,printPdf,printSvg,printPng,printC);
+        }
+      }
+    for (int iWorker=0; iWorker<nWorkers; iWorker++)
+      {
+      if (pids[iWorker]<0) continue;
+      int status = 0;
+      bool success = waitpid(pids[iWorker],&status,0)==pids[iWorker] && WIFEXITED(status) && WEXITSTATUS(status)==0;
+      if (success) continue;
+      cout << "<E> CanvasCollection::printAllCanvasParallel(...) Worker " << iWorker << " failed." << endl;
+      for (int k=iWorker; k<nCanvases; k+=nWorkers) printed[k] = false;
+      }
+    }
+
+  // record the hashes of the printed canvases
+  if (!skipUnchanged) return;
+  for (int k=0; k<nCanvases; k++)
+    {
+    if (!printed[k]) continue;
+    ofstream hashFile(hashFileNames[k].Data());
+    hashFile << hashes[k] << endl;
+    }
+}
+
 ////////////////////////////////////////////////////
 // Create a label within an existing pad
 ////////////////////////////////////////////////////
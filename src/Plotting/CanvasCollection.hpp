@@ -49,6 +49,21 @@ public:
 
   void printCanvas(TCanvas * canvas, const String & directoryName="./", bool printGif=0, bool printPdf=1, bool printSvg=0, bool printPng=0, bool printC=0);
   void printAllCanvas(const String & outputPath, bool printGif=0, bool printPdf=1, bool printSvg=0, bool printPng=0, bool printC=0);
+
+  //!
+  //! Print all the canvases of this collection with a pool of nWorkers worker processes, each rendering and saving every
+  //! nWorkers-th canvas. The workers are forked only in batch mode (gROOT->IsBatch()); the canvases are otherwise printed
+  //! sequentially. If skipUnchanged is true, a canvas is printed only if one of the requested output files is missing or
+  //! if its hash, i.e., the checksum of the streamed canvas and the histograms it draws, differs from the hash recorded
+  //! in outputPath/.<canvasName>.hash when it was last printed.
+  //!
+  void printAllCanvasParallel(const String & outputPath, int nWorkers, bool skipUnchanged, bool printGif=0, bool printPdf=1, bool printSvg=0, bool printPng=0, bool printC=0);
+
+  //!
+  //! Checksum of the given canvas streamed with all its primitives.
+  //!
+  static unsigned int getCanvasHash(TCanvas * canvas);
+
   TLatex * createLabel(double x, double y, int color, int fontType, double fontSize, const String & text, bool doDraw=true);
   TLegend * createLegend(float x1, float y1, float x2, float y2, int fontType, float fontSize);
   TLine * createLine(float x1, float y1, float x2, float y2, int style, int color, int width, bool doDraw=true);
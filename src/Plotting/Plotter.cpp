@@ -34,6 +34,9 @@ void Plotter::setDefaultConfiguration()
   addParameter("DoPrintPdf",             NO);
   addParameter("DoPrintSvg",             NO);
   addParameter("DoPrintPng",             YES);
+  addParameter("DoPrintC",               NO);
+  addParameter("PrintWorkers",           1);
+  addParameter("PrintSkipUnchanged",     NO);
   addParameter("UseColor",               YES);
 }
 
@@ -391,12 +394,14 @@ void Plotter::printAllCanvas(const String & outputPath, bool printGif, bool prin
 
 void Plotter::printAllCanvas(const String & outputPath)
 {
-  bool printGif = getValueBool("getVa");
-  bool printPdf = getValueBool("DoPrintPdf");
-  bool printSvg = getValueBool("DoPrintSvg");
-  bool printPng = getValueBool("DoPrintPng");
-  bool printC   = getValueBool("DoPrintC");
-  canvasCollection.printAllCanvas(outputPath, printGif, printPdf, printSvg, printPng, printC);
+  bool printGif      = getValueBool("DoPrintGif");
+  bool printPdf      = getValueBool("DoPrintPdf");
+  bool printSvg      = getValueBool("DoPrintSvg");
+  bool printPng      = getValueBool("DoPrintPng");
+  bool printC        = getValueBool("DoPrintC");
+  int  nWorkers      = getValueInt("PrintWorkers");
+  bool skipUnchanged = getValueBool("PrintSkipUnchanged");
+  canvasCollection.printAllCanvasParallel(outputPath, nWorkers, skipUnchanged, printGif, printPdf, printSvg, printPng, printC);
 }
 
 
@@ -212,6 +212,12 @@ public:
   void setDefaultOptions(bool color);
 
   void printAllCanvas(const String & outputPath, bool printGif, bool printPdf, bool printSvg, bool printPng, bool printC);
+
+  //!
+  //! Print all the canvases according to the configuration: formats DoPrintGif, DoPrintPdf, DoPrintSvg, DoPrintPng, DoPrintC;
+  //! number of worker processes PrintWorkers (used in batch mode only); and PrintSkipUnchanged to skip the canvases whose
+  //! hash is unchanged since they were last printed (see CanvasCollection::printAllCanvasParallel).
+  //!
   void printAllCanvas(const String & outputPath);
 
   CanvasCollection & getCanvases()
@@ -9,8 +9,11 @@
  * Author: Claude Pruneau,   04/01/2022
  *
  * *********************************************************************/
+#include <algorithm>
 #include "PTHistos.hpp"
+#include "PowerSumCorrelator.hpp"
 using CAP::PTHistos;
+using CAP::PowerSumCorrelator;
 
 ClassImp(PTHistos);
 
@@ -21,490 +24,516 @@ PTHistos::PTHistos(Task *          _parent,
                    int             _ord)
 :
 HistogramGroup(_parent,_name,_configuration),
-maxOrder(ord),
+maxOrder(_ord),
 histoIndex(0),
 size(0),
-numFunc(3)
+orders(nullptr),
+h_eventStreams(nullptr),
+hS(nullptr),
+hC(nullptr),
+h_eventStreams_vsMult(nullptr),
+hS_vsMult(nullptr),
+hC_vsMult(nullptr),
+h_eventStreams_vsCent(nullptr),
+hS_vsCent(nullptr),
+hC_vsCent(nullptr),
+h_counts(nullptr),
+h_counts_vsMult(nullptr),
+h_counts_vsCent(nullptr),
+numFunc(3),
+reorder(nullptr),
+totEvents(0),
+ptCorrelatorVsMult(false),
+ptCorrelatorVsCent(false),
+nBins_mult(1),
+min_mult(0.0),
+max_mult(1.0),
+nBins_cent(1),
+min_cent(0.0),
+max_cent(1.0),
+avgpT(nullptr),
+avgCounts(nullptr),
+counts(nullptr),
+SValues(nullptr),
+names(nullptr),
+titles(nullptr),
+names2(nullptr),
+titles2(nullptr)
 {
 	// no  ops
 }
 
+// the histograms are owned by the collection, only the arrays holding them are deleted here
 PTHistos::~PTHistos()
 {
-	//deleteHistograms();
+	if (hS)
+	{
+		for(int i = 0; i < numFunc; i++)
+		{
+			delete [] hS[i];
+			delete [] hS_vsMult[i];
+			delete [] hS_vsCent[i];
+			delete [] hC[i];
+			delete [] hC_vsMult[i];
+			delete [] hC_vsCent[i];
+		}
+		delete [] hS;
+		delete [] hS_vsMult;
+		delete [] hS_vsCent;
+		delete [] hC;
+		delete [] hC_vsMult;
+		delete [] hC_vsCent;
+	}
+	if (names)
+	{
+		for(int i = 0; i < numFunc; i++)
+		{
+			delete [] names[i];
+			delete [] titles[i];
+			delete [] names2[i];
+			delete [] titles2[i];
+		}
+		delete [] names;
+		delete [] titles;
+		delete [] names2;
+		delete [] titles2;
+	}
+	delete [] h_counts;
+	delete [] h_counts_vsMult;
+	delete [] h_counts_vsCent;
+	delete [] orders;
+	delete [] reorder;
+	delete [] avgpT;
+	delete [] avgCounts;
+	if (counts)
+	{
+		for(int iEvent = 0; iEvent < totEvents; iEvent++) delete [] counts[iEvent];
+		delete [] counts;
+	}
+	if (SValues)
+	{
+		for(int iEvent = 0; iEvent < totEvents; iEvent++) delete [] SValues[iEvent];
+		delete [] SValues;
+	}
 }
 
-// for now use the same boundaries for eta and y histogram
-void PTHistos::HistogramsCreate()
+////////////////////////////////////////////
+// allocate the arrays of histograms of the size functions of order 1 - maxOrder
+////////////////////////////////////////////
+void PTHistos::allocateArrays()
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::HistogramsCreate(..) started"<< endl;
-//	HeavyIonconst Configuration & ac = (HeavyIonConfiguration&)( *getConfiguration());
-//	String bn = getParentTaskName();
-//	TH1::SetDefaultBufferSize(ac.totEvents);
-//	totEvents =ac.totEvents;
-//
-//	// ================================================================================
-//	// Naming convention
-//	// ================================================================================
-//  	// S is the pT deviation moments
-//  	// s are the normalized moments
-//  	// s* are the moments normalized by inclusive average pT's
-// 	// C is the cumulants
-//	// c are the normalized cumulants
-// 	// c* are the cumulants normalizd by inclusive average pT's
-//
-//	size = (TMath::Factorial(2 * maxOrder)) / (TMath::Factorial(maxOrder ) * TMath::Factorial(maxOrder )) - 1;
-//
-//	hS = new TProfile ** [numFunc];
-//	hS_vsMult = new TProfile ** [numFunc];
-//	hS_vsCent = new TProfile ** [numFunc];
-//
-//	hC = new TH1 ** [numFunc];
-//	hC_vsMult = new TH1 ** [numFunc];
-//	hC_vsCent = new TH1 ** [numFunc];
-//
-//	names = new TString* [numFunc];
-//	titles = new String *[numFunc];
-//	names2 = new TString* [numFunc];
-//	titles2 = new String *[numFunc];
-//
-//	for(int i = 0; i < numFunc; i++)
-//	{
-//		hS[i] = new TProfile * [size];
-//		hS_vsMult[i] = new TProfile * [size];
-//		hS_vsCent[i] = new TProfile * [size];
-//
-//		hC[i] = new TH1 * [size];
-//		hC_vsMult[i] = new TH1 * [size];
-//		hC_vsCent[i] = new TH1 * [size];
-//
-//		names[i] = new String [size];
-//		titles[i] = new String [size];
-//		names2[i] = new String [size];
-//		titles2[i] = new String [size];
-//	}
-//
-//	h_counts = new TProfile*  [size];
-//	h_counts_vsMult = new TProfile * [size];
-//	h_counts_vsCent = new TProfile * [size];
-//
-//
-//	orders = new int [size];
-//
-//	h_eventStreams   = createHistogram(createName(bn,"NeventStreams"),1, 0.0, 0.0,  "mult","n_{Events}");
-//	if (ac.ptCorrelatorVsMult) h_eventStreams_vsMult = createHistogram(createName(bn,"NeventStreams_vsMult"),ac.nBins_mult, 0.0, 0.0,  "mult","n_{Events}");
-//	if (ac.ptCorrelatorVsCent) h_eventStreams_vsCent = createHistogram(createName(bn,"NeventStreams_vsCent"),ac.nBins_cent, 0.0, 0.0,  "cent","n_{Events}");
-//
-//	String * baseName = new TString[2 * numFunc + 1];
-//	baseName[0] = bn + "S_";
-//	baseName[1] = bn + "s_";
-//	baseName[2] = bn + "s*_";
-//	baseName[3] = bn + "C_";
-//	baseName[4] = bn + "c_" ;
-//	baseName[5] = bn + "c*_";
-//	baseName[6] = bn + "Counts_";
-//
-//	String * baseTitle = new TString[2 * numFunc + 1];
-//	baseTitle[0] = "S_{";
-//	baseTitle[1] = "s_{";
-//	baseTitle[2] = "s*_{";
-//	baseTitle[3] = "C_{";
-//	baseTitle[4] = "c_{";
-//	baseTitle[5] = "c*_{";
-//	baseTitle[6] = "Counts_{";
-//
-//	histoIndex = 0;
-//	createHistogramRec(baseName, baseTitle, maxOrder - 1, 0);
-//
-//	reorder = new int[size];
-//	int counter = 0;
-//	for(int iOrd = 1; iOrd <= maxOrder; iOrd++)
-//	{
-//		for(int iHisto = 0; iHisto < size; iHisto++)
-//		{
-//			if(orders[iHisto] == iOrd)
-//			{
-//				reorder[iHisto] = counter;
-//				counter++;
-//
-//			}
-//		}
-//	}
-//
-//	histoIndex = 0;
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::HistogramsCreate(..) ended"<< endl;
-//	//h_c123vsMultTest = createProfile("c123Test", ac.nBins_mult,ac.min_mult,ac.max_mult,"mult", "c123Test" );
+	// number of combinations of 1 to maxOrder particle filters out of maxOrder
+	size = int(TMath::Binomial(2 * maxOrder, maxOrder) + 0.5) - 1;
+
+	hS = new TProfile ** [numFunc];
+	hS_vsMult = new TProfile ** [numFunc];
+	hS_vsCent = new TProfile ** [numFunc];
+
+	hC = new TH1 ** [numFunc];
+	hC_vsMult = new TH1 ** [numFunc];
+	hC_vsCent = new TH1 ** [numFunc];
+
+	names = new TString* [numFunc];
+	titles = new TString* [numFunc];
+	names2 = new TString* [numFunc];
+	titles2 = new TString* [numFunc];
+
+	for(int i = 0; i < numFunc; i++)
+	{
+		hS[i] = new TProfile * [size]();
+		hS_vsMult[i] = new TProfile * [size]();
+		hS_vsCent[i] = new TProfile * [size]();
+
+		hC[i] = new TH1 * [size]();
+		hC_vsMult[i] = new TH1 * [size]();
+		hC_vsCent[i] = new TH1 * [size]();
+
+		names[i] = new TString [size];
+		titles[i] = new TString [size];
+		names2[i] = new TString [size];
+		titles2[i] = new TString [size];
+	}
+
+	h_counts = new TProfile*  [size]();
+	h_counts_vsMult = new TProfile * [size]();
+	h_counts_vsCent = new TProfile * [size]();
+
+	orders = new int [size];
 }
 
-/////////////////////////////////////////////////////////
-// needs to be fixed
-////////////////////////////////////////////////////////
-void PTHistos::HistogramsImport(TFile & inputFile)
+////////////////////////////////////////////
+// index, in "recursive order", of each histogram in normal order
+////////////////////////////////////////////
+void PTHistos::calculateReorder()
+{
+	reorder = new int[size];
+	int counter = 0;
+	for(int iOrd = 1; iOrd <= maxOrder; iOrd++)
+	{
+		for(int iHisto = 0; iHisto < size; iHisto++)
+		{
+			if(orders[iHisto] == iOrd)
+			{
+				reorder[iHisto] = counter;
+				counter++;
+			}
+		}
+	}
+}
+
+void PTHistos::readConfiguration()
+{
+	const String & ppn = getParentPathName();
+	totEvents          = configuration.getValueInt(ppn,"TotEvents");
+	ptCorrelatorVsMult = configuration.getValueBool(ppn,"PtCorrelatorVsMult");
+	ptCorrelatorVsCent = configuration.getValueBool(ppn,"PtCorrelatorVsCent");
+	nBins_mult         = configuration.getValueInt(ppn,"nBins_mult");
+	min_mult           = configuration.getValueDouble(ppn,"Min_mult");
+	max_mult           = configuration.getValueDouble(ppn,"Max_mult");
+	nBins_cent         = configuration.getValueInt(ppn,"nBins_cent");
+	min_cent           = configuration.getValueDouble(ppn,"Min_cent");
+	max_cent           = configuration.getValueDouble(ppn,"Max_cent");
+	if (reportInfo(__FUNCTION__))
+	{
+		cout << endl;
+		cout << "  PtFluc:Parent Path Name....................: " << ppn << endl;
+		cout << "  PtFluc:maxOrder............................: " << maxOrder << endl;
+		cout << "  PtFluc:totEvents...........................: " << totEvents << endl;
+		cout << "  PtFluc:ptCorrelatorVsMult..................: " << ptCorrelatorVsMult << endl;
+		cout << "  PtFluc:ptCorrelatorVsCent..................: " << ptCorrelatorVsCent << endl;
+		cout << "  PtFluc:nBins_mult..........................: " << nBins_mult << endl;
+		cout << "  PtFluc:min_mult............................: " << min_mult << endl;
+		cout << "  PtFluc:max_mult............................: " << max_mult << endl;
+		cout << "  PtFluc:nBins_cent..........................: " << nBins_cent << endl;
+		cout << "  PtFluc:min_cent............................: " << min_cent << endl;
+		cout << "  PtFluc:max_cent............................: " << max_cent << endl;
+	}
+}
+
+void PTHistos::createHistograms()
+{
+	if (reportStart(__FUNCTION__))
+		;
+	const String & bn = getName();
+	readConfiguration();
+
+	// ================================================================================
+	// Naming convention
+	// ================================================================================
+	// S is the pT deviation moments
+	// s are the normalized moments
+	// s* are the moments normalized by inclusive average pT's
+	// C is the cumulants
+	// c are the normalized cumulants
+	// c* are the cumulants normalizd by inclusive average pT's
+
+	allocateArrays();
+
+	h_eventStreams   = createHistogram(createName(bn,"NeventStreams"),1, min_mult, max_mult,  "mult","n_{Events}");
+	if (ptCorrelatorVsMult) h_eventStreams_vsMult = createHistogram(createName(bn,"NeventStreams_vsMult"),nBins_mult, min_mult, max_mult,  "mult","n_{Events}");
+	if (ptCorrelatorVsCent) h_eventStreams_vsCent = createHistogram(createName(bn,"NeventStreams_vsCent"),nBins_cent, min_cent, max_cent,  "cent","n_{Events}");
+
+	TString * baseName = new TString[2 * numFunc + 1];
+	baseName[0] = createName(bn,"S_");
+	baseName[1] = createName(bn,"s_");
+	baseName[2] = createName(bn,"s*_");
+	baseName[3] = createName(bn,"C_");
+	baseName[4] = createName(bn,"c_");
+	baseName[5] = createName(bn,"c*_");
+	baseName[6] = createName(bn,"Counts_");
+
+	TString * baseTitle = new TString[2 * numFunc + 1];
+	baseTitle[0] = "S_{";
+	baseTitle[1] = "s_{";
+	baseTitle[2] = "s*_{";
+	baseTitle[3] = "C_{";
+	baseTitle[4] = "c_{";
+	baseTitle[5] = "c*_{";
+	baseTitle[6] = "Counts_{";
+
+	histoIndex = 0;
+	createHistogramRec(baseName, baseTitle, maxOrder - 1, 0);
+	histoIndex = 0;
+	delete [] baseName;
+	delete [] baseTitle;
+
+	calculateReorder();
+	if (reportEnd(__FUNCTION__))
+		;
+}
+
+void PTHistos::importHistograms(TFile & inputFile)
 {
-//	if (!inputFile)
-//	{
-//		if (reportFatal()) cout << "-Fatal- Attempting to load NuDynHistos from an invalid file pointer" << endl;
-//		return;
-//	}
-//	const Configuration & ac = *(Configuration*) getConfiguration();
-//
-//	String  bn = getParentTaskName();
-//
-//	size = (TMath::Factorial(2 * maxOrder)) / (TMath::Factorial(maxOrder ) * TMath::Factorial(maxOrder )) - 1;
-//
-//	hS = new TProfile ** [numFunc];
-//	hS_vsMult = new TProfile ** [numFunc];
-//	hS_vsCent = new TProfile ** [numFunc];
-//
-//	hC = new TH1 ** [numFunc];
-//	hC_vsMult = new TH1 ** [numFunc];
-//	hC_vsCent = new TH1 ** [numFunc];
-//
-//	for(int i = 0; i < numFunc; i++)
-//	{
-//		hS[i] = new TProfile * [size];
-//		hS_vsMult[i] = new TProfile * [size];
-//		hS_vsCent[i] = new TProfile * [size];
-//
-//		hC[i] = new TH1 * [size];
-//		hC_vsMult[i] = new TH1 * [size];
-//		hC_vsCent[i] = new TH1 * [size];
-//	}
-//
-//	h_counts = new TProfile*  [size];
-//	h_counts_vsMult = new TProfile * [size];
-//	h_counts_vsCent = new TProfile * [size];
-//
-//
-//	orders = new int [size];
-//
-//	h_eventStreams   = loadH1(inputFile, createName(bn,"NeventStreams"));
-//	if (ac.ptCorrelatorVsMult) h_eventStreams_vsMult = loadH1(inputFile, createName(bn,"NeventStreams_vsMult"));
-//	if (ac.ptCorrelatorVsCent) h_eventStreams_vsCent = loadH1(inputFile, createName(bn,"NeventStreams_vsCent"));
-//
-//	String * baseName = new TString[numFunc + 1];
-//	baseName[0] = bn + "S_";
-//	baseName[1] = bn + "s_";
-//	baseName[2] = bn + "s*_";
-//	baseName[3] = bn + "C_";
-//	baseName[4] = bn + "c_" ;
-//	baseName[5] = bn + "c*_";
-//	baseName[6] = bn + "Counts_";
-//
-//	String * baseTitle = new TString[numFunc + 1];
-//	baseTitle[0] = "S_{";
-//	baseTitle[1] = "s_{";
-//	baseTitle[2] = "s*_{";
-//	baseTitle[3] = "C_{";
-//	baseTitle[4] = "c_{";
-//	baseTitle[5] = "c*_{";
-//	baseTitle[6] = "Counts_{";
-//
-//
-//	loadHistogramRec(baseName, maxOrder - 1, 0, inputFile);
-//
-//	histoIndex = 0;
+	if (reportStart(__FUNCTION__))
+		;
+	const String & bn = getName();
+	readConfiguration();
+	allocateArrays();
+
+	h_eventStreams   = loadH1(inputFile, createName(bn,"NeventStreams"));
+	if (ptCorrelatorVsMult) h_eventStreams_vsMult = loadH1(inputFile, createName(bn,"NeventStreams_vsMult"));
+	if (ptCorrelatorVsCent) h_eventStreams_vsCent = loadH1(inputFile, createName(bn,"NeventStreams_vsCent"));
+
+	TString * baseName = new TString[2 * numFunc + 1];
+	baseName[0] = createName(bn,"S_");
+	baseName[1] = createName(bn,"s_");
+	baseName[2] = createName(bn,"s*_");
+	baseName[3] = createName(bn,"C_");
+	baseName[4] = createName(bn,"c_");
+	baseName[5] = createName(bn,"c*_");
+	baseName[6] = createName(bn,"Counts_");
+
+	histoIndex = 0;
+	loadHistogramRec(baseName, maxOrder - 1, 0, &inputFile);
+	histoIndex = 0;
+	delete [] baseName;
+
+	calculateReorder();
+	if (reportEnd(__FUNCTION__))
+		;
 }
 
 //overloaded HistogramsExport to save histograms in sequence of lowest order to highest order
-void PTHistos::exportHistograms(TFile & outputFile, bool saveAll)
+void PTHistos::exportHistograms(TFile & outputFile, bool saveAll __attribute__((unused)))
 {
-//
-//	if (reportDebug(__FUNCTION__)) cout << "HistogramCollection::exportHistograms(TFile & outputFile) started."  << endl;
-//	outputFile->cd();
-//
-//	const Configuration & ac = *(Configuration*) getConfiguration();
-//
-//	int numTypes = 1;
-//	if (ac.ptCorrelatorVsMult) numTypes++;
-//	if (ac.ptCorrelatorVsCent) numTypes++;
-//
-//	for (int k=0; k<numTypes; k++)
-//	{
-//		if (isSaved(options[k]) || saveAll)  getObjectAt(k)->Write();
-//	}
-//
-//	for(int iFunc = 0; iFunc <= 2 * numFunc; iFunc++)
-//	{
-//		for (int i = 1; i <= maxOrder; i++)
-//		{
-//			for (int k=numTypes; k<getCollectionSize(); k++)
-//			{
-//				if(k < size * numTypes + numTypes && iFunc == 2 * numFunc)
-//				{
-//					int k1 = (k - numTypes);
-//					int orderIndex = k1 / numTypes;
-//        if ((isSaved(options[k]) || saveAll) && (orders[orderIndex] == i)) getObjectAt(k)->Write();
-//				}
-//				if(k >= size * numTypes + numTypes && k < size * (numFunc + 1) * numTypes + numTypes && iFunc < numFunc)
-//				{
-//					int k1 = k - size * numTypes - numTypes;
-//					int orderIndex = (k1 )/(numTypes * (numFunc ));
-//					int funcIndex = (k1 )/numTypes - ( (numFunc )) * ((k1)/(numTypes * (numFunc )));
-//        if ((isSaved(options[k]) || saveAll) && (orders[orderIndex] == i) && ((funcIndex) % ( numFunc) == (iFunc % ( numFunc)))) getObjectAt(k)->Write();
-//				}
-//				if(k >= size * (numFunc + 1) * numTypes + numTypes && iFunc >= numFunc && iFunc < 2 * numFunc)
-//				{
-//					int k1 = k - size * (numFunc + 1) * numTypes - numTypes;
-//					int orderIndex = (k1 )/(numTypes * (numFunc ));
-//					int funcIndex = (k1 )/numTypes - ( (numFunc )) * ((k1)/(numTypes * (numFunc )));
-//        if ((isSaved(options[k]) || saveAll) && (orders[orderIndex] == i) && ((funcIndex) % ( numFunc) == (iFunc - ( numFunc)))) getObjectAt(k)->Write();
-//				}
-//			}
-//		}
-//	}
-//
-//	if (reportDebug(__FUNCTION__)) cout << "HistogramCollection::exportHistograms(TFile & outputFile) completed."  << endl;
+	if (reportStart(__FUNCTION__))
+		;
+	outputFile.cd();
+	h_eventStreams->Write();
+	if (ptCorrelatorVsMult) h_eventStreams_vsMult->Write();
+	if (ptCorrelatorVsCent) h_eventStreams_vsCent->Write();
+
+	// counts, then S, s, s*, then C, c, c*, each from the lowest to the highest order
+	for(int iOrd = 1; iOrd <= maxOrder; iOrd++)
+	{
+		for(int iHisto = 0; iHisto < size; iHisto++)
+		{
+			if(orders[iHisto] != iOrd) continue;
+			h_counts[iHisto]->Write();
+			if (ptCorrelatorVsMult) h_counts_vsMult[iHisto]->Write();
+			if (ptCorrelatorVsCent) h_counts_vsCent[iHisto]->Write();
+		}
+	}
+	for(int iFunc = 0; iFunc < 2 * numFunc; iFunc++)
+	{
+		for(int iOrd = 1; iOrd <= maxOrder; iOrd++)
+		{
+			for(int iHisto = 0; iHisto < size; iHisto++)
+			{
+				if(orders[iHisto] != iOrd) continue;
+				if(iFunc < numFunc)
+				{
+					hS[iFunc][iHisto]->Write();
+					if (ptCorrelatorVsMult) hS_vsMult[iFunc][iHisto]->Write();
+					if (ptCorrelatorVsCent) hS_vsCent[iFunc][iHisto]->Write();
+				}
+				else
+				{
+					hC[iFunc - numFunc][iHisto]->Write();
+					if (ptCorrelatorVsMult) hC_vsMult[iFunc - numFunc][iHisto]->Write();
+					if (ptCorrelatorVsCent) hC_vsCent[iFunc - numFunc][iHisto]->Write();
+				}
+			}
+		}
+	}
+	if (reportEnd(__FUNCTION__))
+		;
 }
 
 
 void PTHistos::fillEventHistos(double mult, double cent, double weight)
 {
-//	const Configuration & ac1 = *(Configuration*) getConfiguration();
-//	h_eventStreams->Fill(mult,weight);
-//	if (ac1.ptCorrelatorVsMult) h_eventStreams_vsMult->Fill(mult,weight);
-//	if (ac1.ptCorrelatorVsCent) h_eventStreams_vsCent->Fill(cent,weight);
+	h_eventStreams->Fill(mult,weight);
+	if (ptCorrelatorVsMult) h_eventStreams_vsMult->Fill(mult,weight);
+	if (ptCorrelatorVsCent) h_eventStreams_vsCent->Fill(cent,weight);
 }
 
 
 // recursively create histograms for correlation functions of order 1 - maxOrder
-// Note: these histograms are not in sequence of lowest order to highest order. The reording occurs when the histograms are saved with the HistogramsExport function.
+// Note: these histograms are not in sequence of lowest order to highest order. The reording occurs when the histograms are saved with the exportHistograms function.
 void PTHistos::createHistogramRec(String * baseName, String * baseTitle, int depth, int partIndex)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::HistogramsCreateRec(..) started"<< endl;
-//	const Configuration & ac = *(Configuration*) getConfiguration();
-//	String *histoName = new TString[2 * numFunc +1];
-//	String *histoTitle= new TString[2 * numFunc +1];
-//
-//
-//	for(int i = partIndex; i < maxOrder; i++)
-//	{
-//
-//		for(int iFunc = 0; iFunc < numFunc ; iFunc++)
-//		{
-//			histoName[iFunc]  = baseName[iFunc] + (i + 1) ;
-//			histoTitle[iFunc] = (depth == maxOrder - 1) ? baseTitle[iFunc] + (i + 1) : baseTitle[iFunc] + ", " + (i + 1);
-//			histoName[iFunc + numFunc]  = baseName[iFunc + numFunc] + (i + 1);
-//			histoTitle[iFunc + numFunc] = (depth == maxOrder - 1) ? baseTitle[iFunc + numFunc] + (i + 1) : baseTitle[iFunc + numFunc] + ", " + (i + 1);
-//
-//			names[iFunc][histoIndex] = histoName[iFunc];
-//			titles[iFunc][histoIndex] = histoTitle[iFunc];
-//
-//			/*hS[iFunc][histoIndex] = createProfile( histoName[iFunc], 1, ac.max_mult, ac.min_mult,"mult",histoTitle[iFunc] + "}" );
-//			if (ac.ptCorrelatorVsMult)	hS_vsMult[iFunc][histoIndex] = createProfile(histoName[iFunc] + "_vsMult",ac.nBins_mult, ac.max_mult, ac.min_mult, "mult", histoTitle[iFunc] + "}");
-//			if (ac.ptCorrelatorVsCent)	hS_vsCent[iFunc][histoIndex] = createProfile(histoName[iFunc] + "_vsCent",ac.nBins_cent,ac.max_mult, ac.min_mult, "cent", histoTitle[iFunc] + "}");*/
-//
-//			names2[iFunc][histoIndex] = histoName[iFunc + numFunc];
-//			titles2[iFunc][histoIndex] = histoTitle[iFunc + numFunc];
-//			/*hC[iFunc][histoIndex] = createHistogram( histoName[iFunc + numFunc], 1, ac.min_mult, ac.max_mult,"mult",histoTitle[iFunc + numFunc] + "}" );
-//			if (ac.ptCorrelatorVsMult)	hC_vsMult[iFunc][histoIndex] = createHistogram(histoName[iFunc + numFunc] + "_vsMult",ac.nBins_mult,ac.min_mult, ac.max_mult, "mult", histoTitle[iFunc + numFunc] + "}");
-//			if (ac.ptCorrelatorVsCent)	hC_vsCent[iFunc][histoIndex] = createHistogram(histoName[iFunc + numFunc] + "_vsCent",ac.nBins_cent,ac.min_mult, ac.max_mult, "cent", histoTitle[iFunc + numFunc] + "}");*/
-//		}
-//
-//
-//		histoName[2 * numFunc]  = baseName[2 * numFunc] + (i + 1);
-//		histoTitle[2 * numFunc] = (depth == maxOrder - 1) ? baseTitle[2 * numFunc] + (i + 1) : baseTitle[2 * numFunc] + ", " + (i + 1);
-//
-//		h_counts[histoIndex]         = createProfile(histoName[2 * numFunc], 1, ac.max_mult, ac.min_mult,"mult", histoTitle[2 * numFunc] + "}" );
-//		if (ac.ptCorrelatorVsMult)	h_counts_vsMult[histoIndex]  = createProfile(histoName[2 * numFunc] + "_vsMult",ac.nBins_mult, ac.max_mult, ac.min_mult, "mult", histoTitle[2 * numFunc] + "}");
-//		if (ac.ptCorrelatorVsCent)	h_counts_vsCent[histoIndex]  = createProfile(histoName[2 * numFunc] + "_vsCent",ac.nBins_cent,ac.max_cent,  ac.min_cent, "cent",histoTitle[2 * numFunc] + "}");
-//
-//		orders[histoIndex] = maxOrder - depth;
-//
-//		histoIndex++;
-//
-//		if(depth != 0)	createHistogramRec(histoName, histoTitle , depth - 1, i);
-//	}
-//
-//	delete [] histoName;
-//	delete [] histoTitle;
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::HistogramsCreateRec(..) ended"<< endl;
-//	return;
+	TString *histoName = new TString[2 * numFunc +1];
+	TString *histoTitle= new TString[2 * numFunc +1];
+
+	for(int i = partIndex; i < maxOrder; i++)
+	{
+		for(int iFunc = 0; iFunc < numFunc ; iFunc++)
+		{
+			histoName[iFunc]  = baseName[iFunc] + (i + 1) ;
+			histoTitle[iFunc] = (depth == maxOrder - 1) ? baseTitle[iFunc] + (i + 1) : baseTitle[iFunc] + ", " + (i + 1);
+			histoName[iFunc + numFunc]  = baseName[iFunc + numFunc] + (i + 1);
+			histoTitle[iFunc + numFunc] = (depth == maxOrder - 1) ? baseTitle[iFunc + numFunc] + (i + 1) : baseTitle[iFunc + numFunc] + ", " + (i + 1);
+
+			names[iFunc][histoIndex] = histoName[iFunc];
+			titles[iFunc][histoIndex] = histoTitle[iFunc];
+			hS[iFunc][histoIndex] = createProfile(histoName[iFunc], 1, min_mult, max_mult, "mult", histoTitle[iFunc] + "}");
+			if (ptCorrelatorVsMult)	hS_vsMult[iFunc][histoIndex] = createProfile(histoName[iFunc] + "_vsMult",nBins_mult, min_mult, max_mult, "mult", histoTitle[iFunc] + "}");
+			if (ptCorrelatorVsCent)	hS_vsCent[iFunc][histoIndex] = createProfile(histoName[iFunc] + "_vsCent",nBins_cent, min_cent, max_cent, "cent", histoTitle[iFunc] + "}");
+
+			names2[iFunc][histoIndex] = histoName[iFunc + numFunc];
+			titles2[iFunc][histoIndex] = histoTitle[iFunc + numFunc];
+			hC[iFunc][histoIndex] = createHistogram(histoName[iFunc + numFunc], 1, min_mult, max_mult, "mult", histoTitle[iFunc + numFunc] + "}");
+			if (ptCorrelatorVsMult)	hC_vsMult[iFunc][histoIndex] = createHistogram(histoName[iFunc + numFunc] + "_vsMult",nBins_mult, min_mult, max_mult, "mult", histoTitle[iFunc + numFunc] + "}");
+			if (ptCorrelatorVsCent)	hC_vsCent[iFunc][histoIndex] = createHistogram(histoName[iFunc + numFunc] + "_vsCent",nBins_cent, min_cent, max_cent, "cent", histoTitle[iFunc + numFunc] + "}");
+		}
+
+		histoName[2 * numFunc]  = baseName[2 * numFunc] + (i + 1);
+		histoTitle[2 * numFunc] = (depth == maxOrder - 1) ? baseTitle[2 * numFunc] + (i + 1) : baseTitle[2 * numFunc] + ", " + (i + 1);
+
+		h_counts[histoIndex]         = createProfile(histoName[2 * numFunc], 1, min_mult, max_mult, "mult", histoTitle[2 * numFunc] + "}");
+		if (ptCorrelatorVsMult)	h_counts_vsMult[histoIndex]  = createProfile(histoName[2 * numFunc] + "_vsMult",nBins_mult, min_mult, max_mult, "mult", histoTitle[2 * numFunc] + "}");
+		if (ptCorrelatorVsCent)	h_counts_vsCent[histoIndex]  = createProfile(histoName[2 * numFunc] + "_vsCent",nBins_cent, min_cent, max_cent, "cent", histoTitle[2 * numFunc] + "}");
+
+		orders[histoIndex] = maxOrder - depth;
+
+		histoIndex++;
+
+		if(depth != 0)	createHistogramRec(histoName, histoTitle , depth - 1, i);
+	}
+
+	delete [] histoName;
+	delete [] histoTitle;
 }
 
-//////////////////////////////////////////////
-// need to fix
-//////////////////////////////////////////////
+// recursively load the histograms created by createHistogramRec
 void PTHistos::loadHistogramRec(String * baseName, int depth, int partIndex, TFile * inputFile)
 {
+	TString *histoName = new TString[2 * numFunc +1];
+
+	for(int i = partIndex; i < maxOrder; i++)
+	{
+		for(int iFunc = 0; iFunc < numFunc ; iFunc++)
+		{
+			histoName[iFunc]  = baseName[iFunc] + (i + 1) ;
+			histoName[iFunc + numFunc]  = baseName[iFunc + numFunc] + (i + 1);
+
+			hS[iFunc][histoIndex] = loadProfile(*inputFile, histoName[iFunc] );
+			if (ptCorrelatorVsMult)	hS_vsMult[iFunc][histoIndex] = loadProfile(*inputFile, histoName[iFunc] + "_vsMult");
+			if (ptCorrelatorVsCent)	hS_vsCent[iFunc][histoIndex] = loadProfile(*inputFile, histoName[iFunc] + "_vsCent");
+
+			hC[iFunc][histoIndex] = loadH1(*inputFile, histoName[iFunc + numFunc] );
+			if (ptCorrelatorVsMult)	hC_vsMult[iFunc][histoIndex] = loadH1(*inputFile, histoName[iFunc + numFunc] + "_vsMult");
+			if (ptCorrelatorVsCent)	hC_vsCent[iFunc][histoIndex] = loadH1(*inputFile, histoName[iFunc + numFunc] + "_vsCent");
+		}
+
+		histoName[2 * numFunc]  = baseName[2 * numFunc] + (i + 1);
+
+		h_counts[histoIndex]         = loadProfile(*inputFile, histoName[2 * numFunc]);
+		if (ptCorrelatorVsMult)	h_counts_vsMult[histoIndex]  = loadProfile(*inputFile, histoName[2 * numFunc] + "_vsMult");
+		if (ptCorrelatorVsCent)	h_counts_vsCent[histoIndex]  = loadProfile(*inputFile, histoName[2 * numFunc] + "_vsCent");
 
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::loadHistogramRec(..) Starting." << endl;
-//	const Configuration & ac = *(Configuration*) getConfiguration();
-//	String *histoName = new TString[2 * numFunc +1];
-//
-//
-//	for(int i = partIndex; i < maxOrder; i++)
-//	{
-//
-//		for(int iFunc = 0; iFunc < numFunc ; iFunc++)
-//		{
-//			histoName[iFunc]  = baseName[iFunc] + (i + 1) ;
-//			histoName[iFunc + numFunc]  = baseName[iFunc + numFunc] + (i + 1);
-//
-//
-//			hS[iFunc][histoIndex] = loadProfile(inputFile, histoName[iFunc] );
-//			if (ac.ptCorrelatorVsMult)	hS_vsMult[iFunc][histoIndex] = loadProfile(inputFile, histoName[iFunc] + "_vsMult");
-//			if (ac.ptCorrelatorVsCent)	hS_vsCent[iFunc][histoIndex] = loadProfile(inputFile, histoName[iFunc] + "_vsCent");
-//
-//
-//			hC[iFunc][histoIndex] = loadProfile(inputFile, histoName[iFunc + numFunc] );
-//			if (ac.ptCorrelatorVsMult)	hC_vsMult[iFunc][histoIndex] = loadProfile(inputFile, histoName[iFunc + numFunc] + "_vsMult");
-//			if (ac.ptCorrelatorVsCent)	hC_vsCent[iFunc][histoIndex] = loadProfile(inputFile, histoName[iFunc + numFunc] + "_vsCent");
-//		}
-//
-//
-//		histoName[2 * numFunc]  = baseName[2 * numFunc] + (i + 1);
-//
-//		h_counts[histoIndex]         = loadProfile(inputFile, histoName[2 * numFunc] + "}" );
-//		if (ac.ptCorrelatorVsMult)	h_counts_vsMult[histoIndex]  = loadProfile(inputFile, histoName[2 * numFunc] + "_vsMult");
-//		if (ac.ptCorrelatorVsCent)	h_counts_vsCent[histoIndex]  = loadProfile(inputFile, histoName[2 * numFunc] + "_vsCent");
-//
-//		orders[histoIndex] = maxOrder - depth;
-//
-//		histoIndex++;
-//
-//		if(depth != 0)	loadHistogramRec(histoName , depth - 1, i, inputFile);
-//	}
-//
-//	delete [] histoName;
-//	return;
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::loadHistogramRec(..) Completed." << endl;
+		orders[histoIndex] = maxOrder - depth;
+
+		histoIndex++;
+
+		if(depth != 0)	loadHistogramRec(histoName , depth - 1, i, inputFile);
+	}
+
+	delete [] histoName;
+}
+
+////////////////////////////////////////////
+// set the cumulant histograms C and c (normalized by the counts) from the cumulants (in normal order) of the given bins
+////////////////////////////////////////////
+void PTHistos::setCumulants(TH1 ** values, TH1 ** CHistos, TH1 ** cHistos, TProfile ** countHistos, int nBins)
+{
+	for(int iHisto = 0; iHisto <size; iHisto++)
+	{
+		TH1 * value = values[reorder[iHisto]];
+		for(int iBin = 1; iBin <=nBins; iBin++)
+		{
+			double v = value->GetBinContent(iBin);
+			if(v == 0) continue;
+			double ev = value->GetBinError(iBin);
+			CHistos[iHisto]->SetBinContent(iBin, totEvents * v);
+			CHistos[iHisto]->SetBinError(iBin, totEvents * ev);
+
+			double n = countHistos[iHisto]->GetBinContent(iBin);
+			if(n == 0) continue;
+			double en = countHistos[iHisto]->GetBinError(iBin);
+			cHistos[iHisto]->SetBinContent(iBin,  totEvents * v/n);
+			cHistos[iHisto]->SetBinError(iBin, totEvents * v/n * ( ev/v + en/n ));
+		}
+	}
 }
 
 void PTHistos::fillDerivedHistos(bool *** acceptances, double * mults, double * cents, int * numParticles, double ** pT)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::fillDerivedHistos(..) Starting." << endl;
-//	auto start = chrono::high_resolution_clock::now();
-//	HeavyIonconst Configuration & ac = (HeavyIonConfiguration&)*getConfiguration();
-//	//double max = ac.nCollisionsMax;
-//	h_eventStreams->BufferEmpty();
-//	ac.min_mult = h_eventStreams->GetXaxis()->GetXmin();
-//	ac.max_mult = h_eventStreams->GetXaxis()->GetXmax();
-//
-//
-//	avgpT = new double  [maxOrder];
-//	calculateInclusivePtAverage(acceptances, numParticles, pT);
-//
-//	avgCounts = new double [size]();
-//	counts = new int * [totEvents]();
-//	calculateInclusiveYieldsAverage(acceptances, numParticles);
-//
-//	SValues = new double * [totEvents]();
-//	calculateEventMoments(acceptances, numParticles, pT);
-//
-//	//fill SValues
-//	//fill SValues normalized by counts and average pT's
-//	for(int iEvent = 0; iEvent < totEvents;iEvent++)
-//	{
-//		for(int iHisto = 0; iHisto <size; iHisto++)
-//		{
-//			if(iEvent == 0)
-//			{
-//				for (int iFunc = 0; iFunc < numFunc; ++iFunc)
-//				{
-//					hS[iFunc][iHisto] = createProfile( names[iFunc][iHisto], 1, ac.min_mult , ac.max_mult ,"mult",titles[iFunc][iHisto] + "}" );
-//					if (ac.ptCorrelatorVsMult)	hS_vsMult[iFunc][iHisto] = createProfile(names[iFunc][iHisto] + "_vsMult",ac.nBins_mult,ac.min_mult, ac.max_mult, "mult", titles[iFunc][iHisto] + "}");
-//					if (ac.ptCorrelatorVsCent)	hS_vsCent[iFunc][iHisto] = createProfile(names[iFunc][iHisto] + "_vsCent",ac.nBins_mult,ac.min_mult, ac.max_mult , "cent", titles[iFunc][iHisto] + "}");
-//				}
-//			}
-//			if(counts[iEvent][iHisto] != 0)
-//			{
-//				hS[0][iHisto]->Fill(mults[iEvent], SValues[iEvent][iHisto], 1.0);//weight is always 1.0
-//				if (ac.ptCorrelatorVsMult)	hS_vsMult[0][iHisto]->Fill(mults[iEvent], SValues[iEvent][iHisto] , 1.0);
-//				if (ac.ptCorrelatorVsCent)	hS_vsCent[0][iHisto]->Fill(cents[iEvent], SValues[iEvent][iHisto] , 1.0);
-//
-//				hS[1][iHisto]->Fill(mults[iEvent], (SValues[iEvent][iHisto] / avgCounts[iHisto]), 1.0);
-//				if (ac.ptCorrelatorVsMult)  hS_vsMult[1][iHisto]->Fill(mults[iEvent], (SValues[iEvent][iHisto] / avgCounts[iHisto]), 1.0);
-//				if (ac.ptCorrelatorVsCent)	hS_vsCent[1][iHisto]->Fill(cents[iEvent], (SValues[iEvent][iHisto] / avgCounts[iHisto]), 1.0);
-//			}
-//
-//			h_counts[iHisto]->Fill(mults[iEvent], counts[iEvent][iHisto], 1.0);//weight is always 1.0
-//			if (ac.ptCorrelatorVsMult)	h_counts_vsMult[iHisto]->Fill(mults[iEvent], counts[iEvent][iHisto] , 1.0);
-//			if (ac.ptCorrelatorVsCent)	h_counts_vsCent[iHisto]->Fill(cents[iEvent], counts[iEvent][iHisto] , 1.0);
-//		}
-//		histoIndex = 0;
-//		fillNormalizedPTValues(maxOrder - 1, 0, 1,  SValues[iEvent], mults[iEvent], cents[iEvent]);
-//		histoIndex = 0;
-//	}
-//
-//	TH1 *** newhCValues = new TH1**[3];
-//	for(int iHisto = 0; iHisto < 3; iHisto++)
-//	{
-//		newhCValues[iHisto] = new TH1*[size];
-//	}
-//
-//	calculateCumulants(hS[0], newhCValues[0], 1 ,ac.min_mult,  ac.max_mult);
-//	if (ac.ptCorrelatorVsMult)	calculateCumulants(hS_vsMult[0], newhCValues[1], ac.nBins_mult,ac.min_mult,  ac.max_mult);
-//	if (ac.ptCorrelatorVsCent)	calculateCumulants(hS_vsCent[0], newhCValues[2], ac.nBins_cent,ac.min_cent,  ac.max_cent);
-//
-//	for(int iHisto = 0; iHisto <size; iHisto++)
-//	{
-//		for (int i = 0; i < numFunc; ++i)
-//		{
-//			hC[i][iHisto] = createHistogram( names2[i][iHisto], 1, ac.min_mult, ac.max_mult,"mult",titles2[i][iHisto] + "}" );
-//			if (ac.ptCorrelatorVsMult)	hC_vsMult[i][iHisto] = createHistogram(names2[i][iHisto] + "_vsMult",ac.nBins_mult,ac.min_mult , ac.max_mult , "mult", titles2[i][iHisto] + "}");
-//			if (ac.ptCorrelatorVsCent)	hC_vsCent[i][iHisto] = createHistogram(names2[i][iHisto] + "_vsCent",ac.nBins_cent,ac.min_mult , ac.max_mult , "cent", titles2[i][iHisto] + "}");
-//		}
-//		int nBins = 1;
-//		for(int iBin = 1; iBin <=nBins; iBin++)
-//		{
-//			if(newhCValues[0][reorder[iHisto]]->GetBinContent(iBin) != 0)
-//			{
-//				hC[0][iHisto]->SetBinContent(iBin, totEvents * newhCValues[0][reorder[iHisto]]->GetBinContent(iBin));
-//				hC[0][iHisto]->SetBinError(iBin, totEvents * newhCValues[0][reorder[iHisto]]->GetBinError(iBin));
-//
-//				hC[1][iHisto]->SetBinContent(iBin,  totEvents * newhCValues[0][reorder[iHisto]]->GetBinContent(iBin)/h_counts[iHisto]->GetBinContent(iBin));
-//				double err = newhCValues[0][reorder[iHisto]]->GetBinContent(iBin)/h_counts[iHisto]->GetBinContent(iBin) * ( newhCValues[0][reorder[iHisto]]->GetBinError(iBin)/newhCValues[0][reorder[iHisto]]->GetBinContent(iBin) + h_counts[iHisto]->GetBinError(iBin)/h_counts[iHisto]->GetBinContent(iBin) );
-//				hC[1][iHisto]->SetBinError(iBin, totEvents * err);
-//			}
-//		}
-//
-//		if (ac.ptCorrelatorVsMult)
-//		{
-//			nBins =ac.nBins_mult;
-//			for(int iBin = 1; iBin <=nBins; iBin++)
-//			{
-//				if(newhCValues[1][reorder[iHisto]]->GetBinContent(iBin) != 0)
-//				{
-//					hC_vsMult[0][iHisto]->SetBinContent(iBin, totEvents * newhCValues[1][reorder[iHisto]]->GetBinContent(iBin));
-//					hC_vsMult[0][iHisto]->SetBinError(iBin, totEvents * newhCValues[1][reorder[iHisto]]->GetBinError(iBin));
-//
-//					hC_vsMult[1][iHisto]->SetBinContent(iBin,  totEvents * newhCValues[1][reorder[iHisto]]->GetBinContent(iBin)/h_counts_vsMult[iHisto]->GetBinContent(iBin));
-//					double err = newhCValues[1][reorder[iHisto]]->GetBinContent(iBin)/h_counts_vsMult[iHisto]->GetBinContent(iBin) * ( newhCValues[1][reorder[iHisto]]->GetBinError(iBin)/newhCValues[1][reorder[iHisto]]->GetBinContent(iBin) + h_counts_vsMult[iHisto]->GetBinError(iBin)/h_counts_vsMult[iHisto]->GetBinContent(iBin) );
-//					hC_vsMult[1][iHisto]->SetBinError(iBin, totEvents * err);
-//				}
-//			}
-//		}
-//
-//		if (ac.ptCorrelatorVsCent)
-//		{
-//			nBins = ac.nBins_cent;
-//			for(int iBin = 1; iBin <=nBins; iBin++)
-//			{
-//				if(newhCValues[2][reorder[iHisto]]->GetBinContent(iBin) != 0)
-//				{
-//					hC_vsCent[0][iHisto]->SetBinContent(iBin, totEvents * newhCValues[2][reorder[iHisto]]->GetBinContent(iBin));
-//					hC_vsCent[0][iHisto]->SetBinError(iBin, totEvents * newhCValues[2][reorder[iHisto]]->GetBinError(iBin));
-//
-//					hC_vsCent[1][iHisto]->SetBinContent(iBin, totEvents * newhCValues[2][reorder[iHisto]]->GetBinContent(iBin)/h_counts_vsCent[iHisto]->GetBinContent(iBin));
-//					double err = newhCValues[2][reorder[iHisto]]->GetBinContent(iBin)/h_counts_vsCent[iHisto]->GetBinContent(iBin) * ( newhCValues[2][reorder[iHisto]]->GetBinError(iBin)/newhCValues[2][reorder[iHisto]]->GetBinContent(iBin) + h_counts_vsCent[iHisto]->GetBinError(iBin)/h_counts_vsCent[iHisto]->GetBinContent(iBin) );
-//					hC_vsCent[1][iHisto]->SetBinError(iBin, totEvents * err);
-//				}
-//			}
-//		}
-//
-//	}
-//
-//	fillNormalizedPTValues(maxOrder - 1, 0, 1,  newhCValues, reorder, new int[3]{1,ac.nBins_mult, ac.nBins_cent});
-//
-//	auto stop = chrono::high_resolution_clock::now();
-//	auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
-//	if (reportInfo(__FUNCTION__)) cout << "Time taken to calculate derived histos: " << duration.count() << " microseconds"<< endl;
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::fillDerivedHistos(..) Completed." << endl;
-//
-//
+	if (reportStart(__FUNCTION__))
+		;
+	auto start = chrono::high_resolution_clock::now();
+
+	avgpT = new double  [maxOrder];
+	calculateInclusivePtAverage(acceptances, numParticles, pT);
 
+	avgCounts = new double [size]();
+	counts = new double * [totEvents]();
+	calculateInclusiveYieldsAverage(acceptances, numParticles);
 
+	SValues = new double * [totEvents]();
+	calculateEventMoments(acceptances, numParticles, pT);
+
+	//fill SValues
+	//fill SValues normalized by counts and average pT's
+	for(int iEvent = 0; iEvent < totEvents;iEvent++)
+	{
+		for(int iHisto = 0; iHisto <size; iHisto++)
+		{
+			if(counts[iEvent][iHisto] != 0)
+			{
+				hS[0][iHisto]->Fill(mults[iEvent], SValues[iEvent][iHisto], 1.0);//weight is always 1.0
+				if (ptCorrelatorVsMult)	hS_vsMult[0][iHisto]->Fill(mults[iEvent], SValues[iEvent][iHisto] , 1.0);
+				if (ptCorrelatorVsCent)	hS_vsCent[0][iHisto]->Fill(cents[iEvent], SValues[iEvent][iHisto] , 1.0);
+
+				if(avgCounts[iHisto] != 0)
+				{
+					hS[1][iHisto]->Fill(mults[iEvent], (SValues[iEvent][iHisto] / avgCounts[iHisto]), 1.0);
+					if (ptCorrelatorVsMult)  hS_vsMult[1][iHisto]->Fill(mults[iEvent], (SValues[iEvent][iHisto] / avgCounts[iHisto]), 1.0);
+					if (ptCorrelatorVsCent)	hS_vsCent[1][iHisto]->Fill(cents[iEvent], (SValues[iEvent][iHisto] / avgCounts[iHisto]), 1.0);
+				}
+			}
+
+			h_counts[iHisto]->Fill(mults[iEvent], counts[iEvent][iHisto], 1.0);//weight is always 1.0
+			if (ptCorrelatorVsMult)	h_counts_vsMult[iHisto]->Fill(mults[iEvent], counts[iEvent][iHisto] , 1.0);
+			if (ptCorrelatorVsCent)	h_counts_vsCent[iHisto]->Fill(cents[iEvent], counts[iEvent][iHisto] , 1.0);
+		}
+		histoIndex = 0;
+		fillNormalizedPTValues(maxOrder - 1, 0, 1,  SValues[iEvent], mults[iEvent], cents[iEvent]);
+		histoIndex = 0;
+	}
+
+	TH1 *** newhCValues = new TH1**[3];
+	for(int iType = 0; iType < 3; iType++)
+	{
+		newhCValues[iType] = new TH1*[size]();
+	}
+
+	calculateCumulants(hS[0], newhCValues[0], 1, min_mult, max_mult);
+	if (ptCorrelatorVsMult)	calculateCumulants(hS_vsMult[0], newhCValues[1], nBins_mult, min_mult, max_mult);
+	if (ptCorrelatorVsCent)	calculateCumulants(hS_vsCent[0], newhCValues[2], nBins_cent, min_cent, max_cent);
+
+	setCumulants(newhCValues[0], hC[0], hC[1], h_counts, 1);
+	if (ptCorrelatorVsMult)	setCumulants(newhCValues[1], hC_vsMult[0], hC_vsMult[1], h_counts_vsMult, nBins_mult);
+	if (ptCorrelatorVsCent)	setCumulants(newhCValues[2], hC_vsCent[0], hC_vsCent[1], h_counts_vsCent, nBins_cent);
+
+	int nBins[3] = {1, nBins_mult, nBins_cent};
+	histoIndex = 0;
+	fillNormalizedPTValues(maxOrder - 1, 0, 1,  newhCValues, reorder, nBins);
+	histoIndex = 0;
+
+	for(int iType = 0; iType < 3; iType++)
+	{
+		for(int iHisto = 0; iHisto < size; iHisto++) delete newhCValues[iType][iHisto];
+		delete [] newhCValues[iType];
+	}
+	delete [] newhCValues;
+
+	auto stop = chrono::high_resolution_clock::now();
+	auto duration = chrono::duration_cast<chrono::microseconds>(stop - start);
+	if (reportInfo(__FUNCTION__)) cout << "Time taken to calculate derived histos: " << duration.count() << " microseconds"<< endl;
+	if (reportEnd(__FUNCTION__))
+		;
 }
 
 ////////////////////////////////////////////
@@ -512,481 +541,270 @@ void PTHistos::fillDerivedHistos(bool *** acceptances, double * mults, double *
 /////////////////////////////////////////////
 void PTHistos::fillNormalizedPTValues( int depth, int partIndex, double product, double * values, double  mult, double  cent)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::fillNormalizedPTValues(..) Starting." << endl;
-//	const Configuration & ac = *(Configuration*)  getConfiguration();
-//
-//	for(int i = partIndex; i < maxOrder; i++)
-//	{
-//		double newProduct = product * avgpT[i];
-//
-//		if(values[histoIndex] != 0)
-//		{
-//			hS[2][histoIndex]->Fill(mult, (values[histoIndex] / newProduct), 1.0);
-//			if (ac.ptCorrelatorVsMult)	hS_vsMult[2][histoIndex]->Fill(mult, (values[histoIndex] / newProduct), 1.0);
-//			if (ac.ptCorrelatorVsCent)	hS_vsCent[2][histoIndex]->Fill(cent, (values[histoIndex] / newProduct), 1.0);
-//		}
-//		if(histoIndex != size - 1)	histoIndex++;
-//
-//		if(depth != 0)	fillNormalizedPTValues(depth - 1, i, newProduct, values, mult, cent);
-//	}
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::fillNormalizedPTValues(..) Completed." << endl;
+	for(int i = partIndex; i < maxOrder; i++)
+	{
+		double newProduct = product * avgpT[i];
+
+		if(values[histoIndex] != 0 && newProduct != 0)
+		{
+			hS[2][histoIndex]->Fill(mult, (values[histoIndex] / newProduct), 1.0);
+			if (ptCorrelatorVsMult)	hS_vsMult[2][histoIndex]->Fill(mult, (values[histoIndex] / newProduct), 1.0);
+			if (ptCorrelatorVsCent)	hS_vsCent[2][histoIndex]->Fill(cent, (values[histoIndex] / newProduct), 1.0);
+		}
+		if(histoIndex != size - 1)	histoIndex++;
+
+		if(depth != 0)	fillNormalizedPTValues(depth - 1, i, newProduct, values, mult, cent);
+	}
 }
-//
+
 void PTHistos::fillNormalizedPTValues( int depth, int partIndex, double product, TH1 *** values, int* reorder, int*  nBin)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::fillNormalizedPTValues(..) Starting." << endl;
-//	const Configuration & ac = *(Configuration*) getConfiguration();
-//
-//	for(int i = partIndex; i < maxOrder; i++)
-//	{
-//
-//
-//		double newProduct = product * avgpT[i];
-//
-//		for(int iBin = 1; iBin <=nBin[0]; iBin++)
-//		{
-//			if(values[0][reorder[histoIndex]]->GetBinContent(iBin) != 0)
-//			{
-//				hC[2][histoIndex]->SetBinContent(iBin, totEvents * values[0][reorder[histoIndex]]->GetBinContent(iBin) / newProduct);
-//				double err = values[0][reorder[histoIndex]]->GetBinContent(iBin)/newProduct * ( values[0][reorder[histoIndex]]->GetBinError(iBin)/values[0][reorder[histoIndex]]->GetBinContent(iBin));
-//				hC[2][histoIndex]->SetBinError(iBin, totEvents * err);
-//			}
-//		}
-//		if (ac.ptCorrelatorVsMult)
-//		{
-//			for(int iBin = 1; iBin <=nBin[1]; iBin++)
-//			{
-//				if(values[1][reorder[histoIndex]]->GetBinContent(iBin) != 0)
-//				{
-//					hC_vsMult[2][histoIndex]->SetBinContent(iBin, totEvents * values[1][reorder[histoIndex]]->GetBinContent(iBin) / newProduct);
-//					double err = values[1][reorder[histoIndex]]->GetBinContent(iBin)/newProduct * ( values[1][reorder[histoIndex]]->GetBinError(iBin)/values[1][reorder[histoIndex]]->GetBinContent(iBin));
-//					hC_vsMult[2][histoIndex]->SetBinError(iBin, totEvents * err);
-//				}
-//			}
-//		}
-//		if (ac.ptCorrelatorVsCent)
-//		{
-//			for(int iBin = 1; iBin <=nBin[2]; iBin++)
-//			{
-//				if(values[2][reorder[histoIndex]]->GetBinContent(iBin) != 0)
-//				{
-//					hC_vsCent[2][histoIndex]->SetBinContent(iBin, totEvents * values[2][reorder[histoIndex]]->GetBinContent(iBin) / newProduct);
-//					double err = values[1][reorder[histoIndex]]->GetBinContent(iBin)/newProduct * ( values[2][reorder[histoIndex]]->GetBinError(iBin)/values[2][reorder[histoIndex]]->GetBinContent(iBin));
-//					hC_vsCent[2][histoIndex]->SetBinError(iBin, totEvents * err);
-//				}
-//			}
-//		}
-//
-//		if(histoIndex != size - 1)	histoIndex++;
-//
-//		if(depth != 0)	fillNormalizedPTValues(depth - 1, i, newProduct, values, reorder, nBin);
-//	}
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::fillNormalizedPTValues(..) Completed." << endl;
+	TH1 ** targets[3] = { hC[2], hC_vsMult[2], hC_vsCent[2] };
+	bool    filled[3] = { true, ptCorrelatorVsMult, ptCorrelatorVsCent };
+	for(int i = partIndex; i < maxOrder; i++)
+	{
+		double newProduct = product * avgpT[i];
+
+		for(int iType = 0; iType < 3 && newProduct != 0; iType++)
+		{
+			if (!filled[iType]) continue;
+			TH1 * value = values[iType][reorder[histoIndex]];
+			for(int iBin = 1; iBin <=nBin[iType]; iBin++)
+			{
+				double v = value->GetBinContent(iBin);
+				if(v == 0) continue;
+				targets[iType][histoIndex]->SetBinContent(iBin, totEvents * v / newProduct);
+				targets[iType][histoIndex]->SetBinError(iBin, totEvents * value->GetBinError(iBin) / newProduct);
+			}
+		}
+
+		if(histoIndex != size - 1)	histoIndex++;
+
+		if(depth != 0)	fillNormalizedPTValues(depth - 1, i, newProduct, values, reorder, nBin);
+	}
 }
 
 ///////////////////////////////////////////
 //calculate the cumulants of the moments
+// The cumulant of the correlation function of filters {f_1, .., f_m} is obtained from the moments of all its sub-functions as
+//	C(f_1, .., f_m) = sum over the partitions P of {1, .., m} of (-1)^(|P|-1) (|P|-1)! prod_{B in P} S(B)
+// where |P| is the number of blocks of the partition. The partitions are enumerated as restricted growth strings.
+// The errors of the products are propagated assuming uncorrelated relative errors.
 //////////////////////////////////////////
 void PTHistos::calculateCumulants(TProfile ** SHistos, TH1 **CHistos, int nBins, double min, double max)
 {	
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateCumulants(..) Starting." << endl;
-//
-//	//HeavyIonconst Configuration & ac = (HeavyIonConfiguration&)( *getConfiguration());
-//
-//	TProfile ** newSHistos = new TProfile *[size];
-//	int counter = 0;
-//	for(int iOrd = 1; iOrd <= maxOrder; iOrd++)
-//	{
-//		for(int iHisto = 0; iHisto < size; iHisto++)
-//		{
-//			if(orders[iHisto] == iOrd)
-//			{
-//				newSHistos[counter] = SHistos[iHisto];
-//				counter++;
-//
-//			}
-//		}
-//	}
-//
-//	int maxSize = TMath::Factorial( maxOrder);
-//	double * used = new double[maxSize];
-//	for(int iBin = 1; iBin <=nBins; iBin++)
-//	{
-//		for(int iHisto = 0; iHisto < size; iHisto++)
-//		{
-//			double sum = 0;
-//			double absESq = 0;
-//
-//			int len = 0;
-//			int * ind = convert(iHisto, len);
-//
-//			int curInd = 0;
-//			int * set = new int[len];
-//			for(int i = 0; i < len; i++)
-//			{
-//				set[i] = i+1;
-//			}
-//
-//			calcRecSum( CHistos, iBin, absESq, 0, ind, set, len, set, len, 1, used, curInd, 1, sum );
-//
-//			String name = nBins * size + iHisto;
-//
-//			if(iBin == 1) CHistos[iHisto] = new TH1F(name, name, nBins, min, max);
-//
-//			double content = newSHistos[iHisto]->GetBinContent(iBin) - sum;
-//			double error = sqrt(newSHistos[iHisto]->GetBinError(iBin) * newSHistos[iHisto]->GetBinError(iBin) + absESq);
-//
-//			if(newSHistos[iHisto]->GetBinContent(iBin) != 0)
-//			{
-//				CHistos[iHisto]->SetBinContent(iBin, content);
-//				CHistos[iHisto]->SetBinError(iBin, error);
-//			}
-//			//if (abs(CHistos[iHisto]->GetBinContent(iBin)) < pow(10, -15)) CHistos[iHisto]->SetBinContent(iBin, 0); // doubles are accurate to 15 decimal places
-//
-//			//ind is now uneccesary
-//			delete[] ind;
-//
-//		}
-//	}
-//
-//	return;
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateCumulants(..) Completed." << endl;
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateCumulants(..) Starting." << endl;
 
+	// moments in normal order (1, 2 .. 11, 12 ..)
+	vector<TProfile*> newSHistos;
+	for(int iOrd = 1; iOrd <= maxOrder; iOrd++)
+	{
+		for(int iHisto = 0; iHisto < size; iHisto++)
+		{
+			if(orders[iHisto] == iOrd) newSHistos.push_back(SHistos[iHisto]);
+		}
+	}
+
+	vector< vector<int> > combinations;
+	getCombinations(combinations);
+	for(int iHisto = 0; iHisto < size; iHisto++)
+	{
+		String name = newSHistos[iHisto]->GetName();
+		name += "_C";
+		CHistos[iHisto] = new TH1F(name, name, nBins, min, max);
+	}
+
+	vector<int> block;
+	vector<int> sub;
+	for(int iBin = 1; iBin <=nBins; iBin++)
+	{
+		for(int iHisto = 0; iHisto < size; iHisto++)
+		{
+			const vector<int> & combination = combinations[iHisto];
+			int len = combination.size();
+			double moment = newSHistos[iHisto]->GetBinContent(iBin);
+			if(moment == 0) continue;
+
+			double sum = 0;
+			double absESq = 0;
+			block.assign(len, 0);
+			// skip the partition with a single block: it is the moment itself
+			while(nextPartition(block))
+			{
+				int nBlocks = 1 + *max_element(block.begin(), block.end());
+				double product = (nBlocks % 2 == 0) ? -1 : 1;
+				for(int i = 2; i < nBlocks; i++) product *= i;
+				double relESq = 0;
+				for(int iBlock = 0; iBlock < nBlocks && product != 0; iBlock++)
+				{
+					// positions are increasing so the sub function is ordered
+					sub.clear();
+					for(int i = 0; i < len; i++) if(block[i] == iBlock) sub.push_back(combination[i] + 1);
+					int iSub = convert(sub.data(), sub.size());
+					double value = newSHistos[iSub]->GetBinContent(iBin);
+					double error = newSHistos[iSub]->GetBinError(iBin);
+					product *= value;
+					if(value != 0) relESq += error * error / (value * value);
+				}
+				sum += product;
+				absESq += product * product * relESq;
+			}
+
+			double error = newSHistos[iHisto]->GetBinError(iBin);
+			CHistos[iHisto]->SetBinContent(iBin, moment + sum);
+			CHistos[iHisto]->SetBinError(iBin, sqrt(error * error + absESq));
+		}
+	}
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateCumulants(..) Completed." << endl;
 }
 
 ///////////////////////////////////////////////////
-//used to calculate a recursive partition sum used in calculation of the cumulants
-// ex: 	if the highest level cumulant corresponds to C(1,2,3), this function calculates sum = C(1, 2) * C(3) + C(1, 3) * C(2) + C(2, 3) * C(1) + C(1) * C(2) * C(3)
-//	   	At the first level, it starts with subset {3}, and gets C(3) * C(1, 2) and adds it to sum and places it on the used array
-//	   	It then proceeds to recurse on the proper subsets of {2, 3} and multiply these by C(3), so it gets C(1) * C(2) * C(3) and adds it to sum and places it on the used array
-//	   	Going back to the top level, it goes to subset {2} and gets C(2) * C(1, 3) and adds it to sum and places it on the used array
-//		It then proceeds to recurse on the proper subsets of {1, 3} and multiply these by C(2), so it gets C(1) * C(2) * C(3) and finds it on the used array so skips
-//		Going back to the top level, it goes to subset {2, 3} and gets C(2, 3) * C(1) and adds it to sum and places it on the used array
-//		It then proceeds to recurse on the proper subsets of {1} of which there are none
-// 		so on..
-//     	After this function concludes, C(1, 2, 3) = S(1, 2, 3) - sum
-// note that C(1) = S(1) because sum = 0
+// advance block (restricted growth string: block[0] = 0, block[i] <= 1 + max(block[0..i-1])) to the next set partition
+// returns false after the last partition (all elements in distinct blocks)
 ///////////////////////////////////////////////////
-void PTHistos::calcRecSum(TH1 **CHistos, int iBin, double& absESq, double curRelESq, int* iHisto, int* Subset, int len,  int * set, int lenSet, double productC, double* used, int& curInd, int productS, double& sum)
+bool PTHistos::nextPartition(vector<int> & block)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calcRecSum(..) Starting." << endl;
-//	int lenSub = 0;
-//	int lenCompSub = 0;
-//	if(len != 1)
-//	{
-//		char* bin = new char[len];
-//		int* subset;
-//		int * comp;
-//		int * compSubset;
-//
-//		// loop over all possible proper subsets
-//		for(int iSubset = 1; iSubset < pow(2, len) - 1; iSubset++)
-//		{
-//			//get the subset corresponding to iSubset, multiply it by the product(which contains cumulant terms from previous recursive levels)
-//			convertToBinary(iSubset, bin, len);
-//			subset = getSubset(bin, Subset, len, lenSub);
-//			int * s = getSubset(bin, iHisto, len, lenSub);
-//
-//			int iSub = convert(s, lenSub);
-//			double tempProduct = productC * CHistos[iSub]->GetBinContent(iBin);
-//			double tempRelErr = curRelESq + CHistos[iSub]->GetBinError(iBin) * CHistos[iSub]->GetBinError(iBin) / CHistos[iSub]->GetBinContent(iBin) / CHistos[iSub]->GetBinContent(iBin);
-//
-//			//One of the terms in the cumulant corresponds to the product of the subset cumulant and the complementary subset cumulant. The remaining terms are further partitions which are counted when recursed
-//			comp = getComplementarySubset(bin, Subset, len, lenCompSub);
-//			compSubset = getComplementarySubset(bin, iHisto, len, lenCompSub);
-//			int iComp = convert(compSubset, lenCompSub);
-//
-//			double tempProduct2 = tempProduct * CHistos[iComp]->GetBinContent(iBin);
-//			double tempRelErr2  = tempRelErr  + CHistos[iComp]->GetBinError(iBin) * CHistos[iComp]->GetBinError(iBin) / CHistos[iComp]->GetBinContent(iBin) / CHistos[iComp]->GetBinContent(iBin);
-//
-//			int tempProduct3 = productS * getSubsetNumber(subset, lenSub, set, lenSet);
-//			int tempProduct4 = tempProduct3 * getSubsetNumber(comp, lenCompSub, set, lenSet);
-//
-//			//check to make sure that no terms are counted more than once( ex. C(1) * C(2,3) can be counted for the subset {1} and {2,3} )
-//			bool accept = true;
-//			for(int i = 0; i < curInd; i++)
-//			{
-//				accept = accept && !(used[i] == tempProduct4);
-//			}
-//			if(accept)
-//			{
-//				sum += tempProduct2;
-//				absESq += tempProduct2 * tempProduct2 * tempRelErr2;
-//				used[curInd] = tempProduct4;
-//				curInd++;
-//			}
-//
-//			delete [] subset;
-//			delete[] s;
-//			//partition the complementary subset into smaller subsets and multiply them by tempProduct and add to the sum
-//			calcRecSum(CHistos, absESq, tempRelErr, iBin, compSubset, comp, lenCompSub, set, lenSet, tempProduct, used, curInd, tempProduct3, sum);
-//
-//			delete [] comp;
-//			delete[] compSubset;
-//
-//
-//
-//		}
-//	}
-//
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calcRecSum(..) Completed." << endl;
-//	return;
-	
+	int len = block.size();
+	for(int i = len - 1; i > 0; i--)
+	{
+		int maxBlock = 0;
+		for(int j = 0; j < i; j++) if(block[j] > maxBlock) maxBlock = block[j];
+		if(block[i] <= maxBlock)
+		{
+			block[i]++;
+			for(int j = i + 1; j < len; j++) block[j] = 0;
+			return true;
+		}
+	}
+	return false;
 }
 
-
-
 void PTHistos::calculateInclusivePtAverage(bool *** acceptances, int * numParticles, double ** pT)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusivePtAverage(..) Starting." << endl;
-//
-//	for(int iFilter = 0; iFilter < maxOrder; iFilter++)
-//	{
-//		double sumPt = 0;
-//		double totParts = 0;
-//		for(int iEvent = 0; iEvent < totEvents; iEvent++)
-//		{
-//			for (int iParticle = 0; iParticle < numParticles[iEvent]; ++iParticle)
-//			{
-//				if(acceptances[iEvent][iFilter][iParticle])
-//				{
-//					sumPt += pT[iEvent][iParticle];
-//					totParts += 1;
-//				}
-//			}
-//		}
-//		avgpT[iFilter] = sumPt/totParts;
-//	}
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusivePtAverage(..) Completed." << endl;
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusivePtAverage(..) Starting." << endl;
 
+	for(int iFilter = 0; iFilter < maxOrder; iFilter++)
+	{
+		double sumPt = 0;
+		double totParts = 0;
+		for(int iEvent = 0; iEvent < totEvents; iEvent++)
+		{
+			for (int iParticle = 0; iParticle < numParticles[iEvent]; ++iParticle)
+			{
+				if(acceptances[iEvent][iFilter][iParticle])
+				{
+					sumPt += pT[iEvent][iParticle];
+					totParts += 1;
+				}
+			}
+		}
+		avgpT[iFilter] = (totParts > 0) ? sumPt/totParts : 0;
+	}
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusivePtAverage(..) Completed." << endl;
 }
 
+///////////////////////////////////////////
+// number of tuples of distinct particles of each combination of particle filters, e.g., n1*(n1-1)*n2 for {1,1,2}
+//////////////////////////////////////////
 void PTHistos::calculateInclusiveYieldsAverage(bool *** acceptances, int * numParticles)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusiveYieldsAverage(..) Starting." << endl;
-//
-//	int ** tempCounts = new int *[totEvents];
-//	double * tempAvgCounts = new double [size];
-//	for(int iEvent = 0; iEvent < totEvents; iEvent++)
-//	{
-//		int *n = new int [maxOrder]();
-//		int counter = 0;
-//		tempCounts[iEvent] = new int [size]();
-//		counts[iEvent] = new int [size];
-//		for(int iFilter = 0; iFilter < maxOrder; iFilter++)
-//		{
-//			for(int iParticle = 0; iParticle < numParticles[iEvent]; iParticle++ )
-//			{
-//				if(acceptances[iEvent][iFilter][iParticle]) n[iFilter]++;
-//			}
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			if(n[iFilter1] > 0 ) tempCounts[iEvent][counter] = n[iFilter1];
-//			tempAvgCounts[counter] += tempCounts[iEvent][counter];
-//			counter++;
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			for(int iFilter2 = iFilter1; iFilter2 < maxOrder; iFilter2++)
-//			{
-//				int same1 = iFilter2 == iFilter1? 1 : 0;
-//				if(n[iFilter1] > 0 && (n[iFilter2] - same1) > 0) tempCounts[iEvent][counter] = n[iFilter1]*(n[iFilter2] - same1);
-//				tempAvgCounts[counter] += tempCounts[iEvent][counter];
-//				counter++;
-//			}
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			for(int iFilter2 = iFilter1; iFilter2 < maxOrder; iFilter2++)
-//			{
-//				int same12 = iFilter2 == iFilter1? 1 : 0;
-//				for(int iFilter3 = iFilter2; iFilter3 < maxOrder; iFilter3++)
-//				{
-//					int same13 = iFilter3 == iFilter1? 1 : 0;
-//					int same23 = iFilter2 == iFilter3? 1 : 0;
-//					if(n[iFilter1] > 0 && (n[iFilter2] - same12) > 0 && (n[iFilter3] - same13 - same23) > 0) tempCounts[iEvent][counter] = n[iFilter1]*(n[iFilter2] - same12)*(n[iFilter3] - same13 - same23);
-//					tempAvgCounts[counter] += tempCounts[iEvent][counter];
-//					counter++;
-//				}
-//			}
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			for(int iFilter2 = iFilter1; iFilter2 < maxOrder; iFilter2++)
-//			{
-//				for(int iFilter3 = iFilter2; iFilter3 < maxOrder; iFilter3++)
-//				{
-//					int same12 = iFilter2 == iFilter1? 1 : 0;
-//					int same13 = iFilter3 == iFilter1? 1 : 0;
-//					int same23 = iFilter2 == iFilter3? 1 : 0;
-//					for(int iFilter4 = iFilter3; iFilter4 < maxOrder; iFilter4++)
-//					{
-//						int same14 = iFilter4 == iFilter1? 1 : 0;
-//						int same24 = iFilter2 == iFilter4? 1 : 0;
-//						int same34 = iFilter3 == iFilter4? 1 : 0;
-//						if(n[iFilter1] > 0 && (n[iFilter2] - same12) > 0 && (n[iFilter3] - same13 - same23) > 0 && (n[iFilter4] - same14 - same24 - same34) > 0) tempCounts[iEvent][counter] = n[iFilter1]*(n[iFilter2] - same12)*(n[iFilter3] - same13 - same23)*(n[iFilter4] - same14 - same24 - same34);
-//						tempAvgCounts[counter] += tempCounts[iEvent][counter];
-//						counter++;
-//					}
-//				}
-//			}
-//		}
-//		delete [] n;
-//	}
-//
-//	for (int i = 0; i < size; ++i)
-//	{
-//		tempAvgCounts[i] /= totEvents;
-//	}
-//
-//	for(int iEvent = 0; iEvent < totEvents; iEvent++)
-//	{
-//		for(int iHisto = 0; iHisto < size; iHisto++)
-//		{
-//			counts[iEvent][iHisto] = tempCounts[iEvent][reorder[iHisto]];
-//		}
-//	}
-//
-//	for(int iHisto = 0; iHisto < size; iHisto++)
-//	{
-//		avgCounts[iHisto] = tempAvgCounts[reorder[iHisto]];
-//	}
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusiveYieldsAverage(..) Completed." << endl;
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusiveYieldsAverage(..) Starting." << endl;
+
+	vector< vector<int> > combinations;
+	getCombinations(combinations);
+	PowerSumCorrelator correlator(maxOrder, maxOrder);
+	vector<double> tempCounts(size);
+	vector<double> tempAvgCounts(size, 0.0);
+	for(int iEvent = 0; iEvent < totEvents; iEvent++)
+	{
+		correlator.reset();
+		for(int iFilter = 0; iFilter < maxOrder; iFilter++)
+		{
+			for(int iParticle = 0; iParticle < numParticles[iEvent]; iParticle++ )
+			{
+				if(acceptances[iEvent][iFilter][iParticle]) correlator.fill(iFilter, 1.0);
+			}
+		}
+		for(int iHisto = 0; iHisto < size; iHisto++)
+		{
+			tempCounts[iHisto] = correlator.getDenominator(combinations[iHisto]);
+			tempAvgCounts[iHisto] += tempCounts[iHisto];
+		}
+		counts[iEvent] = new double [size];
+		for(int iHisto = 0; iHisto < size; iHisto++)
+		{
+			counts[iEvent][iHisto] = tempCounts[reorder[iHisto]];
+		}
+	}
 
+	for(int iHisto = 0; iHisto < size; iHisto++)
+	{
+		avgCounts[iHisto] = tempAvgCounts[reorder[iHisto]] / totEvents;
+	}
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateInclusiveYieldsAverage(..) Completed." << endl;
 }
 
+///////////////////////////////////////////
+// event-wise moments S(f_1, .., f_m) = sum over tuples of distinct particles of prod (pT_i - <pT>_f_i) for all combinations of
+// particle filters up to order maxOrder, computed from the per-filter power sums (see PowerSumCorrelator)
+// The particle filters must be disjoint: a particle accepted by several filters enters the mixed moments as if it were distinct
+// particles, which adds its self-correlations to them. A warning is issued when an overlap is found.
+//////////////////////////////////////////
 void PTHistos::calculateEventMoments(bool *** acceptances, int * numParticles, double ** pT)
 {
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateEventMoments(..) Starting." << endl;
-//
-//	double ** tempSValues = new double *[totEvents];
-//	for(int iEvent = 0; iEvent < totEvents; iEvent++)
-//	{
-//		double *n1 = new double [maxOrder]();
-//		double *n2 = new double [maxOrder]();
-//		double *n3 = new double [maxOrder]();
-//		double *n4 = new double [maxOrder]();
-//		int counter = 0;
-//		tempSValues[iEvent] = new double [size]();
-//		SValues[iEvent] = new double [size];
-//		for(int iFilter = 0; iFilter < maxOrder; iFilter++)
-//		{
-//			for(int iParticle = 0; iParticle < numParticles[iEvent]; iParticle++ )
-//			{
-//				if(acceptances[iEvent][iFilter][iParticle])
-//				{
-//					n1[iFilter]+= pT[iEvent][iParticle] - avgpT[iFilter];
-//					n2[iFilter]+= (pT[iEvent][iParticle] - avgpT[iFilter]) * (pT[iEvent][iParticle] - avgpT[iFilter]);
-//					n3[iFilter]+= (pT[iEvent][iParticle] - avgpT[iFilter]) * (pT[iEvent][iParticle] - avgpT[iFilter]) * (pT[iEvent][iParticle] - avgpT[iFilter]);
-//					n4[iFilter]+= (pT[iEvent][iParticle] - avgpT[iFilter]) * (pT[iEvent][iParticle] - avgpT[iFilter]) * (pT[iEvent][iParticle] - avgpT[iFilter]) * (pT[iEvent][iParticle] - avgpT[iFilter]);
-//				}
-//			}
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			tempSValues[iEvent][counter] = n1[iFilter1];
-//			counter++;
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			for(int iFilter2 = iFilter1; iFilter2 < maxOrder; iFilter2++)
-//			{
-//				double same12 = iFilter2 == iFilter1? n2[iFilter1] : 0;
-//				tempSValues[iEvent][counter] = n1[iFilter1] * n1[iFilter2] - same12;
-//				counter++;
-//			}
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			for(int iFilter2 = iFilter1; iFilter2 < maxOrder; iFilter2++)
-//			{
-//				int same12 = iFilter2 == iFilter1? 1 : 0;
-//				for(int iFilter3 = iFilter2; iFilter3 < maxOrder; iFilter3++)
-//				{
-//					if(iFilter1 == iFilter2)
-//					{
-//						if(iFilter1 == iFilter3) tempSValues[iEvent][counter] = n1[iFilter1] * n1[iFilter1] * n1[iFilter1] - 3 * n2[iFilter1] * n1[iFilter1] + 2 * n3[iFilter1];
-//						else tempSValues[iEvent][counter] = (n1[iFilter1] * n1[iFilter1] - n2[iFilter1] ) * n1[iFilter3];
-//					}
-//					else
-//					{
-//						if(iFilter2 == iFilter3) tempSValues[iEvent][counter] = (n1[iFilter2] * n1[iFilter2] - n2[iFilter2] ) * n1[iFilter1];
-//						else tempSValues[iEvent][counter] = n1[iFilter1] * n1[iFilter2] * n1[iFilter3];
-//					}
-//					counter++;
-//				}
-//			}
-//		}
-//
-//		for(int iFilter1 = 0; iFilter1 < maxOrder; iFilter1++)
-//		{
-//			for(int iFilter2 = iFilter1; iFilter2 < maxOrder; iFilter2++)
-//			{
-//				for(int iFilter3 = iFilter2; iFilter3 < maxOrder; iFilter3++)
-//				{
-//					for(int iFilter4 = iFilter3; iFilter4 < maxOrder; iFilter4++)
-//					{
-//						if(iFilter1 == iFilter2)
-//						{
-//							if(iFilter1 == iFilter3)
-//							{
-//								if(iFilter1 == iFilter4)  tempSValues[iEvent][counter] = n1[iFilter2] * n1[iFilter1] * n1[iFilter1] * n1[iFilter1] - 6 * n1[iFilter1] * n1[iFilter1] * n2[iFilter1] + 8 * n1[iFilter1] *  n3[iFilter1] + 3 * n2[iFilter1] *  n2[iFilter1] - 6 *  n4[iFilter1];
-//								else tempSValues[iEvent][counter] = (n1[iFilter1] * n1[iFilter1] * n1[iFilter1] - 3 * n2[iFilter1] * n1[iFilter1] + 2 * n3[iFilter1]) * n1[iFilter4];
-//							}
-//							else
-//							{
-//								if(iFilter3 == iFilter4) tempSValues[iEvent][counter] = (n1[iFilter1] * n1[iFilter1] - n2[iFilter1] ) * (n1[iFilter3] * n1[iFilter3] - n2[iFilter3] );
-//								else tempSValues[iEvent][counter] = (n1[iFilter1] * n1[iFilter1] - n2[iFilter1] ) * n1[iFilter3] * n1[iFilter4];
-//							}
-//						}
-//						else
-//						{
-//							if(iFilter2 == iFilter3)
-//							{
-//								if(iFilter2 == iFilter4) tempSValues[iEvent][counter] = (n1[iFilter2] * n1[iFilter2] * n1[iFilter2] - 3 * n2[iFilter2] * n1[iFilter2] + 2 * n3[iFilter2]) * n1[iFilter1];
-//								else tempSValues[iEvent][counter] = (n1[iFilter2] * n1[iFilter2] - n2[iFilter2] ) * n1[iFilter1] * n1[iFilter4];
-//							}
-//							else
-//							{
-//								if(iFilter3 == iFilter4) tempSValues[iEvent][counter] = (n1[iFilter3] * n1[iFilter3] - n2[iFilter3] ) * n1[iFilter1] * n1[iFilter2];
-//								else tempSValues[iEvent][counter] = n1[iFilter1] * n1[iFilter2] * n1[iFilter3] * n1[iFilter4];
-//							}
-//						}
-//						counter++;
-//					}
-//				}
-//			}
-//		}
-//		delete [] n1;
-//		delete [] n2;
-//		delete [] n3;
-//		delete [] n4;
-//	}
-//
-//	for(int iEvent = 0; iEvent < totEvents; iEvent++)
-//	{
-//		for(int iHisto = 0; iHisto < size; iHisto++)
-//		{
-//			SValues[iEvent][iHisto] = tempSValues[iEvent][reorder[iHisto]];
-//		}
-//	}
-//
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateEventMoments(..) Completed." << endl;
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateEventMoments(..) Starting." << endl;
+
+	vector< vector<int> > combinations;
+	getCombinations(combinations);
+	PowerSumCorrelator correlator(maxOrder, maxOrder);
+	long nOverlaps = 0;
+	for(int iEvent = 0; iEvent < totEvents; iEvent++)
+	{
+		correlator.reset();
+		for(int iFilter = 0; iFilter < maxOrder; iFilter++)
+		{
+			for(int iParticle = 0; iParticle < numParticles[iEvent]; iParticle++ )
+			{
+				if(acceptances[iEvent][iFilter][iParticle]) correlator.fill(iFilter, pT[iEvent][iParticle] - avgpT[iFilter]);
+			}
+		}
+		for(int iParticle = 0; iParticle < numParticles[iEvent]; iParticle++ )
+		{
+			int nAccepted = 0;
+			for(int iFilter = 0; iFilter < maxOrder; iFilter++) if(acceptances[iEvent][iFilter][iParticle]) nAccepted++;
+			if(nAccepted > 1) nOverlaps++;
+		}
+		SValues[iEvent] = new double [size];
+		for(int iHisto = 0; iHisto < size; iHisto++)
+		{
+			SValues[iEvent][iHisto] = correlator.getNumerator(combinations[reorder[iHisto]]);
+		}
+	}
+
+	if (nOverlaps > 0 && reportWarning(__FUNCTION__))
+		cout << nOverlaps << " particles are accepted by more than one filter: the mixed moments include their self-correlations." << endl;
+	if (reportDebug(__FUNCTION__))  cout << "PTHistos::calculateEventMoments(..) Completed." << endl;
 }
 ////////////////////////////////////////////////////////////////////////////
 //Helper Functions
 ////////////////////////////////////////////////////////////////////////////
 
-
-
+///////////////////////////////////////
+// combinations of particle filters (indices from 0) in normal order (1, 2, 3, 4, 11, 12 .. 44, 111, .. 123 ..)
+///////////////////////////////////////
+void PTHistos::getCombinations(vector< vector<int> > & combinations)
+{
+	combinations.clear();
+	for(int iHisto = 0; iHisto < size; iHisto++)
+	{
+		int len = 0;
+		int * num = convert(iHisto, len);
+		vector<int> combination;
+		for(int i = 0; i < len; i++) combination.push_back(num[i] - 1);
+		combinations.push_back(combination);
+		delete [] num;
+	}
+}
 
 ///////////////////////////////////////
 // convert a base maxOrder integer (represented by num) into the index of the corresponding moment in the array
@@ -995,15 +813,15 @@ void PTHistos::calculateEventMoments(bool *** acceptances, int * numParticles, d
 ///////////////////////////////////////
 int PTHistos::convert(int * num, int len)
 {
-//	int convert = (TMath::Factorial( maxOrder + len - 1)) / (TMath::Factorial(maxOrder ) * TMath::Factorial(len - 1 )) - 1;
-//	for(int i = 0; i < len; i++)
-//	{
-//		for(int j = (i == 0)? 0: num[i - 1] - 1; j < num[i] - 1; j++)
-//		{
-//			convert += (TMath::Factorial( maxOrder + len - j - i - 2)) / (TMath::Factorial(maxOrder - j - 1 ) * TMath::Factorial(len - i - 1 ));
-//		}
-//	}
-  return 0;//convert;
+	int convert = int(TMath::Binomial(maxOrder + len - 1, len - 1) + 0.5) - 1;
+	for(int i = 0; i < len; i++)
+	{
+		for(int j = (i == 0)? 0: num[i - 1] - 1; j < num[i] - 1; j++)
+		{
+			convert += int(TMath::Binomial(maxOrder + len - j - i - 2, len - i - 1) + 0.5);
+		}
+	}
+	return convert;
 }
 
 //////////////////////////////////////
@@ -1012,38 +830,34 @@ int PTHistos::convert(int * num, int len)
 //////////////////////////////////////
 int * PTHistos::convert(int num, int & len)
 {
-  return 0;
-
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::convert(..) started." << endl;
-//	for(len = 2; len <=maxOrder + 1; len++)
-//	{
-//		int temp = (TMath::Factorial( maxOrder + len - 1)) / (TMath::Factorial(maxOrder ) * TMath::Factorial(len - 1 )) - 1 ;
-//		if(num < temp)
-//		{
-//			len--;
-//			num -= (TMath::Factorial( maxOrder + len - 1)) / (TMath::Factorial(maxOrder ) * TMath::Factorial(len - 1 )) - 1 ;
-//			break;
-//		}
-//	}
-//
-//	int * convert = new int[len];
-//
-//	for(int i = 0; i <len; i++)
-//	{
-//		int temp = 0;
-//		for(convert[i] = (i == 0)? 1: convert[i - 1] ; convert[i] <= maxOrder; convert[i]++)
-//		{
-//			int temp2 = (TMath::Factorial( maxOrder + len - (convert[i] - 1) - i - 2)) / (TMath::Factorial(maxOrder - (convert[i] - 1) - 1 ) * TMath::Factorial(len - i - 1 ));
-//			temp += temp2;
-//			if(num < temp)
-//			{
-//				num -=  (temp - temp2);
-//				break;
-//			}
-//		}
-//	}
-//	if (reportDebug(__FUNCTION__))  cout << "PTHistos::convert(..) Completed." << endl;
-//	return convert;
+	for(len = 2; len <=maxOrder + 1; len++)
+	{
+		int temp = int(TMath::Binomial(maxOrder + len - 1, len - 1) + 0.5) - 1;
+		if(num < temp)
+		{
+			len--;
+			num -= int(TMath::Binomial(maxOrder + len - 1, len - 1) + 0.5) - 1;
+			break;
+		}
+	}
+
+	int * convert = new int[len];
+
+	for(int i = 0; i <len; i++)
+	{
+		int temp = 0;
+		for(convert[i] = (i == 0)? 1: convert[i - 1] ; convert[i] <= maxOrder; convert[i]++)
+		{
+			int temp2 = int(TMath::Binomial(maxOrder + len - (convert[i] - 1) - i - 2, len - i - 1) + 0.5);
+			temp += temp2;
+			if(num < temp)
+			{
+				num -=  (temp - temp2);
+				break;
+			}
+		}
+	}
+	return convert;
 }
 
 //////////////////////////////////////////////
@@ -33,8 +33,18 @@ public:
            int             _ord);
   virtual ~PTHistos();
 
+  //!
+  //! Create the histograms of the correlation functions of order 1 to maxOrder. The following parameters are read from the
+  //! configuration of the parent task: TotEvents (number of events passed to fillDerivedHistos), PtCorrelatorVsMult,
+  //! PtCorrelatorVsCent, nBins_mult, Min_mult, Max_mult, nBins_cent, Min_cent, and Max_cent.
+  //!
   virtual void createHistograms();
   virtual void importHistograms(TFile & inputFile);
+
+  //!
+  //! Compute the inclusive average pT and yields, the event-wise moments, and their cumulants from the particles of the
+  //! totEvents events passed as arguments, and fill the moment (S, s, s*), cumulant (C, c, c*), and count histograms.
+  //!
   virtual void fillDerivedHistos(bool *** acceptances, double * mults, double * cents, int * numParticles, double ** pT);
   virtual void exportHistograms(TFile & outputFile, bool saveAll=false);
   virtual void createHistogramRec(String * baseName, String * baseTitle, int depth, int partIndex);
@@ -43,7 +53,6 @@ public:
   virtual void fillNormalizedPTValues( int depth, int partIndex, double product, double * SValues, double  mult, double  cent);
   virtual void fillNormalizedPTValues( int depth, int partIndex, double product, TH1 *** values, int* reorder, int*  nBin);
   virtual void calculateCumulants(TProfile ** Shistos, TH1 **CHistos, int nBins, double min, double max);
-  virtual void calcRecSum(TH1 **CHistos, int iBin, double& absESq, double curRelESq, int* iHisto, int* Subset, int len,  int * set, int lenSet, double productC, double* used, int& curInd, int productS, double& sum);
   virtual void calculateInclusivePtAverage(bool *** acceptances, int * numParticles, double ** pT);
   virtual void calculateInclusiveYieldsAverage(bool *** acceptances, int * numParticles);
   virtual void calculateEventMoments(bool *** acceptances, int * numParticles, double ** pT);
@@ -52,6 +61,12 @@ public:
   //Helper Functions
   ////////////////////////////////////////////////////////////////////////////
 
+  virtual void readConfiguration();
+  virtual void allocateArrays();
+  virtual void calculateReorder();
+  virtual void setCumulants(TH1 ** values, TH1 ** CHistos, TH1 ** cHistos, TProfile ** countHistos, int nBins);
+  virtual void getCombinations(vector< vector<int> > & combinations);
+  static bool nextPartition(vector<int> & block);
   virtual int convert(int * num, int len);
   virtual int* convert(int num, int & len);
   virtual void convertToBinary(int num, char*str, int len );
@@ -122,6 +137,15 @@ public:
 
   int totEvents;
 
+  bool   ptCorrelatorVsMult;
+  bool   ptCorrelatorVsCent;
+  int    nBins_mult;
+  double min_mult;
+  double max_mult;
+  int    nBins_cent;
+  double min_cent;
+  double max_cent;
+
   //store the inclusive avgpT of each of the particle filters
   double * avgpT; 
   
@@ -132,7 +156,7 @@ public:
   //store the yields of each combination of particle filters (1, 2 .. 4, 11, 12, .. 44 ..) per event
   //first index is event number
   //calculated in normal order, but then changed into recursive order.
-  int ** counts;
+  double ** counts;
 
   //store the moments of each combination of particle filters (1, 2 .. 4, 11, 12, .. 44 ..) per event
   //first index is event number
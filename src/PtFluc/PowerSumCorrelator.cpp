@@ -0,0 +1,82 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#include "PowerSumCorrelator.hpp"
+using CAP::PowerSumCorrelator;
+
+ClassImp(PowerSumCorrelator);
+
+PowerSumCorrelator::PowerSumCorrelator(int _nFilters, int _maxOrder)
+:
+nFilters(_nFilters),
+maxOrder(_maxOrder),
+powerSums(_nFilters*(_maxOrder+1),0.0),
+weightSums(_nFilters*(_maxOrder+1),0.0)
+{ }
+
+void PowerSumCorrelator::reset()
+{
+  powerSums.assign(powerSums.size(),0.0);
+  weightSums.assign(weightSums.size(),0.0);
+}
+
+double PowerSumCorrelator::getTupleSum(const double * p, int m)
+{
+  // T(n) = sum_{k=1}^{n} (-1)^{k-1} (n-1)!/(n-k)! T(n-k) p[k]
+  vector<double> t(m+1,0.0);
+  t[0] = 1.0;
+  for (int n=1; n<=m; n++)
+    {
+    double sum   = 0.0;
+    double coeff = 1.0;
+    for (int k=1; k<=n; k++)
+      {
+      sum   += coeff*t[n-k]*p[k];
+      coeff *= -double(n-k);
+      }
+    t[n] = sum;
+    }
+  return t[m];
+}
+
+double PowerSumCorrelator::getProduct(const vector<double> & sums, const vector<int> & filters) const
+{
+  double product = 1.0;
+  unsigned int nIndices = filters.size();
+  for (unsigned int i=0; i<nIndices; i++)
+    {
+    // count each filter once, at its first occurrence
+    bool first = true;
+    for (unsigned int j=0; j<i && first; j++) first = filters[j]!=filters[i];
+    if (!first) continue;
+    int m = 0;
+    for (unsigned int j=i; j<nIndices; j++) if (filters[j]==filters[i]) m++;
+    product *= getTupleSum(&sums[filters[i]*(maxOrder+1)],m);
+    if (product==0.0) break;
+    }
+  return product;
+}
+
+double PowerSumCorrelator::getNumerator(const vector<int> & filters) const
+{
+  return getProduct(powerSums,filters);
+}
+
+double PowerSumCorrelator::getDenominator(const vector<int> & filters) const
+{
+  return getProduct(weightSums,filters);
+}
+
+double PowerSumCorrelator::getCorrelator(const vector<int> & filters) const
+{
+  double denominator = getDenominator(filters);
+  return denominator!=0.0 ? getNumerator(filters)/denominator : 0.0;
+}
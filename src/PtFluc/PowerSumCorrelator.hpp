@@ -0,0 +1,138 @@
+/* **********************************************************************
+ * Copyright (C) 2019-2022, Claude Pruneau, Victor Gonzalez, Sumit Basu
+ * All rights reserved.
+ *
+ * Based on the ROOT package and environment
+ *
+ * For the licensing terms see LICENSE.
+ *
+ * Author: Claude Pruneau,   04/01/2022
+ *
+ * *********************************************************************/
+#ifndef CAP__PowerSumCorrelator
+#define CAP__PowerSumCorrelator
+#include <vector>
+#include "TObject.h"
+
+using namespace std;
+
+namespace CAP
+{
+
+//!
+//! Event-wise multi-particle correlators computed from power sums. For each particle filter f, the engine accumulates the power sums
+//! P_f(k) = sum_i (w_i x_i)^k and W_f(k) = sum_i w_i^k, k=1..maxOrder, where x_i is a per-particle value (e.g., pT or pT-<pT>) and w_i
+//! a per-particle weight. The sum over distinct particles of the products (w_1 x_1)...(w_m x_m) is then obtained with the recursion
+//!
+//!   T(m) = sum_{k=1}^{m} (-1)^{k-1} (m-1)!/(m-k)! T(m-k) P(k),   T(0) = 1,
+//!
+//! (Newton's identities for m! times the elementary symmetric polynomials). Filling costs O(N x maxOrder) and each correlator
+//! O(maxOrder^2), instead of O(N^m) for nested loops. Mixed correlators are specified by a list of filter indices (e.g., {0,0,1} for
+//! two particles of filter 0 and one of filter 1) and are computed as products over the distinct filters, assuming particles of
+//! different filters are distinct (as is the case for filters selecting different species or disjoint kinematic ranges).
+//!
+class PowerSumCorrelator
+{
+public:
+
+  //!
+  //! CTOR
+  //!
+  //! @param _nFilters number of particle filters
+  //! @param _maxOrder maximum order of the correlators
+  //!
+  PowerSumCorrelator(int _nFilters, int _maxOrder);
+
+  //!
+  //! DTOR
+  //!
+  virtual ~PowerSumCorrelator() {}
+
+  //!
+  //! Clear the power sums, e.g., at the beginning of an event.
+  //!
+  void reset();
+
+  //!
+  //! Add a particle with the given value and weight to the power sums of the given filter.
+  //!
+  inline void fill(int iFilter, double value, double weight=1.0)
+  {
+  double * p  = &powerSums[iFilter*(maxOrder+1)];
+  double * pw = &weightSums[iFilter*(maxOrder+1)];
+  double wx  = weight*value;
+  double wxk = 1.0;
+  double wk  = 1.0;
+  for (int k=1; k<=maxOrder; k++)
+    {
+    wxk   *= wx;
+    wk    *= weight;
+    p[k]  += wxk;
+    pw[k] += wk;
+    }
+  }
+
+  //!
+  //! Power sum sum_i (w_i x_i)^k of the given filter.
+  //!
+  inline double getPowerSum(int iFilter, int k) const
+  {
+  return powerSums[iFilter*(maxOrder+1)+k];
+  }
+
+  //!
+  //! Power sum sum_i w_i^k of the given filter.
+  //!
+  inline double getWeightSum(int iFilter, int k) const
+  {
+  return weightSums[iFilter*(maxOrder+1)+k];
+  }
+
+  //!
+  //! Sum, over all tuples of distinct particles of the given filters, of the products of w_i x_i.
+  //!
+  //! Particles are only known to be distinct within a filter. If the filters overlap (a particle accepted by two of the requested
+  //! filters), the tuples in which that particle appears once per filter are included, i.e., the result contains the
+  //! corresponding self-correlations. Callers must use disjoint filters, or fill the overlap as a filter of its own and correct
+  //! for it, to obtain the sum over distinct particles.
+  //!
+  double getNumerator(const vector<int> & filters) const;
+
+  //!
+  //! Sum, over all tuples of distinct particles of the given filters, of the products of w_i, i.e., the (weighted) number of tuples.
+  //!
+  double getDenominator(const vector<int> & filters) const;
+
+  //!
+  //! Correlator <x_1 ... x_m> of the given filters, or zero if the event has no such tuple.
+  //!
+  double getCorrelator(const vector<int> & filters) const;
+
+  inline int getNFilters() const { return nFilters; }
+  inline int getMaxOrder() const { return maxOrder; }
+
+  //!
+  //! Sum over the ordered tuples of m distinct elements of the products of their values, computed from the power sums
+  //! p[1..m] of the values.
+  //!
+  static double getTupleSum(const double * p, int m);
+
+protected:
+
+  //!
+  //! Product over the distinct filters of the tuple sums of the given power sums. The product factorizes only if the filters are
+  //! disjoint: see getNumerator.
+  //!
+  double getProduct(const vector<double> & sums, const vector<int> & filters) const;
+
+  int nFilters;
+  int maxOrder;
+  vector<double> powerSums;  //!< sum (w x)^k, stored per filter: [iFilter*(maxOrder+1)+k]
+  vector<double> weightSums; //!< sum w^k, stored per filter: [iFilter*(maxOrder+1)+k]
+
+  ClassDef(PowerSumCorrelator,0)
+};
+
+} // namespace CAP
+
+#endif /* CAP__PowerSumCorrelator */
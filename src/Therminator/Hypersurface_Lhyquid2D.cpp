@@ -110,12 +110,16 @@ void Hypersurface_Lhyquid2D::setPositionOnHypersurface(LorentzVector & position)
   zeta      = mDistance->getXMin() + (mDistance->getXMax() - mDistance->getXMin()) * gRandom->Rndm();
   phiS      = mDistance->getYMin() + (mDistance->getYMax() - mDistance->getYMin()) * gRandom->Rndm();
   rapidityS = spatialRapidityRange * (gRandom->Rndm() - 0.5); // * spatialRapidityRange;
-  Dhs       = mDistance     ->interpolate(zeta, phiS, 0.0);
-  dDdPhi    = mDistanceDPhi ->interpolate(zeta, phiS, 0.0);
-  dDdZeta   = mDistanceDZeta->interpolate(zeta, phiS, 0.0);
-  vT	      = mFluidVt      ->interpolate(zeta, phiS, 0.0);
+  // all hypersurface fields share the same grid: locate the point and compute the weights once
+  const VectorField * fields[5] = { mDistance, mDistanceDPhi, mDistanceDZeta, mFluidVt, mFluidPhi };
+  double values[5];
+  VectorField::interpolate(5, fields, zeta, phiS, 0.0, values);
+  Dhs       = values[0];
+  dDdPhi    = values[1];
+  dDdZeta   = values[2];
+  vT	      = values[3];
   gammaT    = 1.0/sqrt(1 - vT*vT);
-  phiF	    = mFluidPhi     ->interpolate(zeta, phiS, 0.0);
+  phiF	    = values[4];
   Tau       = tauI + Dhs * sin(zeta);
   rho       = Dhs * cos(zeta);
   position.SetXYZT(rho*cos(phiS),rho*sin(phiS),Tau*sinh(rapidityS),Tau*cosh(rapidityS));
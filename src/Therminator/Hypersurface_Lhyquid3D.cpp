@@ -83,13 +83,17 @@ void Hypersurface_Lhyquid3D::setPositionOnHypersurface(LorentzVector & position)
   zeta    = mDistance->getXMin() + (mDistance->getXMax() - mDistance->getXMin()) * gRandom->Rndm();
   phiS    = mDistance->getYMin() + (mDistance->getYMax() - mDistance->getYMin()) * gRandom->Rndm();
   Theta   = mDistance->getZMin() + (mDistance->getZMax() - mDistance->getZMin()) * gRandom->Rndm();
-  Dhs     = mDistance      ->interpolate(zeta, phiS, Theta);
-  dDdZeta = mDistanceDZeta ->interpolate(zeta, phiS, Theta);
-  dDdPhi  = mDistanceDPhi  ->interpolate(zeta, phiS, Theta);
-  dDdTheta= mDistanceDTheta->interpolate(zeta, phiS, Theta);
-  Ux	    = mFluidUx       ->interpolate(zeta, phiS, Theta);
-  Uy	    = mFluidUy       ->interpolate(zeta, phiS, Theta);
-  RapF	  = mFluidRapidity ->interpolate(zeta, phiS, Theta);
+  // all hypersurface fields share the same grid: locate the point and compute the weights once
+  const VectorField * fields[7] = { mDistance, mDistanceDZeta, mDistanceDPhi, mDistanceDTheta, mFluidUx, mFluidUy, mFluidRapidity };
+  double values[7];
+  VectorField::interpolate(7, fields, zeta, phiS, Theta, values);
+  Dhs     = values[0];
+  dDdZeta = values[1];
+  dDdPhi  = values[2];
+  dDdTheta= values[3];
+  Ux	    = values[4];
+  Uy	    = values[5];
+  RapF	  = values[6];
   Tau     = tauI + Dhs * sin(Theta) * sin(zeta);
   rho     = Dhs * sin(Theta) * cos(zeta);
   rapidityS	  = Dhs * cos(Theta) / lambda;
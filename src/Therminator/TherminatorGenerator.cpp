@@ -78,7 +78,9 @@ modelOnlyBackFlow(0),
 decayRescaleChannels(0),
 decayDisable2Prong(false),
 decayDisable3Prong(false),
+decayStoreDecayedParts(true),
 particleDecayer(),
+particleCascade(),
 model(nullptr),
 averageMultiplicities(),
 eventMultiplicities()
@@ -281,7 +283,6 @@ void TherminatorGenerator::createEvent()
   double   maxIntegrand;
   double   value;
   double   valueTest;
-  CAP::Factory<Particle> * factory = Particle::getFactory();
   for (unsigned int iType=0; iType<nTypes; iType++)
     {
 
@@ -300,132 +301,22 @@ void TherminatorGenerator::createEvent()
 
       if (valueTest<value)
         {
-        Particle * particle = factory->getNextObject();
+        Particle * particle = particleFactory->getNextObject();
         particle->setType(particleType);
         particle->setLive(true);
         model->setParticlePX(*particle);
         iParticle++;
         //cout << " iParticle:" << iParticle << endl;
         event.add(particle);
-        // particle->printProperties();
-        //continue;
-
-
-
-        if (particleType->isStable()) continue;
-        //if (particleType->isWeakStable() || decayNoWeakDecay) continue;
-
-        Particle          & parent     = *particle;
-        ParticleType      & parentType = *particleType;
-        ParticleDecayMode & decayMode  = parentType.generateDecayMode();
-        int nChildren = decayMode.getNChildren();
-        if (nChildren<2  && decayDisable2Prong)  continue;
-        if (nChildren==2 && decayDisable2Prong)  continue;
-        if (nChildren==3 && decayDisable3Prong)  continue;
-
-        // decay this particle
-        // ===================
-        if (decayStoreDecayedParts) event.add(particle);
-
-        LorentzVector & parentMomentum  = parent.getMomentum();
-        LorentzVector & parentPosition  = parent.getPosition();
-        switch (nChildren)
-          {
-            case 1:
-            if (reportInfo(__FUNCTION__)) cout << "case 1  parentType==" << parent.getName() << endl;
-            break;
-
-            case 2:
-            {
-            //cout << "2-body decay" << endl;
-            Particle * child1 = particleFactory->getNextObject();
-            Particle * child2 = particleFactory->getNextObject();
-            ParticleType  & childType1 = decayMode.getChildType(0); child1->setType(&childType1); child1->setLive(true);
-            ParticleType  & childType2 = decayMode.getChildType(1); child2->setType(&childType2); child2->setLive(true);
-            LorentzVector & p1 = child1->getMomentum();
-            LorentzVector & r1 = child1->getPosition();
-            LorentzVector & p2 = child2->getMomentum();
-            LorentzVector & r2 = child2->getPosition();
-            particleDecayer.decay2(parentType,
-                                   parentMomentum,
-                                   parentPosition,
-                                   childType1,p1,r1,
-                                   childType2,p2,r2);
-            event.add(child1);
-            event.add(child2);
-            parent.setDecayed(true);
-            }
-            break;
-
-            case 3:
-            {
-            //cout << "3-body decay" << endl;
-
-            Particle * child1 = particleFactory->getNextObject();
-            Particle * child2 = particleFactory->getNextObject();
-            Particle * child3 = particleFactory->getNextObject();
-            ParticleType  & childType1 = decayMode.getChildType(0); child1->setType(&childType1); child1->setLive(true);
-            ParticleType  & childType2 = decayMode.getChildType(1); child2->setType(&childType2); child2->setLive(true);
-            ParticleType  & childType3 = decayMode.getChildType(2); child3->setType(&childType3); child3->setLive(true);
-            LorentzVector & p1 = child1->getMomentum();
-            LorentzVector & r1 = child1->getPosition();
-            LorentzVector & p2 = child2->getMomentum();
-            LorentzVector & r2 = child2->getPosition();
-            LorentzVector & p3 = child3->getMomentum();
-            LorentzVector & r3 = child3->getPosition();
-            particleDecayer.decay3(parentType,
-                                   parentMomentum,
-                                   parentPosition,
-                                   childType1,p1,r1,
-                                   childType2,p2,r2,
-                                   childType3,p3,r3);
-            event.add(child1);
-            event.add(child2);
-            event.add(child3);
-            parent.setDecayed(true);
-            }
-            break;
-            case 4:
-            cout << "4-body decay should not happen " << endl;
-            exit(1);
-            //          {
-            //  //        Particle * child1 = particleFactory->getNextObject();
-            //  //        Particle * child2 = particleFactory->getNextObject();
-            //  //        Particle * child3 = particleFactory->getNextObject();
-            //  //        Particle * child4 = particleFactory->getNextObject();
-            //  //        ParticleType   & childType1 = decayMode.getChildType(0); child1->setType(&childType1); child1->setLive(true);
-            //  //        ParticleType   & childType2 = decayMode.getChildType(1); child2->setType(&childType2); child2->setLive(true);
-            //  //        ParticleType   & childType3 = decayMode.getChildType(2); child3->setType(&childType3); child3->setLive(true);
-            //  //        ParticleType   & childType4 = decayMode.getChildType(3); child4->setType(&childType4); child4->setLive(true);
-            //  //        LorentzVector & p1 = child1->getMomentum();
-            //  //        LorentzVector & r1 = child1->getPosition();
-            //  //        LorentzVector & p2 = child2->getMomentum();
-            //  //        LorentzVector & r2 = child2->getPosition();
-            //  //        LorentzVector & p3 = child3->getMomentum();
-            //  //        LorentzVector & r3 = child3->getPosition();
-            //  //        LorentzVector & p4 = child4->getMomentum();
-            //  //        LorentzVector & r4 = child4->getPosition();
-            //  //        decayer.decay4(parentType,
-            //  //                       parentMomentum,
-            //  //                       parentPosition,
-            //  //                       childType1,p1,r1,
-            //  //                       childType2,p2,r2,
-            //  //                       childType3,p3,r3,
-            //  //                       childType4,p4,r4);
-            //  //        event.add(child1); child1->setLive(true);
-            //  //        event.add(child2); child2->setLive(true);
-            //  //        event.add(child3); child3->setLive(true);
-            //  //        event.add(child4); child4->setLive(true);
-            //  //        parent.setDecayed(true);
-            //  //        nParticles += 4;
-            //          }
-            break;
-            case 5:
-            break;
-          }
         }
       }
     }
+
+  // decay the unstable primaries (one generation) in a single batch
+  particleCascade.setDisable2Prong(decayDisable2Prong);
+  particleCascade.setDisable3Prong(decayDisable3Prong);
+  particleCascade.setStoreDecayedParents(decayStoreDecayedParts);
+  particleCascade.decay(event, *particleFactory, 0, 1);
 }
 
 void TherminatorGenerator::printIntroMessage(const TString & option __attribute__ (( unused)) )  const
@@ -509,6 +400,7 @@ void TherminatorGenerator::initializeEventGenerator() throw (TaskException)
     exportMultiplicities();
     }
   eventMultiplicities.assign(averageMultiplicities.size(),0.0);
+  particleCascade.initialize(*particleDb);
 }
 
 
@@ -518,6 +410,8 @@ void TherminatorGenerator::finalizeEventGenerator()
     {
     cout << endl;
     }
+  if (particleCascade.getNSkippedDecays()>0 && reportWarning(__FUNCTION__))
+    cout << "Decays skipped (channels with fewer than two children): " << particleCascade.getNSkippedDecays() << endl;
 
   particleDb = nullptr;
   if (model) delete model;
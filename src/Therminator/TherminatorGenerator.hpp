@@ -32,6 +32,7 @@
 #include "THGlobal.hpp"
 #include "ParticleDb.hpp"
 #include "ParticleDecayer.hpp"
+#include "ParticleDecayCascade.hpp"
 #include "EventTask.hpp"
 #include "Model.hpp"
 #include "Hypersurface.hpp"
@@ -47,6 +48,7 @@ using CAP::ParticleDb;
 using CAP::ParticleType;
 using CAP::ParticleDecayMode;
 using CAP::ParticleDecayer;
+using CAP::ParticleDecayCascade;
 using CAP::ParticleFilter;
 using CAP::TaskException;
 using CAP::FileException;
@@ -131,6 +133,7 @@ protected:
   bool   decayStoreDecayedParts;
 
   ParticleDecayer particleDecayer;
+  ParticleDecayCascade particleCascade;
   Model           * model;
   Event           * event;
   vector<ParticleMultiplicity> averageMultiplicities;